@@ -0,0 +1,167 @@
+/**
+ ****************************************************************************************
+ *
+ * @file ble_evt_pump.c
+ *
+ * @brief BLE event processing in batches
+ *
+ * Shared by the BLE examples, which link this folder into their project as ble_evt_pump.
+ *
+ * Copyright (C) 2024 Renesas Electronics Corporation and/or its affiliates.
+ * All rights reserved. Confidential Information.
+ *
+ * This software ("Software") is supplied by Renesas Electronics Corporation and/or its
+ * affiliates ("Renesas"). Renesas grants you a personal, non-exclusive, non-transferable,
+ * revocable, non-sub-licensable right and license to use the Software, solely if used in
+ * or together with Renesas products. You may make copies of this Software, provided this
+ * copyright notice and disclaimer ("Notice") is included in all such copies. Renesas
+ * reserves the right to change or discontinue the Software at any time without notice.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS". RENESAS DISCLAIMS ALL WARRANTIES OF ANY KIND,
+ * WHETHER EXPRESS, IMPLIED, OR STATUTORY, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT. TO THE
+ * MAXIMUM EXTENT PERMITTED UNDER LAW, IN NO EVENT SHALL RENESAS BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, SPECIAL, INCIDENTAL OR CONSEQUENTIAL DAMAGES ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE, EVEN IF RENESAS HAS BEEN ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGES. USE OF THIS SOFTWARE MAY BE SUBJECT TO TERMS AND CONDITIONS CONTAINED IN
+ * AN ADDITIONAL AGREEMENT BETWEEN YOU AND RENESAS. IN CASE OF CONFLICT BETWEEN THE TERMS
+ * OF THIS NOTICE AND ANY SUCH ADDITIONAL LICENSE AGREEMENT, THE TERMS OF THE AGREEMENT
+ * SHALL TAKE PRECEDENCE. BY CONTINUING TO USE THIS SOFTWARE, YOU AGREE TO THE TERMS OF
+ * THIS NOTICE.IF YOU DO NOT AGREE TO THESE TERMS, YOU ARE NOT PERMITTED TO USE THIS
+ * SOFTWARE.
+ *
+ ****************************************************************************************
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include "sdk_defs.h"
+#include "osal.h"
+#include "ble_common.h"
+#include "ble_evt_pump.h"
+
+#if BLE_EVT_PUMP_STATS_EN
+/* Statistics of an event type */
+typedef struct {
+        uint16_t evt_code;
+        uint32_t count;
+        uint32_t cycles;                /* Cycles spent in the handler, including freeing the event */
+        uint32_t cycles_max;
+} evt_stats_t;
+
+__RETAINED static evt_stats_t evt_stats[BLE_EVT_PUMP_STATS_TYPES];
+__RETAINED static uint32_t num_of_events;
+__RETAINED static uint32_t num_of_wakeups;
+__RETAINED static uint32_t num_of_empty_wakeups;
+__RETAINED static uint64_t busy_cycles;         /* Cycles spent in the pump */
+__RETAINED static OS_TICK_TIME period_start;
+__RETAINED static bool stats_started;
+
+static void stats_add_event(uint16_t evt_code, uint32_t cycles)
+{
+        for (int i = 0; i < BLE_EVT_PUMP_STATS_TYPES; i++) {
+                evt_stats_t *stats = &evt_stats[i];
+
+                if (stats->count && (stats->evt_code != evt_code)) {
+                        continue;
+                }
+
+                /* Found or first free entry; event types not fitting in the table are not shown */
+                stats->evt_code = evt_code;
+                stats->count++;
+                stats->cycles += cycles;
+                stats->cycles_max = MAX(stats->cycles_max, cycles);
+                break;
+        }
+        num_of_events++;
+}
+
+static void stats_print(uint32_t elapsed_ms)
+{
+        uint64_t elapsed_cycles = (uint64_t)elapsed_ms * (SystemCoreClock / 1000);
+        uint32_t load = (uint32_t)(busy_cycles * 10000 / elapsed_cycles);
+        uint32_t per_wakeup = num_of_wakeups ? (num_of_events * 100 / num_of_wakeups) : 0;
+
+        printf("BLE events: %lu (%lu/s), Wakeups: %lu (%lu empty), Events per wakeup: %lu.%02lu, "
+                "CPU load: %lu.%02lu %%\n\r",
+                num_of_events, num_of_events * 1000 / elapsed_ms, num_of_wakeups, num_of_empty_wakeups,
+                per_wakeup / 100, per_wakeup % 100, load / 100, load % 100);
+
+        for (int i = 0; (i < BLE_EVT_PUMP_STATS_TYPES) && evt_stats[i].count; i++) {
+                printf("  Event 0x%04X: %lu, Cycles avg/max: %lu/%lu\n\r", evt_stats[i].evt_code,
+                        evt_stats[i].count, evt_stats[i].cycles / evt_stats[i].count,
+                        evt_stats[i].cycles_max);
+        }
+}
+
+static void stats_add_wakeup(int events, uint32_t cycles)
+{
+        OS_TICK_TIME now = OS_GET_TICK_COUNT();
+        uint32_t elapsed_ms = OS_TICKS_2_MS(now - period_start);
+
+        num_of_wakeups++;
+        if (events == 0) {
+                num_of_empty_wakeups++;
+        }
+        busy_cycles += cycles;
+
+        if (elapsed_ms < BLE_EVT_PUMP_STATS_PERIOD_MS) {
+                return;
+        }
+
+        stats_print(elapsed_ms);
+
+        memset(evt_stats, 0, sizeof(evt_stats));
+        num_of_events = 0;
+        num_of_wakeups = 0;
+        num_of_empty_wakeups = 0;
+        busy_cycles = 0;
+        period_start = now;
+}
+#endif /* BLE_EVT_PUMP_STATS_EN */
+
+void ble_evt_pump(OS_TASK task, ble_evt_pump_handler_t handler, void *user_data)
+{
+        int events;
+
+#if BLE_EVT_PUMP_STATS_EN
+        uint32_t pump_start;
+
+        if (!stats_started) {
+                CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+                DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+                period_start = OS_GET_TICK_COUNT();
+                stats_started = true;
+        }
+        pump_start = DWT->CYCCNT;
+#endif
+
+        for (events = 0; events < BLE_EVT_PUMP_BATCH; events++) {
+                ble_evt_hdr_t *hdr = ble_get_event(false);
+
+                if (!hdr) {
+                        break;
+                }
+
+#if BLE_EVT_PUMP_STATS_EN
+                uint16_t evt_code = hdr->evt_code;
+                uint32_t start = DWT->CYCCNT;
+#endif
+
+                handler(hdr, user_data);
+                OS_FREE(hdr);
+
+#if BLE_EVT_PUMP_STATS_EN
+                stats_add_event(evt_code, DWT->CYCCNT - start);
+#endif
+        }
+
+        /* Notify again if there are more events to process in queue */
+        if (ble_has_event()) {
+                OS_TASK_NOTIFY(task, BLE_APP_NOTIFY_MASK, OS_NOTIFY_SET_BITS);
+        }
+
+#if BLE_EVT_PUMP_STATS_EN
+        stats_add_wakeup(events, DWT->CYCCNT - pump_start);
+#endif
+}
@@ -0,0 +1,89 @@
+/**
+ ****************************************************************************************
+ *
+ * @file ble_evt_pump.h
+ *
+ * @brief BLE event processing in batches
+ *
+ * Shared by the BLE examples, which link this folder into their project as ble_evt_pump.
+ *
+ * Copyright (C) 2024 Renesas Electronics Corporation and/or its affiliates.
+ * All rights reserved. Confidential Information.
+ *
+ * This software ("Software") is supplied by Renesas Electronics Corporation and/or its
+ * affiliates ("Renesas"). Renesas grants you a personal, non-exclusive, non-transferable,
+ * revocable, non-sub-licensable right and license to use the Software, solely if used in
+ * or together with Renesas products. You may make copies of this Software, provided this
+ * copyright notice and disclaimer ("Notice") is included in all such copies. Renesas
+ * reserves the right to change or discontinue the Software at any time without notice.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS". RENESAS DISCLAIMS ALL WARRANTIES OF ANY KIND,
+ * WHETHER EXPRESS, IMPLIED, OR STATUTORY, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT. TO THE
+ * MAXIMUM EXTENT PERMITTED UNDER LAW, IN NO EVENT SHALL RENESAS BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, SPECIAL, INCIDENTAL OR CONSEQUENTIAL DAMAGES ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE, EVEN IF RENESAS HAS BEEN ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGES. USE OF THIS SOFTWARE MAY BE SUBJECT TO TERMS AND CONDITIONS CONTAINED IN
+ * AN ADDITIONAL AGREEMENT BETWEEN YOU AND RENESAS. IN CASE OF CONFLICT BETWEEN THE TERMS
+ * OF THIS NOTICE AND ANY SUCH ADDITIONAL LICENSE AGREEMENT, THE TERMS OF THE AGREEMENT
+ * SHALL TAKE PRECEDENCE. BY CONTINUING TO USE THIS SOFTWARE, YOU AGREE TO THE TERMS OF
+ * THIS NOTICE.IF YOU DO NOT AGREE TO THESE TERMS, YOU ARE NOT PERMITTED TO USE THIS
+ * SOFTWARE.
+ *
+ ****************************************************************************************
+ */
+
+#ifndef BLE_EVT_PUMP_H_
+#define BLE_EVT_PUMP_H_
+
+#include <stdint.h>
+#include "osal.h"
+#include "ble_common.h"
+
+/*
+ * Max. number of BLE events processed per task wakeup. Events left in the queue are processed
+ * at the next wakeup, so that the other notifications of the task are not delayed during event
+ * bursts. Setting it to 1 processes one event per wakeup.
+ */
+#ifndef BLE_EVT_PUMP_BATCH
+#define BLE_EVT_PUMP_BATCH              ( 8 )
+#endif
+
+/*
+ * If set, the events and the wakeups per second, the CPU load of the event processing and the
+ * CPU cycles spent per event type are measured (DWT cycle counter) and displayed periodically.
+ */
+#ifndef BLE_EVT_PUMP_STATS_EN
+#define BLE_EVT_PUMP_STATS_EN           ( 0 )
+#endif
+
+/* Period, expressed in ms, of the statistics */
+#ifndef BLE_EVT_PUMP_STATS_PERIOD_MS
+#define BLE_EVT_PUMP_STATS_PERIOD_MS    ( 10000 )
+#endif
+
+/* Max. number of event types measured */
+#ifndef BLE_EVT_PUMP_STATS_TYPES
+#define BLE_EVT_PUMP_STATS_TYPES        ( 16 )
+#endif
+
+/*
+ * BLE event handler. The event is freed by the pump once the handler returns.
+ *
+ * \param [in] hdr       The BLE event
+ * \param [in] user_data User data passed to ble_evt_pump()
+ */
+typedef void (*ble_evt_pump_handler_t)(ble_evt_hdr_t *hdr, void *user_data);
+
+/*
+ * Process the queued BLE events, up to BLE_EVT_PUMP_BATCH. It should be called by the task
+ * registered to the BLE manager when notified with BLE_APP_NOTIFY_MASK. If events are left in
+ * the queue, the task is notified again.
+ *
+ * \param [in] task      The task registered to the BLE manager
+ * \param [in] handler   Function called for each event
+ * \param [in] user_data User data passed to \p handler
+ */
+void ble_evt_pump(OS_TASK task, ble_evt_pump_handler_t handler, void *user_data);
+
+#endif /* BLE_EVT_PUMP_H_ */
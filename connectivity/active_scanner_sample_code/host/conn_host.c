@@ -0,0 +1,273 @@
+/**
+ ****************************************************************************************
+ *
+ * @file conn_host.c
+ *
+ * @brief Host simulation of the time to connect multiple targets
+ *
+ * Copyright (C) 2024 Renesas Electronics Corporation and/or its affiliates.
+ * All rights reserved. Confidential Information.
+ *
+ * This software ("Software") is supplied by Renesas Electronics Corporation and/or its
+ * affiliates ("Renesas"). Renesas grants you a personal, non-exclusive, non-transferable,
+ * revocable, non-sub-licensable right and license to use the Software, solely if used in
+ * or together with Renesas products. You may make copies of this Software, provided this
+ * copyright notice and disclaimer ("Notice") is included in all such copies. Renesas
+ * reserves the right to change or discontinue the Software at any time without notice.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS". RENESAS DISCLAIMS ALL WARRANTIES OF ANY KIND,
+ * WHETHER EXPRESS, IMPLIED, OR STATUTORY, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT. TO THE
+ * MAXIMUM EXTENT PERMITTED UNDER LAW, IN NO EVENT SHALL RENESAS BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, SPECIAL, INCIDENTAL OR CONSEQUENTIAL DAMAGES ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE, EVEN IF RENESAS HAS BEEN ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGES. USE OF THIS SOFTWARE MAY BE SUBJECT TO TERMS AND CONDITIONS CONTAINED IN
+ * AN ADDITIONAL AGREEMENT BETWEEN YOU AND RENESAS. IN CASE OF CONFLICT BETWEEN THE TERMS
+ * OF THIS NOTICE AND ANY SUCH ADDITIONAL LICENSE AGREEMENT, THE TERMS OF THE AGREEMENT
+ * SHALL TAKE PRECEDENCE. BY CONTINUING TO USE THIS SOFTWARE, YOU AGREE TO THE TERMS OF
+ * THIS NOTICE.IF YOU DO NOT AGREE TO THESE TERMS, YOU ARE NOT PERMITTED TO USE THIS
+ * SOFTWARE.
+ *
+ ****************************************************************************************
+ */
+
+/*
+ * Time to connect all targets of the connection scheduler (conn_sched.c), for 1 up to 8 targets,
+ * in simulated time. The scheduler is driven as the scanner task drives it: each report is
+ * passed to conn_sched_is_candidate(), scanning is stopped while a connection is attempted to a
+ * candidate and resumed once the attempt completes. The radio is a model, with the following
+ * assumptions:
+ *  - Each target sends ADV_IND every CONN_HOST_ADV_INTERVAL_MS plus a random delay of up to
+ *    CONN_HOST_ADV_DELAY_MS (advDelay), starting at a random time, and stops advertising once
+ *    connected.
+ *  - Scanning is continuous (100% duty cycle) and every advertising event is received.
+ *  - The connection request is sent at the next advertising event of the target after the
+ *    attempt is started. The connection is established at the first connection event, up to one
+ *    connection interval (CONN_HOST_CONN_INTERVAL_MS) later, or fails after 6 connection
+ *    intervals with a probability of fail_pct percent.
+ * The figures are therefore those of the scheduling, not of a given radio environment, and have
+ * not been compared with the target.
+ *
+ * The check verifies that all the targets are connected, at one attempt each when no attempt
+ * fails and within the time of two advertising events and one connection interval per target,
+ * and that failed attempts are retried no earlier than the backoff time.
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <inttypes.h>
+#include "sdk_defs.h"
+#include "conn_sched.h"
+#include "host_stubs.h"
+
+#define CONN_HOST_ADV_INTERVAL_MS       ( 100 )
+#define CONN_HOST_ADV_DELAY_MS          ( 10 )
+#define CONN_HOST_CONN_INTERVAL_MS      ( 15 )
+#define CONN_HOST_FAIL_INTERVALS        ( 6 )
+
+/* Runs per number of targets and failure probability */
+#define CONN_HOST_RUNS                  ( 1000 )
+
+/* Simulated time after which a run is stopped */
+#define CONN_HOST_TIMEOUT_MS            ( 120000 )
+
+#define CONN_HOST_MAX_TARGETS           ( 8 )
+
+/* Connection attempt failure probabilities, in percent */
+static const uint8_t fail_pcts[] = { 0, 10, 30 };
+
+typedef enum {
+        SIM_STATE_SCANNING,
+        SIM_STATE_INITIATING,           /* Waiting for the next advertising event of the target */
+        SIM_STATE_ESTABLISHING,         /* Connection request sent */
+} sim_state_t;
+
+typedef struct {
+        bd_address_t address;
+        uint32_t next_adv_ms;
+        bool connected;
+        bool failed;
+        uint32_t backoff_ms;            /* Backoff expected after the last failed attempt */
+        uint32_t fail_ms;
+} sim_target_t;
+
+typedef struct {
+        bool all_connected;
+        uint32_t time_ms;               /* Time to connect all targets */
+        uint32_t num_of_attempts;
+        uint32_t num_of_early;          /* Attempts started before the end of the backoff time */
+} sim_result_t;
+
+static uint32_t lcg_state;
+static uint32_t num_of_violations;
+
+static uint32_t lcg_next(void)
+{
+        lcg_state = lcg_state * 1664525 + 1013904223;
+        return lcg_state >> 8;
+}
+
+static void violation(const char *what)
+{
+        num_of_violations++;
+        printf("Violation: %s\n", what);
+}
+
+static void simulate(uint8_t num_of_targets, uint8_t fail_pct, uint32_t timeout_ms, sim_result_t *r)
+{
+        sim_target_t sim[CONN_HOST_MAX_TARGETS];
+        ble_evt_gap_adv_report_t evt;
+        sim_state_t state = SIM_STATE_SCANNING;
+        uint32_t event_ms = 0;
+        bool success = false;
+        int cur = -1;
+
+        memset(r, 0, sizeof(*r));
+        memset(&evt, 0, sizeof(evt));
+        conn_sched_clear();
+
+        for (int i = 0; i < num_of_targets; i++) {
+                memset(&sim[i], 0, sizeof(sim[i]));
+                sim[i].address.addr_type = PUBLIC_ADDRESS;
+                sim[i].address.addr[0] = (uint8_t)(i + 1);
+                sim[i].address.addr[5] = 0xC0;
+                sim[i].next_adv_ms = lcg_next() % CONN_HOST_ADV_INTERVAL_MS;
+                conn_sched_add_address(&sim[i].address, false);
+        }
+        conn_sched_start(0);
+
+        for (uint32_t t = 0; t < timeout_ms; t++) {
+                if ((state == SIM_STATE_ESTABLISHING) && (t == event_ms)) {
+                        state = SIM_STATE_SCANNING;
+                        if (success) {
+                                sim[cur].connected = true;
+                                if (conn_sched_connected((uint16_t)cur, t)) {
+                                        r->all_connected = true;
+                                        r->time_ms = t;
+                                        return;
+                                }
+                        } else {
+                                conn_sched_attempt_failed(t);
+                                sim[cur].backoff_ms = sim[cur].failed ?
+                                        MIN(sim[cur].backoff_ms * 2, CONN_SCHED_BACKOFF_MAX_MS) :
+                                        CONN_SCHED_BACKOFF_MIN_MS;
+                                sim[cur].failed = true;
+                                sim[cur].fail_ms = t;
+                        }
+                }
+
+                for (int i = 0; i < num_of_targets; i++) {
+                        if (sim[i].connected || (sim[i].next_adv_ms != t)) {
+                                continue;
+                        }
+                        sim[i].next_adv_ms = t + CONN_HOST_ADV_INTERVAL_MS +
+                                                        lcg_next() % (CONN_HOST_ADV_DELAY_MS + 1);
+
+                        if (state == SIM_STATE_SCANNING) {
+                                evt.type = 0x00;        /* ADV_IND */
+                                evt.address = sim[i].address;
+                                if (!conn_sched_is_candidate(&evt, false, t)) {
+                                        continue;
+                                }
+                                conn_sched_attempt_started(&evt.address, t);
+                                if (sim[i].failed && (t - sim[i].fail_ms < sim[i].backoff_ms)) {
+                                        r->num_of_early++;
+                                }
+                                r->num_of_attempts++;
+                                state = SIM_STATE_INITIATING;
+                                cur = i;
+                        } else if ((state == SIM_STATE_INITIATING) && (i == cur)) {
+                                success = (lcg_next() % 100) >= fail_pct;
+                                event_ms = t + (success ? 2 + lcg_next() % CONN_HOST_CONN_INTERVAL_MS :
+                                                CONN_HOST_FAIL_INTERVALS * CONN_HOST_CONN_INTERVAL_MS);
+                                state = SIM_STATE_ESTABLISHING;
+                        }
+                }
+        }
+        r->time_ms = timeout_ms;
+}
+
+/************************************** Benchmark *******************************************/
+
+static void bench(void)
+{
+        sim_result_t r;
+
+        printf("Simulated time, %d runs per line, advertising every %d-%d ms, connection interval %d ms\n\n",
+                CONN_HOST_RUNS, CONN_HOST_ADV_INTERVAL_MS, CONN_HOST_ADV_INTERVAL_MS + CONN_HOST_ADV_DELAY_MS,
+                CONN_HOST_CONN_INTERVAL_MS);
+        printf("Targets  Failed attempts  Time to connect all avg/max (ms)  Attempts avg\n");
+
+        for (int f = 0; f < ARRAY_LENGTH(fail_pcts); f++) {
+                for (uint8_t n = 1; n <= CONN_HOST_MAX_TARGETS; n++) {
+                        uint64_t sum_ms = 0, sum_attempts = 0;
+                        uint32_t max_ms = 0, num_of_timeouts = 0;
+
+                        lcg_state = n;
+                        for (int run = 0; run < CONN_HOST_RUNS; run++) {
+                                simulate(n, fail_pcts[f], CONN_HOST_TIMEOUT_MS, &r);
+                                num_of_timeouts += !r.all_connected;
+                                sum_ms += r.time_ms;
+                                sum_attempts += r.num_of_attempts;
+                                max_ms = MAX(max_ms, r.time_ms);
+                        }
+                        printf("%7d  %14d%%  %16" PRIu64 "/%-15" PRIu32 "  %12.1f%s\n", n, fail_pcts[f],
+                                sum_ms / CONN_HOST_RUNS, max_ms, (double)sum_attempts / CONN_HOST_RUNS,
+                                num_of_timeouts ? "  (timeouts)" : "");
+                }
+        }
+}
+
+/**************************************** Check *********************************************/
+
+static void check(void)
+{
+        const uint32_t bound_ms = 2 * (CONN_HOST_ADV_INTERVAL_MS + CONN_HOST_ADV_DELAY_MS) +
+                                                                        CONN_HOST_CONN_INTERVAL_MS + 1;
+        sim_result_t r;
+
+        for (uint8_t n = 1; n <= CONN_HOST_MAX_TARGETS; n++) {
+                lcg_state = n;
+                for (int run = 0; run < CONN_HOST_RUNS; run++) {
+                        simulate(n, 0, CONN_HOST_TIMEOUT_MS, &r);
+                        if (!r.all_connected || (r.num_of_attempts != n) || (r.time_ms > n * bound_ms)) {
+                                printf("Targets: %d, time: %" PRIu32 " ms, attempts: %" PRIu32 "\n", n,
+                                                                        r.time_ms, r.num_of_attempts);
+                                violation("targets not connected at one attempt each");
+                                return;
+                        }
+
+                        simulate(n, 30, CONN_HOST_TIMEOUT_MS, &r);
+                        if (!r.all_connected || r.num_of_early) {
+                                printf("Targets: %d, time: %" PRIu32 " ms, early attempts: %" PRIu32 "\n", n,
+                                                                        r.time_ms, r.num_of_early);
+                                violation("targets not connected with failed attempts");
+                                return;
+                        }
+                }
+        }
+
+        /* Attempts failing forever: retried after 0.5, 1, 2, 4, 8 and 8 s within 30 s */
+        lcg_state = 1;
+        simulate(1, 100, 30000, &r);
+        if (r.all_connected || r.num_of_early || (r.num_of_attempts != 7)) {
+                printf("Attempts: %" PRIu32 ", early: %" PRIu32 "\n", r.num_of_attempts, r.num_of_early);
+                violation("backoff of failed attempts");
+        }
+}
+
+int main(int argc, char *argv[])
+{
+        if ((argc == 2) && !strcmp(argv[1], "bench")) {
+                bench();
+        } else if ((argc == 2) && !strcmp(argv[1], "check")) {
+                check();
+                printf("Check - Violations: %" PRIu32 ", Assertions: %" PRIu32 "\n", num_of_violations,
+                                                                                host_assert_count());
+        } else {
+                printf("Usage: %s bench | check\n", argv[0]);
+                return 2;
+        }
+
+        return (num_of_violations || host_assert_count()) ? 1 : 0;
+}
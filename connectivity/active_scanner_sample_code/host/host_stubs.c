@@ -0,0 +1,197 @@
+/**
+ ****************************************************************************************
+ *
+ * @file host_stubs.c
+ *
+ * @brief Stub OS, BLE and UART layers of the active scanner host harness
+ *
+ * Copyright (C) 2024 Renesas Electronics Corporation and/or its affiliates.
+ * All rights reserved. Confidential Information.
+ *
+ * This software ("Software") is supplied by Renesas Electronics Corporation and/or its
+ * affiliates ("Renesas"). Renesas grants you a personal, non-exclusive, non-transferable,
+ * revocable, non-sub-licensable right and license to use the Software, solely if used in
+ * or together with Renesas products. You may make copies of this Software, provided this
+ * copyright notice and disclaimer ("Notice") is included in all such copies. Renesas
+ * reserves the right to change or discontinue the Software at any time without notice.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS". RENESAS DISCLAIMS ALL WARRANTIES OF ANY KIND,
+ * WHETHER EXPRESS, IMPLIED, OR STATUTORY, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT. TO THE
+ * MAXIMUM EXTENT PERMITTED UNDER LAW, IN NO EVENT SHALL RENESAS BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, SPECIAL, INCIDENTAL OR CONSEQUENTIAL DAMAGES ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE, EVEN IF RENESAS HAS BEEN ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGES. USE OF THIS SOFTWARE MAY BE SUBJECT TO TERMS AND CONDITIONS CONTAINED IN
+ * AN ADDITIONAL AGREEMENT BETWEEN YOU AND RENESAS. IN CASE OF CONFLICT BETWEEN THE TERMS
+ * OF THIS NOTICE AND ANY SUCH ADDITIONAL LICENSE AGREEMENT, THE TERMS OF THE AGREEMENT
+ * SHALL TAKE PRECEDENCE. BY CONTINUING TO USE THIS SOFTWARE, YOU AGREE TO THE TERMS OF
+ * THIS NOTICE.IF YOU DO NOT AGREE TO THESE TERMS, YOU ARE NOT PERMITTED TO USE THIS
+ * SOFTWARE.
+ *
+ ****************************************************************************************
+ */
+
+#include <stdarg.h>
+#include <time.h>
+#include "osal.h"
+#include "misc.h"
+#include "ble_common.h"
+#include "ad_uart.h"
+#include "host_stubs.h"
+
+/* Heap available to the sample code, as configured for the target (configTOTAL_HEAP_SIZE) */
+#define HOST_HEAP_SIZE                  ( 24000 )
+
+/* Cycles are nanoseconds of the host monotonic clock */
+uint32_t SystemCoreClock = 1000000000;
+
+static uint32_t now_ms;
+static size_t heap_in_use, heap_peak;
+static uint32_t asserts;
+static bool verbose;
+
+static DWT_Type dwt;
+CoreDebug_Type host_core_debug;
+
+static bool uart_open;
+static uint32_t uart_bytes;
+
+/*********************************** Harness services ***************************************/
+
+void host_assert_failed(const char *file, int line)
+{
+        asserts++;
+        fprintf(stderr, "Assertion failed: %s:%d\n", file, line);
+}
+
+uint32_t host_assert_count(void)
+{
+        return asserts;
+}
+
+void host_set_verbose(bool enable)
+{
+        verbose = enable;
+}
+
+void host_printf(const char *format, ...)
+{
+        va_list ap;
+
+        if (!verbose) {
+                return;
+        }
+
+        va_start(ap, format);
+        vprintf(format, ap);
+        va_end(ap);
+}
+
+size_t host_heap_in_use(void)
+{
+        return heap_in_use;
+}
+
+size_t host_heap_peak(void)
+{
+        return heap_peak;
+}
+
+uint32_t host_uart_bytes(void)
+{
+        return uart_bytes;
+}
+
+/************************************* OS layer *********************************************/
+
+void *host_malloc(size_t size)
+{
+        size_t *block;
+
+        /* Heap block headers are not accounted for */
+        if (heap_in_use + size > HOST_HEAP_SIZE) {
+                return NULL;
+        }
+
+        block = malloc(sizeof(size_t) + size);
+        if (block == NULL) {
+                return NULL;
+        }
+
+        *block = size;
+        heap_in_use += size;
+        heap_peak = MAX(heap_peak, heap_in_use);
+        return block + 1;
+}
+
+void host_free(void *ptr)
+{
+        if (ptr) {
+                size_t *block = (size_t *)ptr - 1;
+
+                heap_in_use -= *block;
+                free(block);
+        }
+}
+
+size_t host_free_heap(void)
+{
+        return HOST_HEAP_SIZE - heap_in_use;
+}
+
+OS_TICK_TIME host_get_tick_count(void)
+{
+        return now_ms;
+}
+
+void host_delay_ms(uint32_t ms)
+{
+        now_ms += ms;
+}
+
+DWT_Type *host_dwt(void)
+{
+        struct timespec ts;
+
+        clock_gettime(CLOCK_MONOTONIC, &ts);
+        dwt.CYCCNT = (uint32_t)((uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec);
+        return &dwt;
+}
+
+/*************************************** BLE ************************************************/
+
+const char *ble_address_to_string(const bd_address_t *address)
+{
+        static char str[18];
+
+        snprintf(str, sizeof(str), "%02X:%02X:%02X:%02X:%02X:%02X", address->addr[5], address->addr[4],
+                        address->addr[3], address->addr[2], address->addr[1], address->addr[0]);
+        return str;
+}
+
+/*************************************** UART ***********************************************/
+
+ad_uart_handle_t ad_uart_open(const ad_uart_controller_conf_t *ad_uart_ctrl_conf)
+{
+        if (uart_open) {
+                return NULL;
+        }
+
+        uart_open = true;
+        return &uart_open;
+}
+
+int ad_uart_close(ad_uart_handle_t handle, bool force)
+{
+        uart_open = false;
+        return AD_UART_ERROR_NONE;
+}
+
+int ad_uart_write_async(ad_uart_handle_t handle, const char *wbuf, size_t wlen, ad_uart_user_cb cb,
+                                                                                void *user_data)
+{
+        /* Transfers complete immediately */
+        uart_bytes += wlen;
+        cb(user_data, (uint16_t)wlen);
+        return AD_UART_ERROR_NONE;
+}
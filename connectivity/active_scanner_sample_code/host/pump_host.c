@@ -0,0 +1,296 @@
+/**
+ ****************************************************************************************
+ *
+ * @file pump_host.c
+ *
+ * @brief Host benchmark of the BLE event processing in batches
+ *
+ * Copyright (C) 2024 Renesas Electronics Corporation and/or its affiliates.
+ * All rights reserved. Confidential Information.
+ *
+ * This software ("Software") is supplied by Renesas Electronics Corporation and/or its
+ * affiliates ("Renesas"). Renesas grants you a personal, non-exclusive, non-transferable,
+ * revocable, non-sub-licensable right and license to use the Software, solely if used in
+ * or together with Renesas products. You may make copies of this Software, provided this
+ * copyright notice and disclaimer ("Notice") is included in all such copies. Renesas
+ * reserves the right to change or discontinue the Software at any time without notice.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS". RENESAS DISCLAIMS ALL WARRANTIES OF ANY KIND,
+ * WHETHER EXPRESS, IMPLIED, OR STATUTORY, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT. TO THE
+ * MAXIMUM EXTENT PERMITTED UNDER LAW, IN NO EVENT SHALL RENESAS BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, SPECIAL, INCIDENTAL OR CONSEQUENTIAL DAMAGES ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE, EVEN IF RENESAS HAS BEEN ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGES. USE OF THIS SOFTWARE MAY BE SUBJECT TO TERMS AND CONDITIONS CONTAINED IN
+ * AN ADDITIONAL AGREEMENT BETWEEN YOU AND RENESAS. IN CASE OF CONFLICT BETWEEN THE TERMS
+ * OF THIS NOTICE AND ANY SUCH ADDITIONAL LICENSE AGREEMENT, THE TERMS OF THE AGREEMENT
+ * SHALL TAKE PRECEDENCE. BY CONTINUING TO USE THIS SOFTWARE, YOU AGREE TO THE TERMS OF
+ * THIS NOTICE.IF YOU DO NOT AGREE TO THESE TERMS, YOU ARE NOT PERMITTED TO USE THIS
+ * SOFTWARE.
+ *
+ ****************************************************************************************
+ */
+
+/*
+ * Compares the BLE event processing in batches (ble_evt_pump()) with the processing of one event
+ * per wakeup (BLE_EVT_PUMP_BATCH 1); the Makefile builds one binary of each. The BLE manager
+ * queues bursts of advertising reports and notifies the task for each one; as it has a higher
+ * priority than the application tasks on the target, a whole burst is queued before the task
+ * runs. The task then runs the loop of the scanner task until it has no notification pending,
+ * and processes the reports as handle_evt_gap_adv_report() does (advertising filter and report
+ * pipeline, in replay mode so that the text output is not displayed).
+ *
+ * The figures are host time: the events per second are the throughput of the event processing
+ * (including the queuing of the events), and the CPU load is the one needed to process
+ * HOST_PUMP_RATE reports per second. The wakeups only depend on the input and are the same on
+ * the target, where a wakeup costs a task notification round trip.
+ *
+ * The exit status is not zero if an event is lost or leaked, or if there are fewer wakeups than
+ * events / BLE_EVT_PUMP_BATCH.
+ */
+
+#include <inttypes.h>
+#include <pthread.h>
+#include <time.h>
+#include "osal.h"
+#include "ble_gap.h"
+#include "adv_filter.h"
+#include "report_pipeline.h"
+#include "ble_evt_pump.h"
+#include "host_stubs.h"
+
+/* Event code of the advertising reports (BLE_EVT_GAP_ADV_REPORT) */
+#define HOST_EVT_GAP_ADV_REPORT         ( 0x0109 )
+
+/* Reports per burst, as received during a scan window with many advertisers */
+#define HOST_PUMP_BURST                 ( 32 )
+
+/* Bursts measured */
+#define HOST_PUMP_BURSTS                ( 20000 )
+
+/* Advertisers sending the reports */
+#define HOST_PUMP_ADVERTISERS           ( 100 )
+
+/* Report rate (reports per second) at which the CPU load is given */
+#define HOST_PUMP_RATE                  ( 1000 )
+
+/* Filter rules of the scanner benchmarks: heart rate sensors, or Apple devices with a strong signal */
+static const char *const filter_rule_1[] = { "uuid16=180D", "name=Sensor1" };
+static const char *const filter_rule_2[] = { "mfr=004C:0215", "rssi=-60" };
+
+/* Event queue of the BLE manager; the event comes first, as it is freed by the pump */
+typedef struct host_evt {
+        ble_evt_gap_adv_report_t evt;
+        struct host_evt *next;
+} host_evt_t;
+
+/* The scanner task; notifications are taken under a lock, as by the OS on the target */
+static pthread_mutex_t task_lock = PTHREAD_MUTEX_INITIALIZER;
+static uint32_t task_bits;
+static int task;
+
+static host_evt_t *queue_head, *queue_tail;
+static uint32_t num_of_queued, num_of_processed, num_of_wakeups, num_of_notifications;
+
+/************************************* BLE manager ******************************************/
+
+void host_task_notify(OS_TASK handle, uint32_t value)
+{
+        pthread_mutex_lock(&task_lock);
+        task_bits |= value;
+        num_of_notifications++;
+        pthread_mutex_unlock(&task_lock);
+}
+
+ble_evt_hdr_t *ble_get_event(bool wait)
+{
+        host_evt_t *e = queue_head;
+
+        if (e) {
+                queue_head = e->next;
+                if (!queue_head) {
+                        queue_tail = NULL;
+                }
+        }
+
+        return e ? &e->evt.hdr : NULL;
+}
+
+bool ble_has_event(void)
+{
+        return queue_head != NULL;
+}
+
+/* Advertising report of an advertiser: flags, heart rate service and name "Sensor<n>" */
+static void build_report(ble_evt_gap_adv_report_t *evt, uint32_t n)
+{
+        uint16_t advertiser = n % HOST_PUMP_ADVERTISERS;
+        int len;
+
+        memset(evt, 0, sizeof(*evt));
+        evt->hdr.evt_code = HOST_EVT_GAP_ADV_REPORT;
+        evt->hdr.length = sizeof(*evt);
+        evt->address.addr_type = PUBLIC_ADDRESS;
+        evt->address.addr[0] = (uint8_t)advertiser;
+        evt->address.addr[5] = 0x80;
+        evt->rssi = -40 - (int8_t)(advertiser % 50);
+
+        evt->data[0] = 2;
+        evt->data[1] = GAP_DATA_TYPE_FLAGS;
+        evt->data[2] = 0x06;
+        evt->data[3] = 3;
+        evt->data[4] = GAP_DATA_TYPE_UUID16_LIST;
+        evt->data[5] = 0x0D;
+        evt->data[6] = 0x18;
+        len = sprintf((char *)&evt->data[9], "Sensor%u", advertiser);
+        evt->data[7] = (uint8_t)(len + 1);
+        evt->data[8] = GAP_DATA_TYPE_LOCAL_NAME;
+        evt->length = (uint8_t)(9 + len);
+}
+
+static bool queue_burst(uint32_t burst)
+{
+        for (int i = 0; i < HOST_PUMP_BURST; i++) {
+                host_evt_t *e = OS_MALLOC(sizeof(host_evt_t));
+
+                if (!e) {
+                        return false;
+                }
+
+                build_report(&e->evt, burst * HOST_PUMP_BURST + i);
+                e->next = NULL;
+                if (queue_tail) {
+                        queue_tail->next = e;
+                } else {
+                        queue_head = e;
+                }
+                queue_tail = e;
+                num_of_queued++;
+
+                OS_TASK_NOTIFY(&task, BLE_APP_NOTIFY_MASK, OS_NOTIFY_SET_BITS);
+        }
+
+        return true;
+}
+
+/*************************************** Task ***********************************************/
+
+static void handle_ble_evt(ble_evt_hdr_t *hdr, void *user_data)
+{
+        const ble_evt_gap_adv_report_t *evt = (const ble_evt_gap_adv_report_t *)hdr;
+
+        num_of_processed++;
+
+        if (adv_filter_match(evt)) {
+                report_pipeline_process(evt, OS_TICKS_2_MS(OS_GET_TICK_COUNT()));
+        }
+}
+
+/* Loop of the scanner task, until it has no notification pending */
+static void task_run(void)
+{
+        for (;;) {
+                uint32_t notif;
+
+                pthread_mutex_lock(&task_lock);
+                notif = task_bits;
+                task_bits = 0;
+                pthread_mutex_unlock(&task_lock);
+
+                if (!notif) {
+                        break;
+                }
+
+                if (notif & BLE_APP_NOTIFY_MASK) {
+                        num_of_wakeups++;
+                        ble_evt_pump(&task, handle_ble_evt, NULL);
+                }
+        }
+}
+
+/************************************** Benchmark *******************************************/
+
+static uint64_t clock_ns(clockid_t clock)
+{
+        struct timespec ts;
+
+        clock_gettime(clock, &ts);
+        return (uint64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+
+static bool run(const char *name, uint32_t num_of_bursts)
+{
+        uint64_t start, ns, load;
+        uint32_t events, wakeups;
+        bool ok = true;
+
+        num_of_queued = 0;
+        num_of_processed = 0;
+        num_of_wakeups = 0;
+        num_of_notifications = 0;
+
+        start = clock_ns(CLOCK_PROCESS_CPUTIME_ID);
+
+        for (uint32_t burst = 0; burst < num_of_bursts; burst++) {
+                host_delay_ms(HOST_PUMP_BURST * 1000 / HOST_PUMP_RATE);
+                if (!queue_burst(burst)) {
+                        printf("Violation: heap exhausted, events are not processed\n");
+                        ok = false;
+                        break;
+                }
+                task_run();
+        }
+
+        ns = clock_ns(CLOCK_PROCESS_CPUTIME_ID) - start;
+        /* Not zero, so that the figures can be printed when the events are not processed */
+        events = MAX(num_of_processed, 1);
+        wakeups = MAX(num_of_wakeups, 1);
+        load = ns * HOST_PUMP_RATE / events;
+
+        printf("  %-7s events: %6" PRIu32 ", wakeups: %6" PRIu32 " (%" PRIu32 ".%02" PRIu32 " events each)"
+               ", notifications: %6" PRIu32 ", events/s: %7" PRIu64 ", ns/event: %4" PRIu64
+               ", CPU load at %d events/s: %" PRIu64 ".%03" PRIu64 " %%\n",
+               name, events, wakeups, events / wakeups, events * 100 / wakeups % 100,
+               num_of_notifications, (uint64_t)events * 1000000000 / ns, ns / events,
+               HOST_PUMP_RATE, load / 10000000, load / 10000 % 1000);
+
+        if (ok && ((num_of_processed != num_of_queued) || (num_of_processed != num_of_bursts * HOST_PUMP_BURST))) {
+                printf("Violation: %" PRIu32 " events queued, %" PRIu32 " processed\n", num_of_queued,
+                                                                                num_of_processed);
+                ok = false;
+        }
+
+        if (wakeups < events / BLE_EVT_PUMP_BATCH) {
+                printf("Violation: more than %d events per wakeup\n", BLE_EVT_PUMP_BATCH);
+                ok = false;
+        }
+
+        return ok;
+}
+
+int main(void)
+{
+        size_t heap;
+        bool ok;
+
+        printf("BLE_EVT_PUMP_BATCH %d, bursts of %d reports of %d advertisers; host time\n",
+                                        BLE_EVT_PUMP_BATCH, HOST_PUMP_BURST, HOST_PUMP_ADVERTISERS);
+
+        adv_filter_add_rule(ARRAY_LENGTH(filter_rule_1), (const char **)filter_rule_1);
+        adv_filter_add_rule(ARRAY_LENGTH(filter_rule_2), (const char **)filter_rule_2);
+        report_pipeline_set_replay(true);
+
+        /* The device table of the report pipeline is populated before measuring */
+        ok = run("warm-up", 10);
+        heap = host_heap_in_use();
+        ok = run("run", HOST_PUMP_BURSTS) && ok;
+
+        if (host_heap_in_use() != heap) {
+                printf("Violation: %zu bytes of heap in use, %zu before\n", host_heap_in_use(), heap);
+                ok = false;
+        }
+
+        report_pipeline_set_replay(false);
+
+        return (ok && !host_assert_count()) ? 0 : 1;
+}
@@ -0,0 +1,311 @@
+/**
+ ****************************************************************************************
+ *
+ * @file scanner_host.c
+ *
+ * @brief Host test and benchmark harness of the active scanner report processing
+ *
+ * Copyright (C) 2024 Renesas Electronics Corporation and/or its affiliates.
+ * All rights reserved. Confidential Information.
+ *
+ * This software ("Software") is supplied by Renesas Electronics Corporation and/or its
+ * affiliates ("Renesas"). Renesas grants you a personal, non-exclusive, non-transferable,
+ * revocable, non-sub-licensable right and license to use the Software, solely if used in
+ * or together with Renesas products. You may make copies of this Software, provided this
+ * copyright notice and disclaimer ("Notice") is included in all such copies. Renesas
+ * reserves the right to change or discontinue the Software at any time without notice.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS". RENESAS DISCLAIMS ALL WARRANTIES OF ANY KIND,
+ * WHETHER EXPRESS, IMPLIED, OR STATUTORY, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT. TO THE
+ * MAXIMUM EXTENT PERMITTED UNDER LAW, IN NO EVENT SHALL RENESAS BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, SPECIAL, INCIDENTAL OR CONSEQUENTIAL DAMAGES ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE, EVEN IF RENESAS HAS BEEN ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGES. USE OF THIS SOFTWARE MAY BE SUBJECT TO TERMS AND CONDITIONS CONTAINED IN
+ * AN ADDITIONAL AGREEMENT BETWEEN YOU AND RENESAS. IN CASE OF CONFLICT BETWEEN THE TERMS
+ * OF THIS NOTICE AND ANY SUCH ADDITIONAL LICENSE AGREEMENT, THE TERMS OF THE AGREEMENT
+ * SHALL TAKE PRECEDENCE. BY CONTINUING TO USE THIS SOFTWARE, YOU AGREE TO THE TERMS OF
+ * THIS NOTICE.IF YOU DO NOT AGREE TO THESE TERMS, YOU ARE NOT PERMITTED TO USE THIS
+ * SOFTWARE.
+ *
+ ****************************************************************************************
+ */
+
+/*
+ * The advertising filter, the device cache, the beacon tracking and the report pipeline are built
+ * against the stub OS, BLE and UART layers of this directory. The DWT cycle counter reads the host
+ * monotonic clock, so the cycle figures are nanoseconds of host time; all the other figures only
+ * depend on the input and are the same on every run and on the target.
+ *
+ * bench:   throughput of the filter, the cache (evictions with more advertisers than entries) and
+ *          the whole report processing replayed at a given rate, in text and beacon modes.
+ * check:   the counts of the cache and the filter benchmarks against their expected values, the
+ *          eviction order, the replay isolation (the scanning session is restored, nothing is
+ *          streamed, no heap is leaked) and determinism, and the beacon event sequence.
+ * beacons: the beacon replay alone; used with BEACON_FAR_CM raised to check that it can fail.
+ */
+
+#include <inttypes.h>
+#include "osal.h"
+#include "adv_cache.h"
+#include "adv_filter.h"
+#include "beacon.h"
+#include "scan_stream.h"
+#include "report_pipeline.h"
+#include "report_replay.h"
+#include "host_stubs.h"
+
+/* Rounds of the cache benchmark; advertisers report every 1, 2, 4 or 8 rounds */
+#define HOST_CACHE_ROUNDS               ( 64 )
+
+/* Reports evaluated by the filter benchmark */
+#define HOST_FILTER_REPORTS             ( 10000 )
+
+/* Synthetic replay: advertisers, reports and report rate (reports per second) */
+#define HOST_REPLAY_ADVERTISERS         ( 100 )
+#define HOST_REPLAY_REPORTS             ( 10000 )
+#define HOST_REPLAY_RATE                ( 1000 )
+
+/* Counts expected from the cache benchmark (ADV_CACHE_SIZE 128) */
+typedef struct {
+        uint16_t num_of_advertisers;
+        uint32_t num_of_reports;
+        uint32_t num_of_evictions;
+} cache_expected_t;
+
+static const cache_expected_t cache_expected[] = {
+        { 50,  1536,  0     },
+        { 100, 3000,  179   },
+        { 200, 6000,  4710  },
+        { 400, 12000, 11904 },
+};
+
+/* Filter rules of the benchmarks: heart rate sensors, or Apple devices with a strong signal */
+static const char *const filter_rule_1[] = { "uuid16=180D", "name=Sensor1" };
+static const char *const filter_rule_2[] = { "mfr=004C:0215", "rssi=-60" };
+
+/*
+ * Matches expected from the filter benchmark with the rules above: names ending in 1 (1 in 10) or
+ * RSSI of -60 dBm or more (31 in 70), counted once if both
+ */
+#define HOST_FILTER_MATCHES             ( 5004 )
+
+static uint32_t num_of_violations;
+
+static void violation(const char *what)
+{
+        num_of_violations++;
+        printf("Violation: %s\n", what);
+}
+
+static void filter_add_rules(void)
+{
+        adv_filter_clear();
+        adv_filter_add_rule(ARRAY_LENGTH(filter_rule_1), (const char **)filter_rule_1);
+        adv_filter_add_rule(ARRAY_LENGTH(filter_rule_2), (const char **)filter_rule_2);
+}
+
+static void print_replay(const char *mode, const report_replay_result_t *r)
+{
+        printf("  %-7s reports: %" PRIu32 ", passed filter: %" PRIu32 ", output: %" PRIu32
+               ", cycles avg/max: %" PRIu32 "/%" PRIu32 ", max. rate: %" PRIu32 " reports/s, late: %" PRIu32
+               ", heap: %+" PRId32 " bytes\n", mode, r->num_of_reports, r->num_of_matches, r->num_of_output,
+               r->cycles_avg, r->cycles_max, r->max_rate, r->num_of_late, r->heap_delta);
+}
+
+/************************************** Benchmark *******************************************/
+
+static void bench(void)
+{
+        uint32_t cycles, matches, reports, changes, evictions;
+        report_replay_result_t result;
+
+        printf("Cycles are nanoseconds of host time\n\nAdvertising filter (%d reports)\n",
+                                                                        HOST_FILTER_REPORTS);
+        adv_filter_clear();
+        adv_filter_benchmark(HOST_FILTER_REPORTS, &cycles, &matches);
+        printf("  No rules  cycles/report: %" PRIu32 ", matches: %" PRIu32 "\n", cycles, matches);
+        filter_add_rules();
+        adv_filter_benchmark(HOST_FILTER_REPORTS, &cycles, &matches);
+        printf("  2 rules   cycles/report: %" PRIu32 ", matches: %" PRIu32 "\n", cycles, matches);
+        adv_filter_clear();
+
+        printf("\nDevice cache (%d entries, %d rounds)\n", ADV_CACHE_SIZE, HOST_CACHE_ROUNDS);
+        for (int i = 0; i < ARRAY_LENGTH(cache_expected); i++) {
+                adv_cache_benchmark(cache_expected[i].num_of_advertisers, HOST_CACHE_ROUNDS, &reports,
+                                                                &cycles, &changes, &evictions);
+                printf("  Advertisers: %3d, reports: %5" PRIu32 ", cycles/report: %4" PRIu32
+                       ", new or changed: %5" PRIu32 ", evicted: %5" PRIu32 "\n",
+                       cache_expected[i].num_of_advertisers, reports, cycles, changes, evictions);
+        }
+
+        printf("\nReport replay (%d advertisers, %d reports at %d reports/s)\n", HOST_REPLAY_ADVERTISERS,
+                                                        HOST_REPLAY_REPORTS, HOST_REPLAY_RATE);
+        for (int beacon_mode = 0; beacon_mode < 2; beacon_mode++) {
+                report_pipeline_set_beacon_mode(beacon_mode);
+                report_replay_synthetic(HOST_REPLAY_ADVERTISERS, HOST_REPLAY_REPORTS, HOST_REPLAY_RATE,
+                                                                                        &result);
+                print_replay(beacon_mode ? "Beacon" : "Text", &result);
+        }
+        report_pipeline_set_beacon_mode(false);
+
+        printf("\nHeap peak: %zu bytes\n", host_heap_peak());
+}
+
+/**************************************** Checks ********************************************/
+
+/* Counts of the cache and filter benchmarks, and the eviction of the least recently seen device */
+static void check_cache_filter(void)
+{
+        uint32_t cycles, matches, reports, changes, evictions;
+        ble_evt_gap_adv_report_t evt;
+
+        for (int i = 0; i < ARRAY_LENGTH(cache_expected); i++) {
+                adv_cache_benchmark(cache_expected[i].num_of_advertisers, HOST_CACHE_ROUNDS, &reports,
+                                                                &cycles, &changes, &evictions);
+                if ((reports != cache_expected[i].num_of_reports) ||
+                                                (evictions != cache_expected[i].num_of_evictions)) {
+                        printf("Advertisers: %d, reports: %" PRIu32 ", evicted: %" PRIu32 "\n",
+                                        cache_expected[i].num_of_advertisers, reports, evictions);
+                        violation("cache benchmark counts");
+                }
+        }
+
+        /* Fill the cache, report the first device again, then add a device: the second one goes */
+        memset(&evt, 0, sizeof(evt));
+        adv_cache_clear();
+        for (int i = 0; i < (ADV_CACHE_SIZE * 3) / 4; i++) {
+                evt.address.addr[0] = (uint8_t)i;
+                adv_cache_update(&evt, i, NULL);
+        }
+        evt.address.addr[0] = 0;
+        adv_cache_update(&evt, 1000, NULL);
+        evt.address.addr[0] = 0xFF;
+        adv_cache_update(&evt, 1001, NULL);
+        evt.address.addr[0] = 0;
+        if (adv_cache_update(&evt, 1002, NULL) != ADV_CACHE_STATUS_SEEN) {
+                violation("device reported recently evicted");
+        }
+        evt.address.addr[0] = 1;
+        if (adv_cache_update(&evt, 1003, NULL) != ADV_CACHE_STATUS_NEW) {
+                violation("least recently seen device not evicted");
+        }
+        adv_cache_clear();
+
+        adv_filter_clear();
+        adv_filter_benchmark(HOST_FILTER_REPORTS, &cycles, &matches);
+        if (matches != HOST_FILTER_REPORTS) {
+                violation("report rejected with no filter rules");
+        }
+        filter_add_rules();
+        adv_filter_benchmark(HOST_FILTER_REPORTS, &cycles, &matches);
+        if (matches != HOST_FILTER_MATCHES) {
+                printf("Matches: %" PRIu32 "\n", matches);
+                violation("filter benchmark matches");
+        }
+        adv_filter_clear();
+}
+
+/* Replays leave the scanning session as found, stream nothing and give the same counts each time */
+static void check_replay(void)
+{
+        report_replay_result_t first, second;
+        ble_evt_gap_adv_report_t evt;
+        uint32_t reports[2], output[2], evictions[2], beacon_reports[2], events[2], overflows[2];
+        uint16_t devices[2];
+        size_t heap = host_heap_in_use();
+
+        /* A scanning session, streaming, with a device and a beacon found */
+        memset(&evt, 0, sizeof(evt));
+        report_pipeline_clear();
+        scan_stream_start(NULL, 0);
+        evt.address.addr[0] = 0x42;
+        report_pipeline_process(&evt, 0);
+        report_pipeline_set_beacon_mode(true);
+        report_replay_synthetic(4, 8, HOST_REPLAY_RATE, &first);
+
+        for (int run = 0; run < 2; run++) {
+                uint32_t uart_bytes = host_uart_bytes();
+
+                report_pipeline_set_beacon_mode(run);
+                adv_cache_get_stats(&devices[0], &evictions[0]);
+                report_pipeline_get_stats(&reports[0], &output[0]);
+                beacon_get_stats(&beacon_reports[0], &events[0], &overflows[0]);
+
+                if (!report_replay_synthetic(HOST_REPLAY_ADVERTISERS, HOST_REPLAY_REPORTS, HOST_REPLAY_RATE,
+                                                                                        &first) ||
+                                !report_replay_synthetic(HOST_REPLAY_ADVERTISERS, HOST_REPLAY_REPORTS,
+                                                                        HOST_REPLAY_RATE, &second)) {
+                        violation("replay state not saved");
+                        continue;
+                }
+
+                adv_cache_get_stats(&devices[1], &evictions[1]);
+                report_pipeline_get_stats(&reports[1], &output[1]);
+                beacon_get_stats(&beacon_reports[1], &events[1], &overflows[1]);
+
+                if ((first.num_of_reports != HOST_REPLAY_REPORTS) || (first.num_of_output == 0) ||
+                                (first.num_of_matches != second.num_of_matches) ||
+                                (first.num_of_output != second.num_of_output)) {
+                        violation("replay counts differ between runs");
+                }
+                if ((devices[0] != devices[1]) || (evictions[0] != evictions[1]) ||
+                                (reports[0] != reports[1]) || (output[0] != output[1]) ||
+                                (beacon_reports[0] != beacon_reports[1]) || (events[0] != events[1])) {
+                        violation("scanning session not restored after a replay");
+                }
+                if (host_uart_bytes() != uart_bytes) {
+                        violation("replayed reports streamed");
+                }
+                if (first.heap_delta || second.heap_delta) {
+                        violation("heap leaked by a replay");
+                }
+        }
+
+        report_pipeline_set_beacon_mode(false);
+        scan_stream_stop();
+        report_pipeline_clear();
+
+        if (host_heap_in_use() != heap) {
+                violation("heap leaked");
+        }
+}
+
+static bool check_beacons(void)
+{
+        uint32_t num_of_events;
+        bool match = report_replay_beacons(&num_of_events);
+
+        printf("Beacon events: %" PRIu32 ", expected sequence: %s\n", num_of_events, match ? "yes" : "no");
+        return match;
+}
+
+static void check(void)
+{
+        check_cache_filter();
+        check_replay();
+
+        if (!check_beacons()) {
+                violation("beacon event sequence");
+        }
+}
+
+int main(int argc, char *argv[])
+{
+        if ((argc == 2) && !strcmp(argv[1], "bench")) {
+                bench();
+        } else if ((argc == 2) && !strcmp(argv[1], "check")) {
+                check();
+                printf("Check - Violations: %" PRIu32 ", Assertions: %" PRIu32 "\n", num_of_violations,
+                                                                                host_assert_count());
+        } else if ((argc == 2) && !strcmp(argv[1], "beacons")) {
+                if (!check_beacons()) {
+                        num_of_violations++;
+                }
+        } else {
+                printf("Usage: %s bench | check | beacons\n", argv[0]);
+                return 2;
+        }
+
+        return (num_of_violations || host_assert_count()) ? 1 : 0;
+}
@@ -0,0 +1,105 @@
+/**
+ ****************************************************************************************
+ *
+ * @file ad_uart.h
+ *
+ * @brief UART adapter of the active scanner host build
+ *
+ * Copyright (C) 2024 Renesas Electronics Corporation and/or its affiliates.
+ * All rights reserved. Confidential Information.
+ *
+ * This software ("Software") is supplied by Renesas Electronics Corporation and/or its
+ * affiliates ("Renesas"). Renesas grants you a personal, non-exclusive, non-transferable,
+ * revocable, non-sub-licensable right and license to use the Software, solely if used in
+ * or together with Renesas products. You may make copies of this Software, provided this
+ * copyright notice and disclaimer ("Notice") is included in all such copies. Renesas
+ * reserves the right to change or discontinue the Software at any time without notice.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS". RENESAS DISCLAIMS ALL WARRANTIES OF ANY KIND,
+ * WHETHER EXPRESS, IMPLIED, OR STATUTORY, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT. TO THE
+ * MAXIMUM EXTENT PERMITTED UNDER LAW, IN NO EVENT SHALL RENESAS BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, SPECIAL, INCIDENTAL OR CONSEQUENTIAL DAMAGES ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE, EVEN IF RENESAS HAS BEEN ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGES. USE OF THIS SOFTWARE MAY BE SUBJECT TO TERMS AND CONDITIONS CONTAINED IN
+ * AN ADDITIONAL AGREEMENT BETWEEN YOU AND RENESAS. IN CASE OF CONFLICT BETWEEN THE TERMS
+ * OF THIS NOTICE AND ANY SUCH ADDITIONAL LICENSE AGREEMENT, THE TERMS OF THE AGREEMENT
+ * SHALL TAKE PRECEDENCE. BY CONTINUING TO USE THIS SOFTWARE, YOU AGREE TO THE TERMS OF
+ * THIS NOTICE.IF YOU DO NOT AGREE TO THESE TERMS, YOU ARE NOT PERMITTED TO USE THIS
+ * SOFTWARE.
+ *
+ ****************************************************************************************
+ */
+
+#ifndef AD_UART_H_
+#define AD_UART_H_
+
+#include "hw_gpio.h"
+
+/* The stream UART records the bytes written; transfers complete immediately */
+#define HW_UART_DMA_SUPPORT             ( 0 )
+
+typedef enum {
+        HW_UART1,
+        HW_UART2,
+} HW_UART_ID;
+
+typedef enum {
+        HW_UART_BAUDRATE_115200 = 115200,
+        HW_UART_BAUDRATE_1000000 = 1000000,
+} HW_UART_BAUDRATE;
+
+#define HW_UART_DATABITS_8              ( 3 )
+#define HW_UART_PARITY_NONE             ( 0 )
+#define HW_UART_STOPBITS_1              ( 0 )
+
+typedef struct {
+        HW_UART_BAUDRATE baud_rate;
+        uint8_t data;
+        uint8_t parity;
+        uint8_t stop;
+        uint8_t auto_flow_control;
+        uint8_t use_fifo;
+        uint8_t tx_fifo_tr_lvl;
+        uint8_t rx_fifo_tr_lvl;
+} uart_config_ex;
+
+typedef struct {
+        uart_config_ex hw_conf;
+} ad_uart_driver_conf_t;
+
+typedef struct {
+        HW_GPIO_MODE mode;
+        HW_GPIO_FUNC function;
+        bool high;
+} ad_io_conf_t;
+
+typedef struct {
+        HW_GPIO_PORT port;
+        HW_GPIO_PIN pin;
+        ad_io_conf_t on;
+        ad_io_conf_t off;
+} ad_pin_conf_t;
+
+typedef struct {
+        ad_pin_conf_t rx;
+        ad_pin_conf_t tx;
+} ad_uart_io_conf_t;
+
+typedef struct {
+        HW_UART_ID id;
+        const ad_uart_io_conf_t *io;
+        const ad_uart_driver_conf_t *drv;
+} ad_uart_controller_conf_t;
+
+typedef void *ad_uart_handle_t;
+typedef void (*ad_uart_user_cb)(void *user_data, uint16_t transferred);
+
+#define AD_UART_ERROR_NONE              ( 0 )
+
+ad_uart_handle_t ad_uart_open(const ad_uart_controller_conf_t *ad_uart_ctrl_conf);
+int ad_uart_close(ad_uart_handle_t handle, bool force);
+int ad_uart_write_async(ad_uart_handle_t handle, const char *wbuf, size_t wlen, ad_uart_user_cb cb,
+                                                                                void *user_data);
+
+#endif /* AD_UART_H_ */
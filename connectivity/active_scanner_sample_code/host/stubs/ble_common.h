@@ -0,0 +1,68 @@
+/**
+ ****************************************************************************************
+ *
+ * @file ble_common.h
+ *
+ * @brief Common BLE API definitions of the active scanner host build
+ *
+ * Copyright (C) 2024 Renesas Electronics Corporation and/or its affiliates.
+ * All rights reserved. Confidential Information.
+ *
+ * This software ("Software") is supplied by Renesas Electronics Corporation and/or its
+ * affiliates ("Renesas"). Renesas grants you a personal, non-exclusive, non-transferable,
+ * revocable, non-sub-licensable right and license to use the Software, solely if used in
+ * or together with Renesas products. You may make copies of this Software, provided this
+ * copyright notice and disclaimer ("Notice") is included in all such copies. Renesas
+ * reserves the right to change or discontinue the Software at any time without notice.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS". RENESAS DISCLAIMS ALL WARRANTIES OF ANY KIND,
+ * WHETHER EXPRESS, IMPLIED, OR STATUTORY, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT. TO THE
+ * MAXIMUM EXTENT PERMITTED UNDER LAW, IN NO EVENT SHALL RENESAS BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, SPECIAL, INCIDENTAL OR CONSEQUENTIAL DAMAGES ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE, EVEN IF RENESAS HAS BEEN ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGES. USE OF THIS SOFTWARE MAY BE SUBJECT TO TERMS AND CONDITIONS CONTAINED IN
+ * AN ADDITIONAL AGREEMENT BETWEEN YOU AND RENESAS. IN CASE OF CONFLICT BETWEEN THE TERMS
+ * OF THIS NOTICE AND ANY SUCH ADDITIONAL LICENSE AGREEMENT, THE TERMS OF THE AGREEMENT
+ * SHALL TAKE PRECEDENCE. BY CONTINUING TO USE THIS SOFTWARE, YOU AGREE TO THE TERMS OF
+ * THIS NOTICE.IF YOU DO NOT AGREE TO THESE TERMS, YOU ARE NOT PERMITTED TO USE THIS
+ * SOFTWARE.
+ *
+ ****************************************************************************************
+ */
+
+#ifndef BLE_COMMON_H_
+#define BLE_COMMON_H_
+
+#include "sdk_defs.h"
+
+typedef struct {
+        uint16_t evt_code;
+        uint16_t length;
+} ble_evt_hdr_t;
+
+/* Notification of the task registered to the BLE manager when events are queued */
+#define BLE_APP_NOTIFY_MASK             ( 1 << 0 )
+
+/* Event queue of the BLE manager, provided by the event pump benchmark (pump_host.c) */
+ble_evt_hdr_t *ble_get_event(bool wait);
+bool ble_has_event(void);
+
+#define BD_ADDR_LEN                     ( 6 )
+
+#define BLE_CONN_IDX_INVALID            ( 0xFFFF )
+
+typedef enum {
+        PUBLIC_ADDRESS = 0x00,
+        PRIVATE_ADDRESS = 0x01,
+} addr_type_t;
+
+typedef struct {
+        addr_type_t addr_type;
+        uint8_t addr[BD_ADDR_LEN];
+} bd_address_t;
+
+/* Address formatted as XX:XX:XX:XX:XX:XX (MSB first), in a static buffer */
+const char *ble_address_to_string(const bd_address_t *address);
+
+#endif /* BLE_COMMON_H_ */
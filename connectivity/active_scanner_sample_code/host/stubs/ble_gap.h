@@ -0,0 +1,72 @@
+/**
+ ****************************************************************************************
+ *
+ * @file ble_gap.h
+ *
+ * @brief GAP API definitions of the active scanner host build
+ *
+ * Copyright (C) 2024 Renesas Electronics Corporation and/or its affiliates.
+ * All rights reserved. Confidential Information.
+ *
+ * This software ("Software") is supplied by Renesas Electronics Corporation and/or its
+ * affiliates ("Renesas"). Renesas grants you a personal, non-exclusive, non-transferable,
+ * revocable, non-sub-licensable right and license to use the Software, solely if used in
+ * or together with Renesas products. You may make copies of this Software, provided this
+ * copyright notice and disclaimer ("Notice") is included in all such copies. Renesas
+ * reserves the right to change or discontinue the Software at any time without notice.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS". RENESAS DISCLAIMS ALL WARRANTIES OF ANY KIND,
+ * WHETHER EXPRESS, IMPLIED, OR STATUTORY, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT. TO THE
+ * MAXIMUM EXTENT PERMITTED UNDER LAW, IN NO EVENT SHALL RENESAS BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, SPECIAL, INCIDENTAL OR CONSEQUENTIAL DAMAGES ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE, EVEN IF RENESAS HAS BEEN ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGES. USE OF THIS SOFTWARE MAY BE SUBJECT TO TERMS AND CONDITIONS CONTAINED IN
+ * AN ADDITIONAL AGREEMENT BETWEEN YOU AND RENESAS. IN CASE OF CONFLICT BETWEEN THE TERMS
+ * OF THIS NOTICE AND ANY SUCH ADDITIONAL LICENSE AGREEMENT, THE TERMS OF THE AGREEMENT
+ * SHALL TAKE PRECEDENCE. BY CONTINUING TO USE THIS SOFTWARE, YOU AGREE TO THE TERMS OF
+ * THIS NOTICE.IF YOU DO NOT AGREE TO THESE TERMS, YOU ARE NOT PERMITTED TO USE THIS
+ * SOFTWARE.
+ *
+ ****************************************************************************************
+ */
+
+#ifndef BLE_GAP_H_
+#define BLE_GAP_H_
+
+#include "ble_common.h"
+
+#define BLE_ADV_DATA_LEN_MAX            ( 31 )
+
+/* Max. number of connections, not less than CONN_SCHED_MAX_TARGETS so that 8 targets can be added */
+#define BLE_GAP_MAX_CONNECTED           ( 8 )
+
+#define BLE_SCAN_INTERVAL_FROM_MS(_ms)  ((uint16_t)((_ms) * 1000 / 625))
+#define BLE_SCAN_WINDOW_FROM_MS(_ms)    ((uint16_t)((_ms) * 1000 / 625))
+
+typedef enum {
+        GAP_SCAN_ACTIVE,
+        GAP_SCAN_PASSIVE,
+} gap_scan_type_t;
+
+typedef enum {
+        GAP_DATA_TYPE_FLAGS             = 0x01,
+        GAP_DATA_TYPE_UUID16_LIST_INC   = 0x02,
+        GAP_DATA_TYPE_UUID16_LIST       = 0x03,
+        GAP_DATA_TYPE_UUID128_LIST_INC  = 0x06,
+        GAP_DATA_TYPE_UUID128_LIST      = 0x07,
+        GAP_DATA_TYPE_SHORT_LOCAL_NAME  = 0x08,
+        GAP_DATA_TYPE_LOCAL_NAME        = 0x09,
+        GAP_DATA_TYPE_MANUFACTURER_SPEC = 0xFF,
+} gap_data_type_t;
+
+typedef struct {
+        ble_evt_hdr_t hdr;
+        uint8_t       type;
+        bd_address_t  address;
+        int8_t        rssi;
+        uint8_t       length;
+        uint8_t       data[BLE_ADV_DATA_LEN_MAX];
+} ble_evt_gap_adv_report_t;
+
+#endif /* BLE_GAP_H_ */
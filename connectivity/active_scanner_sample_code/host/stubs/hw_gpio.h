@@ -0,0 +1,62 @@
+/**
+ ****************************************************************************************
+ *
+ * @file hw_gpio.h
+ *
+ * @brief GPIO definitions of the active scanner host build
+ *
+ * Copyright (C) 2024 Renesas Electronics Corporation and/or its affiliates.
+ * All rights reserved. Confidential Information.
+ *
+ * This software ("Software") is supplied by Renesas Electronics Corporation and/or its
+ * affiliates ("Renesas"). Renesas grants you a personal, non-exclusive, non-transferable,
+ * revocable, non-sub-licensable right and license to use the Software, solely if used in
+ * or together with Renesas products. You may make copies of this Software, provided this
+ * copyright notice and disclaimer ("Notice") is included in all such copies. Renesas
+ * reserves the right to change or discontinue the Software at any time without notice.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS". RENESAS DISCLAIMS ALL WARRANTIES OF ANY KIND,
+ * WHETHER EXPRESS, IMPLIED, OR STATUTORY, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT. TO THE
+ * MAXIMUM EXTENT PERMITTED UNDER LAW, IN NO EVENT SHALL RENESAS BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, SPECIAL, INCIDENTAL OR CONSEQUENTIAL DAMAGES ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE, EVEN IF RENESAS HAS BEEN ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGES. USE OF THIS SOFTWARE MAY BE SUBJECT TO TERMS AND CONDITIONS CONTAINED IN
+ * AN ADDITIONAL AGREEMENT BETWEEN YOU AND RENESAS. IN CASE OF CONFLICT BETWEEN THE TERMS
+ * OF THIS NOTICE AND ANY SUCH ADDITIONAL LICENSE AGREEMENT, THE TERMS OF THE AGREEMENT
+ * SHALL TAKE PRECEDENCE. BY CONTINUING TO USE THIS SOFTWARE, YOU AGREE TO THE TERMS OF
+ * THIS NOTICE.IF YOU DO NOT AGREE TO THESE TERMS, YOU ARE NOT PERMITTED TO USE THIS
+ * SOFTWARE.
+ *
+ ****************************************************************************************
+ */
+
+#ifndef HW_GPIO_H_
+#define HW_GPIO_H_
+
+#include "sdk_defs.h"
+
+typedef enum {
+        HW_GPIO_PORT_0,
+        HW_GPIO_PORT_1,
+} HW_GPIO_PORT;
+
+typedef enum {
+        HW_GPIO_PIN_0,
+        HW_GPIO_PIN_1,
+        HW_GPIO_PIN_2,
+        HW_GPIO_PIN_3,
+} HW_GPIO_PIN;
+
+typedef enum {
+        HW_GPIO_MODE_INPUT,
+        HW_GPIO_MODE_OUTPUT,
+} HW_GPIO_MODE;
+
+typedef enum {
+        HW_GPIO_FUNC_GPIO,
+        HW_GPIO_FUNC_UART_RX,
+        HW_GPIO_FUNC_UART_TX,
+} HW_GPIO_FUNC;
+
+#endif /* HW_GPIO_H_ */
@@ -0,0 +1,68 @@
+/**
+ ****************************************************************************************
+ *
+ * @file osal.h
+ *
+ * @brief OS abstraction layer of the active scanner host build
+ *
+ * Copyright (C) 2024 Renesas Electronics Corporation and/or its affiliates.
+ * All rights reserved. Confidential Information.
+ *
+ * This software ("Software") is supplied by Renesas Electronics Corporation and/or its
+ * affiliates ("Renesas"). Renesas grants you a personal, non-exclusive, non-transferable,
+ * revocable, non-sub-licensable right and license to use the Software, solely if used in
+ * or together with Renesas products. You may make copies of this Software, provided this
+ * copyright notice and disclaimer ("Notice") is included in all such copies. Renesas
+ * reserves the right to change or discontinue the Software at any time without notice.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS". RENESAS DISCLAIMS ALL WARRANTIES OF ANY KIND,
+ * WHETHER EXPRESS, IMPLIED, OR STATUTORY, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT. TO THE
+ * MAXIMUM EXTENT PERMITTED UNDER LAW, IN NO EVENT SHALL RENESAS BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, SPECIAL, INCIDENTAL OR CONSEQUENTIAL DAMAGES ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE, EVEN IF RENESAS HAS BEEN ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGES. USE OF THIS SOFTWARE MAY BE SUBJECT TO TERMS AND CONDITIONS CONTAINED IN
+ * AN ADDITIONAL AGREEMENT BETWEEN YOU AND RENESAS. IN CASE OF CONFLICT BETWEEN THE TERMS
+ * OF THIS NOTICE AND ANY SUCH ADDITIONAL LICENSE AGREEMENT, THE TERMS OF THE AGREEMENT
+ * SHALL TAKE PRECEDENCE. BY CONTINUING TO USE THIS SOFTWARE, YOU AGREE TO THE TERMS OF
+ * THIS NOTICE.IF YOU DO NOT AGREE TO THESE TERMS, YOU ARE NOT PERMITTED TO USE THIS
+ * SOFTWARE.
+ *
+ ****************************************************************************************
+ */
+
+#ifndef OSAL_H_
+#define OSAL_H_
+
+#include "sdk_defs.h"
+
+typedef void *OS_TASK;
+typedef uint32_t OS_TICK_TIME;
+
+/* Heap accounted by the harness */
+void *host_malloc(size_t size);
+void host_free(void *ptr);
+size_t host_free_heap(void);
+
+#define OS_MALLOC(_size)                host_malloc(_size)
+#define OS_FREE(_ptr)                   host_free(_ptr)
+#define OS_ASSERT(_cond)                ASSERT_WARNING(_cond)
+#define OS_GET_FREE_HEAP_SIZE()         host_free_heap()
+
+/* Virtual time, advanced by delays; one tick per millisecond */
+OS_TICK_TIME host_get_tick_count(void);
+void host_delay_ms(uint32_t ms);
+
+#define OS_GET_TICK_COUNT()             host_get_tick_count()
+#define OS_MS_2_TICKS(_ms)              ((OS_TICK_TIME)(_ms))
+#define OS_TICKS_2_MS(_ticks)           ((uint32_t)(_ticks))
+#define OS_DELAY_MS(_ms)                host_delay_ms(_ms)
+
+/* Only the event pump benchmark has a task to notify (pump_host.c); bits are always set */
+void host_task_notify(OS_TASK task, uint32_t value);
+
+#define OS_NOTIFY_SET_BITS              ( 0 )
+#define OS_TASK_NOTIFY(_task, _value, _action) host_task_notify(_task, _value)
+#define OS_TASK_NOTIFY_FROM_ISR(_task, _value, _action) do { } while (0)
+
+#endif /* OSAL_H_ */
@@ -0,0 +1,185 @@
+#!/usr/bin/env python3
+#########################################################################################
+# Copyright (C) 2024 Renesas Electronics Corporation and/or its affiliates.
+# All rights reserved. Confidential Information.
+#
+# This software ("Software") is supplied by Renesas Electronics Corporation and/or its
+# affiliates ("Renesas"). Renesas grants you a personal, non-exclusive, non-transferable,
+# revocable, non-sub-licensable right and license to use the Software, solely if used in
+# or together with Renesas products. You may make copies of this Software, provided this
+# copyright notice and disclaimer ("Notice") is included in all such copies. Renesas
+# reserves the right to change or discontinue the Software at any time without notice.
+#
+# THE SOFTWARE IS PROVIDED "AS IS". RENESAS DISCLAIMS ALL WARRANTIES OF ANY KIND,
+# WHETHER EXPRESS, IMPLIED, OR STATUTORY, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+# OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT. TO THE
+# MAXIMUM EXTENT PERMITTED UNDER LAW, IN NO EVENT SHALL RENESAS BE LIABLE FOR ANY DIRECT,
+# INDIRECT, SPECIAL, INCIDENTAL OR CONSEQUENTIAL DAMAGES ARISING FROM, OUT OF OR IN
+# CONNECTION WITH THE SOFTWARE, EVEN IF RENESAS HAS BEEN ADVISED OF THE POSSIBILITY OF
+# SUCH DAMAGES. USE OF THIS SOFTWARE MAY BE SUBJECT TO TERMS AND CONDITIONS CONTAINED IN
+# AN ADDITIONAL AGREEMENT BETWEEN YOU AND RENESAS. IN CASE OF CONFLICT BETWEEN THE TERMS
+# OF THIS NOTICE AND ANY SUCH ADDITIONAL LICENSE AGREEMENT, THE TERMS OF THE AGREEMENT
+# SHALL TAKE PRECEDENCE. BY CONTINUING TO USE THIS SOFTWARE, YOU AGREE TO THE TERMS OF
+# THIS NOTICE.IF YOU DO NOT AGREE TO THESE TERMS, YOU ARE NOT PERMITTED TO USE THIS
+# SOFTWARE.
+
+"""
+Decode the binary stream of advertising reports of the active scanner and print the reports
+as CSV or JSON (one object per line). The stream is read from a serial port (requires pyserial)
+or a file captured from the stream UART ('-' for the standard input). The C format generates
+replay_trace.h, the trace replayed by the report_replay command (see report_replay.h).
+"""
+
+import sys
+import argparse
+import csv
+import json
+import struct
+import time
+
+SYNC = b'\xA5\x5A'
+RECORD_ADV_REPORT = 0x01
+RECORD_HDR = struct.Struct('<BIBB6sb')
+FIELDS = ['timestamp_ms', 'adv_type', 'addr_type', 'address', 'rssi', 'data']
+
+
+def crc16(data):
+    """ CRC-16/CCITT-FALSE """
+    crc = 0xFFFF
+    for byte in data:
+        crc ^= byte << 8
+        for _ in range(8):
+            crc = ((crc << 1) ^ 0x1021) if crc & 0x8000 else (crc << 1)
+            crc &= 0xFFFF
+    return crc
+
+
+class Decoder:
+    def __init__(self):
+        self.buf = bytearray()
+        self.frames = 0
+        self.crc_errors = 0
+        self.skipped = 0
+
+    def feed(self, data):
+        """ Add stream data and return the reports decoded """
+        reports = []
+        self.buf += data
+
+        while True:
+            idx = self.buf.find(SYNC)
+            if idx < 0:
+                # Keep a possible first half of the sync word
+                keep = 1 if self.buf[-1:] == SYNC[:1] else 0
+                self.skipped += len(self.buf) - keep
+                del self.buf[:len(self.buf) - keep]
+                break
+
+            self.skipped += idx
+            del self.buf[:idx]
+
+            if len(self.buf) < 3:
+                break
+            length = self.buf[2]
+            if len(self.buf) < 3 + length + 2:
+                break
+
+            record = bytes(self.buf[3:3 + length])
+            crc, = struct.unpack_from('<H', self.buf, 3 + length)
+            if crc != crc16(self.buf[2:3 + length]) or length < RECORD_HDR.size:
+                # Not a frame; resynchronize after the sync word
+                self.crc_errors += 1
+                self.skipped += len(SYNC)
+                del self.buf[:len(SYNC)]
+                continue
+
+            del self.buf[:3 + length + 2]
+            self.frames += 1
+
+            rec_type, timestamp, adv_type, addr_type, addr, rssi = RECORD_HDR.unpack_from(record)
+            if rec_type != RECORD_ADV_REPORT:
+                continue
+
+            reports.append({
+                'timestamp_ms': timestamp,
+                'adv_type': adv_type,
+                'addr_type': addr_type,
+                'address': ':'.join('%02X' % b for b in reversed(addr)),
+                'rssi': rssi,
+                'data': record[RECORD_HDR.size:].hex().upper(),
+            })
+
+        return reports
+
+
+def c_record(report):
+    """ report_replay_record_t initializer of a report """
+    addr = reversed(bytes.fromhex(report['address'].replace(':', '')))
+    data = bytes.fromhex(report['data'])
+    return '        { %d, 0x%02X, 0x%02X, { %s }, %d, %d, { %s } },' % (
+        report['timestamp_ms'], report['adv_type'], report['addr_type'],
+        ', '.join('0x%02X' % b for b in addr), report['rssi'], len(data),
+        ', '.join('0x%02X' % b for b in data) or '0')
+
+
+def open_input(args):
+    if args.port:
+        import serial
+        port = serial.Serial(args.port, args.baudrate, timeout=0.1)
+        return lambda: port.read(4096)
+    if args.input == '-':
+        return lambda: sys.stdin.buffer.read1(4096)
+    stream = open(args.input, 'rb')
+    return lambda: stream.read(4096)
+
+
+if __name__ == '__main__':
+    parser = argparse.ArgumentParser()
+    source = parser.add_mutually_exclusive_group(required=True)
+    source.add_argument('--port', type=str, help='Serial port of the stream UART, e.g. /dev/ttyUSB1')
+    source.add_argument('--input', type=str, help='Captured stream file (\'-\' for stdin)')
+    parser.add_argument('--baudrate', type=int, default=1000000, help='Baud rate of the stream UART')
+    parser.add_argument('--format', choices=['csv', 'json', 'c'], default='csv',
+                        help='Output format (c: replay_trace.h of the report replay)')
+    args = parser.parse_args()
+
+    read = open_input(args)
+    decoder = Decoder()
+    writer = None
+    if args.format == 'csv':
+        writer = csv.DictWriter(sys.stdout, fieldnames=FIELDS)
+        writer.writeheader()
+    elif args.format == 'c':
+        print('/* Recorded advertising reports, generated by scan_stream_decode.py */')
+        print('static const report_replay_record_t replay_trace[] = {')
+
+    num_of_reports = 0
+    start = time.monotonic()
+    try:
+        while True:
+            data = read()
+            if not data:
+                if args.port:
+                    continue
+                break
+            for report in decoder.feed(data):
+                num_of_reports += 1
+                if writer:
+                    writer.writerow(report)
+                elif args.format == 'c':
+                    print(c_record(report))
+                else:
+                    print(json.dumps(report))
+            sys.stdout.flush()
+    except KeyboardInterrupt:
+        pass
+
+    if args.format == 'c':
+        print('};')
+
+    elapsed = time.monotonic() - start
+    sys.stderr.write('Reports: %d, Frames: %d, CRC errors: %d, Bytes skipped: %d' %
+                     (num_of_reports, decoder.frames, decoder.crc_errors, decoder.skipped))
+    if args.port and elapsed > 0:
+        sys.stderr.write(', Reports per second: %.1f' % (num_of_reports / elapsed))
+    sys.stderr.write('\n')
@@ -31,6 +31,8 @@
  ****************************************************************************************
  */
 
+#include <stdlib.h>
+#include <string.h>
 #include "osal.h"
 #include "sys_watchdog.h"
 #include "ble_att.h"
@@ -48,26 +50,17 @@
 #include "cli.h"
 #include "console.h"
 #include "cli_app.h"
-
-#define APP_BLE_GAP_CALL_FUNC_UNTIL_NO_ERR(_func, args...) \
-        {                                                  \
-                ble_error_t ret;                           \
-                uint32_t loop = 0;                         \
-                                                           \
-                while (true) {                             \
-                        ret = (_func)(args);               \
-                                                           \
-                        if (ret == BLE_STATUS_OK) {        \
-                               break;                      \
-                        }                                  \
-                        OS_DELAY_MS(5);                    \
-                        loop++;                            \
-                                                           \
-                        DBG_LOG("%s failed with status = %d (%lu)", #_func, ret, loop); \
-                }                                          \
-        }
-
-#define CONN_TIMEOUT_MS        ( 15000 )
+#include "adv_cache.h"
+#include "adv_filter.h"
+#include "scan_stream.h"
+#include "scan_sched.h"
+#include "conn_sched.h"
+#include "report_pipeline.h"
+#include "report_replay.h"
+#include "ble_evt_pump.h"
+
+/* Delay, expressed in ms, before retrying to start scanning if the BLE manager is busy */
+#define SCAN_RETRY_MS          ( 5 )
 
 /**
  * Task notifications and handles
@@ -77,14 +70,27 @@
 #define BLE_CONN_TIMEOUT_NOTIF          (1 << 3)
 #define BLE_CTS_N_INACTIVE_NOTIF        (1 << 4)
 #define BLE_CTS_N_ACTIVE_NOTIF          (1 << 5)
-
-#define BLE_SCAN_INTERVAL               (BLE_SCAN_INTERVAL_FROM_MS(30))
-#define BLE_SCAN_WINDOW                 (BLE_SCAN_WINDOW_FROM_MS(15))
+#define BLE_SCAN_STREAM_NOTIF           (1 << 6)
+#define BLE_SCAN_EPOCH_NOTIF            (1 << 7)
+
+/* Scanning state */
+typedef enum {
+        SCAN_STATE_IDLE,
+        SCAN_STATE_STARTING,            /* Scanning could not be started; a retry is pending */
+        SCAN_STATE_SCANNING,
+        SCAN_STATE_RESTARTING,          /* Scanning is being stopped to apply new scan parameters */
+        SCAN_STATE_STOPPING,            /* Scanning is being stopped as the session is over */
+        SCAN_STATE_CONNECTING,          /* Scanning is stopped to connect to a target */
+} scan_state_t;
 
 __RETAINED static OS_TASK active_scanner_handle;
 __RETAINED static bd_address_t peer_addr;
 __RETAINED static OS_TIMER conn_timeout_h;
-__RETAINED_RW static bool is_scan_allowed = true;
+__RETAINED static OS_TIMER scan_epoch_h;
+__RETAINED static scan_state_t scan_state;
+
+/* Start time of the current scanning session */
+__RETAINED static OS_TICK_TIME scan_start_time;
 
 __RETAINED_RW static gap_conn_params_t cp = {
         .interval_min  = defaultBLE_PPCP_INTERVAL_MIN,   // in unit of 1.25ms
@@ -157,26 +163,70 @@ static void device_get_random_address(void)
 
 static void handle_evt_gap_adv_report(ble_evt_gap_adv_report_t *evt)
 {
-        int tlv_idx = 0;
-        int data_idx = 0;
+        bool filter_match = adv_filter_match(evt);
+
+        /* Scanning is stopped to connect to a pending target */
+        if ((scan_state == SCAN_STATE_SCANNING) &&
+                        conn_sched_is_candidate(evt, filter_match, OS_TICKS_2_MS(OS_GET_TICK_COUNT()))) {
+                peer_addr = evt->address;
+                scan_state = SCAN_STATE_CONNECTING;
+                ble_gap_scan_stop();
+        }
 
-        DBG_LOG("\n\r****** BD address = %s *******\n\r", ble_address_to_string(&evt->address));
+        /* Reports not matching any of the filter rules are discarded */
+        if (!filter_match) {
+                return;
+        }
 
-        /* Process TLVs */
-        while (tlv_idx + 2 < evt->length) {
-                /*
-                 * The 1st byte should reflect the number of bytes that follow for the specific data type.
-                 * The 2nd byte should reflect the data type (should be interpreted using the gap_data_type_t enumerator).
-                 */
-                DBG_LOG("\n\r[%d]. Length = %d, Type = %d, Data = ", data_idx, evt->data[tlv_idx], evt->data[tlv_idx + 1]);
+        report_pipeline_process(evt, OS_TICKS_2_MS(OS_GET_TICK_COUNT()));
+}
 
-                for (int i = 0; i < evt->data[tlv_idx]; i++) {
-                        DBG_LOG("0x%02X ", evt->data[tlv_idx + 2 + i]);
-                }
-                DBG_LOG("\n\r");
+static void scan_session_completed(void)
+{
+        report_pipeline_print_stats(OS_TICKS_2_MS(OS_GET_TICK_COUNT() - scan_start_time));
+        scan_sched_print_stats();
+        conn_sched_print();
+
+        scan_state = SCAN_STATE_IDLE;
+}
+
+static void scan_params_start(void)
+{
+        scan_sched_params_t params;
+        ble_error_t ret;
+
+        scan_sched_get_params(&params);
+
+        ret = ble_gap_scan_start(params.type, GAP_SCAN_GEN_DISC_MODE, params.interval, params.window,
+                                                                                        false, false);
+        if (ret != BLE_STATUS_OK) {
+                /* Retry later, without blocking the task */
+                DBG_LOG("ble_gap_scan_start failed with status = %d\n\r", ret);
+
+                scan_state = SCAN_STATE_STARTING;
+                OS_TIMER_CHANGE_PERIOD(scan_epoch_h, OS_MS_2_TICKS(SCAN_RETRY_MS), OS_TIMER_FOREVER);
+                return;
+        }
+
+        DBG_LOG("Scanning: %s, interval = %d ms, window = %d ms\n\r",
+                params.type == GAP_SCAN_ACTIVE ? "active" : "passive",
+                params.interval * 5 / 8, params.window * 5 / 8);
+
+        scan_state = SCAN_STATE_SCANNING;
+        OS_TIMER_CHANGE_PERIOD(scan_epoch_h, OS_MS_2_TICKS(SCAN_SCHED_EPOCH_MS), OS_TIMER_FOREVER);
+}
+
+/* Resume scanning after a connection attempt, unless all of the targets are connected */
+static void conn_attempt_completed(void)
+{
+        if (scan_state != SCAN_STATE_CONNECTING) {
+                return;
+        }
 
-                data_idx++;
-                tlv_idx += (evt->data[tlv_idx] + 1); // go to the next TLV
+        if (conn_sched_is_active()) {
+                scan_params_start();
+        } else {
+                scan_session_completed();
         }
 }
 
@@ -186,34 +236,83 @@ static void handle_evt_gap_connection_completed(ble_evt_gap_connection_completed
 
         /*
          * Should reach here if a connection request is aborted by the user
-         * explicitly by calling ble_gap_connect_cancel().
+         * explicitly by calling ble_gap_connect_cancel(), e.g. on attempt timeout.
          */
-        if (evt->status == BLE_ERROR_CANCELED) {
+        if (evt->status != BLE_STATUS_OK) {
+                conn_sched_attempt_failed(OS_TICKS_2_MS(OS_GET_TICK_COUNT()));
+        }
+
+        conn_attempt_completed();
+}
+
+static void scan_epoch_expired(void)
+{
+        scan_sched_action_t action;
+        uint32_t now_ms;
+
+        if (scan_state == SCAN_STATE_STARTING) {
+                scan_params_start();
+                return;
+        }
+
+        if (scan_state != SCAN_STATE_SCANNING) {
+                return;
+        }
+
+        now_ms = OS_TICKS_2_MS(OS_GET_TICK_COUNT());
+
+        report_pipeline_tick(now_ms);
 
+        action = scan_sched_epoch(now_ms);
+        if ((action == SCAN_SCHED_DONE) && conn_sched_is_active()) {
+                /* Keep scanning until all of the targets are connected */
+                scan_sched_start(now_ms);
+                action = SCAN_SCHED_RESTART;
         }
+
+        if (action == SCAN_SCHED_CONTINUE) {
+                OS_TIMER_START(scan_epoch_h, OS_TIMER_FOREVER);
+                return;
+        }
+
+        /* Scanning is restarted, or the session is completed, once stopping is completed */
+        scan_state = (action == SCAN_SCHED_RESTART) ? SCAN_STATE_RESTARTING : SCAN_STATE_STOPPING;
+        ble_gap_scan_stop();
 }
 
 static void handle_evt_gap_scan_completed(ble_evt_gap_scan_completed_t *evt)
 {
         DBG_LOG("%s, status = %d\n\r", __func__, evt->status);
 
-        /* Process only if scanner was canceled by user. */
-        if (evt->status == BLE_ERROR_CANCELED) {
-                ble_error_t ret = ble_gap_connect_ce((const bd_address_t *)&peer_addr, &cp,
-                                                                defaultBLE_CONN_EVENT_LENGTH_MIN, 0);
+        /* Scanning was stopped by the scan scheduler */
+        if (scan_state == SCAN_STATE_RESTARTING) {
+                scan_params_start();
+                return;
+        } else if (scan_state == SCAN_STATE_STOPPING) {
+                scan_session_completed();
+                return;
+        }
+
+        /* Scanning was stopped to connect to a target */
+        if (scan_state == SCAN_STATE_CONNECTING) {
+                ble_error_t ret;
 
-                if (ret == BLE_ERROR_BUSY) {
-                        DBG_LOG("%s failed with status BLE_ERROR_CANCELED.\n\r", __func__);
+                conn_sched_attempt_started(&peer_addr, OS_TICKS_2_MS(OS_GET_TICK_COUNT()));
+
+                ret = ble_gap_connect_ce((const bd_address_t *)&peer_addr, &cp,
+                                                                defaultBLE_CONN_EVENT_LENGTH_MIN, 0);
+                if (ret != BLE_STATUS_OK) {
+                        DBG_LOG("ble_gap_connect_ce failed with status = %d\n\r", ret);
 
                         /*
-                         * ble_gap_connect_ce() will return a BLE_ERROR_BUSY status when another connection
-                         * procedure is already ongoing. To be able to connect to another device, cancel
-                         * the last connection request to retry connecting with the new device.
+                         * No connection procedure has been started (e.g. BLE_ERROR_BUSY if another
+                         * one is ongoing), so no connection completed event will follow. The attempt
+                         * is accounted as failed, so the target is retried after its backoff time,
+                         * and scanning is resumed.
                          */
-                        ble_gap_connect_cancel();
+                        conn_sched_attempt_failed(OS_TICKS_2_MS(OS_GET_TICK_COUNT()));
+                        scan_params_start();
                 } else {
-                        ASSERT_WARNING(ret == BLE_STATUS_OK);
-
                         /*
                          * A connection establishment should now be initiated. Start a timer
                          * which will be in charge of making sure that the connection request
@@ -226,8 +325,11 @@ static void handle_evt_gap_scan_completed(ble_evt_gap_scan_completed_t *evt)
         } else {
                 ASSERT_WARNING(evt->status == BLE_ERROR_TIMEOUT);
 
-                /* Scanning operations should timeout, now. */
-                is_scan_allowed = true;
+                /*
+                 * The general discovery procedure timed out before the end of the session (the
+                 * session is ended by the scan scheduler); keep scanning.
+                 */
+                scan_params_start();
         }
 }
 
@@ -245,6 +347,12 @@ static void handle_evt_gap_connected(ble_evt_gap_connected_t *evt)
 
         /* Connection has been established; stop connection timer. */
         OS_TIMER_STOP(conn_timeout_h, OS_TIMER_FOREVER);
+
+        if (conn_sched_connected(evt->conn_idx, OS_TICKS_2_MS(OS_GET_TICK_COUNT()))) {
+                DBG_LOG("All targets connected\n\r");
+        }
+
+        conn_attempt_completed();
 }
 
 static void handle_evt_gap_conn_param_updated_req(ble_evt_gap_conn_param_update_req_t * evt)
@@ -261,6 +369,8 @@ static void handle_evt_gap_disconnected(ble_evt_gap_disconnected_t *evt)
                                         evt->conn_idx, ble_address_to_string(&evt->address), evt->reason);
 
         conn_idx = BLE_CONN_IDX_INVALID;
+
+        conn_sched_disconnected(evt->conn_idx);
 }
 
 static void handle_evt_gap_security_request(ble_evt_gap_security_request_t *evt)
@@ -279,14 +389,25 @@ static void handle_evt_gap_pair_completed(ble_evt_gap_pair_completed_t *evt)
 
 static void scan_start(void)
 {
-        if (is_scan_allowed) {
-                is_scan_allowed = false;
+        if (scan_state == SCAN_STATE_IDLE) {
+                /* Devices found in a previous scanning session are displayed again */
+                report_pipeline_clear();
 
-                APP_BLE_GAP_CALL_FUNC_UNTIL_NO_ERR(ble_gap_scan_start,
-                        GAP_SCAN_ACTIVE, GAP_SCAN_GEN_DISC_MODE, BLE_SCAN_INTERVAL, BLE_SCAN_WINDOW, false, false);
+                scan_start_time = OS_GET_TICK_COUNT();
+
+                scan_sched_start(OS_TICKS_2_MS(scan_start_time));
+                scan_params_start();
         }
 }
 
+/* Scan epoch timer callback */
+static void scan_epoch_cb(OS_TIMER xTimer)
+{
+        OS_TASK task = (OS_TASK) OS_TIMER_GET_TIMER_ID(xTimer);
+
+        OS_TASK_NOTIFY(task, BLE_SCAN_EPOCH_NOTIF, OS_NOTIFY_SET_BITS);
+}
+
 /* Connection timer callback */
 static void conn_timeout_cb(OS_TIMER xTimer)
 {
@@ -304,8 +425,309 @@ static void cli_active_scanner_start_handler(int argc, const char *argv[], void
         OS_TASK_NOTIFY(active_scanner_handle, BLE_SCAN_START_NOTIF, OS_NOTIFY_SET_BITS);
 }
 
+static void cli_active_scanner_devices_handler(int argc, const char *argv[], void *user_data)
+{
+        report_pipeline_print_devices();
+}
+
+#if ADV_CACHE_BENCHMARK_EN
+static void cli_adv_cache_bench_handler(int argc, const char *argv[], void *user_data)
+{
+        uint32_t num_of_reports, cycles_per_report, num_of_changes, num_of_evictions;
+        int num_of_advertisers, num_of_rounds = 10;
+
+        if ((argc < 2) || (argc > 3)) {
+                DBG_LOG("Usage: adv_cache_bench <advertisers> [rounds]\n\r");
+                return;
+        }
+
+        num_of_advertisers = atoi(argv[1]);
+        if (argc == 3) {
+                num_of_rounds = atoi(argv[2]);
+        }
+
+        if ((num_of_advertisers <= 0) || (num_of_advertisers > UINT16_MAX) ||
+                                                (num_of_rounds <= 0) || (num_of_rounds > UINT16_MAX)) {
+                DBG_LOG("Invalid arguments\n\r");
+                return;
+        }
+
+        adv_cache_benchmark(num_of_advertisers, num_of_rounds, &num_of_reports, &cycles_per_report,
+                                                                &num_of_changes, &num_of_evictions);
+
+        DBG_LOG("Advertisers: %d, Reports: %lu, Cycles per report: %lu, New or changed: %lu, Evicted: %lu\n\r",
+                num_of_advertisers, num_of_reports, cycles_per_report, num_of_changes, num_of_evictions);
+}
+#endif
+
+static void cli_adv_filter_add_handler(int argc, const char *argv[], void *user_data)
+{
+        adv_filter_status_t status;
+
+        if (argc < 2) {
+                DBG_LOG("Usage: adv_filter_add <term> [<term> ...]\n\r");
+                return;
+        }
+
+        status = adv_filter_add_rule(argc - 1, &argv[1]);
+        if (status == ADV_FILTER_STATUS_INVALID_TERM) {
+                DBG_LOG("Invalid term. Supported terms: uuid16=<XXXX>, uuid128=<UUID>, "
+                        "mfr=<XXXX>[:<hex bytes>], name=<text>, rssi=<dBm>, addr=<XX:..:XX>[/<XX:..:XX>]\n\r");
+        } else if (status == ADV_FILTER_STATUS_NO_RESOURCES) {
+                DBG_LOG("No resources for the rule. Consider increasing ADV_FILTER_MAX_RULES, "
+                        "ADV_FILTER_MAX_TERMS or ADV_FILTER_PROGRAM_SIZE\n\r");
+        } else {
+                DBG_LOG("Rule added, %d rule(s) defined\n\r", adv_filter_num_of_rules());
+        }
+}
+
+static void cli_adv_filter_clear_handler(int argc, const char *argv[], void *user_data)
+{
+        adv_filter_clear();
+        DBG_LOG("All rules removed\n\r");
+}
+
+static void cli_adv_filter_show_handler(int argc, const char *argv[], void *user_data)
+{
+        if (adv_filter_num_of_rules() == 0) {
+                DBG_LOG("No rules defined, all reports are displayed\n\r");
+                return;
+        }
+
+        adv_filter_print();
+}
+
+#if ADV_FILTER_BENCHMARK_EN
+static void cli_adv_filter_bench_handler(int argc, const char *argv[], void *user_data)
+{
+        uint32_t cycles_per_report, num_of_matches;
+        int num_of_reports = 10000;
+
+        if (argc > 2) {
+                DBG_LOG("Usage: adv_filter_bench [reports]\n\r");
+                return;
+        }
+
+        if (argc == 2) {
+                num_of_reports = atoi(argv[1]);
+        }
+
+        if (num_of_reports <= 0) {
+                DBG_LOG("Invalid arguments\n\r");
+                return;
+        }
+
+        adv_filter_benchmark(num_of_reports, &cycles_per_report, &num_of_matches);
+
+        DBG_LOG("Rules: %d, Reports: %d, Cycles per report: %lu, Reports per second: %lu, Matches: %lu\n\r",
+                adv_filter_num_of_rules(), num_of_reports, cycles_per_report,
+                cycles_per_report ? (SystemCoreClock / cycles_per_report) : 0, num_of_matches);
+}
+#endif
+
+#if REPORT_REPLAY_EN
+static void cli_report_replay_handler(int argc, const char *argv[], void *user_data)
+{
+        report_replay_result_t result;
+        int num_of_advertisers, num_of_reports, rate = 0;
+
+        if (scan_state != SCAN_STATE_IDLE) {
+                DBG_LOG("Scanning should be stopped first\n\r");
+                return;
+        }
+
+        if ((argc >= 4) && (argc <= 5) && !strcmp(argv[1], "synthetic")) {
+                num_of_advertisers = atoi(argv[2]);
+                num_of_reports = atoi(argv[3]);
+                rate = (argc == 5) ? atoi(argv[4]) : 1000;
+
+                if ((num_of_advertisers <= 0) || (num_of_advertisers > UINT16_MAX) ||
+                                                        (num_of_reports <= 0) || (rate <= 0)) {
+                        DBG_LOG("Invalid arguments\n\r");
+                        return;
+                }
+
+                if (!report_replay_synthetic(num_of_advertisers, num_of_reports, rate, &result)) {
+                        DBG_LOG("Not enough heap\n\r");
+                        return;
+                }
+#if REPORT_REPLAY_TRACE
+        } else if ((argc >= 2) && (argc <= 3) && !strcmp(argv[1], "trace")) {
+                if (argc == 3) {
+                        rate = atoi(argv[2]);
+                }
+
+                if (rate < 0) {
+                        DBG_LOG("Invalid arguments\n\r");
+                        return;
+                }
+
+                if (!report_replay_trace(rate, &result)) {
+                        DBG_LOG("Not enough heap\n\r");
+                        return;
+                }
+#endif
+        } else if ((argc == 2) && !strcmp(argv[1], "beacons")) {
+                uint32_t num_of_events;
+                bool match = report_replay_beacons(&num_of_events);
+
+                DBG_LOG("Beacon events: %lu, Expected sequence: %s\n\r", num_of_events, match ? "yes" : "no");
+                return;
+        } else {
+                DBG_LOG("Usage: report_replay synthetic <advertisers> <reports> [rate]"
+#if REPORT_REPLAY_TRACE
+                        " | trace [rate]"
+#endif
+                        " | beacons\n\r");
+                return;
+        }
+
+        DBG_LOG("Reports: %lu, Passed filter: %lu, Output: %lu\n\r", result.num_of_reports,
+                                                        result.num_of_matches, result.num_of_output);
+        DBG_LOG("Cycles per report avg/max: %lu/%lu, Max. sustainable rate: %lu reports/s\n\r",
+                                        result.cycles_avg, result.cycles_max, result.max_rate);
+        DBG_LOG("Late reports: %lu, Max. delay: %lu us\n\r", result.num_of_late, result.max_delay_us);
+        DBG_LOG("Static memory: %lu bytes, Free heap change: %ld bytes\n\r", result.static_mem,
+                                                                                result.heap_delta);
+}
+#endif
+
+static void cli_scan_stream_handler(int argc, const char *argv[], void *user_data)
+{
+        scan_stream_stats_t stats;
+
+        if ((argc == 2) && !strcmp(argv[1], "on")) {
+                if (scan_stream_start(active_scanner_handle, BLE_SCAN_STREAM_NOTIF)) {
+                        DBG_LOG("Streaming reports over the stream UART\n\r");
+                } else {
+                        DBG_LOG("Stream UART could not be opened\n\r");
+                }
+        } else if ((argc == 2) && !strcmp(argv[1], "off")) {
+                if (scan_stream_is_active()) {
+                        scan_stream_stop();
+                        scan_stream_get_stats(&stats);
+                        DBG_LOG("Streaming stopped. Frames: %lu, Bytes: %lu, Dropped: %lu\n\r",
+                                stats.frames, stats.bytes, stats.dropped);
+                }
+        } else {
+                DBG_LOG("Usage: scan_stream <on|off>\n\r");
+        }
+}
+
+static void cli_beacon_mode_handler(int argc, const char *argv[], void *user_data)
+{
+        if ((argc == 2) && !strcmp(argv[1], "on")) {
+                report_pipeline_set_beacon_mode(true);
+        } else if ((argc == 2) && !strcmp(argv[1], "off")) {
+                report_pipeline_set_beacon_mode(false);
+        } else {
+                DBG_LOG("Usage: beacon_mode <on|off>\n\r");
+                return;
+        }
+
+        DBG_LOG("Beacon mode %s\n\r", report_pipeline_get_beacon_mode() ? "enabled" : "disabled");
+}
+
+static void cli_beacon_list_handler(int argc, const char *argv[], void *user_data)
+{
+        report_pipeline_print_beacons();
+}
+
+/* Parse an address written MSB first, e.g. 80:EA:CA:00:00:01 */
+static bool parse_address(const char *str, uint8_t *addr)
+{
+        for (int i = BD_ADDR_LEN - 1; i >= 0; i--) {
+                char *end;
+                unsigned long byte = strtoul(str, &end, 16);
+
+                if ((end - str != 2) || (*end != (i ? ':' : '\0'))) {
+                        return false;
+                }
+                addr[i] = (uint8_t)byte;
+                str = end + 1;
+        }
+        return true;
+}
+
+static void cli_conn_target_add_handler(int argc, const char *argv[], void *user_data)
+{
+        bd_address_t address;
+
+        if ((argc == 3) && !strcmp(argv[1], "filter")) {
+                int count = atoi(argv[2]);
+
+                if (count <= 0) {
+                        DBG_LOG("Invalid arguments\n\r");
+                        return;
+                }
+                DBG_LOG("%d target(s) added\n\r", conn_sched_add_filter(count));
+                return;
+        }
+
+        if ((argc < 2) || (argc > 3) || !parse_address(argv[1], address.addr)) {
+                DBG_LOG("Usage: conn_target_add <XX:XX:XX:XX:XX:XX> [public|random] | filter <count>\n\r");
+                return;
+        }
+
+        address.addr_type = ((argc == 3) && !strcmp(argv[2], "random")) ? PRIVATE_ADDRESS : PUBLIC_ADDRESS;
+
+        if (!conn_sched_add_address(&address, argc == 2)) {
+                DBG_LOG("Target could not be added\n\r");
+        }
+}
+
+static void cli_conn_targets_handler(int argc, const char *argv[], void *user_data)
+{
+        if ((argc == 2) && !strcmp(argv[1], "clear")) {
+                if ((scan_state == SCAN_STATE_CONNECTING) || conn_sched_is_active()) {
+                        DBG_LOG("Connecting to targets; try again later\n\r");
+                        return;
+                }
+                conn_sched_clear();
+        }
+
+        conn_sched_print();
+}
+
+static void cli_conn_start_handler(int argc, const char *argv[], void *user_data)
+{
+        if ((scan_state != SCAN_STATE_IDLE) && (scan_state != SCAN_STATE_SCANNING)) {
+                DBG_LOG("Scanning is being restarted; try again later\n\r");
+                return;
+        }
+
+        if (!conn_sched_start(OS_TICKS_2_MS(OS_GET_TICK_COUNT()))) {
+                DBG_LOG("No pending targets\n\r");
+                return;
+        }
+
+        /* Targets are connected while scanning */
+        if (scan_state == SCAN_STATE_IDLE) {
+                OS_TASK_NOTIFY(active_scanner_handle, BLE_SCAN_START_NOTIF, OS_NOTIFY_SET_BITS);
+        }
+}
+
 static const cli_command_t cli_cmd_handlers[] = {
         {"active_scanner_start", cli_active_scanner_start_handler, NULL},
+        {"active_scanner_devices", cli_active_scanner_devices_handler, NULL},
+#if ADV_CACHE_BENCHMARK_EN
+        {"adv_cache_bench", cli_adv_cache_bench_handler, NULL},
+#endif
+        {"adv_filter_add", cli_adv_filter_add_handler, NULL},
+        {"adv_filter_clear", cli_adv_filter_clear_handler, NULL},
+        {"adv_filter_show", cli_adv_filter_show_handler, NULL},
+        {"scan_stream", cli_scan_stream_handler, NULL},
+        {"beacon_mode", cli_beacon_mode_handler, NULL},
+        {"beacon_list", cli_beacon_list_handler, NULL},
+        {"conn_target_add", cli_conn_target_add_handler, NULL},
+        {"conn_targets", cli_conn_targets_handler, NULL},
+        {"conn_start", cli_conn_start_handler, NULL},
+#if ADV_FILTER_BENCHMARK_EN
+        {"adv_filter_bench", cli_adv_filter_bench_handler, NULL},
+#endif
+#if REPORT_REPLAY_EN
+        {"report_replay", cli_report_replay_handler, NULL},
+#endif
         {} //! A null entry is required to indicate the ending point
 };
 
@@ -333,6 +755,39 @@ static void app_gpio0_cb(uint32_t status)
 #endif
 }
 
+static void handle_ble_evt(ble_evt_hdr_t *hdr, void *user_data)
+{
+        switch (hdr->evt_code) {
+        case BLE_EVT_GAP_CONNECTED:
+                handle_evt_gap_connected((ble_evt_gap_connected_t *) hdr);
+                break;
+        case BLE_EVT_GAP_ADV_REPORT:
+                handle_evt_gap_adv_report((ble_evt_gap_adv_report_t *) hdr);
+                break;
+        case BLE_EVT_GAP_SCAN_COMPLETED:
+                handle_evt_gap_scan_completed((ble_evt_gap_scan_completed_t *) hdr);
+                break;
+        case BLE_EVT_GAP_CONNECTION_COMPLETED:
+                handle_evt_gap_connection_completed((ble_evt_gap_connection_completed_t *) hdr);
+                break;
+        case BLE_EVT_GAP_CONN_PARAM_UPDATE_REQ:
+                handle_evt_gap_conn_param_updated_req((ble_evt_gap_conn_param_update_req_t *) hdr);
+                break;
+        case BLE_EVT_GAP_DISCONNECTED:
+                handle_evt_gap_disconnected((ble_evt_gap_disconnected_t *) hdr);
+                break;
+        case BLE_EVT_GAP_SECURITY_REQUEST:
+                handle_evt_gap_security_request((ble_evt_gap_security_request_t *) hdr);
+                break;
+        case BLE_EVT_GAP_PAIR_COMPLETED:
+                handle_evt_gap_pair_completed((ble_evt_gap_pair_completed_t *) hdr);
+                break;
+        default:
+                ble_handle_event_default(hdr);
+                break;
+        }
+}
+
 OS_TASK_FUNCTION(active_scanner_task, pvParameters)
 {
         int8_t wdog_id;
@@ -357,10 +812,14 @@ OS_TASK_FUNCTION(active_scanner_task, pvParameters)
         device_set_random_address();
         device_get_random_address();
 
-        conn_timeout_h = OS_TIMER_CREATE("CONN_TIMEOUT", OS_MS_2_TICKS(CONN_TIMEOUT_MS), OS_TIMER_FAIL,
+        conn_timeout_h = OS_TIMER_CREATE("CONN_TIMEOUT", OS_MS_2_TICKS(CONN_SCHED_ATTEMPT_TIMEOUT_MS), OS_TIMER_FAIL,
                                                                         OS_GET_CURRENT_TASK(), conn_timeout_cb);
         ASSERT_WARNING(conn_timeout_h);
 
+        scan_epoch_h = OS_TIMER_CREATE("SCAN_EPOCH", OS_MS_2_TICKS(SCAN_SCHED_EPOCH_MS), OS_TIMER_FAIL,
+                                                                        OS_GET_CURRENT_TASK(), scan_epoch_cb);
+        ASSERT_WARNING(scan_epoch_h);
+
         for (;;) {
                 OS_BASE_TYPE ret;
                 uint32_t notif;
@@ -383,50 +842,7 @@ OS_TASK_FUNCTION(active_scanner_task, pvParameters)
 
                 /* notified from BLE manager, can get event */
                 if (notif & BLE_APP_NOTIFY_MASK) {
-                        ble_evt_hdr_t *hdr;
-
-                        hdr = ble_get_event(false);
-                        if (!hdr) {
-                                goto no_event;
-                        }
-
-                        switch (hdr->evt_code) {
-                        case BLE_EVT_GAP_CONNECTED:
-                                handle_evt_gap_connected((ble_evt_gap_connected_t *) hdr);
-                                break;
-                        case BLE_EVT_GAP_ADV_REPORT:
-                                handle_evt_gap_adv_report((ble_evt_gap_adv_report_t *) hdr);
-                                break;
-                        case BLE_EVT_GAP_SCAN_COMPLETED:
-                                handle_evt_gap_scan_completed((ble_evt_gap_scan_completed_t *) hdr);
-                                break;
-                        case BLE_EVT_GAP_CONNECTION_COMPLETED:
-                                handle_evt_gap_connection_completed((ble_evt_gap_connection_completed_t *) hdr);
-                                break;
-                        case BLE_EVT_GAP_CONN_PARAM_UPDATE_REQ:
-                                handle_evt_gap_conn_param_updated_req((ble_evt_gap_conn_param_update_req_t *) hdr);
-                                break;
-                        case BLE_EVT_GAP_DISCONNECTED:
-                                handle_evt_gap_disconnected((ble_evt_gap_disconnected_t *) hdr);
-                                break;
-                        case BLE_EVT_GAP_SECURITY_REQUEST:
-                                handle_evt_gap_security_request((ble_evt_gap_security_request_t *) hdr);
-                                break;
-                        case BLE_EVT_GAP_PAIR_COMPLETED:
-                                handle_evt_gap_pair_completed((ble_evt_gap_pair_completed_t *) hdr);
-                                break;
-                        default:
-                                ble_handle_event_default(hdr);
-                                break;
-                        }
-
-                        OS_FREE(hdr);
-
-no_event:
-                        /* Notify again if there are more events to process in queue */
-                        if (ble_has_event()) {
-                                OS_TASK_NOTIFY(active_scanner_handle, BLE_APP_NOTIFY_MASK, OS_NOTIFY_SET_BITS);
-                        }
+                        ble_evt_pump(active_scanner_handle, handle_ble_evt, NULL);
                 }
 
                 if (notif & BLE_CTS_N_ACTIVE_NOTIF) {
@@ -435,6 +851,15 @@ no_event:
                         console_wkup_handler();
                 }
 
+                if (notif & BLE_SCAN_EPOCH_NOTIF) {
+                        scan_epoch_expired();
+                }
+
+                if (notif & BLE_SCAN_STREAM_NOTIF) {
+                        /* A DMA transfer has completed; transmit the frames added in the meantime */
+                        scan_stream_flush();
+                }
+
                 if (notif & BLE_CLI_NOTIF) {
                         cli_handle_notified(cli);
                 }
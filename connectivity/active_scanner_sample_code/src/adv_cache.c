@@ -0,0 +1,310 @@
+/**
+ ****************************************************************************************
+ *
+ * @file adv_cache.c
+ *
+ * @brief Advertising report deduplication cache
+ *
+ * Copyright (C) 2024 Renesas Electronics Corporation and/or its affiliates.
+ * All rights reserved. Confidential Information.
+ *
+ * This software ("Software") is supplied by Renesas Electronics Corporation and/or its
+ * affiliates ("Renesas"). Renesas grants you a personal, non-exclusive, non-transferable,
+ * revocable, non-sub-licensable right and license to use the Software, solely if used in
+ * or together with Renesas products. You may make copies of this Software, provided this
+ * copyright notice and disclaimer ("Notice") is included in all such copies. Renesas
+ * reserves the right to change or discontinue the Software at any time without notice.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS". RENESAS DISCLAIMS ALL WARRANTIES OF ANY KIND,
+ * WHETHER EXPRESS, IMPLIED, OR STATUTORY, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT. TO THE
+ * MAXIMUM EXTENT PERMITTED UNDER LAW, IN NO EVENT SHALL RENESAS BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, SPECIAL, INCIDENTAL OR CONSEQUENTIAL DAMAGES ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE, EVEN IF RENESAS HAS BEEN ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGES. USE OF THIS SOFTWARE MAY BE SUBJECT TO TERMS AND CONDITIONS CONTAINED IN
+ * AN ADDITIONAL AGREEMENT BETWEEN YOU AND RENESAS. IN CASE OF CONFLICT BETWEEN THE TERMS
+ * OF THIS NOTICE AND ANY SUCH ADDITIONAL LICENSE AGREEMENT, THE TERMS OF THE AGREEMENT
+ * SHALL TAKE PRECEDENCE. BY CONTINUING TO USE THIS SOFTWARE, YOU AGREE TO THE TERMS OF
+ * THIS NOTICE.IF YOU DO NOT AGREE TO THESE TERMS, YOU ARE NOT PERMITTED TO USE THIS
+ * SOFTWARE.
+ *
+ ****************************************************************************************
+ */
+
+#include <string.h>
+#include "sdk_defs.h"
+#include "adv_cache.h"
+
+#if (ADV_CACHE_SIZE & (ADV_CACHE_SIZE - 1))
+#error "ADV_CACHE_SIZE should be a power of two"
+#endif
+
+/* Max. number of devices tracked; the least recently seen device is evicted beyond that */
+#define ADV_CACHE_MAX_DEVICES           ( (ADV_CACHE_SIZE * 3) / 4 )
+
+/* FNV-1a hash parameters */
+#define FNV_OFFSET_BASIS                ( 2166136261UL )
+#define FNV_PRIME                       ( 16777619UL )
+
+/* State of the cache */
+typedef struct {
+        adv_cache_entry_t entries[ADV_CACHE_SIZE];
+        uint16_t num_of_devices;
+        uint32_t num_of_evictions;
+        uint32_t report_seq;
+} adv_cache_state_t;
+
+__RETAINED static adv_cache_state_t cache;
+
+static uint32_t hash_update(uint32_t hash, const uint8_t *data, uint16_t length)
+{
+        for (int i = 0; i < length; i++) {
+                hash ^= data[i];
+                hash *= FNV_PRIME;
+        }
+        return hash;
+}
+
+static uint32_t hash_address(const bd_address_t *address)
+{
+        uint32_t hash = FNV_OFFSET_BASIS;
+        uint8_t type = (uint8_t)address->addr_type;
+
+        hash = hash_update(hash, &type, sizeof(type));
+        return hash_update(hash, address->addr, BD_ADDR_LEN);
+}
+
+static bool address_equal(const bd_address_t *a, const bd_address_t *b)
+{
+        return (a->addr_type == b->addr_type) && !memcmp(a->addr, b->addr, BD_ADDR_LEN);
+}
+
+static uint32_t home_index(const bd_address_t *address)
+{
+        return hash_address(address) & (ADV_CACHE_SIZE - 1);
+}
+
+/*
+ * Get the entry of a device (open addressing, linear probing). The free entry that should hold
+ * the device is returned if the device is not in the cache.
+ */
+static adv_cache_entry_t *cache_lookup(const bd_address_t *address)
+{
+        uint32_t idx = home_index(address);
+
+        /* The cache is never full, so a free entry is always found */
+        while (cache.entries[idx].used && !address_equal(&cache.entries[idx].address, address)) {
+                idx = (idx + 1) & (ADV_CACHE_SIZE - 1);
+        }
+        return &cache.entries[idx];
+}
+
+/*
+ * Remove an entry. The entries that follow it in the same probe sequence are shifted back, so
+ * that lookups need no tombstones and remain as short as if the entry had never been inserted.
+ */
+static void cache_remove(uint32_t idx)
+{
+        uint32_t next = idx;
+
+        for (;;) {
+                next = (next + 1) & (ADV_CACHE_SIZE - 1);
+                if (!cache.entries[next].used) {
+                        break;
+                }
+
+                /* An entry can move back to idx only if its home index is not within (idx, next] */
+                uint32_t home = home_index(&cache.entries[next].address);
+
+                if (((next - home) & (ADV_CACHE_SIZE - 1)) >= ((next - idx) & (ADV_CACHE_SIZE - 1))) {
+                        cache.entries[idx] = cache.entries[next];
+                        idx = next;
+                }
+        }
+
+        cache.entries[idx].used = false;
+        cache.num_of_devices--;
+}
+
+/*
+ * Evict the least recently seen device. Report sequence numbers are compared instead of tick
+ * counts, as many reports are received within the same tick.
+ */
+static void cache_evict(void)
+{
+        uint32_t oldest = 0;
+        uint32_t oldest_age = 0;
+
+        for (uint32_t i = 0; i < ADV_CACHE_SIZE; i++) {
+                if (cache.entries[i].used && (cache.report_seq - cache.entries[i].last_report >= oldest_age)) {
+                        oldest = i;
+                        oldest_age = cache.report_seq - cache.entries[i].last_report;
+                }
+        }
+
+        cache_remove(oldest);
+        cache.num_of_evictions++;
+}
+
+/* Update the payload hash of a report type. True is returned if the payload has changed. */
+static bool payload_update(adv_cache_entry_t *entry, uint8_t type, uint32_t hash)
+{
+        int free_idx = -1;
+
+        for (int i = 0; i < ADV_CACHE_PAYLOAD_TYPES; i++) {
+                if (!entry->payload[i].valid) {
+                        if (free_idx < 0) {
+                                free_idx = i;
+                        }
+                } else if (entry->payload[i].type == type) {
+                        bool changed = (entry->payload[i].hash != hash);
+
+                        entry->payload[i].hash = hash;
+                        return changed;
+                }
+        }
+
+        /* A report type not seen before; the first one is replaced if none is free */
+        if (free_idx < 0) {
+                free_idx = 0;
+        }
+        entry->payload[free_idx].type  = type;
+        entry->payload[free_idx].valid = true;
+        entry->payload[free_idx].hash  = hash;
+
+        return true;
+}
+
+adv_cache_status_t adv_cache_update(const ble_evt_gap_adv_report_t *evt, uint32_t timestamp_ms,
+                                                                const adv_cache_entry_t **entry)
+{
+        adv_cache_entry_t *e = cache_lookup(&evt->address);
+        uint32_t hash = hash_update(FNV_OFFSET_BASIS, evt->data, evt->length);
+        adv_cache_status_t status;
+
+        if (!e->used) {
+                /* Entries are shifted on eviction, so the free entry of the device is looked up again */
+                if (cache.num_of_devices >= ADV_CACHE_MAX_DEVICES) {
+                        cache_evict();
+                        e = cache_lookup(&evt->address);
+                }
+
+                memset(e, 0, sizeof(*e));
+                e->used = true;
+                e->address = evt->address;
+                e->first_seen_ms = timestamp_ms;
+                e->rssi_min = evt->rssi;
+                e->rssi_max = evt->rssi;
+                cache.num_of_devices++;
+
+                payload_update(e, evt->type, hash);
+                status = ADV_CACHE_STATUS_NEW;
+        } else {
+                status = payload_update(e, evt->type, hash) ? ADV_CACHE_STATUS_CHANGED :
+                                                              ADV_CACHE_STATUS_SEEN;
+        }
+
+        e->last_seen_ms = timestamp_ms;
+        e->last_report = ++cache.report_seq;
+        e->count++;
+        e->rssi_sum += evt->rssi;
+        if (evt->rssi < e->rssi_min) {
+                e->rssi_min = evt->rssi;
+        }
+        if (evt->rssi > e->rssi_max) {
+                e->rssi_max = evt->rssi;
+        }
+
+        if (entry) {
+                *entry = e;
+        }
+        return status;
+}
+
+void adv_cache_clear(void)
+{
+        memset(&cache, 0, sizeof(cache));
+}
+
+uint32_t adv_cache_state_size(void)
+{
+        return sizeof(cache);
+}
+
+void adv_cache_save(void *state)
+{
+        memcpy(state, &cache, sizeof(cache));
+}
+
+void adv_cache_restore(const void *state)
+{
+        memcpy(&cache, state, sizeof(cache));
+}
+
+void adv_cache_foreach(void (*cb)(const adv_cache_entry_t *entry, void *user_data), void *user_data)
+{
+        for (int i = 0; i < ADV_CACHE_SIZE; i++) {
+                if (cache.entries[i].used) {
+                        cb(&cache.entries[i], user_data);
+                }
+        }
+}
+
+void adv_cache_get_stats(uint16_t *num_of_devices, uint32_t *num_of_evictions)
+{
+        *num_of_devices = cache.num_of_devices;
+        if (num_of_evictions) {
+                *num_of_evictions = cache.num_of_evictions;
+        }
+}
+
+#if ADV_CACHE_BENCHMARK_EN
+void adv_cache_benchmark(uint16_t num_of_advertisers, uint16_t num_of_rounds, uint32_t *num_of_reports,
+                        uint32_t *cycles_per_report, uint32_t *num_of_changes, uint32_t *num_of_evictions)
+{
+        ble_evt_gap_adv_report_t evt;
+        uint32_t cycles = 0, changes = 0, reports = 0;
+
+        memset(&evt, 0, sizeof(evt));
+        evt.address.addr_type = PUBLIC_ADDRESS;
+        evt.length = 20;
+
+        adv_cache_clear();
+
+        CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+        DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
+        for (int round = 0; round < num_of_rounds; round++) {
+                for (int i = 0; i < num_of_advertisers; i++) {
+                        /* Advertisers report every 1, 2, 4 or 8 rounds */
+                        if ((round + i) & ((1 << (i % 4)) - 1)) {
+                                continue;
+                        }
+
+                        /* Synthetic advertiser address and payload; every 8th report changes the payload */
+                        evt.address.addr[0] = (uint8_t)i;
+                        evt.address.addr[1] = (uint8_t)(i >> 8);
+                        evt.address.addr[5] = 0xC0;
+                        evt.data[0] = (uint8_t)i;
+                        evt.data[1] = (uint8_t)(((round + i) >> (i % 4)) / 8);
+                        evt.rssi = (int8_t)(-40 - ((round + i) % 50));
+
+                        uint32_t start = DWT->CYCCNT;
+                        adv_cache_status_t status = adv_cache_update(&evt, round, NULL);
+                        cycles += DWT->CYCCNT - start;
+                        reports++;
+
+                        if ((status == ADV_CACHE_STATUS_NEW) || (status == ADV_CACHE_STATUS_CHANGED)) {
+                                changes++;
+                        }
+                }
+        }
+
+        *num_of_reports = reports;
+        *cycles_per_report = reports ? cycles / reports : 0;
+        *num_of_changes = changes;
+        *num_of_evictions = cache.num_of_evictions;
+
+        adv_cache_clear();
+}
+#endif /* ADV_CACHE_BENCHMARK_EN */
@@ -0,0 +1,162 @@
+/**
+ ****************************************************************************************
+ *
+ * @file adv_cache.h
+ *
+ * @brief Advertising report deduplication cache
+ *
+ * Copyright (C) 2024 Renesas Electronics Corporation and/or its affiliates.
+ * All rights reserved. Confidential Information.
+ *
+ * This software ("Software") is supplied by Renesas Electronics Corporation and/or its
+ * affiliates ("Renesas"). Renesas grants you a personal, non-exclusive, non-transferable,
+ * revocable, non-sub-licensable right and license to use the Software, solely if used in
+ * or together with Renesas products. You may make copies of this Software, provided this
+ * copyright notice and disclaimer ("Notice") is included in all such copies. Renesas
+ * reserves the right to change or discontinue the Software at any time without notice.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS". RENESAS DISCLAIMS ALL WARRANTIES OF ANY KIND,
+ * WHETHER EXPRESS, IMPLIED, OR STATUTORY, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT. TO THE
+ * MAXIMUM EXTENT PERMITTED UNDER LAW, IN NO EVENT SHALL RENESAS BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, SPECIAL, INCIDENTAL OR CONSEQUENTIAL DAMAGES ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE, EVEN IF RENESAS HAS BEEN ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGES. USE OF THIS SOFTWARE MAY BE SUBJECT TO TERMS AND CONDITIONS CONTAINED IN
+ * AN ADDITIONAL AGREEMENT BETWEEN YOU AND RENESAS. IN CASE OF CONFLICT BETWEEN THE TERMS
+ * OF THIS NOTICE AND ANY SUCH ADDITIONAL LICENSE AGREEMENT, THE TERMS OF THE AGREEMENT
+ * SHALL TAKE PRECEDENCE. BY CONTINUING TO USE THIS SOFTWARE, YOU AGREE TO THE TERMS OF
+ * THIS NOTICE.IF YOU DO NOT AGREE TO THESE TERMS, YOU ARE NOT PERMITTED TO USE THIS
+ * SOFTWARE.
+ *
+ ****************************************************************************************
+ */
+
+#ifndef ADV_CACHE_H_
+#define ADV_CACHE_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "osal.h"
+#include "ble_gap.h"
+
+/*
+ * Number of entries of the cache (should be a power of two). At most three quarters of the entries
+ * are occupied, so that lookups remain short; beyond that, the least recently seen device is
+ * evicted to make room for a new one.
+ */
+#ifndef ADV_CACHE_SIZE
+#define ADV_CACHE_SIZE                  ( 128 )
+#endif
+
+/*
+ * If set, the report processing throughput of the cache can be measured via the CLI, using
+ * synthetic reports of a given number of advertisers (DWT cycle counter).
+ */
+#ifndef ADV_CACHE_BENCHMARK_EN
+#define ADV_CACHE_BENCHMARK_EN          ( 0 )
+#endif
+
+/* Number of payload types (advertising data, scan response data) tracked per device */
+#define ADV_CACHE_PAYLOAD_TYPES         ( 2 )
+
+/* Status of a report processed by the cache */
+typedef enum {
+        ADV_CACHE_STATUS_NEW,           /* Device reported for the first time */
+        ADV_CACHE_STATUS_CHANGED,       /* Device reported with a different payload */
+        ADV_CACHE_STATUS_SEEN,          /* Device reported with the same payload */
+} adv_cache_status_t;
+
+/* Cache entry of a device */
+typedef struct {
+        bd_address_t address;           /* Address and address type of the device */
+        bool used;
+
+        uint32_t first_seen_ms;         /* Time of the first report */
+        uint32_t last_seen_ms;          /* Time of the latest report */
+        uint32_t count;                 /* Number of reports */
+        uint32_t last_report;           /* Sequence number of the latest report, for eviction */
+
+        int32_t rssi_sum;               /* Sum of the RSSI of all the reports (average = rssi_sum / count) */
+        int8_t rssi_min;
+        int8_t rssi_max;
+
+        /* Hash of the latest payload per report type */
+        struct {
+                uint8_t type;
+                bool valid;
+                uint32_t hash;
+        } payload[ADV_CACHE_PAYLOAD_TYPES];
+} adv_cache_entry_t;
+
+/*
+ * Process an advertising report. If the cache is full, the least recently seen device is evicted
+ * to track a new device. Timestamps are passed explicitly, so that recorded reports can be
+ * replayed.
+ *
+ * \param [in]  evt          The advertising report
+ * \param [in]  timestamp_ms Time the report was received
+ * \param [out] entry        The cache entry of the device; valid until the next report is
+ *                           processed. Can be NULL.
+ *
+ * \return The status of the report
+ */
+adv_cache_status_t adv_cache_update(const ble_evt_gap_adv_report_t *evt, uint32_t timestamp_ms,
+                                                                const adv_cache_entry_t **entry);
+
+/* Remove all the devices from the cache */
+void adv_cache_clear(void);
+
+/* Size, in bytes, of the state of the cache (devices tracked and statistics) */
+uint32_t adv_cache_state_size(void);
+
+/*
+ * Save the state of the cache, e.g. so that reports can be replayed through an empty cache
+ * without losing the devices found
+ *
+ * \param [out] state Buffer of adv_cache_state_size() bytes
+ */
+void adv_cache_save(void *state);
+
+/*
+ * Restore the state of the cache
+ *
+ * \param [in] state State saved by adv_cache_save()
+ */
+void adv_cache_restore(const void *state);
+
+/*
+ * Iterate over the devices of the cache.
+ *
+ * \param [in] cb       Function called for each device of the cache
+ * \param [in] user_data User data passed to \p cb
+ */
+void adv_cache_foreach(void (*cb)(const adv_cache_entry_t *entry, void *user_data), void *user_data);
+
+/*
+ * Get the number of devices tracked and the number of devices evicted as the cache was full.
+ *
+ * \param [out] num_of_devices   Number of devices tracked
+ * \param [out] num_of_evictions Number of devices evicted. Can be NULL.
+ */
+void adv_cache_get_stats(uint16_t *num_of_devices, uint32_t *num_of_evictions);
+
+#if ADV_CACHE_BENCHMARK_EN
+/*
+ * Measure the report processing throughput of the cache, using \p num_of_advertisers synthetic
+ * advertisers over \p num_of_rounds rounds. As in a dense environment, advertisers report at
+ * different rates: every 1, 2, 4 or 8 rounds (every 8th report carries a changed payload). With
+ * more advertisers than the cache can track, the least recently seen ones are evicted, while those
+ * reporting often remain tracked. The cache is cleared before and after the measurement.
+ *
+ * \param [in]  num_of_advertisers Number of synthetic advertisers
+ * \param [in]  num_of_rounds      Number of rounds
+ * \param [out] num_of_reports     Number of reports processed
+ * \param [out] cycles_per_report  Average CPU cycles spent per report
+ * \param [out] num_of_changes     Number of reports reported as new or changed
+ * \param [out] num_of_evictions   Number of devices evicted as the cache was full
+ */
+void adv_cache_benchmark(uint16_t num_of_advertisers, uint16_t num_of_rounds, uint32_t *num_of_reports,
+                        uint32_t *cycles_per_report, uint32_t *num_of_changes, uint32_t *num_of_evictions);
+#endif
+
+#endif /* ADV_CACHE_H_ */
@@ -0,0 +1,446 @@
+/**
+ ****************************************************************************************
+ *
+ * @file adv_filter.c
+ *
+ * @brief Advertising report filter engine
+ *
+ * Copyright (C) 2024 Renesas Electronics Corporation and/or its affiliates.
+ * All rights reserved. Confidential Information.
+ *
+ * This software ("Software") is supplied by Renesas Electronics Corporation and/or its
+ * affiliates ("Renesas"). Renesas grants you a personal, non-exclusive, non-transferable,
+ * revocable, non-sub-licensable right and license to use the Software, solely if used in
+ * or together with Renesas products. You may make copies of this Software, provided this
+ * copyright notice and disclaimer ("Notice") is included in all such copies. Renesas
+ * reserves the right to change or discontinue the Software at any time without notice.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS". RENESAS DISCLAIMS ALL WARRANTIES OF ANY KIND,
+ * WHETHER EXPRESS, IMPLIED, OR STATUTORY, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT. TO THE
+ * MAXIMUM EXTENT PERMITTED UNDER LAW, IN NO EVENT SHALL RENESAS BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, SPECIAL, INCIDENTAL OR CONSEQUENTIAL DAMAGES ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE, EVEN IF RENESAS HAS BEEN ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGES. USE OF THIS SOFTWARE MAY BE SUBJECT TO TERMS AND CONDITIONS CONTAINED IN
+ * AN ADDITIONAL AGREEMENT BETWEEN YOU AND RENESAS. IN CASE OF CONFLICT BETWEEN THE TERMS
+ * OF THIS NOTICE AND ANY SUCH ADDITIONAL LICENSE AGREEMENT, THE TERMS OF THE AGREEMENT
+ * SHALL TAKE PRECEDENCE. BY CONTINUING TO USE THIS SOFTWARE, YOU AGREE TO THE TERMS OF
+ * THIS NOTICE.IF YOU DO NOT AGREE TO THESE TERMS, YOU ARE NOT PERMITTED TO USE THIS
+ * SOFTWARE.
+ *
+ ****************************************************************************************
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include "sdk_defs.h"
+#include "misc.h"
+#include "adv_filter.h"
+
+#if ADV_FILTER_MAX_TERMS > 32
+#error "ADV_FILTER_MAX_TERMS should not exceed 32"
+#endif
+
+/*
+ * Opcodes of the advertising data terms. Each instruction of the bytecode consists of the opcode,
+ * the operand length and the operand. Instructions are numbered in program order; the number of
+ * an instruction is its bit in the term masks of the rules.
+ */
+#define OP_UUID16                       ( 0x01 )    /* Operand: UUID (little endian) */
+#define OP_UUID128                      ( 0x02 )    /* Operand: UUID (little endian) */
+#define OP_MFR                          ( 0x03 )    /* Operand: company ID (little endian) and data prefix */
+#define OP_NAME                         ( 0x04 )    /* Operand: name prefix */
+
+/* Instruction header size (opcode and operand length) */
+#define OP_HDR_SIZE                     ( 2 )
+
+/* Filter rule */
+typedef struct {
+        uint32_t terms;                 /* Advertising data terms that should be matched (bit per term) */
+        int8_t rssi_min;                /* Min. RSSI; INT8_MIN if not checked */
+        bool addr_check;
+        uint8_t addr[BD_ADDR_LEN];      /* Address (LSB first), already masked */
+        uint8_t addr_mask[BD_ADDR_LEN];
+} adv_filter_rule_t;
+
+__RETAINED static uint8_t program[ADV_FILTER_PROGRAM_SIZE];
+__RETAINED static uint16_t program_len;
+__RETAINED static uint8_t num_of_terms;
+
+__RETAINED static adv_filter_rule_t rules[ADV_FILTER_MAX_RULES];
+__RETAINED static uint8_t num_of_rules;
+
+/********************************* Rule compilation *****************************************/
+
+static int hex_digit(char c)
+{
+        if (c >= '0' && c <= '9') {
+                return c - '0';
+        }
+        if (c >= 'a' && c <= 'f') {
+                return c - 'a' + 10;
+        }
+        if (c >= 'A' && c <= 'F') {
+                return c - 'A' + 10;
+        }
+        return -1;
+}
+
+/*
+ * Parse a hex string (separators '-' and ':' are ignored) into bytes, in the order written.
+ * The number of bytes parsed is returned; -1 on error.
+ */
+static int parse_hex(const char *str, uint8_t *buf, int max_len)
+{
+        int len = 0;
+
+        while (*str) {
+                int hi, lo;
+
+                if ((*str == '-') || (*str == ':')) {
+                        str++;
+                        continue;
+                }
+
+                hi = hex_digit(str[0]);
+                lo = (hi < 0) ? -1 : hex_digit(str[1]);
+                if ((lo < 0) || (len == max_len)) {
+                        return -1;
+                }
+
+                buf[len++] = (uint8_t)((hi << 4) | lo);
+                str += 2;
+        }
+        return len;
+}
+
+/* Reverse bytes in place (written order to little endian) */
+static void reverse(uint8_t *buf, int len)
+{
+        for (int i = 0; i < len / 2; i++) {
+                uint8_t tmp = buf[i];
+
+                buf[i] = buf[len - 1 - i];
+                buf[len - 1 - i] = tmp;
+        }
+}
+
+/* Append an instruction to the bytecode. The bit of the term is returned; 0 on error. */
+static uint32_t emit(uint16_t *pc, uint8_t *num, uint8_t op, const uint8_t *operand, uint8_t len)
+{
+        if ((*num == ADV_FILTER_MAX_TERMS) || (*pc + OP_HDR_SIZE + len > ADV_FILTER_PROGRAM_SIZE)) {
+                return 0;
+        }
+
+        program[*pc] = op;
+        program[*pc + 1] = len;
+        memcpy(&program[*pc + OP_HDR_SIZE], operand, len);
+        *pc += OP_HDR_SIZE + len;
+
+        return 1UL << (*num)++;
+}
+
+/* Compile a term */
+static adv_filter_status_t compile_term(const char *term, adv_filter_rule_t *rule, uint16_t *pc, uint8_t *num)
+{
+        uint8_t operand[BLE_ADV_DATA_LEN_MAX];
+        const char *value = strchr(term, '=');
+        uint32_t bit;
+        int len;
+
+        if (value == NULL) {
+                return ADV_FILTER_STATUS_INVALID_TERM;
+        }
+        value++;
+
+        if (!strncmp(term, "uuid16=", 7)) {
+                if (parse_hex(value, operand, sizeof(operand)) != 2) {
+                        return ADV_FILTER_STATUS_INVALID_TERM;
+                }
+                reverse(operand, 2);
+                bit = emit(pc, num, OP_UUID16, operand, 2);
+        } else if (!strncmp(term, "uuid128=", 8)) {
+                if (parse_hex(value, operand, sizeof(operand)) != 16) {
+                        return ADV_FILTER_STATUS_INVALID_TERM;
+                }
+                reverse(operand, 16);
+                bit = emit(pc, num, OP_UUID128, operand, 16);
+        } else if (!strncmp(term, "mfr=", 4)) {
+                /* Company ID followed by the data prefix (if any) */
+                len = parse_hex(value, operand, sizeof(operand));
+                if ((len < 2) || ((len > 2) && (value[4] != ':'))) {
+                        return ADV_FILTER_STATUS_INVALID_TERM;
+                }
+                reverse(operand, 2);
+                bit = emit(pc, num, OP_MFR, operand, len);
+        } else if (!strncmp(term, "name=", 5)) {
+                len = strlen(value);
+                if ((len == 0) || (len > BLE_ADV_DATA_LEN_MAX)) {
+                        return ADV_FILTER_STATUS_INVALID_TERM;
+                }
+                bit = emit(pc, num, OP_NAME, (const uint8_t *)value, len);
+        } else if (!strncmp(term, "rssi=", 5)) {
+                char *end;
+                long rssi = strtol(value, &end, 10);
+
+                if ((*end != '\0') || (rssi < INT8_MIN) || (rssi > INT8_MAX)) {
+                        return ADV_FILTER_STATUS_INVALID_TERM;
+                }
+                rule->rssi_min = (int8_t)rssi;
+                return ADV_FILTER_STATUS_OK;
+        } else if (!strncmp(term, "addr=", 5)) {
+                const char *mask = strchr(value, '/');
+                char addr[3 * BD_ADDR_LEN];
+
+                len = mask ? (mask - value) : (int)strlen(value);
+                if (len >= (int)sizeof(addr)) {
+                        return ADV_FILTER_STATUS_INVALID_TERM;
+                }
+                memcpy(addr, value, len);
+                addr[len] = '\0';
+
+                if (parse_hex(addr, rule->addr, BD_ADDR_LEN) != BD_ADDR_LEN) {
+                        return ADV_FILTER_STATUS_INVALID_TERM;
+                }
+                memset(rule->addr_mask, 0xFF, BD_ADDR_LEN);
+                if (mask && (parse_hex(mask + 1, rule->addr_mask, BD_ADDR_LEN) != BD_ADDR_LEN)) {
+                        return ADV_FILTER_STATUS_INVALID_TERM;
+                }
+
+                /* Addresses are written MSB first but stored LSB first */
+                reverse(rule->addr, BD_ADDR_LEN);
+                reverse(rule->addr_mask, BD_ADDR_LEN);
+                for (int i = 0; i < BD_ADDR_LEN; i++) {
+                        rule->addr[i] &= rule->addr_mask[i];
+                }
+                rule->addr_check = true;
+                return ADV_FILTER_STATUS_OK;
+        } else {
+                return ADV_FILTER_STATUS_INVALID_TERM;
+        }
+
+        if (bit == 0) {
+                return ADV_FILTER_STATUS_NO_RESOURCES;
+        }
+        rule->terms |= bit;
+
+        return ADV_FILTER_STATUS_OK;
+}
+
+adv_filter_status_t adv_filter_add_rule(int argc, const char *argv[])
+{
+        adv_filter_rule_t rule;
+        uint16_t pc = program_len;
+        uint8_t num = num_of_terms;
+
+        if (num_of_rules == ADV_FILTER_MAX_RULES) {
+                return ADV_FILTER_STATUS_NO_RESOURCES;
+        }
+
+        memset(&rule, 0, sizeof(rule));
+        rule.rssi_min = INT8_MIN;
+
+        for (int i = 0; i < argc; i++) {
+                adv_filter_status_t status = compile_term(argv[i], &rule, &pc, &num);
+
+                /* The bytecode emitted so far is discarded, as the program length is not updated */
+                if (status != ADV_FILTER_STATUS_OK) {
+                        return status;
+                }
+        }
+
+        program_len = pc;
+        num_of_terms = num;
+        rules[num_of_rules++] = rule;
+
+        return ADV_FILTER_STATUS_OK;
+}
+
+void adv_filter_clear(void)
+{
+        program_len = 0;
+        num_of_terms = 0;
+        num_of_rules = 0;
+}
+
+uint8_t adv_filter_num_of_rules(void)
+{
+        return num_of_rules;
+}
+
+void adv_filter_print(void)
+{
+        static const char *op_names[] = { "", "uuid16", "uuid128", "mfr", "name" };
+        uint16_t pc = 0;
+
+        for (int i = 0; i < num_of_rules; i++) {
+                DBG_LOG("Rule %d: terms = 0x%08lX, rssi >= %d", i, rules[i].terms, rules[i].rssi_min);
+                if (rules[i].addr_check) {
+                        DBG_LOG(", addr = ");
+                        for (int j = BD_ADDR_LEN - 1; j >= 0; j--) {
+                                DBG_LOG("%02X%s", rules[i].addr[j], j ? ":" : "");
+                        }
+                        DBG_LOG("/");
+                        for (int j = BD_ADDR_LEN - 1; j >= 0; j--) {
+                                DBG_LOG("%02X%s", rules[i].addr_mask[j], j ? ":" : "");
+                        }
+                }
+                DBG_LOG("\n\r");
+        }
+
+        for (int i = 0; pc < program_len; i++) {
+                DBG_LOG("Term %d: %s,", i, op_names[program[pc]]);
+                for (int j = 0; j < program[pc + 1]; j++) {
+                        DBG_LOG(" %02X", program[pc + OP_HDR_SIZE + j]);
+                }
+                DBG_LOG("\n\r");
+                pc += OP_HDR_SIZE + program[pc + 1];
+        }
+}
+
+/********************************* Rule evaluation *****************************************/
+
+/* Check whether a list of UUIDs contains a UUID */
+static bool uuid_list_match(const uint8_t *data, uint8_t len, const uint8_t *uuid, uint8_t uuid_len)
+{
+        for (int i = 0; i + uuid_len <= len; i += uuid_len) {
+                if (!memcmp(&data[i], uuid, uuid_len)) {
+                        return true;
+                }
+        }
+        return false;
+}
+
+/* Evaluate the advertising data terms against an AD structure. The terms matched are returned. */
+static uint32_t match_terms(uint8_t type, const uint8_t *data, uint8_t len, uint32_t matched)
+{
+        uint16_t pc = 0;
+
+        for (uint32_t bit = 1; pc < program_len; bit <<= 1) {
+                uint8_t op = program[pc];
+                uint8_t op_len = program[pc + 1];
+                const uint8_t *operand = &program[pc + OP_HDR_SIZE];
+
+                pc += OP_HDR_SIZE + op_len;
+
+                if (matched & bit) {
+                        continue;
+                }
+
+                switch (op) {
+                case OP_UUID16:
+                        if (((type == GAP_DATA_TYPE_UUID16_LIST_INC) || (type == GAP_DATA_TYPE_UUID16_LIST)) &&
+                                                        uuid_list_match(data, len, operand, op_len)) {
+                                matched |= bit;
+                        }
+                        break;
+                case OP_UUID128:
+                        if (((type == GAP_DATA_TYPE_UUID128_LIST_INC) || (type == GAP_DATA_TYPE_UUID128_LIST)) &&
+                                                        uuid_list_match(data, len, operand, op_len)) {
+                                matched |= bit;
+                        }
+                        break;
+                case OP_MFR:
+                        if ((type == GAP_DATA_TYPE_MANUFACTURER_SPEC) && (len >= op_len) &&
+                                                        !memcmp(data, operand, op_len)) {
+                                matched |= bit;
+                        }
+                        break;
+                case OP_NAME:
+                        if (((type == GAP_DATA_TYPE_SHORT_LOCAL_NAME) || (type == GAP_DATA_TYPE_LOCAL_NAME)) &&
+                                                        (len >= op_len) && !memcmp(data, operand, op_len)) {
+                                matched |= bit;
+                        }
+                        break;
+                default:
+                        ASSERT_WARNING(0);
+                        break;
+                }
+        }
+        return matched;
+}
+
+bool adv_filter_match(const ble_evt_gap_adv_report_t *evt)
+{
+        uint32_t matched = 0;
+        int idx = 0;
+
+        if (num_of_rules == 0) {
+                return true;
+        }
+
+        /* Single pass over the AD structures; all the terms are evaluated in place */
+        while (program_len && (idx + 1 < evt->length)) {
+                uint8_t len = evt->data[idx];
+
+                if ((len == 0) || (idx + 1 + len > evt->length)) {
+                        break;
+                }
+
+                matched = match_terms(evt->data[idx + 1], &evt->data[idx + 2], len - 1, matched);
+                idx += len + 1;
+        }
+
+        for (int i = 0; i < num_of_rules; i++) {
+                const adv_filter_rule_t *rule = &rules[i];
+
+                if (((matched & rule->terms) != rule->terms) || (evt->rssi < rule->rssi_min)) {
+                        continue;
+                }
+
+                if (rule->addr_check) {
+                        int j;
+
+                        for (j = 0; j < BD_ADDR_LEN; j++) {
+                                if ((evt->address.addr[j] & rule->addr_mask[j]) != rule->addr[j]) {
+                                        break;
+                                }
+                        }
+                        if (j < BD_ADDR_LEN) {
+                                continue;
+                        }
+                }
+                return true;
+        }
+        return false;
+}
+
+#if ADV_FILTER_BENCHMARK_EN
+void adv_filter_benchmark(uint32_t num_of_reports, uint32_t *cycles_per_report, uint32_t *num_of_matches)
+{
+        /* Synthetic reports: flags, 16-bit UUID list, manufacturer data and local name */
+        static const uint8_t adv_data[] = {
+                0x02, 0x01, 0x06,
+                0x05, 0x03, 0x0D, 0x18, 0x0F, 0x18,
+                0x07, 0xFF, 0x4C, 0x00, 0x02, 0x15, 0x01, 0x02,
+                0x08, 0x09, 'S', 'e', 'n', 's', 'o', 'r', '1',
+        };
+        ble_evt_gap_adv_report_t evt;
+        uint32_t cycles = 0, matches = 0;
+
+        memset(&evt, 0, sizeof(evt));
+        memcpy(evt.data, adv_data, sizeof(adv_data));
+        evt.length = sizeof(adv_data);
+
+        CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+        DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
+        for (uint32_t i = 0; i < num_of_reports; i++) {
+                /* Vary the address, the RSSI and the last byte of the name */
+                evt.address.addr[0] = (uint8_t)i;
+                evt.rssi = (int8_t)(-30 - (i % 70));
+                evt.data[sizeof(adv_data) - 1] = '0' + (i % 10);
+
+                uint32_t start = DWT->CYCCNT;
+                bool match = adv_filter_match(&evt);
+                cycles += DWT->CYCCNT - start;
+
+                if (match) {
+                        matches++;
+                }
+        }
+
+        *cycles_per_report = num_of_reports ? (cycles / num_of_reports) : 0;
+        *num_of_matches = matches;
+}
+#endif /* ADV_FILTER_BENCHMARK_EN */
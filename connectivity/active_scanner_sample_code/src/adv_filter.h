@@ -0,0 +1,119 @@
+/**
+ ****************************************************************************************
+ *
+ * @file adv_filter.h
+ *
+ * @brief Advertising report filter engine
+ *
+ * Copyright (C) 2024 Renesas Electronics Corporation and/or its affiliates.
+ * All rights reserved. Confidential Information.
+ *
+ * This software ("Software") is supplied by Renesas Electronics Corporation and/or its
+ * affiliates ("Renesas"). Renesas grants you a personal, non-exclusive, non-transferable,
+ * revocable, non-sub-licensable right and license to use the Software, solely if used in
+ * or together with Renesas products. You may make copies of this Software, provided this
+ * copyright notice and disclaimer ("Notice") is included in all such copies. Renesas
+ * reserves the right to change or discontinue the Software at any time without notice.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS". RENESAS DISCLAIMS ALL WARRANTIES OF ANY KIND,
+ * WHETHER EXPRESS, IMPLIED, OR STATUTORY, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT. TO THE
+ * MAXIMUM EXTENT PERMITTED UNDER LAW, IN NO EVENT SHALL RENESAS BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, SPECIAL, INCIDENTAL OR CONSEQUENTIAL DAMAGES ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE, EVEN IF RENESAS HAS BEEN ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGES. USE OF THIS SOFTWARE MAY BE SUBJECT TO TERMS AND CONDITIONS CONTAINED IN
+ * AN ADDITIONAL AGREEMENT BETWEEN YOU AND RENESAS. IN CASE OF CONFLICT BETWEEN THE TERMS
+ * OF THIS NOTICE AND ANY SUCH ADDITIONAL LICENSE AGREEMENT, THE TERMS OF THE AGREEMENT
+ * SHALL TAKE PRECEDENCE. BY CONTINUING TO USE THIS SOFTWARE, YOU AGREE TO THE TERMS OF
+ * THIS NOTICE.IF YOU DO NOT AGREE TO THESE TERMS, YOU ARE NOT PERMITTED TO USE THIS
+ * SOFTWARE.
+ *
+ ****************************************************************************************
+ */
+
+#ifndef ADV_FILTER_H_
+#define ADV_FILTER_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "ble_gap.h"
+
+/* Max. number of filter rules. A report passes the filter if it matches any of the rules. */
+#ifndef ADV_FILTER_MAX_RULES
+#define ADV_FILTER_MAX_RULES            ( 4 )
+#endif
+
+/* Max. number of advertising data terms (service UUID, manufacturer, name) of all the rules */
+#ifndef ADV_FILTER_MAX_TERMS
+#define ADV_FILTER_MAX_TERMS            ( 16 )
+#endif
+
+/* Size, expressed in bytes, of the bytecode of the advertising data terms of all the rules */
+#ifndef ADV_FILTER_PROGRAM_SIZE
+#define ADV_FILTER_PROGRAM_SIZE         ( 128 )
+#endif
+
+/*
+ * If set, the filter evaluation throughput can be measured via the CLI, using synthetic reports
+ * (DWT cycle counter).
+ */
+#ifndef ADV_FILTER_BENCHMARK_EN
+#define ADV_FILTER_BENCHMARK_EN         ( 0 )
+#endif
+
+/* Status of adding a filter rule */
+typedef enum {
+        ADV_FILTER_STATUS_OK,
+        ADV_FILTER_STATUS_INVALID_TERM,         /* A term could not be parsed */
+        ADV_FILTER_STATUS_NO_RESOURCES,         /* Max. number of rules/terms or program size reached */
+} adv_filter_status_t;
+
+/*
+ * Compile a filter rule and add it to the filter. A rule consists of terms, all of which should
+ * be matched by a report:
+ *
+ *  - uuid16=<XXXX>            16-bit service UUID (complete or incomplete list)
+ *  - uuid128=<UUID>           128-bit service UUID, e.g. 0000180d-0000-1000-8000-00805f9b34fb
+ *  - mfr=<XXXX>[:<hex bytes>] Manufacturer (company ID) and, optionally, a data prefix
+ *  - name=<text>              Local name (complete or shortened) prefix
+ *  - rssi=<dBm>               Min. RSSI
+ *  - addr=<XX:..:XX>[/<XX:..:XX>] Device address and, optionally, an address mask
+ *
+ * \param [in] argc Number of terms
+ * \param [in] argv Terms
+ *
+ * \return The status of the operation; the filter is not modified on failure
+ */
+adv_filter_status_t adv_filter_add_rule(int argc, const char *argv[]);
+
+/* Remove all the filter rules; all reports pass the filter */
+void adv_filter_clear(void);
+
+/* Print the filter rules and their bytecode */
+void adv_filter_print(void);
+
+/* Get the number of filter rules defined */
+uint8_t adv_filter_num_of_rules(void);
+
+/*
+ * Check whether a report passes the filter. The advertising data are parsed once, in place.
+ *
+ * \param [in] evt The advertising report
+ *
+ * \return True if no rules are defined or the report matches any of the rules
+ */
+bool adv_filter_match(const ble_evt_gap_adv_report_t *evt);
+
+#if ADV_FILTER_BENCHMARK_EN
+/*
+ * Measure the filter evaluation throughput. A set of synthetic reports is evaluated
+ * \p num_of_reports times against the filter rules.
+ *
+ * \param [in]  num_of_reports    Number of reports evaluated
+ * \param [out] cycles_per_report Average CPU cycles spent per report
+ * \param [out] num_of_matches    Number of reports that passed the filter
+ */
+void adv_filter_benchmark(uint32_t num_of_reports, uint32_t *cycles_per_report, uint32_t *num_of_matches);
+#endif
+
+#endif /* ADV_FILTER_H_ */
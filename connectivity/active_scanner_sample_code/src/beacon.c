@@ -0,0 +1,368 @@
+/**
+ ****************************************************************************************
+ *
+ * @file beacon.c
+ *
+ * @brief iBeacon and Eddystone decoding and proximity estimation
+ *
+ * Copyright (C) 2024 Renesas Electronics Corporation and/or its affiliates.
+ * All rights reserved. Confidential Information.
+ *
+ * This software ("Software") is supplied by Renesas Electronics Corporation and/or its
+ * affiliates ("Renesas"). Renesas grants you a personal, non-exclusive, non-transferable,
+ * revocable, non-sub-licensable right and license to use the Software, solely if used in
+ * or together with Renesas products. You may make copies of this Software, provided this
+ * copyright notice and disclaimer ("Notice") is included in all such copies. Renesas
+ * reserves the right to change or discontinue the Software at any time without notice.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS". RENESAS DISCLAIMS ALL WARRANTIES OF ANY KIND,
+ * WHETHER EXPRESS, IMPLIED, OR STATUTORY, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT. TO THE
+ * MAXIMUM EXTENT PERMITTED UNDER LAW, IN NO EVENT SHALL RENESAS BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, SPECIAL, INCIDENTAL OR CONSEQUENTIAL DAMAGES ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE, EVEN IF RENESAS HAS BEEN ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGES. USE OF THIS SOFTWARE MAY BE SUBJECT TO TERMS AND CONDITIONS CONTAINED IN
+ * AN ADDITIONAL AGREEMENT BETWEEN YOU AND RENESAS. IN CASE OF CONFLICT BETWEEN THE TERMS
+ * OF THIS NOTICE AND ANY SUCH ADDITIONAL LICENSE AGREEMENT, THE TERMS OF THE AGREEMENT
+ * SHALL TAKE PRECEDENCE. BY CONTINUING TO USE THIS SOFTWARE, YOU AGREE TO THE TERMS OF
+ * THIS NOTICE.IF YOU DO NOT AGREE TO THESE TERMS, YOU ARE NOT PERMITTED TO USE THIS
+ * SOFTWARE.
+ *
+ ****************************************************************************************
+ */
+
+#include <string.h>
+#include "sdk_defs.h"
+#include "ble_bufops.h"
+#include "beacon.h"
+
+#define AD_TYPE_SERVICE_DATA_UUID16     ( 0x16 )
+#define AD_TYPE_MANUFACTURER_SPEC       ( 0xFF )
+
+/* iBeacon manufacturer data: company ID (Apple), type, length, UUID, major, minor, TX power */
+#define IBEACON_COMPANY_ID              ( 0x004C )
+#define IBEACON_TYPE                    ( 0x02 )
+#define IBEACON_LEN                     ( 0x15 )
+#define IBEACON_DATA_LEN                ( 25 )
+
+/* Eddystone service data: service UUID, frame type and frame */
+#define EDDYSTONE_UUID                  ( 0xFEAA )
+#define EDDYSTONE_FRAME_UID             ( 0x00 )
+#define EDDYSTONE_FRAME_URL             ( 0x10 )
+#define EDDYSTONE_FRAME_TLM             ( 0x20 )
+#define EDDYSTONE_UID_DATA_LEN          ( 20 )      /* UUID, frame type, TX power, namespace, instance */
+#define EDDYSTONE_URL_MIN_DATA_LEN      ( 5 )       /* UUID, frame type, TX power, scheme */
+#define EDDYSTONE_TLM_DATA_LEN          ( 16 )
+
+/* Eddystone TX power is calibrated at 0 m; the path loss at 1 m is 41 dB */
+#define EDDYSTONE_LOSS_AT_1M            ( 41 )
+
+/* Path loss range, relative to the calibrated RSSI at 1 m, of the distance table (dB) */
+#define PATH_LOSS_MIN                   ( -20 )
+#define PATH_LOSS_MAX                   ( 100 )
+
+/* Decoded beacon frame */
+typedef struct {
+        beacon_type_t type;
+        bool tlm;
+        uint8_t id[20];
+        int8_t tx_power;                /* Calibrated RSSI at 1 m */
+        uint16_t battery_mv;
+        int16_t temperature_x256;
+} beacon_frame_t;
+
+/* State of the beacon tracking */
+typedef struct {
+        beacon_t beacons[BEACON_MAX];
+        bool used[BEACON_MAX];
+        uint32_t reports;
+        uint32_t events;
+        uint32_t overflows;
+} beacon_state_t;
+
+__RETAINED static beacon_state_t tracking;
+
+/* Distance, in cm, per dB of path loss in [PATH_LOSS_MIN, PATH_LOSS_MAX] */
+__RETAINED static uint32_t distance_table[PATH_LOSS_MAX - PATH_LOSS_MIN + 1];
+__RETAINED static bool distance_table_ready;
+
+/*
+ * Fill the distance table of the log-distance path loss model, d = 10 ^ (loss / (10 * n)),
+ * using multiplications only.
+ */
+static void distance_table_init(void)
+{
+        float lo = 1.0f, hi = 10.0f, step, distance;
+
+        /* Distance ratio per dB: the (10 * n)-th root of 10, found by bisection */
+        for (int i = 0; i < 32; i++) {
+                float mid = (lo + hi) / 2;
+                float pow = 1.0f;
+
+                for (int j = 0; j < BEACON_PATH_LOSS_EXP_X10; j++) {
+                        pow *= mid;
+                }
+                if (pow > 10.0f) {
+                        hi = mid;
+                } else {
+                        lo = mid;
+                }
+        }
+        step = lo;
+
+        distance = 100.0f;
+        for (int i = PATH_LOSS_MIN; i < 0; i++) {
+                distance /= step;
+        }
+        for (int i = 0; i < ARRAY_LENGTH(distance_table); i++) {
+                distance_table[i] = (uint32_t)(distance + 0.5f);
+                distance *= step;
+        }
+
+        distance_table_ready = true;
+}
+
+static uint32_t estimate_distance(int8_t tx_power, int16_t rssi_x16)
+{
+        int loss = tx_power - ((rssi_x16 + 8) >> 4);
+
+        if (loss < PATH_LOSS_MIN) {
+                loss = PATH_LOSS_MIN;
+        } else if (loss > PATH_LOSS_MAX) {
+                loss = PATH_LOSS_MAX;
+        }
+
+        return distance_table[loss - PATH_LOSS_MIN];
+}
+
+/* Decode an AD structure. True is returned if it is a beacon frame. */
+static bool decode_ad(uint8_t type, const uint8_t *data, uint8_t len, beacon_frame_t *frame)
+{
+        memset(frame, 0, sizeof(*frame));
+
+        if ((type == AD_TYPE_MANUFACTURER_SPEC) && (len == IBEACON_DATA_LEN) &&
+                        (get_u16(data) == IBEACON_COMPANY_ID) && (data[2] == IBEACON_TYPE) &&
+                        (data[3] == IBEACON_LEN)) {
+                frame->type = BEACON_TYPE_IBEACON;
+                memcpy(frame->id, &data[4], 20);
+                frame->tx_power = (int8_t)data[24];
+                return true;
+        }
+
+        if ((type != AD_TYPE_SERVICE_DATA_UUID16) || (len < 3) || (get_u16(data) != EDDYSTONE_UUID)) {
+                return false;
+        }
+
+        switch (data[2]) {
+        case EDDYSTONE_FRAME_UID:
+                if (len < EDDYSTONE_UID_DATA_LEN) {
+                        return false;
+                }
+                frame->type = BEACON_TYPE_EDDYSTONE_UID;
+                memcpy(frame->id, &data[4], 16);
+                frame->tx_power = (int8_t)data[3] - EDDYSTONE_LOSS_AT_1M;
+                return true;
+        case EDDYSTONE_FRAME_URL:
+                if (len < EDDYSTONE_URL_MIN_DATA_LEN) {
+                        return false;
+                }
+                frame->type = BEACON_TYPE_EDDYSTONE_URL;
+                frame->tx_power = (int8_t)data[3] - EDDYSTONE_LOSS_AT_1M;
+                return true;
+        case EDDYSTONE_FRAME_TLM:
+                /* Unencrypted TLM: version, battery voltage, temperature (big endian) */
+                if ((len < EDDYSTONE_TLM_DATA_LEN) || (data[3] != 0x00)) {
+                        return false;
+                }
+                frame->tlm = true;
+                frame->battery_mv = (data[4] << 8) | data[5];
+                frame->temperature_x256 = (int16_t)((data[6] << 8) | data[7]);
+                return true;
+        default:
+                return false;
+        }
+}
+
+static bool address_equal(const bd_address_t *a, const bd_address_t *b)
+{
+        return (a->addr_type == b->addr_type) && !memcmp(a->addr, b->addr, BD_ADDR_LEN);
+}
+
+/* Find a beacon; Eddystone-URL beacons and telemetry frames are matched by address */
+static int beacon_find(const beacon_frame_t *frame, const bd_address_t *address)
+{
+        for (int i = 0; i < BEACON_MAX; i++) {
+                const beacon_t *beacon = &tracking.beacons[i];
+
+                if (!tracking.used[i]) {
+                        continue;
+                }
+
+                if (frame->tlm) {
+                        if ((beacon->type != BEACON_TYPE_IBEACON) && address_equal(&beacon->address, address)) {
+                                return i;
+                        }
+                } else if (beacon->type == frame->type) {
+                        if ((frame->type == BEACON_TYPE_EDDYSTONE_URL) ?
+                                        address_equal(&beacon->address, address) :
+                                        !memcmp(beacon->id, frame->id, sizeof(frame->id))) {
+                                return i;
+                        }
+                }
+        }
+        return -1;
+}
+
+static void report_event(const beacon_t *beacon, beacon_event_t event, beacon_event_cb_t cb)
+{
+        tracking.events++;
+        if (cb) {
+                cb(beacon, event);
+        }
+}
+
+static void beacon_track(int idx, const beacon_frame_t *frame, const ble_evt_gap_adv_report_t *evt,
+                                                        uint32_t timestamp_ms, beacon_event_cb_t cb)
+{
+        beacon_t *beacon = &tracking.beacons[idx];
+
+        if (!tracking.used[idx]) {
+                memset(beacon, 0, sizeof(*beacon));
+                beacon->type = frame->type;
+                memcpy(beacon->id, frame->id, sizeof(frame->id));
+                beacon->rssi_x16 = evt->rssi * 16;
+                tracking.used[idx] = true;
+        } else {
+                /* Exponentially weighted moving average */
+                beacon->rssi_x16 += (evt->rssi * 16 - beacon->rssi_x16) >> BEACON_RSSI_EWMA_SHIFT;
+        }
+
+        beacon->address = evt->address;
+        beacon->tx_power = frame->tx_power;
+        beacon->last_seen_ms = timestamp_ms;
+        beacon->count++;
+        beacon->distance_cm = estimate_distance(beacon->tx_power, beacon->rssi_x16);
+
+        if (!beacon->entered) {
+                if (beacon->count < BEACON_ENTER_REPORTS) {
+                        return;
+                }
+                beacon->entered = true;
+                beacon->near = (beacon->distance_cm < BEACON_NEAR_CM);
+                report_event(beacon, BEACON_EVENT_ENTER, cb);
+                report_event(beacon, beacon->near ? BEACON_EVENT_NEAR : BEACON_EVENT_FAR, cb);
+                return;
+        }
+
+        /* Zone changes only when the distance crosses the threshold of the other zone */
+        if (!beacon->near && (beacon->distance_cm < BEACON_NEAR_CM)) {
+                beacon->near = true;
+                report_event(beacon, BEACON_EVENT_NEAR, cb);
+        } else if (beacon->near && (beacon->distance_cm > BEACON_FAR_CM)) {
+                beacon->near = false;
+                report_event(beacon, BEACON_EVENT_FAR, cb);
+        }
+}
+
+void beacon_clear(void)
+{
+        memset(&tracking, 0, sizeof(tracking));
+}
+
+uint32_t beacon_state_size(void)
+{
+        return sizeof(tracking);
+}
+
+void beacon_save(void *state)
+{
+        memcpy(state, &tracking, sizeof(tracking));
+}
+
+void beacon_restore(const void *state)
+{
+        memcpy(&tracking, state, sizeof(tracking));
+}
+
+bool beacon_update(const ble_evt_gap_adv_report_t *evt, uint32_t timestamp_ms, beacon_event_cb_t cb)
+{
+        bool is_beacon = false;
+        int idx = 0;
+
+        if (!distance_table_ready) {
+                distance_table_init();
+        }
+
+        while (idx + 1 < evt->length) {
+                uint8_t len = evt->data[idx];
+                beacon_frame_t frame;
+                int slot;
+
+                if ((len == 0) || (idx + 1 + len > evt->length)) {
+                        break;
+                }
+
+                if (decode_ad(evt->data[idx + 1], &evt->data[idx + 2], len - 1, &frame)) {
+                        is_beacon = true;
+                        slot = beacon_find(&frame, &evt->address);
+
+                        if (frame.tlm) {
+                                /* Telemetry is kept only for beacons already tracked */
+                                if (slot >= 0) {
+                                        tracking.beacons[slot].battery_mv = frame.battery_mv;
+                                        tracking.beacons[slot].temperature_x256 = frame.temperature_x256;
+                                        tracking.beacons[slot].last_seen_ms = timestamp_ms;
+                                }
+                        } else {
+                                for (int i = 0; (slot < 0) && (i < BEACON_MAX); i++) {
+                                        if (!tracking.used[i]) {
+                                                slot = i;
+                                        }
+                                }
+
+                                if (slot >= 0) {
+                                        beacon_track(slot, &frame, evt, timestamp_ms, cb);
+                                } else {
+                                        tracking.overflows++;
+                                }
+                        }
+                }
+
+                idx += len + 1;
+        }
+
+        if (is_beacon) {
+                tracking.reports++;
+        }
+        return is_beacon;
+}
+
+void beacon_expire(uint32_t timestamp_ms, beacon_event_cb_t cb)
+{
+        for (int i = 0; i < BEACON_MAX; i++) {
+                if (!tracking.used[i] || (timestamp_ms - tracking.beacons[i].last_seen_ms < BEACON_EXIT_TIMEOUT_MS)) {
+                        continue;
+                }
+
+                if (tracking.beacons[i].entered) {
+                        report_event(&tracking.beacons[i], BEACON_EVENT_EXIT, cb);
+                }
+                tracking.used[i] = false;
+        }
+}
+
+void beacon_foreach(void (*cb)(const beacon_t *beacon, void *user_data), void *user_data)
+{
+        for (int i = 0; i < BEACON_MAX; i++) {
+                if (tracking.used[i]) {
+                        cb(&tracking.beacons[i], user_data);
+                }
+        }
+}
+
+void beacon_get_stats(uint32_t *num_of_reports, uint32_t *num_of_events, uint32_t *num_of_overflows)
+{
+        *num_of_reports = tracking.reports;
+        *num_of_events = tracking.events;
+        *num_of_overflows = tracking.overflows;
+}
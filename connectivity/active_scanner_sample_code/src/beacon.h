@@ -0,0 +1,183 @@
+/**
+ ****************************************************************************************
+ *
+ * @file beacon.h
+ *
+ * @brief iBeacon and Eddystone decoding and proximity estimation
+ *
+ * Copyright (C) 2024 Renesas Electronics Corporation and/or its affiliates.
+ * All rights reserved. Confidential Information.
+ *
+ * This software ("Software") is supplied by Renesas Electronics Corporation and/or its
+ * affiliates ("Renesas"). Renesas grants you a personal, non-exclusive, non-transferable,
+ * revocable, non-sub-licensable right and license to use the Software, solely if used in
+ * or together with Renesas products. You may make copies of this Software, provided this
+ * copyright notice and disclaimer ("Notice") is included in all such copies. Renesas
+ * reserves the right to change or discontinue the Software at any time without notice.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS". RENESAS DISCLAIMS ALL WARRANTIES OF ANY KIND,
+ * WHETHER EXPRESS, IMPLIED, OR STATUTORY, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT. TO THE
+ * MAXIMUM EXTENT PERMITTED UNDER LAW, IN NO EVENT SHALL RENESAS BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, SPECIAL, INCIDENTAL OR CONSEQUENTIAL DAMAGES ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE, EVEN IF RENESAS HAS BEEN ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGES. USE OF THIS SOFTWARE MAY BE SUBJECT TO TERMS AND CONDITIONS CONTAINED IN
+ * AN ADDITIONAL AGREEMENT BETWEEN YOU AND RENESAS. IN CASE OF CONFLICT BETWEEN THE TERMS
+ * OF THIS NOTICE AND ANY SUCH ADDITIONAL LICENSE AGREEMENT, THE TERMS OF THE AGREEMENT
+ * SHALL TAKE PRECEDENCE. BY CONTINUING TO USE THIS SOFTWARE, YOU AGREE TO THE TERMS OF
+ * THIS NOTICE.IF YOU DO NOT AGREE TO THESE TERMS, YOU ARE NOT PERMITTED TO USE THIS
+ * SOFTWARE.
+ *
+ ****************************************************************************************
+ */
+
+#ifndef BEACON_H_
+#define BEACON_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "ble_gap.h"
+
+/* Max. number of beacons tracked */
+#ifndef BEACON_MAX
+#define BEACON_MAX                      ( 16 )
+#endif
+
+/*
+ * Weight of a new RSSI sample in the filtered (EWMA) RSSI of a beacon, expressed as a power of
+ * two (3: 1/8)
+ */
+#ifndef BEACON_RSSI_EWMA_SHIFT
+#define BEACON_RSSI_EWMA_SHIFT          ( 3 )
+#endif
+
+/* Path loss exponent, multiplied by 10, used for the distance estimation (20: free space) */
+#ifndef BEACON_PATH_LOSS_EXP_X10
+#define BEACON_PATH_LOSS_EXP_X10        ( 20 )
+#endif
+
+/* Number of reports of a beacon before an enter event is reported */
+#ifndef BEACON_ENTER_REPORTS
+#define BEACON_ENTER_REPORTS            ( 2 )
+#endif
+
+/* Time, expressed in ms, a beacon should not be reported before an exit event is reported */
+#ifndef BEACON_EXIT_TIMEOUT_MS
+#define BEACON_EXIT_TIMEOUT_MS          ( 5000 )
+#endif
+
+/*
+ * Distances, expressed in cm, below which a beacon is considered near and above which it is
+ * considered far. In between, the beacon remains in its previous zone (hysteresis).
+ */
+#ifndef BEACON_NEAR_CM
+#define BEACON_NEAR_CM                  ( 150 )
+#endif
+
+#ifndef BEACON_FAR_CM
+#define BEACON_FAR_CM                   ( 300 )
+#endif
+
+/* Beacon formats */
+typedef enum {
+        BEACON_TYPE_IBEACON,
+        BEACON_TYPE_EDDYSTONE_UID,
+        BEACON_TYPE_EDDYSTONE_URL,
+} beacon_type_t;
+
+/* Beacon events */
+typedef enum {
+        BEACON_EVENT_ENTER,
+        BEACON_EVENT_EXIT,
+        BEACON_EVENT_NEAR,
+        BEACON_EVENT_FAR,
+} beacon_event_t;
+
+/* Tracked beacon */
+typedef struct {
+        beacon_type_t type;
+        bd_address_t address;           /* Address of the latest report */
+
+        /*
+         * Identity: UUID, major and minor (big endian) of iBeacons; namespace and instance of
+         * Eddystone-UID beacons; the address identifies Eddystone-URL beacons.
+         */
+        uint8_t id[20];
+
+        int8_t tx_power;                /* Calibrated RSSI at 1 m */
+        int16_t rssi_x16;               /* Filtered RSSI, multiplied by 16 */
+        uint32_t distance_cm;           /* Estimated distance */
+
+        uint32_t count;                 /* Number of reports */
+        uint32_t last_seen_ms;
+
+        bool entered;
+        bool near;
+
+        /* Latest telemetry (Eddystone-TLM) of Eddystone beacons; 0 if not received */
+        uint16_t battery_mv;
+        int16_t temperature_x256;       /* In 1/256 degrees Celsius */
+} beacon_t;
+
+/* Function called for each beacon event */
+typedef void (*beacon_event_cb_t)(const beacon_t *beacon, beacon_event_t event);
+
+/* Remove all the beacons */
+void beacon_clear(void);
+
+/* Size, in bytes, of the state of the beacon tracking (beacons tracked and statistics) */
+uint32_t beacon_state_size(void);
+
+/*
+ * Save the state of the beacon tracking
+ *
+ * \param [out] state Buffer of beacon_state_size() bytes
+ */
+void beacon_save(void *state);
+
+/*
+ * Restore the state of the beacon tracking
+ *
+ * \param [in] state State saved by beacon_save()
+ */
+void beacon_restore(const void *state);
+
+/*
+ * Process an advertising report. Timestamps are passed explicitly, so that recorded reports
+ * can be replayed.
+ *
+ * \param [in] evt          The advertising report
+ * \param [in] timestamp_ms Time the report was received
+ * \param [in] cb           Function called for the resulting events
+ *
+ * \return True if the report carries a beacon frame
+ */
+bool beacon_update(const ble_evt_gap_adv_report_t *evt, uint32_t timestamp_ms, beacon_event_cb_t cb);
+
+/*
+ * Report exit events for the beacons not reported for BEACON_EXIT_TIMEOUT_MS, and stop tracking
+ * them. It should be called periodically.
+ *
+ * \param [in] timestamp_ms Current time
+ * \param [in] cb           Function called for the resulting events
+ */
+void beacon_expire(uint32_t timestamp_ms, beacon_event_cb_t cb);
+
+/*
+ * Iterate over the beacons tracked.
+ *
+ * \param [in] cb        Function called for each beacon
+ * \param [in] user_data User data passed to \p cb
+ */
+void beacon_foreach(void (*cb)(const beacon_t *beacon, void *user_data), void *user_data);
+
+/*
+ * Get the beacon statistics
+ *
+ * \param [out] num_of_reports  Number of beacon reports processed
+ * \param [out] num_of_events   Number of events reported
+ * \param [out] num_of_overflows Number of reports of beacons that could not be tracked
+ */
+void beacon_get_stats(uint32_t *num_of_reports, uint32_t *num_of_events, uint32_t *num_of_overflows);
+
+#endif /* BEACON_H_ */
@@ -0,0 +1,277 @@
+/**
+ ****************************************************************************************
+ *
+ * @file conn_sched.c
+ *
+ * @brief Multi-target connection scheduler
+ *
+ * Copyright (C) 2024 Renesas Electronics Corporation and/or its affiliates.
+ * All rights reserved. Confidential Information.
+ *
+ * This software ("Software") is supplied by Renesas Electronics Corporation and/or its
+ * affiliates ("Renesas"). Renesas grants you a personal, non-exclusive, non-transferable,
+ * revocable, non-sub-licensable right and license to use the Software, solely if used in
+ * or together with Renesas products. You may make copies of this Software, provided this
+ * copyright notice and disclaimer ("Notice") is included in all such copies. Renesas
+ * reserves the right to change or discontinue the Software at any time without notice.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS". RENESAS DISCLAIMS ALL WARRANTIES OF ANY KIND,
+ * WHETHER EXPRESS, IMPLIED, OR STATUTORY, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT. TO THE
+ * MAXIMUM EXTENT PERMITTED UNDER LAW, IN NO EVENT SHALL RENESAS BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, SPECIAL, INCIDENTAL OR CONSEQUENTIAL DAMAGES ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE, EVEN IF RENESAS HAS BEEN ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGES. USE OF THIS SOFTWARE MAY BE SUBJECT TO TERMS AND CONDITIONS CONTAINED IN
+ * AN ADDITIONAL AGREEMENT BETWEEN YOU AND RENESAS. IN CASE OF CONFLICT BETWEEN THE TERMS
+ * OF THIS NOTICE AND ANY SUCH ADDITIONAL LICENSE AGREEMENT, THE TERMS OF THE AGREEMENT
+ * SHALL TAKE PRECEDENCE. BY CONTINUING TO USE THIS SOFTWARE, YOU AGREE TO THE TERMS OF
+ * THIS NOTICE.IF YOU DO NOT AGREE TO THESE TERMS, YOU ARE NOT PERMITTED TO USE THIS
+ * SOFTWARE.
+ *
+ ****************************************************************************************
+ */
+
+#include <string.h>
+#include "sdk_defs.h"
+#include "ble_common.h"
+#include "misc.h"
+#include "conn_sched.h"
+
+/* Connectable advertising report types (as reported by the controller) */
+#define REPORT_TYPE_ADV_IND             ( 0x00 )
+#define REPORT_TYPE_ADV_DIRECT_IND      ( 0x01 )
+
+#define MAX_TARGETS                     ( CONN_SCHED_MAX_TARGETS < BLE_GAP_MAX_CONNECTED ? \
+                                                CONN_SCHED_MAX_TARGETS : BLE_GAP_MAX_CONNECTED )
+
+typedef enum {
+        TARGET_STATE_PENDING,
+        TARGET_STATE_CONNECTING,
+        TARGET_STATE_CONNECTED,
+} target_state_t;
+
+typedef struct {
+        target_state_t state;
+        bool from_filter;               /* Target matched by the advertising filter */
+        bool bound;                     /* Address known; always set for address targets */
+        bool any_type;                  /* Address type not checked */
+        bd_address_t address;
+        uint16_t conn_idx;
+
+        uint16_t attempts;
+        uint16_t failures;              /* Consecutive failed attempts */
+        uint32_t backoff_ms;
+        uint32_t next_attempt_ms;       /* No attempts before this time */
+        uint32_t connect_time_ms;       /* Time to connect, since scheduling was started */
+} conn_target_t;
+
+__RETAINED static conn_target_t targets[MAX_TARGETS];
+__RETAINED static uint8_t num_of_targets;
+
+__RETAINED static bool sched_active;
+__RETAINED static uint32_t start_ms;
+__RETAINED static uint32_t all_connected_ms;
+__RETAINED static int8_t candidate;
+__RETAINED_RW static int8_t current = -1;       /* Target of the ongoing attempt */
+
+static const char *state_names[] = { "pending", "connecting", "connected" };
+
+static bool address_match(const conn_target_t *target, const bd_address_t *address)
+{
+        return target->bound && (target->any_type || (target->address.addr_type == address->addr_type)) &&
+                                        !memcmp(target->address.addr, address->addr, BD_ADDR_LEN);
+}
+
+bool conn_sched_add_address(const bd_address_t *address, bool any_type)
+{
+        conn_target_t *target;
+
+        if (sched_active || (num_of_targets == MAX_TARGETS)) {
+                return false;
+        }
+
+        target = &targets[num_of_targets++];
+        memset(target, 0, sizeof(*target));
+        target->bound = true;
+        target->any_type = any_type;
+        target->address = *address;
+        target->conn_idx = BLE_CONN_IDX_INVALID;
+
+        return true;
+}
+
+uint8_t conn_sched_add_filter(uint8_t count)
+{
+        uint8_t added = 0;
+
+        while (!sched_active && (added < count) && (num_of_targets < MAX_TARGETS)) {
+                conn_target_t *target = &targets[num_of_targets++];
+
+                memset(target, 0, sizeof(*target));
+                target->from_filter = true;
+                target->conn_idx = BLE_CONN_IDX_INVALID;
+                added++;
+        }
+        return added;
+}
+
+void conn_sched_clear(void)
+{
+        num_of_targets = 0;
+        sched_active = false;
+        current = -1;
+}
+
+bool conn_sched_start(uint32_t timestamp_ms)
+{
+        bool pending = false;
+
+        for (int i = 0; i < num_of_targets; i++) {
+                if (targets[i].state == TARGET_STATE_PENDING) {
+                        targets[i].failures = 0;
+                        targets[i].backoff_ms = 0;
+                        targets[i].next_attempt_ms = timestamp_ms;
+                        pending = true;
+                }
+        }
+
+        if (pending) {
+                sched_active = true;
+                start_ms = timestamp_ms;
+                current = -1;
+        }
+        return pending;
+}
+
+bool conn_sched_is_active(void)
+{
+        return sched_active;
+}
+
+bool conn_sched_is_candidate(const ble_evt_gap_adv_report_t *evt, bool filter_match, uint32_t timestamp_ms)
+{
+        if (!sched_active || (current >= 0) ||
+                ((evt->type != REPORT_TYPE_ADV_IND) && (evt->type != REPORT_TYPE_ADV_DIRECT_IND))) {
+                return false;
+        }
+
+        /* A known target; it is connected only if pending and not in backoff */
+        for (int i = 0; i < num_of_targets; i++) {
+                if (address_match(&targets[i], &evt->address)) {
+                        if ((targets[i].state != TARGET_STATE_PENDING) ||
+                                        ((int32_t)(timestamp_ms - targets[i].next_attempt_ms) < 0)) {
+                                return false;
+                        }
+                        candidate = i;
+                        return true;
+                }
+        }
+
+        if (!filter_match) {
+                return false;
+        }
+
+        /* A new device passing the filter takes the first free filter target */
+        for (int i = 0; i < num_of_targets; i++) {
+                if (targets[i].from_filter && !targets[i].bound) {
+                        candidate = i;
+                        return true;
+                }
+        }
+        return false;
+}
+
+void conn_sched_attempt_started(const bd_address_t *address, uint32_t timestamp_ms)
+{
+        conn_target_t *target = &targets[candidate];
+
+        if (!target->bound) {
+                target->bound = true;
+                target->address = *address;
+        }
+
+        target->state = TARGET_STATE_CONNECTING;
+        target->attempts++;
+        current = candidate;
+}
+
+bool conn_sched_connected(uint16_t conn_idx, uint32_t timestamp_ms)
+{
+        if (current < 0) {
+                return false;
+        }
+
+        targets[current].state = TARGET_STATE_CONNECTED;
+        targets[current].conn_idx = conn_idx;
+        targets[current].connect_time_ms = timestamp_ms - start_ms;
+        targets[current].failures = 0;
+        current = -1;
+
+        for (int i = 0; i < num_of_targets; i++) {
+                if (targets[i].state != TARGET_STATE_CONNECTED) {
+                        return false;
+                }
+        }
+
+        sched_active = false;
+        all_connected_ms = timestamp_ms - start_ms;
+
+        return true;
+}
+
+void conn_sched_attempt_failed(uint32_t timestamp_ms)
+{
+        conn_target_t *target;
+
+        if (current < 0) {
+                return;
+        }
+
+        target = &targets[current];
+        target->state = TARGET_STATE_PENDING;
+        target->failures++;
+        target->backoff_ms = target->backoff_ms ? MIN(target->backoff_ms * 2, CONN_SCHED_BACKOFF_MAX_MS) :
+                                                                                CONN_SCHED_BACKOFF_MIN_MS;
+        target->next_attempt_ms = timestamp_ms + target->backoff_ms;
+
+        /* Give other devices passing the filter a chance */
+        if (target->from_filter && (target->failures >= CONN_SCHED_FILTER_MAX_FAILURES)) {
+                target->bound = false;
+                target->failures = 0;
+                target->backoff_ms = 0;
+        }
+
+        current = -1;
+}
+
+void conn_sched_disconnected(uint16_t conn_idx)
+{
+        for (int i = 0; i < num_of_targets; i++) {
+                if ((targets[i].state == TARGET_STATE_CONNECTED) && (targets[i].conn_idx == conn_idx)) {
+                        targets[i].state = TARGET_STATE_PENDING;
+                        targets[i].conn_idx = BLE_CONN_IDX_INVALID;
+                }
+        }
+}
+
+void conn_sched_print(void)
+{
+        uint8_t num_of_connected = 0;
+
+        for (int i = 0; i < num_of_targets; i++) {
+                const conn_target_t *target = &targets[i];
+
+                DBG_LOG("Target %d: %s%s, %s, Attempts = %d", i, target->from_filter ? "filter " : "",
+                        target->bound ? ble_address_to_string(&target->address) : "(any)",
+                        state_names[target->state], target->attempts);
+                if (target->state == TARGET_STATE_CONNECTED) {
+                        DBG_LOG(", Time to connect = %lu ms", target->connect_time_ms);
+                        num_of_connected++;
+                }
+                DBG_LOG("\n\r");
+        }
+
+        if (num_of_targets && (num_of_connected == num_of_targets) && !sched_active) {
+                DBG_LOG("All %d targets connected in %lu ms\n\r", num_of_targets, all_connected_ms);
+        }
+}
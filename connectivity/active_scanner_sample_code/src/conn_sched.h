@@ -0,0 +1,141 @@
+/**
+ ****************************************************************************************
+ *
+ * @file conn_sched.h
+ *
+ * @brief Multi-target connection scheduler
+ *
+ * Copyright (C) 2024 Renesas Electronics Corporation and/or its affiliates.
+ * All rights reserved. Confidential Information.
+ *
+ * This software ("Software") is supplied by Renesas Electronics Corporation and/or its
+ * affiliates ("Renesas"). Renesas grants you a personal, non-exclusive, non-transferable,
+ * revocable, non-sub-licensable right and license to use the Software, solely if used in
+ * or together with Renesas products. You may make copies of this Software, provided this
+ * copyright notice and disclaimer ("Notice") is included in all such copies. Renesas
+ * reserves the right to change or discontinue the Software at any time without notice.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS". RENESAS DISCLAIMS ALL WARRANTIES OF ANY KIND,
+ * WHETHER EXPRESS, IMPLIED, OR STATUTORY, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT. TO THE
+ * MAXIMUM EXTENT PERMITTED UNDER LAW, IN NO EVENT SHALL RENESAS BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, SPECIAL, INCIDENTAL OR CONSEQUENTIAL DAMAGES ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE, EVEN IF RENESAS HAS BEEN ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGES. USE OF THIS SOFTWARE MAY BE SUBJECT TO TERMS AND CONDITIONS CONTAINED IN
+ * AN ADDITIONAL AGREEMENT BETWEEN YOU AND RENESAS. IN CASE OF CONFLICT BETWEEN THE TERMS
+ * OF THIS NOTICE AND ANY SUCH ADDITIONAL LICENSE AGREEMENT, THE TERMS OF THE AGREEMENT
+ * SHALL TAKE PRECEDENCE. BY CONTINUING TO USE THIS SOFTWARE, YOU AGREE TO THE TERMS OF
+ * THIS NOTICE.IF YOU DO NOT AGREE TO THESE TERMS, YOU ARE NOT PERMITTED TO USE THIS
+ * SOFTWARE.
+ *
+ ****************************************************************************************
+ */
+
+#ifndef CONN_SCHED_H_
+#define CONN_SCHED_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "ble_gap.h"
+
+/*
+ * Connections are established to a list of targets, each one either a device address or any
+ * device passing the advertising filter (see adv_filter.h). Scanning and connecting are
+ * interleaved: scanning is stopped when a connectable report of a pending target is received, a
+ * connection is attempted and scanning is resumed once the attempt completes. Failed attempts
+ * are retried after a backoff time, doubled after each failure.
+ */
+
+/* Max. number of targets (limited to BLE_GAP_MAX_CONNECTED) */
+#ifndef CONN_SCHED_MAX_TARGETS
+#define CONN_SCHED_MAX_TARGETS                  ( 8 )
+#endif
+
+/* Time, expressed in ms, after which a connection attempt is canceled */
+#ifndef CONN_SCHED_ATTEMPT_TIMEOUT_MS
+#define CONN_SCHED_ATTEMPT_TIMEOUT_MS           ( 3000 )
+#endif
+
+/* Backoff time, expressed in ms, after the first failed attempt to a target */
+#ifndef CONN_SCHED_BACKOFF_MIN_MS
+#define CONN_SCHED_BACKOFF_MIN_MS               ( 500 )
+#endif
+
+/* Max. backoff time, expressed in ms */
+#ifndef CONN_SCHED_BACKOFF_MAX_MS
+#define CONN_SCHED_BACKOFF_MAX_MS               ( 8000 )
+#endif
+
+/*
+ * Number of failed attempts after which a device matched by the advertising filter is released,
+ * so that another matching device can be connected instead
+ */
+#ifndef CONN_SCHED_FILTER_MAX_FAILURES
+#define CONN_SCHED_FILTER_MAX_FAILURES          ( 3 )
+#endif
+
+/*
+ * Add a target device.
+ *
+ * \param [in] address  Device address
+ * \param [in] any_type If set, the address type is not checked
+ *
+ * \return True if the target was added
+ */
+bool conn_sched_add_address(const bd_address_t *address, bool any_type);
+
+/*
+ * Add targets matched by the advertising filter.
+ *
+ * \param [in] count Number of devices to be connected
+ *
+ * \return The number of targets added
+ */
+uint8_t conn_sched_add_filter(uint8_t count);
+
+/* Remove all targets. It should not be called while connecting. */
+void conn_sched_clear(void);
+
+/*
+ * Start connecting to the pending targets
+ *
+ * \param [in] timestamp_ms Current time
+ *
+ * \return False if there are no pending targets
+ */
+bool conn_sched_start(uint32_t timestamp_ms);
+
+/* Check whether the scheduler is active, i.e. not all of the targets are connected yet */
+bool conn_sched_is_active(void);
+
+/*
+ * Check whether a report belongs to a pending target, not in backoff, that can be connected
+ *
+ * \param [in] evt          The advertising report
+ * \param [in] filter_match True if the report passed the advertising filter
+ * \param [in] timestamp_ms Current time
+ *
+ * \return True if a connection should be attempted to the device
+ */
+bool conn_sched_is_candidate(const ble_evt_gap_adv_report_t *evt, bool filter_match, uint32_t timestamp_ms);
+
+/* A connection attempt is started to the device of a report accepted by conn_sched_is_candidate() */
+void conn_sched_attempt_started(const bd_address_t *address, uint32_t timestamp_ms);
+
+/*
+ * The device of the current attempt has been connected.
+ *
+ * \return True if all of the targets are now connected
+ */
+bool conn_sched_connected(uint16_t conn_idx, uint32_t timestamp_ms);
+
+/* The current attempt has failed or has been canceled */
+void conn_sched_attempt_failed(uint32_t timestamp_ms);
+
+/* A device has been disconnected; its target becomes pending again */
+void conn_sched_disconnected(uint16_t conn_idx);
+
+/* Print the targets and the time to connect each of them */
+void conn_sched_print(void);
+
+#endif /* CONN_SCHED_H_ */
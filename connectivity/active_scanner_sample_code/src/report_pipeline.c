@@ -0,0 +1,304 @@
+/**
+ ****************************************************************************************
+ *
+ * @file report_pipeline.c
+ *
+ * @brief Advertising report processing pipeline
+ *
+ * Copyright (C) 2024 Renesas Electronics Corporation and/or its affiliates.
+ * All rights reserved. Confidential Information.
+ *
+ * This software ("Software") is supplied by Renesas Electronics Corporation and/or its
+ * affiliates ("Renesas"). Renesas grants you a personal, non-exclusive, non-transferable,
+ * revocable, non-sub-licensable right and license to use the Software, solely if used in
+ * or together with Renesas products. You may make copies of this Software, provided this
+ * copyright notice and disclaimer ("Notice") is included in all such copies. Renesas
+ * reserves the right to change or discontinue the Software at any time without notice.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS". RENESAS DISCLAIMS ALL WARRANTIES OF ANY KIND,
+ * WHETHER EXPRESS, IMPLIED, OR STATUTORY, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT. TO THE
+ * MAXIMUM EXTENT PERMITTED UNDER LAW, IN NO EVENT SHALL RENESAS BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, SPECIAL, INCIDENTAL OR CONSEQUENTIAL DAMAGES ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE, EVEN IF RENESAS HAS BEEN ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGES. USE OF THIS SOFTWARE MAY BE SUBJECT TO TERMS AND CONDITIONS CONTAINED IN
+ * AN ADDITIONAL AGREEMENT BETWEEN YOU AND RENESAS. IN CASE OF CONFLICT BETWEEN THE TERMS
+ * OF THIS NOTICE AND ANY SUCH ADDITIONAL LICENSE AGREEMENT, THE TERMS OF THE AGREEMENT
+ * SHALL TAKE PRECEDENCE. BY CONTINUING TO USE THIS SOFTWARE, YOU AGREE TO THE TERMS OF
+ * THIS NOTICE.IF YOU DO NOT AGREE TO THESE TERMS, YOU ARE NOT PERMITTED TO USE THIS
+ * SOFTWARE.
+ *
+ ****************************************************************************************
+ */
+
+#include <stdarg.h>
+#include <stdio.h>
+#include "sdk_defs.h"
+#include "osal.h"
+#include "ble_common.h"
+#include "misc.h"
+#include "adv_cache.h"
+#include "beacon.h"
+#include "scan_sched.h"
+#include "scan_stream.h"
+#include "report_pipeline.h"
+
+__RETAINED static bool beacon_mode;
+__RETAINED static bool replay;
+
+__RETAINED static uint32_t reports_processed;
+__RETAINED static uint32_t reports_output;
+
+/* State of the scanning session, saved in replay mode */
+typedef struct {
+        uint32_t reports_processed;
+        uint32_t reports_output;
+        uint8_t *beacons;
+        uint8_t adv_cache[];
+} saved_state_t;
+
+__RETAINED static saved_state_t *saved_state;
+
+#if DBG_LOG_ENABLE
+/* Replay mode output */
+__RETAINED static char scratch[64];
+#endif
+
+/* Output formatted text; it is discarded in replay mode, once formatted */
+static void output(const char *format, ...)
+{
+#if DBG_LOG_ENABLE
+        va_list args;
+
+        va_start(args, format);
+        if (replay) {
+                vsnprintf(scratch, sizeof(scratch), format, args);
+        } else {
+                vprintf(format, args);
+        }
+        va_end(args);
+#endif
+}
+
+static void print_beacon(const beacon_t *beacon)
+{
+        if (beacon->type == BEACON_TYPE_IBEACON) {
+                output("iBeacon ");
+                for (int i = 0; i < 16; i++) {
+                        output("%02X", beacon->id[i]);
+                }
+                output(" %d/%d", (beacon->id[16] << 8) | beacon->id[17], (beacon->id[18] << 8) | beacon->id[19]);
+        } else if (beacon->type == BEACON_TYPE_EDDYSTONE_UID) {
+                output("Eddystone-UID ");
+                for (int i = 0; i < 16; i++) {
+                        output("%02X%s", beacon->id[i], i == 9 ? "/" : "");
+                }
+        } else {
+                output("Eddystone-URL %s", ble_address_to_string(&beacon->address));
+        }
+
+        output(", RSSI = %d, Distance = %lu cm", beacon->rssi_x16 / 16, beacon->distance_cm);
+}
+
+static void print_beacon_event(const beacon_t *beacon, beacon_event_t event)
+{
+        static const char *event_names[] = { "Enter", "Exit", "Near", "Far" };
+
+        output("%s: ", event_names[event]);
+        print_beacon(beacon);
+        output("\n\r");
+}
+
+static void print_report(const ble_evt_gap_adv_report_t *evt, adv_cache_status_t status)
+{
+        int tlv_idx = 0;
+        int data_idx = 0;
+
+        output("\n\r****** BD address = %s (%s), RSSI = %d *******\n\r", ble_address_to_string(&evt->address),
+                status == ADV_CACHE_STATUS_NEW ? "new" : "changed", evt->rssi);
+
+        /* Process TLVs */
+        while (tlv_idx + 2 < evt->length) {
+                /*
+                 * The 1st byte should reflect the number of bytes that follow for the specific data type.
+                 * The 2nd byte should reflect the data type (should be interpreted using the gap_data_type_t enumerator).
+                 */
+                output("\n\r[%d]. Length = %d, Type = %d, Data = ", data_idx, evt->data[tlv_idx], evt->data[tlv_idx + 1]);
+
+                for (int i = 1; (i < evt->data[tlv_idx]) && (tlv_idx + 1 + i < evt->length); i++) {
+                        output("0x%02X ", evt->data[tlv_idx + 1 + i]);
+                }
+                output("\n\r");
+
+                data_idx++;
+                tlv_idx += (evt->data[tlv_idx] + 1); // go to the next TLV
+        }
+}
+
+void report_pipeline_clear(void)
+{
+        adv_cache_clear();
+        beacon_clear();
+
+        reports_processed = 0;
+        reports_output = 0;
+}
+
+void report_pipeline_set_beacon_mode(bool enable)
+{
+        beacon_mode = enable;
+}
+
+bool report_pipeline_get_beacon_mode(void)
+{
+        return beacon_mode;
+}
+
+bool report_pipeline_set_replay(bool enable)
+{
+        uint32_t adv_cache_size = adv_cache_state_size();
+
+        if (enable == replay) {
+                return true;
+        }
+
+        if (enable) {
+                saved_state = OS_MALLOC(sizeof(saved_state_t) + adv_cache_size + beacon_state_size());
+                if (!saved_state) {
+                        return false;
+                }
+
+                saved_state->reports_processed = reports_processed;
+                saved_state->reports_output = reports_output;
+                saved_state->beacons = &saved_state->adv_cache[adv_cache_size];
+                adv_cache_save(saved_state->adv_cache);
+                beacon_save(saved_state->beacons);
+
+                report_pipeline_clear();
+        } else {
+                reports_processed = saved_state->reports_processed;
+                reports_output = saved_state->reports_output;
+                adv_cache_restore(saved_state->adv_cache);
+                beacon_restore(saved_state->beacons);
+
+                OS_FREE(saved_state);
+                saved_state = NULL;
+        }
+
+        replay = enable;
+        return true;
+}
+
+void report_pipeline_process(const ble_evt_gap_adv_report_t *evt, uint32_t timestamp_ms)
+{
+        adv_cache_status_t status;
+
+        reports_processed++;
+
+        /* Devices already reported with the same payload are not displayed again */
+        status = adv_cache_update(evt, timestamp_ms, NULL);
+
+        /* Replayed reports are not part of the scanning session */
+        if (!replay) {
+                scan_sched_report(evt, status, timestamp_ms);
+        }
+
+        /* In beacon mode only proximity events are displayed */
+        if (beacon_mode) {
+                beacon_update(evt, timestamp_ms, print_beacon_event);
+                return;
+        }
+
+        /* When streaming, all reports are sent to the host, in binary format, instead of being displayed */
+        if (scan_stream_is_active() && !replay) {
+                if (scan_stream_report(evt, timestamp_ms)) {
+                        reports_output++;
+                }
+                return;
+        }
+
+        if (status == ADV_CACHE_STATUS_SEEN) {
+                return;
+        }
+
+        reports_output++;
+        print_report(evt, status);
+}
+
+void report_pipeline_tick(uint32_t timestamp_ms)
+{
+        if (beacon_mode) {
+                beacon_expire(timestamp_ms, print_beacon_event);
+        }
+}
+
+void report_pipeline_get_stats(uint32_t *num_of_reports, uint32_t *num_of_reports_output)
+{
+        *num_of_reports = reports_processed;
+        *num_of_reports_output = reports_output;
+
+        /* In beacon mode, events are output instead of reports */
+        if (beacon_mode) {
+                uint32_t num_of_beacon_reports, num_of_overflows;
+
+                beacon_get_stats(&num_of_beacon_reports, num_of_reports_output, &num_of_overflows);
+        }
+}
+
+void report_pipeline_print_stats(uint32_t duration_ms)
+{
+        uint16_t num_of_devices;
+        uint32_t num_of_evictions, num_of_overflows;
+        uint32_t num_of_reports, num_of_output;
+
+        adv_cache_get_stats(&num_of_devices, &num_of_evictions);
+        DBG_LOG("Devices tracked: %d, Devices evicted: %lu\n\r", num_of_devices, num_of_evictions);
+
+        report_pipeline_get_stats(&num_of_reports, &num_of_output);
+        DBG_LOG("Reports received: %lu, output (%s): %lu, Output per second: %lu\n\r",
+                num_of_reports, beacon_mode ? "beacon events" : scan_stream_is_active() ? "stream" : "text",
+                num_of_output, duration_ms ? (uint32_t)((uint64_t)num_of_output * 1000 / duration_ms) : 0);
+
+        if (beacon_mode) {
+                uint32_t num_of_beacon_reports, num_of_events;
+
+                beacon_get_stats(&num_of_beacon_reports, &num_of_events, &num_of_overflows);
+                DBG_LOG("Beacon reports: %lu, Beacons not tracked: %lu\n\r", num_of_beacon_reports,
+                                                                                num_of_overflows);
+        }
+}
+
+static void print_device(const adv_cache_entry_t *entry, void *user_data)
+{
+        DBG_LOG("%s, Reports = %lu, RSSI min/avg/max = %d/%ld/%d, First seen = %lu ms, Last seen = %lu ms\n\r",
+                ble_address_to_string(&entry->address), entry->count, entry->rssi_min,
+                entry->rssi_sum / (int32_t)entry->count, entry->rssi_max,
+                (unsigned long)entry->first_seen_ms, (unsigned long)entry->last_seen_ms);
+}
+
+void report_pipeline_print_devices(void)
+{
+        uint16_t num_of_devices;
+        uint32_t num_of_evictions;
+
+        adv_cache_foreach(print_device, NULL);
+
+        adv_cache_get_stats(&num_of_devices, &num_of_evictions);
+        DBG_LOG("Devices tracked: %d, Devices evicted: %lu\n\r", num_of_devices, num_of_evictions);
+}
+
+static void print_beacon_entry(const beacon_t *beacon, void *user_data)
+{
+        print_beacon(beacon);
+        output(", Zone = %s, Reports = %lu", beacon->near ? "near" : "far", beacon->count);
+        if (beacon->battery_mv) {
+                output(", Battery = %d mV, Temperature = %d C", beacon->battery_mv,
+                                                                beacon->temperature_x256 / 256);
+        }
+        output("\n\r");
+}
+
+void report_pipeline_print_beacons(void)
+{
+        beacon_foreach(print_beacon_entry, NULL);
+}
@@ -0,0 +1,101 @@
+/**
+ ****************************************************************************************
+ *
+ * @file report_pipeline.h
+ *
+ * @brief Advertising report processing pipeline
+ *
+ * Copyright (C) 2024 Renesas Electronics Corporation and/or its affiliates.
+ * All rights reserved. Confidential Information.
+ *
+ * This software ("Software") is supplied by Renesas Electronics Corporation and/or its
+ * affiliates ("Renesas"). Renesas grants you a personal, non-exclusive, non-transferable,
+ * revocable, non-sub-licensable right and license to use the Software, solely if used in
+ * or together with Renesas products. You may make copies of this Software, provided this
+ * copyright notice and disclaimer ("Notice") is included in all such copies. Renesas
+ * reserves the right to change or discontinue the Software at any time without notice.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS". RENESAS DISCLAIMS ALL WARRANTIES OF ANY KIND,
+ * WHETHER EXPRESS, IMPLIED, OR STATUTORY, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT. TO THE
+ * MAXIMUM EXTENT PERMITTED UNDER LAW, IN NO EVENT SHALL RENESAS BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, SPECIAL, INCIDENTAL OR CONSEQUENTIAL DAMAGES ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE, EVEN IF RENESAS HAS BEEN ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGES. USE OF THIS SOFTWARE MAY BE SUBJECT TO TERMS AND CONDITIONS CONTAINED IN
+ * AN ADDITIONAL AGREEMENT BETWEEN YOU AND RENESAS. IN CASE OF CONFLICT BETWEEN THE TERMS
+ * OF THIS NOTICE AND ANY SUCH ADDITIONAL LICENSE AGREEMENT, THE TERMS OF THE AGREEMENT
+ * SHALL TAKE PRECEDENCE. BY CONTINUING TO USE THIS SOFTWARE, YOU AGREE TO THE TERMS OF
+ * THIS NOTICE.IF YOU DO NOT AGREE TO THESE TERMS, YOU ARE NOT PERMITTED TO USE THIS
+ * SOFTWARE.
+ *
+ ****************************************************************************************
+ */
+
+#ifndef REPORT_PIPELINE_H_
+#define REPORT_PIPELINE_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "ble_gap.h"
+
+/*
+ * Processing of the advertising reports that passed the advertising filter: deduplication
+ * (adv_cache.h), scan scheduler accounting (scan_sched.h) and output, either as text, as a binary
+ * stream (scan_stream.h) or as beacon events (beacon.h). The pipeline does not depend on the
+ * BLE manager or the OS tick count (timestamps are passed explicitly), so that recorded or
+ * synthetic reports can be replayed through it (report_replay.h).
+ */
+
+/* Clear the devices and beacons tracked and the report counters */
+void report_pipeline_clear(void);
+
+/* Enable or disable the beacon mode, where only beacon events are output */
+void report_pipeline_set_beacon_mode(bool enable);
+
+/* Check whether the beacon mode is enabled */
+bool report_pipeline_get_beacon_mode(void);
+
+/*
+ * Enable or disable the replay mode, where reports are processed in isolation from the scanning
+ * session. Enabling it saves (on the heap) and clears the devices and beacons tracked and the
+ * report counters; disabling it restores them. In replay mode the scan scheduler is not accounted,
+ * reports are not streamed and the text output is formatted into memory but not displayed, so
+ * that the processing cost can be measured without the console.
+ *
+ * \param [in] enable True to enable the replay mode
+ *
+ * \return False if the replay mode could not be enabled, as the heap is exhausted
+ */
+bool report_pipeline_set_replay(bool enable);
+
+/*
+ * Process an advertising report that passed the advertising filter
+ *
+ * \param [in] evt          The advertising report
+ * \param [in] timestamp_ms Time the report was received
+ */
+void report_pipeline_process(const ble_evt_gap_adv_report_t *evt, uint32_t timestamp_ms);
+
+/* Periodic processing (beacon exit events). It should be called at least once per second. */
+void report_pipeline_tick(uint32_t timestamp_ms);
+
+/*
+ * Get the number of reports processed and output (displayed, streamed or resulting in beacon
+ * events)
+ */
+void report_pipeline_get_stats(uint32_t *num_of_reports, uint32_t *num_of_reports_output);
+
+/*
+ * Print the statistics of a scanning session
+ *
+ * \param [in] duration_ms Duration of the session
+ */
+void report_pipeline_print_stats(uint32_t duration_ms);
+
+/* Print the devices tracked */
+void report_pipeline_print_devices(void);
+
+/* Print the beacons tracked */
+void report_pipeline_print_beacons(void);
+
+#endif /* REPORT_PIPELINE_H_ */
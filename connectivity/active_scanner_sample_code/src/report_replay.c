@@ -0,0 +1,416 @@
+/**
+ ****************************************************************************************
+ *
+ * @file report_replay.c
+ *
+ * @brief Replay of recorded or synthetic advertising reports
+ *
+ * Copyright (C) 2024 Renesas Electronics Corporation and/or its affiliates.
+ * All rights reserved. Confidential Information.
+ *
+ * This software ("Software") is supplied by Renesas Electronics Corporation and/or its
+ * affiliates ("Renesas"). Renesas grants you a personal, non-exclusive, non-transferable,
+ * revocable, non-sub-licensable right and license to use the Software, solely if used in
+ * or together with Renesas products. You may make copies of this Software, provided this
+ * copyright notice and disclaimer ("Notice") is included in all such copies. Renesas
+ * reserves the right to change or discontinue the Software at any time without notice.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS". RENESAS DISCLAIMS ALL WARRANTIES OF ANY KIND,
+ * WHETHER EXPRESS, IMPLIED, OR STATUTORY, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT. TO THE
+ * MAXIMUM EXTENT PERMITTED UNDER LAW, IN NO EVENT SHALL RENESAS BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, SPECIAL, INCIDENTAL OR CONSEQUENTIAL DAMAGES ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE, EVEN IF RENESAS HAS BEEN ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGES. USE OF THIS SOFTWARE MAY BE SUBJECT TO TERMS AND CONDITIONS CONTAINED IN
+ * AN ADDITIONAL AGREEMENT BETWEEN YOU AND RENESAS. IN CASE OF CONFLICT BETWEEN THE TERMS
+ * OF THIS NOTICE AND ANY SUCH ADDITIONAL LICENSE AGREEMENT, THE TERMS OF THE AGREEMENT
+ * SHALL TAKE PRECEDENCE. BY CONTINUING TO USE THIS SOFTWARE, YOU AGREE TO THE TERMS OF
+ * THIS NOTICE.IF YOU DO NOT AGREE TO THESE TERMS, YOU ARE NOT PERMITTED TO USE THIS
+ * SOFTWARE.
+ *
+ ****************************************************************************************
+ */
+
+#include <string.h>
+#include "sdk_defs.h"
+#include "osal.h"
+#include "adv_cache.h"
+#include "adv_filter.h"
+#include "beacon.h"
+#include "scan_stream.h"
+#include "report_pipeline.h"
+#include "report_replay.h"
+
+#if REPORT_REPLAY_EN
+
+#if REPORT_REPLAY_TRACE
+/* Defines replay_trace[], an array of report_replay_record_t */
+#include "replay_trace.h"
+#endif
+
+#define REPORT_TYPE_ADV_IND             ( 0x00 )
+#define REPORT_TYPE_ADV_SCAN_IND        ( 0x02 )
+#define REPORT_TYPE_ADV_NONCONN_IND     ( 0x03 )
+#define REPORT_TYPE_SCAN_RSP            ( 0x04 )
+
+#define AD_TYPE_SERVICE_DATA_UUID16     ( 0x16 )
+
+/* Kinds of synthetic advertisers */
+typedef enum {
+        SYNTHETIC_GENERIC,
+        SYNTHETIC_IBEACON,
+        SYNTHETIC_EDDYSTONE_UID,
+        SYNTHETIC_SCANNABLE,
+        SYNTHETIC_KINDS,
+} synthetic_kind_t;
+
+/* Number of reports after which the payloads of the synthetic advertisers change */
+#define SYNTHETIC_PAYLOAD_PERIOD        ( 1024 )
+
+/*
+ * Replay state. Time is virtual and expressed in CPU cycles: reports arrive at their replay time
+ * and are processed once the previous report has been processed.
+ */
+typedef struct {
+        report_replay_result_t *result;
+        uint64_t busy_until;            /* Time the previous report was processed */
+        uint64_t next_tick;             /* Time of the next periodic processing */
+        uint64_t cycles;                /* Total cycles spent on reports */
+        size_t free_heap;               /* Free heap size before the replay */
+} replay_t;
+
+__RETAINED static replay_t replay;
+
+static bool replay_begin(report_replay_result_t *result)
+{
+        memset(result, 0, sizeof(*result));
+        memset(&replay, 0, sizeof(replay));
+
+        /* The state of the scanning session is saved, so it is not affected by the replay */
+        if (!report_pipeline_set_replay(true)) {
+                return false;
+        }
+
+        replay.result = result;
+        replay.next_tick = SystemCoreClock;
+        replay.free_heap = OS_GET_FREE_HEAP_SIZE();
+
+        CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+        DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
+        return true;
+}
+
+/* Replay a report arriving at time arrival (in cycles) */
+static void replay_report(const ble_evt_gap_adv_report_t *evt, uint64_t arrival)
+{
+        report_replay_result_t *result = replay.result;
+        uint32_t cycles_per_ms = SystemCoreClock / 1000;
+        uint64_t start_time;
+        uint32_t start, cycles;
+        bool match;
+
+        /* Periodic processing, once per second; it delays the reports that follow */
+        while (arrival >= replay.next_tick) {
+                start = DWT->CYCCNT;
+                report_pipeline_tick((uint32_t)(replay.next_tick / cycles_per_ms));
+                cycles = DWT->CYCCNT - start;
+
+                replay.busy_until = MAX(replay.busy_until, replay.next_tick) + cycles;
+                replay.next_tick += SystemCoreClock;
+        }
+
+        /* The report waits while a previous one is being processed */
+        start_time = MAX(arrival, replay.busy_until);
+        if (start_time > arrival) {
+                uint32_t delay_us = (uint32_t)((start_time - arrival) * 1000 / cycles_per_ms);
+
+                result->num_of_late++;
+                result->max_delay_us = MAX(result->max_delay_us, delay_us);
+        }
+
+        start = DWT->CYCCNT;
+        match = adv_filter_match(evt);
+        if (match) {
+                report_pipeline_process(evt, (uint32_t)(arrival / cycles_per_ms));
+        }
+        cycles = DWT->CYCCNT - start;
+
+        replay.busy_until = start_time + cycles;
+        replay.cycles += cycles;
+
+        result->num_of_reports++;
+        result->cycles_max = MAX(result->cycles_max, cycles);
+        if (match) {
+                result->num_of_matches++;
+        }
+}
+
+static void replay_end(void)
+{
+        report_replay_result_t *result = replay.result;
+        uint32_t num_of_reports;
+
+        report_pipeline_get_stats(&num_of_reports, &result->num_of_output);
+
+        if (result->num_of_reports) {
+                result->cycles_avg = (uint32_t)(replay.cycles / result->num_of_reports);
+        }
+        result->max_rate = result->cycles_avg ? (SystemCoreClock / result->cycles_avg) : 0;
+
+        /* Devices and beacons tracked, filter program and stream buffers */
+        result->static_mem = ADV_CACHE_SIZE * sizeof(adv_cache_entry_t) + BEACON_MAX * sizeof(beacon_t) +
+                                                ADV_FILTER_PROGRAM_SIZE + 2 * SCAN_STREAM_BUF_SIZE;
+        result->heap_delta = (int32_t)OS_GET_FREE_HEAP_SIZE() - (int32_t)replay.free_heap;
+
+        report_pipeline_set_replay(false);
+}
+
+static uint32_t lcg_next(uint32_t *seed)
+{
+        *seed = *seed * 1664525 + 1013904223;
+        return *seed >> 16;
+}
+
+/* Append an AD structure to a report */
+static void add_ad(ble_evt_gap_adv_report_t *evt, uint8_t type, const uint8_t *data, uint8_t len)
+{
+        evt->data[evt->length++] = len + 1;
+        evt->data[evt->length++] = type;
+        memcpy(&evt->data[evt->length], data, len);
+        evt->length += len;
+}
+
+/* Build the report n of a synthetic advertiser */
+static void synthetic_report(uint16_t advertiser, uint32_t n, uint32_t rnd, ble_evt_gap_adv_report_t *evt)
+{
+        static const uint8_t flags[] = { 0x06 };
+        static const uint8_t uuid16[] = { 0x0F, 0x18 };
+        static const uint8_t eddystone_uuid[] = { 0xAA, 0xFE };
+        uint8_t version = (uint8_t)(n / SYNTHETIC_PAYLOAD_PERIOD);
+        uint8_t buf[25];
+
+        memset(evt, 0, sizeof(*evt));
+        evt->address.addr_type = PUBLIC_ADDRESS;
+        evt->address.addr[0] = (uint8_t)advertiser;
+        evt->address.addr[1] = (uint8_t)(advertiser >> 8);
+        evt->address.addr[5] = 0xC0;
+
+        /* RSSI varies by up to 4 dB around the level of the advertiser */
+        evt->rssi = (int8_t)(-40 - ((advertiser * 7) % 50) + (int)(rnd & 7) - 4);
+
+        switch (advertiser % SYNTHETIC_KINDS) {
+        case SYNTHETIC_GENERIC:
+                evt->type = REPORT_TYPE_ADV_IND;
+                add_ad(evt, GAP_DATA_TYPE_FLAGS, flags, sizeof(flags));
+                add_ad(evt, GAP_DATA_TYPE_UUID16_LIST_INC, uuid16, sizeof(uuid16));
+                buf[0] = 0xD2;
+                buf[1] = 0x00;
+                buf[2] = version;
+                buf[3] = (uint8_t)advertiser;
+                add_ad(evt, GAP_DATA_TYPE_MANUFACTURER_SPEC, buf, 4);
+                break;
+        case SYNTHETIC_IBEACON:
+                /* Company ID, type, length, UUID, major, minor and calibrated RSSI at 1 m */
+                evt->type = REPORT_TYPE_ADV_NONCONN_IND;
+                add_ad(evt, GAP_DATA_TYPE_FLAGS, flags, sizeof(flags));
+                memset(buf, 0x5A, sizeof(buf));
+                buf[0] = 0x4C;
+                buf[1] = 0x00;
+                buf[2] = 0x02;
+                buf[3] = 0x15;
+                buf[20] = 0x00;
+                buf[21] = 0x01;
+                buf[22] = (uint8_t)(advertiser >> 8);
+                buf[23] = (uint8_t)advertiser;
+                buf[24] = (uint8_t)-59;
+                add_ad(evt, GAP_DATA_TYPE_MANUFACTURER_SPEC, buf, 25);
+                break;
+        case SYNTHETIC_EDDYSTONE_UID:
+                /* Service UUID, frame type, TX power at 0 m, namespace, instance and reserved bytes */
+                evt->type = REPORT_TYPE_ADV_NONCONN_IND;
+                add_ad(evt, GAP_DATA_TYPE_FLAGS, flags, sizeof(flags));
+                add_ad(evt, GAP_DATA_TYPE_UUID16_LIST, eddystone_uuid, sizeof(eddystone_uuid));
+                memset(buf, 0xA5, 22);
+                buf[0] = 0xAA;
+                buf[1] = 0xFE;
+                buf[2] = 0x00;
+                buf[3] = (uint8_t)-18;
+                buf[18] = (uint8_t)(advertiser >> 8);
+                buf[19] = (uint8_t)advertiser;
+                buf[20] = 0x00;
+                buf[21] = 0x00;
+                add_ad(evt, AD_TYPE_SERVICE_DATA_UUID16, buf, 22);
+                break;
+        default:
+                /* Advertising and scan response reports alternate randomly */
+                if (rnd & 0x100) {
+                        evt->type = REPORT_TYPE_SCAN_RSP;
+                        memcpy(buf, "Sensor", 6);
+                        buf[6] = '0' + (advertiser % 10);
+                        buf[7] = '0' + (version % 10);
+                        add_ad(evt, GAP_DATA_TYPE_LOCAL_NAME, buf, 8);
+                } else {
+                        evt->type = REPORT_TYPE_ADV_SCAN_IND;
+                        add_ad(evt, GAP_DATA_TYPE_FLAGS, flags, sizeof(flags));
+                        buf[0] = 0xD2;
+                        buf[1] = 0x00;
+                        buf[2] = (uint8_t)advertiser;
+                        add_ad(evt, GAP_DATA_TYPE_MANUFACTURER_SPEC, buf, 3);
+                }
+                break;
+        }
+}
+
+bool report_replay_synthetic(uint16_t num_of_advertisers, uint32_t num_of_reports, uint32_t rate,
+                                                                        report_replay_result_t *result)
+{
+        ble_evt_gap_adv_report_t evt;
+        uint32_t seed = 1;
+
+        if (!replay_begin(result)) {
+                return false;
+        }
+
+        for (uint32_t n = 0; n < num_of_reports; n++) {
+                uint32_t rnd = lcg_next(&seed);
+
+                synthetic_report((uint16_t)(lcg_next(&seed) % num_of_advertisers), n, rnd, &evt);
+                replay_report(&evt, (uint64_t)n * SystemCoreClock / rate);
+        }
+
+        replay_end();
+        return true;
+}
+
+#if REPORT_REPLAY_TRACE
+bool report_replay_trace(uint32_t rate, report_replay_result_t *result)
+{
+        ble_evt_gap_adv_report_t evt;
+        uint32_t num_of_records = sizeof(replay_trace) / sizeof(replay_trace[0]);
+        uint64_t arrival;
+
+        if (!replay_begin(result)) {
+                return false;
+        }
+
+        for (uint32_t n = 0; n < num_of_records; n++) {
+                const report_replay_record_t *record = &replay_trace[n];
+
+                memset(&evt, 0, sizeof(evt));
+                evt.type = record->type;
+                evt.address.addr_type = record->addr_type;
+                memcpy(evt.address.addr, record->addr, BD_ADDR_LEN);
+                evt.rssi = record->rssi;
+                evt.length = MIN(record->length, sizeof(evt.data));
+                memcpy(evt.data, record->data, evt.length);
+
+                if (rate) {
+                        arrival = (uint64_t)n * SystemCoreClock / rate;
+                } else {
+                        arrival = (uint64_t)(record->timestamp_ms - replay_trace[0].timestamp_ms) *
+                                                                                (SystemCoreClock / 1000);
+                }
+                replay_report(&evt, arrival);
+        }
+
+        replay_end();
+        return true;
+}
+#endif /* REPORT_REPLAY_TRACE */
+
+/* Advertisers of the beacon trace (see synthetic_report()); both calibrated at -59 dBm at 1 m */
+#define TRACE_IBEACON                   ( 1 )
+#define TRACE_EDDYSTONE_UID             ( 2 )
+
+/* Step of the beacon trace; beacon_expire() is called at the time of the steps with no advertiser */
+typedef struct {
+        uint32_t timestamp_ms;
+        uint8_t advertiser;
+        int8_t rssi;
+        uint8_t repeat;                 /* Number of reports, 100 ms apart */
+} beacon_trace_step_t;
+
+/* Event expected from the beacon trace */
+typedef struct {
+        uint8_t advertiser;
+        beacon_event_t event;
+} beacon_trace_event_t;
+
+static const beacon_trace_step_t beacon_trace[] = {
+        /* The iBeacon enters once reported twice, at 1 m (near) */
+        { 0,    TRACE_IBEACON,       -59, 2 },
+        /* The Eddystone-UID beacon enters at 10 m (far), then moves to 2 m (between the zones) */
+        { 200,  TRACE_EDDYSTONE_UID, -79, 2 },
+        { 400,  TRACE_EDDYSTONE_UID, -65, 10 },
+        /* The iBeacon moves to 10 m (far), then back to 0.5 m (near) */
+        { 1400, TRACE_IBEACON,       -79, 10 },
+        { 2400, TRACE_IBEACON,       -53, 10 },
+        /* Not reported for 5 s: the Eddystone-UID beacon exits, then the iBeacon */
+        { 5000, 0,                     0, 1 },
+        { 6300, 0,                     0, 1 },
+        { 8300, 0,                     0, 1 },
+};
+
+static const beacon_trace_event_t beacon_trace_events[] = {
+        { TRACE_IBEACON,       BEACON_EVENT_ENTER },
+        { TRACE_IBEACON,       BEACON_EVENT_NEAR },
+        { TRACE_EDDYSTONE_UID, BEACON_EVENT_ENTER },
+        { TRACE_EDDYSTONE_UID, BEACON_EVENT_FAR },
+        { TRACE_IBEACON,       BEACON_EVENT_FAR },
+        { TRACE_IBEACON,       BEACON_EVENT_NEAR },
+        { TRACE_EDDYSTONE_UID, BEACON_EVENT_EXIT },
+        { TRACE_IBEACON,       BEACON_EVENT_EXIT },
+};
+
+__RETAINED static uint32_t beacon_trace_num_of_events;
+__RETAINED static bool beacon_trace_match;
+
+static void beacon_trace_event_cb(const beacon_t *beacon, beacon_event_t event)
+{
+        uint32_t n = beacon_trace_num_of_events++;
+
+        /* Beacons are identified by the address of the synthetic advertiser */
+        if ((n >= ARRAY_LENGTH(beacon_trace_events)) ||
+                                (beacon->address.addr[0] != beacon_trace_events[n].advertiser) ||
+                                (event != beacon_trace_events[n].event)) {
+                beacon_trace_match = false;
+        }
+}
+
+bool report_replay_beacons(uint32_t *num_of_events)
+{
+        ble_evt_gap_adv_report_t evt;
+
+        *num_of_events = 0;
+        if (!report_pipeline_set_replay(true)) {
+                return false;
+        }
+
+        beacon_trace_num_of_events = 0;
+        beacon_trace_match = true;
+
+        for (int i = 0; i < ARRAY_LENGTH(beacon_trace); i++) {
+                const beacon_trace_step_t *step = &beacon_trace[i];
+
+                for (int n = 0; n < step->repeat; n++) {
+                        uint32_t timestamp_ms = step->timestamp_ms + n * 100;
+
+                        if (!step->advertiser) {
+                                beacon_expire(timestamp_ms, beacon_trace_event_cb);
+                                continue;
+                        }
+
+                        synthetic_report(step->advertiser, 0, 0, &evt);
+                        evt.rssi = step->rssi;
+                        beacon_update(&evt, timestamp_ms, beacon_trace_event_cb);
+                }
+        }
+
+        report_pipeline_set_replay(false);
+
+        *num_of_events = beacon_trace_num_of_events;
+        return beacon_trace_match && (beacon_trace_num_of_events == ARRAY_LENGTH(beacon_trace_events));
+}
+
+#endif /* REPORT_REPLAY_EN */
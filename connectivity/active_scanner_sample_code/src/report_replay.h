@@ -0,0 +1,130 @@
+/**
+ ****************************************************************************************
+ *
+ * @file report_replay.h
+ *
+ * @brief Replay of recorded or synthetic advertising reports
+ *
+ * Copyright (C) 2024 Renesas Electronics Corporation and/or its affiliates.
+ * All rights reserved. Confidential Information.
+ *
+ * This software ("Software") is supplied by Renesas Electronics Corporation and/or its
+ * affiliates ("Renesas"). Renesas grants you a personal, non-exclusive, non-transferable,
+ * revocable, non-sub-licensable right and license to use the Software, solely if used in
+ * or together with Renesas products. You may make copies of this Software, provided this
+ * copyright notice and disclaimer ("Notice") is included in all such copies. Renesas
+ * reserves the right to change or discontinue the Software at any time without notice.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS". RENESAS DISCLAIMS ALL WARRANTIES OF ANY KIND,
+ * WHETHER EXPRESS, IMPLIED, OR STATUTORY, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT. TO THE
+ * MAXIMUM EXTENT PERMITTED UNDER LAW, IN NO EVENT SHALL RENESAS BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, SPECIAL, INCIDENTAL OR CONSEQUENTIAL DAMAGES ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE, EVEN IF RENESAS HAS BEEN ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGES. USE OF THIS SOFTWARE MAY BE SUBJECT TO TERMS AND CONDITIONS CONTAINED IN
+ * AN ADDITIONAL AGREEMENT BETWEEN YOU AND RENESAS. IN CASE OF CONFLICT BETWEEN THE TERMS
+ * OF THIS NOTICE AND ANY SUCH ADDITIONAL LICENSE AGREEMENT, THE TERMS OF THE AGREEMENT
+ * SHALL TAKE PRECEDENCE. BY CONTINUING TO USE THIS SOFTWARE, YOU AGREE TO THE TERMS OF
+ * THIS NOTICE.IF YOU DO NOT AGREE TO THESE TERMS, YOU ARE NOT PERMITTED TO USE THIS
+ * SOFTWARE.
+ *
+ ****************************************************************************************
+ */
+
+#ifndef REPORT_REPLAY_H_
+#define REPORT_REPLAY_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "ble_gap.h"
+
+/*
+ * If set, the report processing (advertising filter and report pipeline, see report_pipeline.h)
+ * can be benchmarked via the CLI by replaying synthetic or recorded reports at a given rate, in
+ * virtual time, without radio activity. Reports carry their replay time as timestamp and are
+ * processed in the replay mode of the pipeline, isolated from the scanning session, so the
+ * processing is deterministic for a given input (the cycle counts are measured).
+ */
+#ifndef REPORT_REPLAY_EN
+#define REPORT_REPLAY_EN                ( 0 )
+#endif
+
+/*
+ * If set, a recorded trace can be replayed. The trace is provided by replay_trace.h, which can be
+ * generated from a captured report stream by scan_stream_decode.py (--format c).
+ */
+#ifndef REPORT_REPLAY_TRACE
+#define REPORT_REPLAY_TRACE             ( 0 )
+#endif
+
+/* Recorded advertising report */
+typedef struct {
+        uint32_t timestamp_ms;          /* Time the report was received */
+        uint8_t type;                   /* Report type, as reported by the controller */
+        uint8_t addr_type;
+        uint8_t addr[BD_ADDR_LEN];
+        int8_t rssi;
+        uint8_t length;
+        uint8_t data[BLE_ADV_DATA_LEN_MAX];
+} report_replay_record_t;
+
+/* Replay results */
+typedef struct {
+        uint32_t num_of_reports;        /* Reports replayed */
+        uint32_t num_of_matches;        /* Reports that passed the advertising filter */
+        uint32_t num_of_output;         /* Reports output (or beacon events) */
+        uint32_t cycles_avg;            /* Average CPU cycles spent per report */
+        uint32_t cycles_max;            /* Max. CPU cycles spent on a single report */
+        uint32_t num_of_late;           /* Reports received while a previous one was being processed */
+        uint32_t max_delay_us;          /* Max. time a report waited to be processed */
+        uint32_t max_rate;              /* Max. sustainable report rate (reports per second) */
+        uint32_t static_mem;            /* Static memory, in bytes, used by the report processing */
+        int32_t heap_delta;             /* Free heap size change during the replay */
+} report_replay_result_t;
+
+#if REPORT_REPLAY_EN
+/*
+ * Replay synthetic reports of \p num_of_advertisers advertisers: generic devices, iBeacons,
+ * Eddystone-UID beacons and scannable devices also sending scan responses. Advertisers are
+ * picked pseudo-randomly (fixed seed), the RSSI of each one varies around a fixed level and
+ * payloads change every 1024 reports. The devices and beacons found during the scanning session
+ * are saved before the replay and restored after it, and the output is discarded.
+ *
+ * \param [in]  num_of_advertisers Number of synthetic advertisers
+ * \param [in]  num_of_reports     Number of reports replayed
+ * \param [in]  rate               Report rate (reports per second)
+ * \param [out] result             Replay results
+ *
+ * \return False if there is not enough heap to save the state of the scanning session
+ */
+bool report_replay_synthetic(uint16_t num_of_advertisers, uint32_t num_of_reports, uint32_t rate,
+                                                                        report_replay_result_t *result);
+
+#if REPORT_REPLAY_TRACE
+/*
+ * Replay the recorded trace (replay_trace.h). The devices and beacons found during the scanning
+ * session are saved before the replay and restored after it, and the output is discarded.
+ *
+ * \param [in]  rate   Report rate (reports per second); 0 to replay with the recorded timing
+ * \param [out] result Replay results
+ *
+ * \return False if there is not enough heap to save the state of the scanning session
+ */
+bool report_replay_trace(uint32_t rate, report_replay_result_t *result);
+#endif
+
+/*
+ * Replay a fixed trace of two beacons (an iBeacon and an Eddystone-UID beacon moving between the
+ * near and far zones, then going out of range) through beacon_update() and beacon_expire(), and
+ * check that the expected sequence of enter, near, far and exit events is reported. The beacons
+ * tracked during the scanning session are saved before the replay and restored after it.
+ *
+ * \param [out] num_of_events Number of events reported
+ *
+ * \return True if the events reported match the expected sequence; false otherwise or if there is
+ *         not enough heap to save the state of the scanning session
+ */
+bool report_replay_beacons(uint32_t *num_of_events);
+#endif /* REPORT_REPLAY_EN */
+
+#endif /* REPORT_REPLAY_H_ */
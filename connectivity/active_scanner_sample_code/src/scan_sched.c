@@ -0,0 +1,217 @@
+/**
+ ****************************************************************************************
+ *
+ * @file scan_sched.c
+ *
+ * @brief Adaptive scan duty-cycle scheduler
+ *
+ * Copyright (C) 2024 Renesas Electronics Corporation and/or its affiliates.
+ * All rights reserved. Confidential Information.
+ *
+ * This software ("Software") is supplied by Renesas Electronics Corporation and/or its
+ * affiliates ("Renesas"). Renesas grants you a personal, non-exclusive, non-transferable,
+ * revocable, non-sub-licensable right and license to use the Software, solely if used in
+ * or together with Renesas products. You may make copies of this Software, provided this
+ * copyright notice and disclaimer ("Notice") is included in all such copies. Renesas
+ * reserves the right to change or discontinue the Software at any time without notice.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS". RENESAS DISCLAIMS ALL WARRANTIES OF ANY KIND,
+ * WHETHER EXPRESS, IMPLIED, OR STATUTORY, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT. TO THE
+ * MAXIMUM EXTENT PERMITTED UNDER LAW, IN NO EVENT SHALL RENESAS BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, SPECIAL, INCIDENTAL OR CONSEQUENTIAL DAMAGES ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE, EVEN IF RENESAS HAS BEEN ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGES. USE OF THIS SOFTWARE MAY BE SUBJECT TO TERMS AND CONDITIONS CONTAINED IN
+ * AN ADDITIONAL AGREEMENT BETWEEN YOU AND RENESAS. IN CASE OF CONFLICT BETWEEN THE TERMS
+ * OF THIS NOTICE AND ANY SUCH ADDITIONAL LICENSE AGREEMENT, THE TERMS OF THE AGREEMENT
+ * SHALL TAKE PRECEDENCE. BY CONTINUING TO USE THIS SOFTWARE, YOU AGREE TO THE TERMS OF
+ * THIS NOTICE.IF YOU DO NOT AGREE TO THESE TERMS, YOU ARE NOT PERMITTED TO USE THIS
+ * SOFTWARE.
+ *
+ ****************************************************************************************
+ */
+
+#include <string.h>
+#include "sdk_defs.h"
+#include "osal.h"
+#include "misc.h"
+#include "scan_sched.h"
+
+/* Advertising report types (as reported by the controller) */
+#define REPORT_TYPE_ADV_IND             ( 0x00 )
+#define REPORT_TYPE_ADV_SCAN_IND        ( 0x02 )
+#define REPORT_TYPE_SCAN_RSP            ( 0x04 )
+
+/* Duty cycle levels, from the highest to the lowest */
+static const struct {
+        uint16_t interval_ms;
+        uint16_t window_ms;
+} duty_levels[] = {
+        { 30,  30 },                    /* 100% */
+        { 30,  15 },                    /* 50% */
+        { 60,  15 },                    /* 25% */
+        { 120, 15 },                    /* 12.5% */
+        { 240, 15 },                    /* 6.25% */
+};
+
+/* Devices seen during an epoch */
+typedef struct {
+        uint32_t since_ms;
+        uint16_t seen;
+        uint16_t pending_scan_rsp;
+} epoch_devices_t;
+
+__RETAINED static uint32_t session_start_ms;
+__RETAINED static uint32_t epoch_start_ms;
+__RETAINED static uint8_t duty_level;
+__RETAINED static gap_scan_type_t scan_type;
+
+/* Current epoch */
+__RETAINED static uint16_t epoch_new_devices;
+
+/* Session statistics */
+__RETAINED static uint16_t num_of_epochs;
+__RETAINED static uint32_t active_ms;
+__RETAINED static uint32_t passive_ms;
+__RETAINED static uint32_t radio_on_ms;
+__RETAINED static uint16_t num_of_discoveries;
+__RETAINED static uint32_t discovery_latency_sum_ms;
+__RETAINED static uint32_t discovery_radio_on_sum_ms;
+
+/* Radio-on time, expressed in ms, of a time span scanned with the current parameters */
+static uint32_t radio_on_time(uint32_t elapsed_ms)
+{
+        return (uint32_t)((uint64_t)elapsed_ms * duty_levels[duty_level].window_ms /
+                                                        duty_levels[duty_level].interval_ms);
+}
+
+void scan_sched_start(uint32_t timestamp_ms)
+{
+        session_start_ms = timestamp_ms;
+        epoch_start_ms = timestamp_ms;
+        duty_level = 0;
+        scan_type = GAP_SCAN_ACTIVE;
+        epoch_new_devices = 0;
+
+        num_of_epochs = 0;
+        active_ms = 0;
+        passive_ms = 0;
+        radio_on_ms = 0;
+        num_of_discoveries = 0;
+        discovery_latency_sum_ms = 0;
+        discovery_radio_on_sum_ms = 0;
+}
+
+void scan_sched_get_params(scan_sched_params_t *params)
+{
+        params->type = scan_type;
+        params->interval = BLE_SCAN_INTERVAL_FROM_MS(duty_levels[duty_level].interval_ms);
+        params->window = BLE_SCAN_WINDOW_FROM_MS(duty_levels[duty_level].window_ms);
+}
+
+void scan_sched_report(const ble_evt_gap_adv_report_t *evt, adv_cache_status_t status, uint32_t timestamp_ms)
+{
+        /* Devices that could not be tracked may have been reported before; only new devices count */
+        if (status != ADV_CACHE_STATUS_NEW) {
+                return;
+        }
+
+        epoch_new_devices++;
+
+        num_of_discoveries++;
+        discovery_latency_sum_ms += timestamp_ms - session_start_ms;
+        discovery_radio_on_sum_ms += radio_on_ms + radio_on_time(timestamp_ms - epoch_start_ms);
+}
+
+/* Count the devices seen during the epoch and those whose scan response is missing */
+static void count_device(const adv_cache_entry_t *entry, void *user_data)
+{
+        epoch_devices_t *devices = user_data;
+        bool scannable = false;
+        bool scan_rsp = false;
+
+        if ((int32_t)(entry->last_seen_ms - devices->since_ms) < 0) {
+                return;
+        }
+
+        devices->seen++;
+
+        for (int i = 0; i < ADV_CACHE_PAYLOAD_TYPES; i++) {
+                if (!entry->payload[i].valid) {
+                        continue;
+                }
+
+                if ((entry->payload[i].type == REPORT_TYPE_ADV_IND) ||
+                                        (entry->payload[i].type == REPORT_TYPE_ADV_SCAN_IND)) {
+                        scannable = true;
+                } else if (entry->payload[i].type == REPORT_TYPE_SCAN_RSP) {
+                        scan_rsp = true;
+                }
+        }
+
+        if (scannable && !scan_rsp) {
+                devices->pending_scan_rsp++;
+        }
+}
+
+scan_sched_action_t scan_sched_epoch(uint32_t timestamp_ms)
+{
+        uint32_t elapsed_ms = timestamp_ms - epoch_start_ms;
+        epoch_devices_t devices = { .since_ms = epoch_start_ms };
+        uint8_t prev_level = duty_level;
+        gap_scan_type_t prev_type = scan_type;
+
+        /* Account for the epoch that ended */
+        num_of_epochs++;
+        radio_on_ms += radio_on_time(elapsed_ms);
+        if (scan_type == GAP_SCAN_ACTIVE) {
+                active_ms += elapsed_ms;
+        } else {
+                passive_ms += elapsed_ms;
+        }
+
+        if (timestamp_ms - session_start_ms >= SCAN_SCHED_SESSION_MS) {
+                return SCAN_SCHED_DONE;
+        }
+
+        adv_cache_foreach(count_device, &devices);
+
+        /* Discovery rate: raise the duty cycle while new devices show up, lower it otherwise */
+        if (epoch_new_devices >= SCAN_SCHED_NEW_DEVICES_HIGH) {
+                duty_level = 0;
+        } else if (epoch_new_devices > 0) {
+                if (duty_level > 0) {
+                        duty_level--;
+                }
+        } else {
+                /* In dense environments most of the radio-on time yields reports of known devices */
+                duty_level += (devices.seen >= SCAN_SCHED_DENSE_DEVICES) ? 2 : 1;
+                if (duty_level >= ARRAY_LENGTH(duty_levels)) {
+                        duty_level = ARRAY_LENGTH(duty_levels) - 1;
+                }
+        }
+
+        /* Scan requests are needed only for devices whose scan response is missing */
+        scan_type = devices.pending_scan_rsp ? GAP_SCAN_ACTIVE : GAP_SCAN_PASSIVE;
+
+        epoch_start_ms = timestamp_ms;
+        epoch_new_devices = 0;
+
+        return ((duty_level != prev_level) || (scan_type != prev_type)) ? SCAN_SCHED_RESTART :
+                                                                        SCAN_SCHED_CONTINUE;
+}
+
+void scan_sched_print_stats(void)
+{
+        uint32_t session_ms = active_ms + passive_ms;
+
+        DBG_LOG("Epochs: %d, Active scanning: %lu ms, Passive scanning: %lu ms, Radio-on: %lu ms (%lu%%)\n\r",
+                num_of_epochs, active_ms, passive_ms, radio_on_ms,
+                session_ms ? (radio_on_ms * 100 / session_ms) : 0);
+
+        if (num_of_discoveries) {
+                DBG_LOG("Discovery latency (avg.): %lu ms, Radio-on time to discovery (avg.): %lu ms\n\r",
+                        discovery_latency_sum_ms / num_of_discoveries,
+                        discovery_radio_on_sum_ms / num_of_discoveries);
+        }
+}
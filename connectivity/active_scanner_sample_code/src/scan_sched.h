@@ -0,0 +1,118 @@
+/**
+ ****************************************************************************************
+ *
+ * @file scan_sched.h
+ *
+ * @brief Adaptive scan duty-cycle scheduler
+ *
+ * Copyright (C) 2024 Renesas Electronics Corporation and/or its affiliates.
+ * All rights reserved. Confidential Information.
+ *
+ * This software ("Software") is supplied by Renesas Electronics Corporation and/or its
+ * affiliates ("Renesas"). Renesas grants you a personal, non-exclusive, non-transferable,
+ * revocable, non-sub-licensable right and license to use the Software, solely if used in
+ * or together with Renesas products. You may make copies of this Software, provided this
+ * copyright notice and disclaimer ("Notice") is included in all such copies. Renesas
+ * reserves the right to change or discontinue the Software at any time without notice.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS". RENESAS DISCLAIMS ALL WARRANTIES OF ANY KIND,
+ * WHETHER EXPRESS, IMPLIED, OR STATUTORY, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT. TO THE
+ * MAXIMUM EXTENT PERMITTED UNDER LAW, IN NO EVENT SHALL RENESAS BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, SPECIAL, INCIDENTAL OR CONSEQUENTIAL DAMAGES ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE, EVEN IF RENESAS HAS BEEN ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGES. USE OF THIS SOFTWARE MAY BE SUBJECT TO TERMS AND CONDITIONS CONTAINED IN
+ * AN ADDITIONAL AGREEMENT BETWEEN YOU AND RENESAS. IN CASE OF CONFLICT BETWEEN THE TERMS
+ * OF THIS NOTICE AND ANY SUCH ADDITIONAL LICENSE AGREEMENT, THE TERMS OF THE AGREEMENT
+ * SHALL TAKE PRECEDENCE. BY CONTINUING TO USE THIS SOFTWARE, YOU AGREE TO THE TERMS OF
+ * THIS NOTICE.IF YOU DO NOT AGREE TO THESE TERMS, YOU ARE NOT PERMITTED TO USE THIS
+ * SOFTWARE.
+ *
+ ****************************************************************************************
+ */
+
+#ifndef SCAN_SCHED_H_
+#define SCAN_SCHED_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "ble_gap.h"
+#include "adv_cache.h"
+
+/*
+ * A scanning session is split into epochs. At the end of each epoch the scan parameters are
+ * re-evaluated:
+ *
+ *  - The duty cycle (window/interval) is raised when new devices are discovered and lowered,
+ *    faster in dense environments, when no new devices are discovered.
+ *  - Active scanning is used only while there are scannable devices, seen during the epoch, whose
+ *    scan response has not been received yet; passive scanning is used otherwise, so that no scan
+ *    requests are sent to devices whose scan response is already cached.
+ */
+
+/* Duration, expressed in ms, of a scanning session */
+#ifndef SCAN_SCHED_SESSION_MS
+#define SCAN_SCHED_SESSION_MS                   ( 10240 )
+#endif
+
+/* Duration, expressed in ms, of an epoch */
+#ifndef SCAN_SCHED_EPOCH_MS
+#define SCAN_SCHED_EPOCH_MS                     ( 1000 )
+#endif
+
+/* Number of new devices per epoch above which the max. duty cycle is used */
+#ifndef SCAN_SCHED_NEW_DEVICES_HIGH
+#define SCAN_SCHED_NEW_DEVICES_HIGH             ( 4 )
+#endif
+
+/* Number of devices seen per epoch above which the environment is considered dense */
+#ifndef SCAN_SCHED_DENSE_DEVICES
+#define SCAN_SCHED_DENSE_DEVICES                ( 32 )
+#endif
+
+/* Action to be taken at the end of an epoch */
+typedef enum {
+        SCAN_SCHED_CONTINUE,            /* Scan parameters have not changed; keep scanning */
+        SCAN_SCHED_RESTART,             /* Scan parameters have changed; scanning should be restarted */
+        SCAN_SCHED_DONE,                /* The scanning session is over; scanning should be stopped */
+} scan_sched_action_t;
+
+/* Scan parameters */
+typedef struct {
+        gap_scan_type_t type;
+        uint16_t interval;              /* In steps of 0.625 ms */
+        uint16_t window;                /* In steps of 0.625 ms */
+} scan_sched_params_t;
+
+/*
+ * Start a scanning session. The max. duty cycle and active scanning are used first.
+ *
+ * \param [in] timestamp_ms Current time
+ */
+void scan_sched_start(uint32_t timestamp_ms);
+
+/* Get the current scan parameters */
+void scan_sched_get_params(scan_sched_params_t *params);
+
+/*
+ * Account for an advertising report.
+ *
+ * \param [in] evt          The advertising report
+ * \param [in] status       The status of the report, as returned by the advertising cache
+ * \param [in] timestamp_ms Time the report was received
+ */
+void scan_sched_report(const ble_evt_gap_adv_report_t *evt, adv_cache_status_t status, uint32_t timestamp_ms);
+
+/*
+ * End the current epoch and evaluate the scan parameters of the next one
+ *
+ * \param [in] timestamp_ms Current time
+ *
+ * \return The action to be taken
+ */
+scan_sched_action_t scan_sched_epoch(uint32_t timestamp_ms);
+
+/* Print the session statistics: radio-on time and discovery latency */
+void scan_sched_print_stats(void);
+
+#endif /* SCAN_SCHED_H_ */
@@ -0,0 +1,254 @@
+/**
+ ****************************************************************************************
+ *
+ * @file scan_stream.c
+ *
+ * @brief Binary stream of advertising reports over UART
+ *
+ * Copyright (C) 2024 Renesas Electronics Corporation and/or its affiliates.
+ * All rights reserved. Confidential Information.
+ *
+ * This software ("Software") is supplied by Renesas Electronics Corporation and/or its
+ * affiliates ("Renesas"). Renesas grants you a personal, non-exclusive, non-transferable,
+ * revocable, non-sub-licensable right and license to use the Software, solely if used in
+ * or together with Renesas products. You may make copies of this Software, provided this
+ * copyright notice and disclaimer ("Notice") is included in all such copies. Renesas
+ * reserves the right to change or discontinue the Software at any time without notice.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS". RENESAS DISCLAIMS ALL WARRANTIES OF ANY KIND,
+ * WHETHER EXPRESS, IMPLIED, OR STATUTORY, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT. TO THE
+ * MAXIMUM EXTENT PERMITTED UNDER LAW, IN NO EVENT SHALL RENESAS BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, SPECIAL, INCIDENTAL OR CONSEQUENTIAL DAMAGES ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE, EVEN IF RENESAS HAS BEEN ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGES. USE OF THIS SOFTWARE MAY BE SUBJECT TO TERMS AND CONDITIONS CONTAINED IN
+ * AN ADDITIONAL AGREEMENT BETWEEN YOU AND RENESAS. IN CASE OF CONFLICT BETWEEN THE TERMS
+ * OF THIS NOTICE AND ANY SUCH ADDITIONAL LICENSE AGREEMENT, THE TERMS OF THE AGREEMENT
+ * SHALL TAKE PRECEDENCE. BY CONTINUING TO USE THIS SOFTWARE, YOU AGREE TO THE TERMS OF
+ * THIS NOTICE.IF YOU DO NOT AGREE TO THESE TERMS, YOU ARE NOT PERMITTED TO USE THIS
+ * SOFTWARE.
+ *
+ ****************************************************************************************
+ */
+
+#include <string.h>
+#include "sdk_defs.h"
+#include "ad_uart.h"
+#include "hw_gpio.h"
+#include "scan_stream.h"
+
+/* Frame overhead: sync word, length and CRC */
+#define FRAME_OVERHEAD                  ( 5 )
+
+/* Size of the record header (all fields except the advertising data) */
+#define RECORD_HDR_SIZE                 ( 14 )
+
+#define STREAM_CLOSE_TIMEOUT_MS         ( 1000 )
+
+#if SCAN_STREAM_BUF_SIZE < (FRAME_OVERHEAD + RECORD_HDR_SIZE + BLE_ADV_DATA_LEN_MAX)
+#error "SCAN_STREAM_BUF_SIZE should fit at least one frame"
+#endif
+
+/* Stream UART device driver */
+static const ad_uart_driver_conf_t uart_stream_drv = {
+        .hw_conf = {
+                .baud_rate = SCAN_STREAM_BAUDRATE,
+                .data = HW_UART_DATABITS_8,
+                .parity = HW_UART_PARITY_NONE,
+                .stop = HW_UART_STOPBITS_1,
+                .auto_flow_control = 0,
+                .use_fifo = 1,
+                .tx_fifo_tr_lvl = 0,
+                .rx_fifo_tr_lvl = 0,
+#if HW_UART_DMA_SUPPORT
+                .use_dma = 1,
+                .tx_dma_channel = HW_DMA_CHANNEL_1,
+                .rx_dma_channel = HW_DMA_CHANNEL_0,
+                .tx_dma_burst_lvl = 0,
+                .rx_dma_burst_lvl = 0,
+#endif
+        }
+};
+
+/* Stream UART bus connections */
+static const ad_uart_io_conf_t uart_stream_bus = {
+        .rx = {
+                .port = SCAN_STREAM_RX_PORT, .pin = SCAN_STREAM_RX_PIN,
+                .on =  { HW_GPIO_MODE_INPUT, HW_GPIO_FUNC_UART_RX, false },
+                .off = { HW_GPIO_MODE_INPUT, HW_GPIO_FUNC_GPIO, true },
+        },
+        .tx = {
+                .port = SCAN_STREAM_TX_PORT, .pin = SCAN_STREAM_TX_PIN,
+                .on =  { HW_GPIO_MODE_OUTPUT, HW_GPIO_FUNC_UART_TX, false },
+                .off = { HW_GPIO_MODE_INPUT, HW_GPIO_FUNC_GPIO, true },
+        },
+};
+
+/* Stream UART controller (the console uses UART2) */
+static const ad_uart_controller_conf_t uart_stream_ctrl = {
+        HW_UART1,
+        &uart_stream_bus,
+        &uart_stream_drv
+};
+
+__RETAINED static ad_uart_handle_t uart_handle;
+__RETAINED static OS_TASK notify_task;
+__RETAINED static uint32_t notify_mask;
+
+/* Frames are added to buffers[active] while the other buffer is transmitted */
+__RETAINED static uint8_t buffers[2][SCAN_STREAM_BUF_SIZE];
+__RETAINED static uint16_t buffer_len[2];
+__RETAINED static uint16_t buffer_frames[2];
+__RETAINED static uint8_t active;
+__RETAINED static volatile bool tx_busy;
+
+__RETAINED static scan_stream_stats_t stream_stats;
+
+/* CRC-16/CCITT-FALSE (polynomial 0x1021, initial value 0xFFFF) */
+static uint16_t crc16(const uint8_t *data, uint16_t len)
+{
+        uint16_t crc = 0xFFFF;
+
+        while (len--) {
+                crc ^= (uint16_t)*data++ << 8;
+                for (int i = 0; i < 8; i++) {
+                        crc = (crc & 0x8000) ? ((crc << 1) ^ 0x1021) : (crc << 1);
+                }
+        }
+        return crc;
+}
+
+/* Called from interrupt context when a DMA transfer completes */
+static void uart_write_cb(void *user_data, uint16_t transferred)
+{
+        stream_stats.bytes += transferred;
+        tx_busy = false;
+
+        OS_TASK_NOTIFY_FROM_ISR(notify_task, notify_mask, OS_NOTIFY_SET_BITS);
+}
+
+bool scan_stream_start(OS_TASK task, uint32_t notif)
+{
+        if (uart_handle) {
+                return true;
+        }
+
+        uart_handle = ad_uart_open(&uart_stream_ctrl);
+        if (!uart_handle) {
+                return false;
+        }
+
+        notify_task = task;
+        notify_mask = notif;
+        buffer_len[0] = buffer_len[1] = 0;
+        buffer_frames[0] = buffer_frames[1] = 0;
+        active = 0;
+        tx_busy = false;
+        memset(&stream_stats, 0, sizeof(stream_stats));
+
+        return true;
+}
+
+void scan_stream_stop(void)
+{
+        OS_TICK_TIME timestamp = OS_GET_TICK_COUNT();
+
+        if (!uart_handle) {
+                return;
+        }
+
+        /* Drain both buffers */
+        while (tx_busy || buffer_len[active]) {
+                if (OS_GET_TICK_COUNT() - timestamp >= OS_MS_2_TICKS(STREAM_CLOSE_TIMEOUT_MS)) {
+                        break;
+                }
+                scan_stream_flush();
+                OS_DELAY_MS(1);
+        }
+
+        while (ad_uart_close(uart_handle, false) != AD_UART_ERROR_NONE) {
+                if (OS_GET_TICK_COUNT() - timestamp >= OS_MS_2_TICKS(STREAM_CLOSE_TIMEOUT_MS)) {
+                        /* Force UART closing */
+                        ad_uart_close(uart_handle, true);
+                        break;
+                }
+                OS_DELAY_MS(1);
+        }
+
+        uart_handle = NULL;
+}
+
+bool scan_stream_is_active(void)
+{
+        return uart_handle != NULL;
+}
+
+void scan_stream_flush(void)
+{
+        uint8_t idx = active;
+
+        if (!uart_handle || tx_busy || (buffer_len[idx] == 0)) {
+                return;
+        }
+
+        /* Frames added from now on go to the other buffer, which has already been transmitted */
+        active ^= 1;
+        buffer_len[active] = 0;
+        buffer_frames[active] = 0;
+
+        tx_busy = true;
+        if (ad_uart_write_async(uart_handle, (const char *)buffers[idx], buffer_len[idx], uart_write_cb,
+                                                                        NULL) != AD_UART_ERROR_NONE) {
+                tx_busy = false;
+                stream_stats.dropped += buffer_frames[idx];
+        }
+}
+
+bool scan_stream_report(const ble_evt_gap_adv_report_t *evt, uint32_t timestamp_ms)
+{
+        uint8_t record_len = RECORD_HDR_SIZE + evt->length;
+        uint8_t *frame;
+        uint16_t crc;
+
+        if (!uart_handle) {
+                return false;
+        }
+
+        if (buffer_len[active] + FRAME_OVERHEAD + record_len > SCAN_STREAM_BUF_SIZE) {
+                stream_stats.dropped++;
+                return false;
+        }
+
+        frame = &buffers[active][buffer_len[active]];
+
+        frame[0] = SCAN_STREAM_SYNC_0;
+        frame[1] = SCAN_STREAM_SYNC_1;
+        frame[2] = record_len;
+        frame[3] = SCAN_STREAM_RECORD_ADV_REPORT;
+        frame[4] = (uint8_t)timestamp_ms;
+        frame[5] = (uint8_t)(timestamp_ms >> 8);
+        frame[6] = (uint8_t)(timestamp_ms >> 16);
+        frame[7] = (uint8_t)(timestamp_ms >> 24);
+        frame[8] = evt->type;
+        frame[9] = evt->address.addr_type;
+        memcpy(&frame[10], evt->address.addr, BD_ADDR_LEN);
+        frame[16] = (uint8_t)evt->rssi;
+        memcpy(&frame[17], evt->data, evt->length);
+
+        crc = crc16(&frame[2], record_len + 1);
+        frame[3 + record_len] = (uint8_t)crc;
+        frame[4 + record_len] = (uint8_t)(crc >> 8);
+
+        buffer_len[active] += FRAME_OVERHEAD + record_len;
+        buffer_frames[active]++;
+        stream_stats.frames++;
+
+        scan_stream_flush();
+
+        return true;
+}
+
+void scan_stream_get_stats(scan_stream_stats_t *stats)
+{
+        *stats = stream_stats;
+}
@@ -0,0 +1,133 @@
+/**
+ ****************************************************************************************
+ *
+ * @file scan_stream.h
+ *
+ * @brief Binary stream of advertising reports over UART
+ *
+ * Copyright (C) 2024 Renesas Electronics Corporation and/or its affiliates.
+ * All rights reserved. Confidential Information.
+ *
+ * This software ("Software") is supplied by Renesas Electronics Corporation and/or its
+ * affiliates ("Renesas"). Renesas grants you a personal, non-exclusive, non-transferable,
+ * revocable, non-sub-licensable right and license to use the Software, solely if used in
+ * or together with Renesas products. You may make copies of this Software, provided this
+ * copyright notice and disclaimer ("Notice") is included in all such copies. Renesas
+ * reserves the right to change or discontinue the Software at any time without notice.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS". RENESAS DISCLAIMS ALL WARRANTIES OF ANY KIND,
+ * WHETHER EXPRESS, IMPLIED, OR STATUTORY, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT. TO THE
+ * MAXIMUM EXTENT PERMITTED UNDER LAW, IN NO EVENT SHALL RENESAS BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, SPECIAL, INCIDENTAL OR CONSEQUENTIAL DAMAGES ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE, EVEN IF RENESAS HAS BEEN ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGES. USE OF THIS SOFTWARE MAY BE SUBJECT TO TERMS AND CONDITIONS CONTAINED IN
+ * AN ADDITIONAL AGREEMENT BETWEEN YOU AND RENESAS. IN CASE OF CONFLICT BETWEEN THE TERMS
+ * OF THIS NOTICE AND ANY SUCH ADDITIONAL LICENSE AGREEMENT, THE TERMS OF THE AGREEMENT
+ * SHALL TAKE PRECEDENCE. BY CONTINUING TO USE THIS SOFTWARE, YOU AGREE TO THE TERMS OF
+ * THIS NOTICE.IF YOU DO NOT AGREE TO THESE TERMS, YOU ARE NOT PERMITTED TO USE THIS
+ * SOFTWARE.
+ *
+ ****************************************************************************************
+ */
+
+#ifndef SCAN_STREAM_H_
+#define SCAN_STREAM_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "osal.h"
+#include "ble_gap.h"
+
+/*
+ * Advertising reports are streamed as binary frames over a dedicated UART (other than the one of
+ * the console), using DMA. Each frame is formatted as follows (multi-byte fields are little endian):
+ *
+ *  - Sync word (2 bytes): 0xA5, 0x5A
+ *  - Length of the record (1 byte)
+ *  - Record:
+ *    - Record type (1 byte): SCAN_STREAM_RECORD_ADV_REPORT
+ *    - Timestamp (4 bytes): Time, expressed in ms, the report was received
+ *    - Advertising event type (1 byte)
+ *    - Address type (1 byte)
+ *    - Address (6 bytes, LSB first)
+ *    - RSSI (1 byte, signed)
+ *    - Advertising data (TLVs, as received over the air)
+ *  - CRC (2 bytes): CRC-16/CCITT-FALSE of the length and the record
+ */
+#define SCAN_STREAM_SYNC_0                      ( 0xA5 )
+#define SCAN_STREAM_SYNC_1                      ( 0x5A )
+
+#define SCAN_STREAM_RECORD_ADV_REPORT           ( 0x01 )
+
+/* Baud rate of the stream UART */
+#ifndef SCAN_STREAM_BAUDRATE
+#define SCAN_STREAM_BAUDRATE                    HW_UART_BAUDRATE_1000000
+#endif
+
+/* Pins of the stream UART. They should be adapted to the board used. */
+#ifndef SCAN_STREAM_TX_PORT
+#define SCAN_STREAM_TX_PORT                     HW_GPIO_PORT_1
+#endif
+
+#ifndef SCAN_STREAM_TX_PIN
+#define SCAN_STREAM_TX_PIN                      HW_GPIO_PIN_2
+#endif
+
+#ifndef SCAN_STREAM_RX_PORT
+#define SCAN_STREAM_RX_PORT                     HW_GPIO_PORT_1
+#endif
+
+#ifndef SCAN_STREAM_RX_PIN
+#define SCAN_STREAM_RX_PIN                      HW_GPIO_PIN_3
+#endif
+
+/*
+ * Size, expressed in bytes, of each of the two stream buffers. Frames are added to one buffer
+ * while the other is transmitted over DMA; frames that do not fit are dropped.
+ */
+#ifndef SCAN_STREAM_BUF_SIZE
+#define SCAN_STREAM_BUF_SIZE                    ( 512 )
+#endif
+
+/* Stream statistics */
+typedef struct {
+        uint32_t frames;                /* Frames added to the stream */
+        uint32_t bytes;                 /* Bytes transmitted over the UART */
+        uint32_t dropped;               /* Frames dropped as no buffer space was available */
+} scan_stream_stats_t;
+
+/*
+ * Open the stream UART and start streaming. The task is notified, from interrupt context, each
+ * time a DMA transfer completes; scan_stream_flush() should be called then.
+ *
+ * \param [in] task  Task to be notified
+ * \param [in] notif Notification bit(s)
+ *
+ * \return True if the stream UART could be opened
+ */
+bool scan_stream_start(OS_TASK task, uint32_t notif);
+
+/* Transmit any pending frames and close the stream UART */
+void scan_stream_stop(void);
+
+/* Check whether streaming is active */
+bool scan_stream_is_active(void);
+
+/*
+ * Add an advertising report to the stream. Transmission starts immediately if the UART is idle.
+ *
+ * \param [in] evt          The advertising report
+ * \param [in] timestamp_ms Time the report was received
+ *
+ * \return True if the report was added; false if it was dropped
+ */
+bool scan_stream_report(const ble_evt_gap_adv_report_t *evt, uint32_t timestamp_ms);
+
+/* Start transmitting the pending frames, if the UART is idle */
+void scan_stream_flush(void);
+
+/* Get the stream statistics (since streaming was started) */
+void scan_stream_get_stats(scan_stream_stats_t *stats);
+
+#endif /* SCAN_STREAM_H_ */
@@ -36,6 +36,7 @@
 #include "ble_gap.h"
 #include "ble_gattc.h"
 #include "misc.h"
+#include "ble_evt_pump.h"
 #include "ble_custom_service.h"
 #if dg_configSUOTA_SUPPORT
   #include "ble_l2cap.h"
@@ -57,7 +58,18 @@
  * \warning The remote device must not exceed that number. Otherwise, the system will crash!!!
  *
  */
+#if MCS_BENCHMARK_EN
+/* Max. size of an attribute value, so long write throughput can be measured */
+#define ATTR_MAX_SIZE                      ( 512 )
+#else
 #define ATTR_MAX_SIZE                      ( 50 )
+#endif
+
+/*
+ * Notification bits reservation
+ * bit #0 is always assigned to BLE event queue notification
+ */
+#define MCS_TIMER_EVENT                    ( 1 << 2 )
 
 #if APP_NOTIF_DEMONSTRATION
   /* Characteristic attributes value update frequency */
@@ -89,6 +101,9 @@
  * Store information about ongoing SUOTA.
  */
 __RETAINED_RW static bool suota_ongoing = false;
+
+/* SUOTA service, which handles the L2CAP events */
+__RETAINED static ble_service_t *suota;
 #endif
 
 /**
@@ -98,6 +113,9 @@ __RETAINED_RW static bool suota_ongoing = false;
  */
 __RETAINED uint8_t attribute_value[ATTR_MAX_SIZE];
 
+/* Version of the attribute value, changed every time the value is updated */
+__RETAINED static uint32_t attribute_version;
+
 #if APP_NOTIF_DEMONSTRATION
 /* OS timer handler used to update characteristic attributes value */
 __RETAINED static OS_TIMER notif_timer_h;
@@ -195,7 +213,21 @@ static void characteristic_attr_read_cb(uint8_t **data, uint16_t *length)
         *data  = attribute_value;
         *length = sizeof(attribute_value);
 
+#if !MCS_BENCHMARK_EN
         DBG_PRINTF("\nRead callback function hit! - Returned value: %s\n\r", (char *)attribute_value);
+#endif
+}
+
+/**
+ * This callback is fired when a peer device issues a read request for a specific attribute value,
+ * at a non-zero offset (long read).
+ *
+ * \return The current version of the attribute value. As long as the version is not changed, the
+ *         rest of the value is read directly from the buffer returned by the read callback.
+ */
+static uint32_t characteristic_attr_version_cb(void)
+{
+        return attribute_version;
 }
 
 /**
@@ -213,9 +245,22 @@ static void characteristic_attr_write_cb(const uint8_t *data, uint16_t length)
 {
         memset((void *)attribute_value, '\0', sizeof(attribute_value));
         memcpy((void *)attribute_value, (void *)data, length);
+        attribute_version++;
 
         DBG_PRINTF("\nWrite callback function hit! - Written value: %s, length: %d\n\r",
                                                                         attribute_value, length);
+
+#if MCS_BENCHMARK_EN
+        mcs_long_write_stats_t stats;
+
+        mcs_long_write_get_stats(&stats);
+        if (stats.duration_ms) {
+                DBG_PRINTF("\n\rLong writes: %lu, Bytes: %lu, Throughput: %lu bytes/s, Rejected: %lu, Exhausted: %lu\n\r",
+                        (unsigned long)stats.committed, (unsigned long)stats.bytes,
+                        (unsigned long)(((uint64_t)stats.bytes * 1000) / stats.duration_ms),
+                        (unsigned long)stats.rejected, (unsigned long)stats.exhausted);
+        }
+#endif
 }
 
 /**
@@ -365,6 +410,52 @@ static void notif_timer_cb(OS_TIMER timer)
 }
 #endif
 
+static void handle_ble_evt(ble_evt_hdr_t *hdr, void *user_data)
+{
+        if (!ble_service_handle_event(hdr)) {
+                switch (hdr->evt_code) {
+                case BLE_EVT_GAP_CONNECTED:
+                        handle_evt_gap_connected((ble_evt_gap_connected_t *) hdr);
+                        break;
+                case BLE_EVT_GAP_ADV_COMPLETED:
+                        handle_evt_gap_adv_completed((ble_evt_gap_adv_completed_t *) hdr);
+                        break;
+                case BLE_EVT_GAP_DISCONNECTED:
+                        handle_evt_gap_disconnected((ble_evt_gap_disconnected_t *) hdr);
+                        break;
+                case BLE_EVT_GAP_PAIR_REQ:
+                {
+                        ble_evt_gap_pair_req_t *evt = (ble_evt_gap_pair_req_t *) hdr;
+                        ble_gap_pair_reply(evt->conn_idx, true, evt->bond);
+                        break;
+                }
+                case BLE_EVT_GATTC_MTU_CHANGED:
+                        handle_evt_gattc_mtu_changed((ble_evt_gattc_mtu_changed_t *) hdr);
+                        break;
+#if (dg_configSUOTA_SUPPORT == 1)
+#if (dg_configBLE_2MBIT_PHY == 1)
+                case BLE_EVT_GAP_PHY_SET_COMPLETED:
+                        handle_ble_evt_gap_phy_set_completed((ble_evt_gap_phy_set_completed_t *) hdr);
+                        break;
+                case BLE_EVT_GAP_PHY_CHANGED:
+                        handle_ble_evt_gap_phy_changed((ble_evt_gap_phy_changed_t *) hdr);
+                        break;
+#endif /* (dg_configBLE_2MBIT_PHY == 1) */
+#endif /* (dg_configSUOTA_SUPPORT == 1) */
+#if dg_configSUOTA_SUPPORT && defined(SUOTA_PSM)
+                case BLE_EVT_L2CAP_CONNECTED:
+                case BLE_EVT_L2CAP_DISCONNECTED:
+                case BLE_EVT_L2CAP_DATA_IND:
+                        suota_l2cap_event(suota, hdr);
+                        break;
+#endif
+                default:
+                        ble_handle_event_default(hdr);
+                        break;
+                }
+        }
+}
+
 /*
  * Define a task that utilizes the BLE custom service service framework, initiates the BLE controller in the slave role
  * and handles the various incoming BLE events.
@@ -372,9 +463,6 @@ static void notif_timer_cb(OS_TIMER timer)
 OS_TASK_FUNCTION(ble_peripheral_task, pvParameters)
 {
         int8_t wdog_id;
-#if dg_configSUOTA_SUPPORT
-        ble_service_t *suota;
-#endif
 
         /* register ble_peripheral task to be monitored by watchdog */
         wdog_id = sys_watchdog_register(false);
@@ -401,15 +489,29 @@ OS_TASK_FUNCTION(ble_peripheral_task, pvParameters)
 
         //************ BLE custom service data base definition  *************
 
-        const mcs_characteristic_config_t custom_service_1[] = {
+        /* Deadlines of the framework (e.g. completion of long writes) are serviced by this task */
+        mcs_timer_init(OS_GET_CURRENT_TASK(), MCS_TIMER_EVENT);
+
+#if MCS_BENCHMARK_EN
+        uint32_t registration_cycles;
+        size_t registration_heap;
+
+        MCS_BENCHMARK_CYCLES_INIT();
+
+        registration_heap = OS_GET_FREE_HEAP_SIZE();
+        registration_cycles = MCS_BENCHMARK_CYCLES();
+#endif
+
+        MCS_CHARACTERISTIC_TABLE mcs_characteristic_config_t custom_service_1[] = {
 
                 /* Characteristic attributes declarations */
-                CHARACTERISTIC_DECLARATION(CHARACTERISTIC_ATTR_1_128_UUID,
+                CHARACTERISTIC_DECLARATION_VERSIONED(CHARACTERISTIC_ATTR_1_128_UUID,
                                            ATTR_MAX_SIZE,
                                            GATT_PROP_WRITE | GATT_PROP_READ | GATT_PROP_NOTIFY,
                                            ATT_PERM_RW,
                                            CHARACTERISTIC_ATTR_1_DESCRIPTOR,
                                            characteristic_attr_read_cb,
+                                           characteristic_attr_version_cb,
                                            characteristic_attr_write_cb,
                                            characteristic_attr_notification_cb),
 
@@ -420,11 +522,14 @@ OS_TASK_FUNCTION(ble_peripheral_task, pvParameters)
 
 
         };
+        /* Characteristic handles, used to send notifications without a UUID lookup */
+        mcs_char_handle_t custom_service_1_h[ARRAY_LENGTH(custom_service_1)];
+
         // ***************** BLE service declaration *****************
-        SERVICE_DECLARATION(custom_service_1, SERVICE_ATTR_1_128_UUID)
+        SERVICE_DECLARATION_EX(custom_service_1, SERVICE_ATTR_1_128_UUID, custom_service_1_h)
 
 
-        const mcs_characteristic_config_t custom_service_2[] = {
+        MCS_CHARACTERISTIC_TABLE mcs_characteristic_config_t custom_service_2[] = {
 
                 /* Characteristic attributes declarations. You can define your preferred settings. */
                 CHARACTERISTIC_DECLARATION(CHARACTERISTIC_ATTR_2_128_UUID, 0,
@@ -453,8 +558,34 @@ OS_TASK_FUNCTION(ble_peripheral_task, pvParameters)
                 // -----------------------------------------------------------------
 
         };
+        /* Characteristic handles, used to send notifications without a UUID lookup */
+        mcs_char_handle_t custom_service_2_h[ARRAY_LENGTH(custom_service_2)];
+
         // ***************** BLE service declaration *****************
-        SERVICE_DECLARATION(custom_service_2, SERVICE_ATTR_2_128_UUID)
+        SERVICE_DECLARATION_EX(custom_service_2, SERVICE_ATTR_2_128_UUID, custom_service_2_h)
+
+#if MCS_BENCHMARK_EN
+        registration_cycles = MCS_BENCHMARK_CYCLES() - registration_cycles;
+        registration_heap -= OS_GET_FREE_HEAP_SIZE();
+
+        DBG_PRINTF("\n\rService registration (%s tables) - %lu cycles, Heap: %lu bytes\n\r",
+                MCS_STATIC_SERVICES ? "static" : "dynamic", (unsigned long)registration_cycles,
+                                                            (unsigned long)registration_heap);
+#endif
+
+#if MCS_BENCHMARK_EN
+        {
+                const uint8_t num_of_characteristics[] = { 5, 20, 50 };
+                uint32_t list_cycles, table_cycles;
+
+                for (int i = 0; i < ARRAY_LENGTH(num_of_characteristics); i++) {
+                        mcs_dispatch_benchmark(num_of_characteristics[i], &list_cycles, &table_cycles);
+
+                        DBG_PRINTF("\n\rDispatch benchmark - Characteristics: %d, List: %lu cycles, Table: %lu cycles\n\r",
+                                num_of_characteristics[i], (unsigned long)list_cycles, (unsigned long)table_cycles);
+                }
+        }
+#endif
 
 #if dg_configSUOTA_SUPPORT
         /* Add SUOTA Service */
@@ -466,6 +597,21 @@ OS_TASK_FUNCTION(ble_peripheral_task, pvParameters)
 #endif
 
         strcpy((char *)attribute_value, "Some dummy text.");
+        attribute_version++;
+
+#if MCS_BENCHMARK_EN
+        {
+                const uint16_t mtu[] = { 23, defaultBLE_MAX_MTU_SIZE };
+                uint32_t uncached_cycles, cached_cycles;
+
+                for (int i = 0; i < ARRAY_LENGTH(mtu); i++) {
+                        mcs_read_benchmark(custom_service_1_h[0], mtu[i], &uncached_cycles, &cached_cycles);
+
+                        DBG_PRINTF("\n\rLong read benchmark - Length: %d, MTU: %d, Uncached: %lu cycles, Cached: %lu cycles\n\r",
+                                ATTR_MAX_SIZE, mtu[i], (unsigned long)uncached_cycles, (unsigned long)cached_cycles);
+                }
+        }
+#endif
 
         ble_gap_adv_ad_struct_set(ARRAY_LENGTH(adv_data), adv_data, 0 , NULL);
         ble_gap_adv_start(GAP_CONN_MODE_UNDIRECTED);
@@ -504,67 +650,11 @@ OS_TASK_FUNCTION(ble_peripheral_task, pvParameters)
 
                 /* notified from BLE manager, can get event */
                 if (notif & BLE_APP_NOTIFY_MASK) {
-                        ble_evt_hdr_t *hdr;
-
-                        hdr = ble_get_event(false);
-                        if (!hdr) {
-                                goto no_event;
-                        }
-
-                        if (!ble_service_handle_event(hdr)) {
-                                switch (hdr->evt_code) {
-                                case BLE_EVT_GAP_CONNECTED:
-                                        handle_evt_gap_connected((ble_evt_gap_connected_t *) hdr);
-                                        break;
-                                case BLE_EVT_GAP_ADV_COMPLETED:
-                                        handle_evt_gap_adv_completed((ble_evt_gap_adv_completed_t *) hdr);
-                                        break;
-                                case BLE_EVT_GAP_DISCONNECTED:
-                                        handle_evt_gap_disconnected((ble_evt_gap_disconnected_t *) hdr);
-                                        break;
-                                case BLE_EVT_GAP_PAIR_REQ:
-                                {
-                                        ble_evt_gap_pair_req_t *evt = (ble_evt_gap_pair_req_t *) hdr;
-                                        ble_gap_pair_reply(evt->conn_idx, true, evt->bond);
-                                        break;
-                                }
-                                case BLE_EVT_GATTC_MTU_CHANGED:
-                                        handle_evt_gattc_mtu_changed((ble_evt_gattc_mtu_changed_t *) hdr);
-                                        break;
-        #if (dg_configSUOTA_SUPPORT == 1)
-        #if (dg_configBLE_2MBIT_PHY == 1)
-                                        case BLE_EVT_GAP_PHY_SET_COMPLETED:
-                                                handle_ble_evt_gap_phy_set_completed((ble_evt_gap_phy_set_completed_t *) hdr);
-                                                break;
-                                        case BLE_EVT_GAP_PHY_CHANGED:
-                                                handle_ble_evt_gap_phy_changed((ble_evt_gap_phy_changed_t *) hdr);
-                                                break;
-        #endif /* (dg_configBLE_2MBIT_PHY == 1) */
-        #endif /* (dg_configSUOTA_SUPPORT == 1) */
-        #if dg_configSUOTA_SUPPORT && defined(SUOTA_PSM)
-                                        case BLE_EVT_L2CAP_CONNECTED:
-                                        case BLE_EVT_L2CAP_DISCONNECTED:
-                                        case BLE_EVT_L2CAP_DATA_IND:
-                                                suota_l2cap_event(suota, hdr);
-                                                break;
-        #endif
-                                default:
-                                        ble_handle_event_default(hdr);
-                                        break;
-                                }
-                        }
-
-                        /* Free event buffer (it's not needed anymore) */
-                        OS_FREE(hdr);
+                        ble_evt_pump(OS_GET_CURRENT_TASK(), handle_ble_evt, NULL);
+                }
 
-no_event:
-                        /*
-                         * If there are more events waiting in queue, application should process
-                         * them now.
-                         */
-                        if (ble_has_event()) {
-                                OS_TASK_NOTIFY(OS_GET_CURRENT_TASK(), BLE_APP_NOTIFY_MASK, OS_NOTIFY_SET_BITS);
-                        }
+                if (notif & MCS_TIMER_EVENT) {
+                        mcs_timer_expired();
                 }
 
 #if APP_NOTIF_DEMONSTRATION
@@ -583,8 +673,60 @@ no_event:
                         mcs_send_notifications(CHARACTERISTIC_ATTR_1_128_UUID,
                              (const uint8_t *)&arbitrary_value, sizeof(arbitrary_value));
 
-                        mcs_send_notifications(CHARACTERISTIC_ATTR_4_128_UUID,
+                        /* Send notifications for a specific attribute value (referenced by its handle) */
+                        mcs_char_send_notifications(custom_service_2_h[2],
                              (const uint8_t *)&arbitrary_value, sizeof(arbitrary_value));
+
+                        {
+                                mcs_notif_stats_t stats;
+                                mcs_indic_stats_t indic_stats;
+
+                                mcs_notif_get_stats(&stats);
+                                DBG_PRINTF("\n\rNotifications - Sent: %lu, Coalesced: %lu, Dropped: %lu\n\r",
+                                        (unsigned long)stats.sent, (unsigned long)stats.coalesced,
+                                        (unsigned long)stats.dropped);
+
+                                mcs_indic_get_stats(&indic_stats);
+                                DBG_PRINTF("\n\rIndications - Queued: %lu, Confirmed: %lu, Timeouts: %lu, Overflows: %lu, Oversized: %lu, Max. depth: %d\n\r",
+                                        (unsigned long)indic_stats.queued, (unsigned long)indic_stats.confirmed,
+                                        (unsigned long)indic_stats.timeouts, (unsigned long)indic_stats.overflows,
+                                        (unsigned long)indic_stats.oversized, indic_stats.max_depth);
+                        }
+
+#if MCS_BENCHMARK_EN
+                        {
+                                uint32_t legacy_cycles, uuid_cycles, handle_cycles;
+
+                                mcs_notify_benchmark(custom_service_1_h[0], CHARACTERISTIC_ATTR_1_128_UUID,
+                                        (const uint8_t *)&arbitrary_value, sizeof(arbitrary_value),
+                                        &legacy_cycles, &uuid_cycles, &handle_cycles);
+
+                                DBG_PRINTF("\n\rNotification benchmark - Legacy: %lu cycles, UUID: %lu cycles, Handle: %lu cycles\n\r",
+                                        (unsigned long)legacy_cycles, (unsigned long)uuid_cycles, (unsigned long)handle_cycles);
+                        }
+
+                        {
+                                uint32_t storage_cycles, cache_cycles;
+                                uint8_t num_of_peers;
+
+                                mcs_fanout_benchmark(custom_service_2_h[2], (const uint8_t *)&arbitrary_value,
+                                        sizeof(arbitrary_value), &num_of_peers, &storage_cycles, &cache_cycles);
+
+                                DBG_PRINTF("\n\rFanout benchmark - Peers: %d, Storage: %lu cycles, Cache: %lu cycles\n\r",
+                                        num_of_peers, (unsigned long)storage_cycles, (unsigned long)cache_cycles);
+                        }
+
+                        {
+                                const mcs_char_handle_t chr[] = { custom_service_1_h[0], custom_service_2_h[2] };
+                                uint32_t single_cycles, txn_cycles;
+
+                                mcs_txn_benchmark(chr, ARRAY_LENGTH(chr), (const uint8_t *)&arbitrary_value,
+                                        sizeof(arbitrary_value), &single_cycles, &txn_cycles);
+
+                                DBG_PRINTF("\n\rTransaction benchmark - Characteristics: %d, Single: %lu cycles, Transaction: %lu cycles\n\r",
+                                        ARRAY_LENGTH(chr), (unsigned long)single_cycles, (unsigned long)txn_cycles);
+                        }
+#endif
                 }
 #endif
         }
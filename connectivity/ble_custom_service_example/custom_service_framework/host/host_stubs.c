@@ -0,0 +1,381 @@
+/**
+ ****************************************************************************************
+ *
+ * @file host_stubs.c
+ *
+ * @brief Stub OS and BLE layers of the custom service framework host build
+ *
+ * Copyright (C) 2024 Renesas Electronics Corporation and/or its affiliates.
+ * All rights reserved. Confidential Information.
+ *
+ * This software ("Software") is supplied by Renesas Electronics Corporation and/or its
+ * affiliates ("Renesas"). Renesas grants you a personal, non-exclusive, non-transferable,
+ * revocable, non-sub-licensable right and license to use the Software, solely if used in
+ * or together with Renesas products. You may make copies of this Software, provided this
+ * copyright notice and disclaimer ("Notice") is included in all such copies. Renesas
+ * reserves the right to change or discontinue the Software at any time without notice.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS". RENESAS DISCLAIMS ALL WARRANTIES OF ANY KIND,
+ * WHETHER EXPRESS, IMPLIED, OR STATUTORY, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT. TO THE
+ * MAXIMUM EXTENT PERMITTED UNDER LAW, IN NO EVENT SHALL RENESAS BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, SPECIAL, INCIDENTAL OR CONSEQUENTIAL DAMAGES ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE, EVEN IF RENESAS HAS BEEN ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGES. USE OF THIS SOFTWARE MAY BE SUBJECT TO TERMS AND CONDITIONS CONTAINED IN
+ * AN ADDITIONAL AGREEMENT BETWEEN YOU AND RENESAS. IN CASE OF CONFLICT BETWEEN THE TERMS
+ * OF THIS NOTICE AND ANY SUCH ADDITIONAL LICENSE AGREEMENT, THE TERMS OF THE AGREEMENT
+ * SHALL TAKE PRECEDENCE. BY CONTINUING TO USE THIS SOFTWARE, YOU AGREE TO THE TERMS OF
+ * THIS NOTICE.IF YOU DO NOT AGREE TO THESE TERMS, YOU ARE NOT PERMITTED TO USE THIS
+ * SOFTWARE.
+ *
+ ****************************************************************************************
+ */
+
+#include <stdarg.h>
+#include <time.h>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+#include "osal.h"
+#include "ble_gap.h"
+#include "ble_gatts.h"
+#include "ble_service.h"
+#include "ble_storage.h"
+#include "ble_uuid.h"
+#include "host_config.h"
+#include "host_stubs.h"
+
+/* Max. number of CCC values kept by the stub BLE storage */
+#define HOST_STORAGE_SIZE               ( 1024 )
+
+struct host_timer {
+        bool active;
+        OS_TICK_TIME deadline;
+        host_timer_cb_t cb;
+};
+
+typedef struct {
+        bool used;
+        uint16_t conn_idx;
+        ble_storage_key_t key;
+        uint32_t value;
+} host_storage_entry_t;
+
+host_gatts_log_t host_gatts_log;
+
+static OS_TICK_TIME now;
+static uint32_t notif;
+static size_t heap_in_use, heap_peak;
+static uint32_t asserts;
+
+/* Only the framework timer is created */
+static struct host_timer timer;
+
+static host_storage_entry_t storage[HOST_STORAGE_SIZE];
+
+/* Attribute handle offsets allocated while a service is declared; services start at handle 1 */
+static uint16_t handle_offset;
+static uint16_t next_start_h = 1;
+
+/*********************************** Harness services ***************************************/
+
+uint64_t host_cycles(void)
+{
+#if defined(__x86_64__) || defined(__i386__)
+        return __rdtsc();
+#else
+        struct timespec ts;
+
+        clock_gettime(CLOCK_MONOTONIC, &ts);
+        return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+#endif
+}
+
+void host_assert_failed(const char *file, int line)
+{
+        asserts++;
+        fprintf(stderr, "Assertion failed: %s:%d\n", file, line);
+}
+
+uint32_t host_assert_count(void)
+{
+        return asserts;
+}
+
+void host_gatts_log_reset(void)
+{
+        host_gatts_log.num_of_cfm = 0;
+        host_gatts_log.type = HOST_CFM_NONE;
+}
+
+void host_advance(uint32_t ms)
+{
+        now += ms;
+
+        if (timer.active && ((int32_t)(now - timer.deadline) >= 0)) {
+                timer.active = false;
+                timer.cb(&timer);
+        }
+}
+
+uint32_t host_take_notif(void)
+{
+        uint32_t value = notif;
+
+        notif = 0;
+        return value;
+}
+
+size_t host_heap_in_use(void)
+{
+        return heap_in_use;
+}
+
+size_t host_heap_peak(void)
+{
+        return heap_peak;
+}
+
+/************************************* OS layer *********************************************/
+
+void *host_malloc(size_t size)
+{
+        size_t *block = malloc(sizeof(size_t) + size);
+
+        if (block == NULL) {
+                return NULL;
+        }
+
+        *block = size;
+        heap_in_use += size;
+        heap_peak = MAX(heap_peak, heap_in_use);
+        return block + 1;
+}
+
+void host_free(void *ptr)
+{
+        if (ptr) {
+                size_t *block = (size_t *)ptr - 1;
+
+                heap_in_use -= *block;
+                free(block);
+        }
+}
+
+OS_TICK_TIME host_get_tick_count(void)
+{
+        return now;
+}
+
+void host_task_notify(OS_TASK task, uint32_t value)
+{
+        notif |= value;
+}
+
+OS_TIMER host_timer_create(OS_TICK_TIME period, bool reload, void *id, host_timer_cb_t cb)
+{
+        timer.active = false;
+        timer.cb = cb;
+        return &timer;
+}
+
+void host_timer_start(OS_TIMER t, OS_TICK_TIME period)
+{
+        t->active = true;
+        t->deadline = now + period;
+}
+
+void host_timer_stop(OS_TIMER t)
+{
+        t->active = false;
+}
+
+bool host_timer_is_active(OS_TIMER t)
+{
+        return t->active;
+}
+
+/*********************************** GATT server ********************************************/
+
+uint16_t ble_gatts_get_num_attr(uint16_t include, uint16_t characteristics, uint16_t descriptors)
+{
+        return 1 + include + (2 * characteristics) + descriptors;
+}
+
+ble_error_t ble_gatts_add_service(const att_uuid_t *uuid, gatt_service_t type, uint16_t num_attrs)
+{
+        handle_offset = 0;
+        return BLE_STATUS_OK;
+}
+
+ble_error_t ble_gatts_add_characteristic(const att_uuid_t *uuid, gatt_prop_t prop, att_perm_t perm,
+                        uint16_t max_len, gatts_flag_t flags, uint16_t *h_offset, uint16_t *h_val_offset)
+{
+        /* Characteristic declaration followed by the value */
+        if (h_offset) {
+                *h_offset = handle_offset + 1;
+        }
+        handle_offset += 2;
+        *h_val_offset = handle_offset;
+        return BLE_STATUS_OK;
+}
+
+ble_error_t ble_gatts_add_descriptor(const att_uuid_t *uuid, att_perm_t perm, uint16_t max_len,
+                                                        gatts_flag_t flags, uint16_t *h_offset)
+{
+        *h_offset = ++handle_offset;
+        return BLE_STATUS_OK;
+}
+
+ble_error_t ble_gatts_register_service(uint16_t *handle, ...)
+{
+        va_list ap;
+        uint16_t *h;
+
+        /* The offsets passed are turned into handles, as done by the BLE stack */
+        *handle = next_start_h;
+        next_start_h += handle_offset + 1;
+
+        va_start(ap, handle);
+        while ((h = va_arg(ap, uint16_t *)) != NULL) {
+                *h += *handle;
+        }
+        va_end(ap);
+
+        return BLE_STATUS_OK;
+}
+
+ble_error_t ble_gatts_set_value(uint16_t handle, uint16_t length, const void *value)
+{
+        return BLE_STATUS_OK;
+}
+
+static void gatts_log_cfm(host_cfm_type_t type, uint16_t handle, att_error_t status, uint16_t length,
+                                                                                const void *value)
+{
+        host_gatts_log.num_of_cfm++;
+        host_gatts_log.type = type;
+        host_gatts_log.handle = handle;
+        host_gatts_log.status = status;
+        host_gatts_log.length = length;
+        host_gatts_log.value = value;
+}
+
+ble_error_t ble_gatts_read_cfm(uint16_t conn_idx, uint16_t handle, att_error_t status, uint16_t length,
+                                                                                const void *value)
+{
+        gatts_log_cfm(HOST_CFM_READ, handle, status, length, value);
+        return BLE_STATUS_OK;
+}
+
+ble_error_t ble_gatts_write_cfm(uint16_t conn_idx, uint16_t handle, att_error_t status)
+{
+        gatts_log_cfm(HOST_CFM_WRITE, handle, status, 0, NULL);
+        return BLE_STATUS_OK;
+}
+
+ble_error_t ble_gatts_prepare_write_cfm(uint16_t conn_idx, uint16_t handle, uint16_t length, att_error_t status)
+{
+        gatts_log_cfm(HOST_CFM_PREPARE_WRITE, handle, status, length, NULL);
+        return BLE_STATUS_OK;
+}
+
+ble_error_t ble_gatts_send_event(uint16_t conn_idx, uint16_t handle, gatt_event_t type, uint16_t length,
+                                                                                const void *value)
+{
+        if (host_gatts_log.events_rejected) {
+                return BLE_ERROR_FAILED;
+        }
+
+        host_gatts_log.num_of_events++;
+        memcpy(host_gatts_log.event_value, value, MIN(length, sizeof(host_gatts_log.event_value)));
+        return BLE_STATUS_OK;
+}
+
+void ble_service_add(ble_service_t *svc)
+{
+}
+
+/*************************************** GAP ************************************************/
+
+ble_error_t ble_gap_get_connected(uint8_t *length, uint16_t **conn_idx)
+{
+        /* Only used by the legacy notification path; no peer device is reported */
+        *length = 0;
+        *conn_idx = NULL;
+        return BLE_STATUS_OK;
+}
+
+/************************************** Storage *********************************************/
+
+static host_storage_entry_t *storage_find(uint16_t conn_idx, ble_storage_key_t key, bool create)
+{
+        host_storage_entry_t *free_entry = NULL;
+
+        for (int i = 0; i < HOST_STORAGE_SIZE; i++) {
+                if (storage[i].used && (storage[i].conn_idx == conn_idx) && (storage[i].key == key)) {
+                        return &storage[i];
+                }
+                if (!storage[i].used && (free_entry == NULL)) {
+                        free_entry = &storage[i];
+                }
+        }
+
+        if (create && free_entry) {
+                free_entry->used = true;
+                free_entry->conn_idx = conn_idx;
+                free_entry->key = key;
+                return free_entry;
+        }
+        return NULL;
+}
+
+ble_error_t ble_storage_get_u16(uint16_t conn_idx, ble_storage_key_t key, uint16_t *value)
+{
+        host_storage_entry_t *entry = storage_find(conn_idx, key, false);
+
+        if (entry == NULL) {
+                return BLE_ERROR_FAILED;
+        }
+
+        *value = (uint16_t)entry->value;
+        return BLE_STATUS_OK;
+}
+
+ble_error_t ble_storage_put_u32(uint16_t conn_idx, ble_storage_key_t key, uint32_t value, bool persistent)
+{
+        host_storage_entry_t *entry = storage_find(conn_idx, key, true);
+
+        if (entry == NULL) {
+                return BLE_ERROR_FAILED;
+        }
+
+        entry->value = value;
+        return BLE_STATUS_OK;
+}
+
+ble_error_t ble_storage_remove_all(ble_storage_key_t key)
+{
+        for (int i = 0; i < HOST_STORAGE_SIZE; i++) {
+                if (storage[i].key == key) {
+                        storage[i].used = false;
+                }
+        }
+        return BLE_STATUS_OK;
+}
+
+/*************************************** UUID ***********************************************/
+
+void ble_uuid_create16(uint16_t uuid16, att_uuid_t *uuid)
+{
+        memset(uuid, 0, sizeof(*uuid));
+        uuid->uuid16 = uuid16;
+}
+
+ble_error_t ble_uuid_from_string(const char *str, att_uuid_t *uuid)
+{
+        memset(uuid, 0, sizeof(*uuid));
+        uuid->type = 1;
+        memcpy(uuid->uuid128, str, MIN(strlen(str), sizeof(uuid->uuid128)));
+        return BLE_STATUS_OK;
+}
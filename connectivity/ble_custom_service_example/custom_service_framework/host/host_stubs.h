@@ -0,0 +1,81 @@
+/**
+ ****************************************************************************************
+ *
+ * @file host_stubs.h
+ *
+ * @brief Stub GATT server of the custom service framework host build
+ *
+ * Copyright (C) 2024 Renesas Electronics Corporation and/or its affiliates.
+ * All rights reserved. Confidential Information.
+ *
+ * This software ("Software") is supplied by Renesas Electronics Corporation and/or its
+ * affiliates ("Renesas"). Renesas grants you a personal, non-exclusive, non-transferable,
+ * revocable, non-sub-licensable right and license to use the Software, solely if used in
+ * or together with Renesas products. You may make copies of this Software, provided this
+ * copyright notice and disclaimer ("Notice") is included in all such copies. Renesas
+ * reserves the right to change or discontinue the Software at any time without notice.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS". RENESAS DISCLAIMS ALL WARRANTIES OF ANY KIND,
+ * WHETHER EXPRESS, IMPLIED, OR STATUTORY, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT. TO THE
+ * MAXIMUM EXTENT PERMITTED UNDER LAW, IN NO EVENT SHALL RENESAS BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, SPECIAL, INCIDENTAL OR CONSEQUENTIAL DAMAGES ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE, EVEN IF RENESAS HAS BEEN ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGES. USE OF THIS SOFTWARE MAY BE SUBJECT TO TERMS AND CONDITIONS CONTAINED IN
+ * AN ADDITIONAL AGREEMENT BETWEEN YOU AND RENESAS. IN CASE OF CONFLICT BETWEEN THE TERMS
+ * OF THIS NOTICE AND ANY SUCH ADDITIONAL LICENSE AGREEMENT, THE TERMS OF THE AGREEMENT
+ * SHALL TAKE PRECEDENCE. BY CONTINUING TO USE THIS SOFTWARE, YOU AGREE TO THE TERMS OF
+ * THIS NOTICE.IF YOU DO NOT AGREE TO THESE TERMS, YOU ARE NOT PERMITTED TO USE THIS
+ * SOFTWARE.
+ *
+ ****************************************************************************************
+ */
+
+#ifndef HOST_STUBS_H_
+#define HOST_STUBS_H_
+
+#include "osal.h"
+#include "ble_att.h"
+#include "ble_gatt.h"
+
+/* Kind of the last response sent by the framework */
+typedef enum {
+        HOST_CFM_NONE,
+        HOST_CFM_READ,
+        HOST_CFM_WRITE,
+        HOST_CFM_PREPARE_WRITE,
+} host_cfm_type_t;
+
+/* Responses and events sent by the framework, as recorded by the stub GATT server */
+typedef struct {
+        uint32_t num_of_cfm;            // Responses sent since the last reset
+        host_cfm_type_t type;           // Last response sent
+        uint16_t handle;
+        att_error_t status;
+        uint16_t length;
+        const void *value;
+
+        uint32_t num_of_events;         // Notifications/indications sent
+        uint8_t event_value[4];         // First bytes of the last event sent
+        bool events_rejected;           // Events sent are rejected (BLE_ERROR_FAILED) if set
+} host_gatts_log_t;
+
+extern host_gatts_log_t host_gatts_log;
+
+/* Clear the responses recorded before a request is synthesized */
+void host_gatts_log_reset(void);
+
+/* Advance the virtual time; a timer reaching its deadline notifies its task */
+void host_advance(uint32_t ms);
+
+/* Notification bits latched for the application task since the last call; cleared once read */
+uint32_t host_take_notif(void);
+
+/* Heap currently allocated via OS_MALLOC() and its high-water mark */
+size_t host_heap_in_use(void);
+size_t host_heap_peak(void);
+
+/* Number of assertions failed */
+uint32_t host_assert_count(void);
+
+#endif /* HOST_STUBS_H_ */
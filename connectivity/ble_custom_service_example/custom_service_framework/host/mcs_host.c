@@ -0,0 +1,774 @@
+/**
+ ****************************************************************************************
+ *
+ * @file mcs_host.c
+ *
+ * @brief Host test and benchmark harness of the custom service framework
+ *
+ * Copyright (C) 2024 Renesas Electronics Corporation and/or its affiliates.
+ * All rights reserved. Confidential Information.
+ *
+ * This software ("Software") is supplied by Renesas Electronics Corporation and/or its
+ * affiliates ("Renesas"). Renesas grants you a personal, non-exclusive, non-transferable,
+ * revocable, non-sub-licensable right and license to use the Software, solely if used in
+ * or together with Renesas products. You may make copies of this Software, provided this
+ * copyright notice and disclaimer ("Notice") is included in all such copies. Renesas
+ * reserves the right to change or discontinue the Software at any time without notice.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS". RENESAS DISCLAIMS ALL WARRANTIES OF ANY KIND,
+ * WHETHER EXPRESS, IMPLIED, OR STATUTORY, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT. TO THE
+ * MAXIMUM EXTENT PERMITTED UNDER LAW, IN NO EVENT SHALL RENESAS BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, SPECIAL, INCIDENTAL OR CONSEQUENTIAL DAMAGES ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE, EVEN IF RENESAS HAS BEEN ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGES. USE OF THIS SOFTWARE MAY BE SUBJECT TO TERMS AND CONDITIONS CONTAINED IN
+ * AN ADDITIONAL AGREEMENT BETWEEN YOU AND RENESAS. IN CASE OF CONFLICT BETWEEN THE TERMS
+ * OF THIS NOTICE AND ANY SUCH ADDITIONAL LICENSE AGREEMENT, THE TERMS OF THE AGREEMENT
+ * SHALL TAKE PRECEDENCE. BY CONTINUING TO USE THIS SOFTWARE, YOU AGREE TO THE TERMS OF
+ * THIS NOTICE.IF YOU DO NOT AGREE TO THESE TERMS, YOU ARE NOT PERMITTED TO USE THIS
+ * SOFTWARE.
+ *
+ ****************************************************************************************
+ */
+
+/*
+ * The framework is built against the stub OS and GATT server layers of this directory. GATT
+ * requests are synthesized for generated services and dispatched to the service callbacks, as
+ * done by the BLE service framework on the target.
+ *
+ * bench: per request CPU cycles (host cycle counter) and heap used, for services of 5 up to 250
+ *        characteristics, along with the framework benchmark routines.
+ * fuzz:  random requests with malformed handles, offsets and lengths, interleaved with connection
+ *        events and timer expirations. Every request should be responded exactly once, values
+ *        delivered should fit the characteristic and no assertion should fail. With
+ *        HOST_LIBFUZZER defined, the same requests are decoded from the libFuzzer input instead.
+ */
+
+#include <inttypes.h>
+#include "osal.h"
+#include "ble_gatts.h"
+#include "ble_service.h"
+#include "ble_custom_service.h"
+#include "host_stubs.h"
+
+/* Number of requests synthesized per request type in the benchmark mode */
+#define HOST_BENCH_ROUNDS               ( 1000 )
+
+/* Max. number of characteristics of a generated service */
+#define HOST_MAX_CHARACTERISTICS        ( 250 )
+
+/* Max. size of a characteristic value (and of a write request value) */
+#define HOST_MAX_VALUE_SIZE             ( 512 )
+
+/* ATT MTU assumed by the read blob requests */
+#define HOST_MTU                        ( 23 )
+
+/* Notification bit of the application task reserved for the framework timer */
+#define HOST_MCS_TIMER_NOTIF            ( 1 << 2 )
+
+/* Default number of requests synthesized in the fuzz mode */
+#define HOST_FUZZ_ITERATIONS            ( 100000 )
+
+/* Generated service */
+typedef struct {
+        uint8_t num_of_characteristics;
+        mcs_characteristic_config_t *cfg;
+        char (*uuids)[40];
+        mcs_char_handle_t handles[HOST_MAX_CHARACTERISTICS];
+        ble_service_t *svc;
+} host_service_t;
+
+static host_service_t service;
+
+/* Value returned by the read callbacks and its version */
+static uint8_t value[HOST_MAX_VALUE_SIZE];
+static uint16_t value_length = HOST_MAX_VALUE_SIZE;
+static uint32_t value_version;
+
+/* Max. sizes the characteristics are generated with; one write callback per size */
+#define HOST_MAX_SIZES                  ( 6 )
+
+static uint16_t max_sizes[HOST_MAX_SIZES];
+static uint32_t num_of_violations;
+
+/* Write request buffer; the value follows the event */
+static union {
+        ble_evt_gatts_write_req_t evt;
+        uint8_t raw[sizeof(ble_evt_gatts_write_req_t) + HOST_MAX_VALUE_SIZE + 100];
+} write_req;
+
+static void violation(const char *what, uint16_t handle)
+{
+        num_of_violations++;
+        fprintf(stderr, "Violation: %s (handle %d)\n", what, handle);
+}
+
+/******************************** Characteristic callbacks **********************************/
+
+static void get_value_cb(uint8_t **v, uint16_t *length)
+{
+        *v = value;
+        *length = value_length;
+}
+
+static void set_value(int size_idx, uint16_t length)
+{
+        if (length > max_sizes[size_idx]) {
+                violation("value delivered exceeds the max. size", 0);
+        }
+}
+
+#define SET_VALUE_CB(n) \
+        static void set_value_cb_##n(const uint8_t *v, uint16_t length) { set_value(n, length); }
+
+SET_VALUE_CB(0)
+SET_VALUE_CB(1)
+SET_VALUE_CB(2)
+SET_VALUE_CB(3)
+SET_VALUE_CB(4)
+SET_VALUE_CB(5)
+
+static void (*const set_value_cbs[HOST_MAX_SIZES])(const uint8_t *v, uint16_t length) = {
+        set_value_cb_0, set_value_cb_1, set_value_cb_2, set_value_cb_3, set_value_cb_4, set_value_cb_5,
+};
+
+static uint32_t get_version_cb(void)
+{
+        return value_version;
+}
+
+/*********************************** Service generation ************************************/
+
+/*
+ * Generate and register a service of \p num characteristics, with mixed properties. Sizes are
+ * taken from \p max_sizes in turn.
+ */
+static void service_create(uint8_t num, const uint16_t sizes[], int num_of_sizes)
+{
+        static const gatt_prop_t props[] = {
+                GATT_PROP_READ | GATT_PROP_WRITE | GATT_PROP_NOTIFY,
+                GATT_PROP_READ | GATT_PROP_WRITE | GATT_PROP_INDICATE,
+                GATT_PROP_READ,
+                GATT_PROP_WRITE,
+        };
+
+        ASSERT_WARNING(num <= HOST_MAX_CHARACTERISTICS);
+        ASSERT_WARNING(num_of_sizes <= HOST_MAX_SIZES);
+
+        memcpy(max_sizes, sizes, num_of_sizes * sizeof(sizes[0]));
+
+        service.num_of_characteristics = num;
+        service.cfg = calloc(num, sizeof(mcs_characteristic_config_t));
+        service.uuids = calloc(num, sizeof(*service.uuids));
+
+        for (int i = 0; i < num; i++) {
+                const mcs_characteristic_config_t chr = {
+                        .uuid                 = service.uuids[i],
+                        .max_size             = max_sizes[i % num_of_sizes],
+                        .gatt_prop            = props[i % ARRAY_LENGTH(props)],
+                        .att_perm             = ATT_PERM_RW,
+                        .user_descriptor      = (i % 3) ? "NULL" : "Generated",
+                        .user_descriptor_size = (i % 3) ? 4 : 9,
+                        {
+                                .get_value    = get_value_cb,
+                                .set_value    = set_value_cbs[i % num_of_sizes],
+                                .event_sent   = NULL,
+                                .get_version  = (i % 2) ? get_version_cb : NULL,
+                        }
+                };
+
+                snprintf(service.uuids[i], sizeof(service.uuids[i]), "00000000-0000-0000-0000-%012d", i);
+                memcpy(&service.cfg[i], &chr, sizeof(chr));
+        }
+
+        service.svc = mcs_service_init_ex(service.cfg, "11111111-0000-0000-0000-000000000000", num,
+                                                                                service.handles);
+}
+
+static void service_destroy(void)
+{
+        service.svc->cleanup(service.svc);
+        free(service.cfg);
+        free(service.uuids);
+        service.svc = NULL;
+}
+
+/*********************************** Request synthesis **************************************/
+
+static void connect(uint16_t conn_idx)
+{
+        ble_evt_gap_connected_t evt = { .conn_idx = conn_idx };
+
+        service.svc->connected_evt(service.svc, &evt);
+}
+
+static void disconnect(uint16_t conn_idx)
+{
+        ble_evt_gap_disconnected_t evt = { .conn_idx = conn_idx };
+
+        service.svc->disconnected_evt(service.svc, &evt);
+}
+
+/* Check that a request has been responded exactly once, with a response of the expected type */
+static void check_cfm(host_cfm_type_t type, uint16_t handle)
+{
+        if (host_gatts_log.num_of_cfm != 1) {
+                violation((host_gatts_log.num_of_cfm ? "request responded more than once" :
+                                                        "request not responded"), handle);
+        } else if (host_gatts_log.type != type) {
+                violation("unexpected response type", handle);
+        }
+}
+
+static void read_req(uint16_t conn_idx, uint16_t handle, uint16_t offset)
+{
+        ble_evt_gatts_read_req_t evt = { .conn_idx = conn_idx, .handle = handle, .offset = offset };
+
+        host_gatts_log_reset();
+        service.svc->read_req(service.svc, &evt);
+        check_cfm(HOST_CFM_READ, handle);
+
+        if ((host_gatts_log.status == ATT_ERROR_OK) && host_gatts_log.length &&
+                                                                (host_gatts_log.value == NULL)) {
+                violation("read response without a value", handle);
+        }
+}
+
+static void write_req_send(uint16_t conn_idx, uint16_t handle, uint16_t offset, uint16_t length)
+{
+        write_req.evt.conn_idx = conn_idx;
+        write_req.evt.handle = handle;
+        write_req.evt.offset = offset;
+        write_req.evt.length = length;
+
+        host_gatts_log_reset();
+        service.svc->write_req(service.svc, &write_req.evt);
+        check_cfm(HOST_CFM_WRITE, handle);
+}
+
+static void ccc_write_req(uint16_t conn_idx, uint16_t handle, uint16_t ccc, uint16_t length)
+{
+        write_req.evt.value[0] = (uint8_t)ccc;
+        write_req.evt.value[1] = (uint8_t)(ccc >> 8);
+        write_req_send(conn_idx, handle, 0, length);
+}
+
+static att_error_t prepare_write_req(uint16_t conn_idx, uint16_t handle)
+{
+        ble_evt_gatts_prepare_write_req_t evt = { .conn_idx = conn_idx, .handle = handle };
+
+        host_gatts_log_reset();
+        service.svc->prepare_write_req(service.svc, &evt);
+        check_cfm(HOST_CFM_PREPARE_WRITE, handle);
+        return host_gatts_log.status;
+}
+
+static void event_sent(uint16_t conn_idx, uint16_t handle, gatt_event_t type, bool status)
+{
+        ble_evt_gatts_event_sent_t evt = { .conn_idx = conn_idx, .handle = handle, .type = type,
+                                                                                .status = status };
+
+        host_gatts_log_reset();
+        service.svc->event_sent(service.svc, &evt);
+        if (host_gatts_log.num_of_cfm) {
+                violation("response sent on event completion", handle);
+        }
+}
+
+/* Advance the virtual time and service the framework timer, as the application task does */
+static void advance(uint32_t ms)
+{
+        host_advance(ms);
+
+        if (host_take_notif() & HOST_MCS_TIMER_NOTIF) {
+                mcs_timer_expired();
+        }
+}
+
+/************************************** Benchmark *******************************************/
+
+typedef enum {
+        BENCH_READ,
+        BENCH_READ_BLOB,
+        BENCH_WRITE,
+        BENCH_LONG_WRITE,
+        BENCH_CCC_WRITE,
+        BENCH_CCC_READ,
+        BENCH_EVENT_SENT,
+        BENCH_NOTIFY,
+        BENCH_NUM_OF_EVENTS,
+} bench_event_t;
+
+static const char *const bench_event_names[] = {
+        [BENCH_READ]       = "Read",
+        [BENCH_READ_BLOB]  = "Read blob",
+        [BENCH_WRITE]      = "Write",
+        [BENCH_LONG_WRITE] = "Long write",
+        [BENCH_CCC_WRITE]  = "CCC write",
+        [BENCH_CCC_READ]   = "CCC read",
+        [BENCH_EVENT_SENT] = "Event sent",
+        [BENCH_NOTIFY]     = "Notify",
+};
+
+/* Synthesize one request of type \p type for characteristic \p i and return the cycles spent */
+static uint64_t bench_event(bench_event_t type, int i)
+{
+        mcs_char_handle_t chr = service.handles[i];
+        uint64_t cycles = 0, start;
+
+        switch (type) {
+        case BENCH_READ:
+                start = host_cycles();
+                read_req(0, chr->attr_h, 0);
+                cycles = host_cycles() - start;
+                break;
+        case BENCH_READ_BLOB:
+                read_req(0, chr->attr_h, 0);
+                start = host_cycles();
+                read_req(0, chr->attr_h, HOST_MTU - 1);
+                cycles = host_cycles() - start;
+                break;
+        case BENCH_WRITE:
+                start = host_cycles();
+                write_req_send(0, chr->attr_h, 0, MIN(service.cfg[i].max_size, 20));
+                cycles = host_cycles() - start;
+                break;
+        case BENCH_LONG_WRITE:
+                /* Prepare write request and the fragments delivered on execution, until completion */
+                start = host_cycles();
+                if (prepare_write_req(0, chr->attr_h) == ATT_ERROR_OK) {
+                        for (int offset = 0; offset < service.cfg[i].max_size; offset += HOST_MTU - 5) {
+                                write_req_send(0, chr->attr_h, offset,
+                                                MIN(HOST_MTU - 5, service.cfg[i].max_size - offset));
+                        }
+                }
+                cycles = host_cycles() - start;
+                advance(100);
+                break;
+        case BENCH_CCC_WRITE:
+                if (chr->attr_ccc_h && (service.cfg[i].gatt_prop & (GATT_PROP_NOTIFY | GATT_PROP_INDICATE))) {
+                        start = host_cycles();
+                        ccc_write_req(0, chr->attr_ccc_h, (service.cfg[i].gatt_prop & GATT_PROP_NOTIFY) ?
+                                                GATT_CCC_NOTIFICATIONS : GATT_CCC_INDICATIONS, 2);
+                        cycles = host_cycles() - start;
+                }
+                break;
+        case BENCH_CCC_READ:
+                if (service.cfg[i].gatt_prop & (GATT_PROP_NOTIFY | GATT_PROP_INDICATE)) {
+                        start = host_cycles();
+                        read_req(0, chr->attr_ccc_h, 0);
+                        cycles = host_cycles() - start;
+                }
+                break;
+        case BENCH_EVENT_SENT:
+                start = host_cycles();
+                event_sent(0, chr->attr_h, (service.cfg[i].gatt_prop & GATT_PROP_NOTIFY) ?
+                                        GATT_EVENT_NOTIFICATION : GATT_EVENT_INDICATION, true);
+                cycles = host_cycles() - start;
+                break;
+        case BENCH_NOTIFY:
+                start = host_cycles();
+                mcs_char_send_notifications(chr, value, MIN(service.cfg[i].max_size, 20));
+                cycles = host_cycles() - start;
+                break;
+        default:
+                break;
+        }
+        return cycles;
+}
+
+/*
+ * Commit a value staged from a buffer released meanwhile, check that a commit bypasses the minimum
+ * interval and reports the values it has rejected, then benchmark the transactions
+ */
+static void bench_txn(void)
+{
+        const mcs_char_handle_t chr[] = { service.handles[0], service.handles[1] };
+        const uint8_t held[1] = { 0x33 }, staged_again[1] = { 0x44 };
+        uint32_t num_of_events, single_cycles, txn_cycles;
+        mcs_txn_t txn;
+
+        advance(1000);
+        mcs_txn_begin(&txn);
+        {
+                uint8_t staged[4] = { 0xA5, 0x5A, 0xA5, 0x5A };
+
+                mcs_txn_stage(&txn, chr[0], staged, sizeof(staged));
+                memset(staged, 0, sizeof(staged));
+        }
+        /* Sent on commit */
+        num_of_events = host_gatts_log.num_of_events;
+        if (!mcs_txn_commit(&txn)) {
+                violation("staged value rejected", chr[0]->attr_h);
+        }
+        event_sent(0, chr[0]->attr_h, GATT_EVENT_NOTIFICATION, true);
+        if ((host_gatts_log.num_of_events == num_of_events) || (host_gatts_log.event_value[0] != 0xA5)) {
+                violation("staged value not committed", chr[0]->attr_h);
+        }
+
+        /* A value held back by the minimum interval is superseded by the transaction */
+        mcs_char_set_min_interval(chr[0], 1000);
+        mcs_char_send_notifications(chr[0], held, sizeof(held));
+        num_of_events = host_gatts_log.num_of_events;
+        mcs_txn_begin(&txn);
+        mcs_txn_stage(&txn, chr[0], staged_again, sizeof(staged_again));
+        if (!mcs_txn_commit(&txn) || (host_gatts_log.num_of_events != num_of_events + 1) ||
+                                                (host_gatts_log.event_value[0] != staged_again[0])) {
+                violation("transaction held back by the minimum interval", chr[0]->attr_h);
+        }
+        event_sent(0, chr[0]->attr_h, GATT_EVENT_NOTIFICATION, true);
+        advance(2000);
+        if (host_gatts_log.num_of_events != num_of_events + 1) {
+                violation("value superseded by a transaction sent", chr[0]->attr_h);
+        }
+        mcs_char_set_min_interval(chr[0], 0);
+
+        /* Values rejected by the BLE stack fail the commit */
+        host_gatts_log.events_rejected = true;
+        mcs_txn_begin(&txn);
+        mcs_txn_stage(&txn, chr[0], staged_again, sizeof(staged_again));
+        if (mcs_txn_commit(&txn)) {
+                violation("rejected transaction committed", chr[0]->attr_h);
+        }
+        host_gatts_log.events_rejected = false;
+
+        num_of_events = host_gatts_log.num_of_events;
+        mcs_txn_benchmark(chr, ARRAY_LENGTH(chr), value, 20, &single_cycles, &txn_cycles);
+        if (host_gatts_log.num_of_events != num_of_events) {
+                violation("events sent by the transaction benchmark", chr[0]->attr_h);
+        }
+
+        printf("  Transaction  single: %lu cycles, transaction: %lu cycles (mcs_txn_benchmark)\n",
+                                        (unsigned long)single_cycles, (unsigned long)txn_cycles);
+}
+
+/*
+ * Check that a peer device holds at most one long write buffer and that buffers of prepare write
+ * sequences not executed are freed once timed out, each being counted once as cancelled
+ */
+static void bench_long_write_pool(void)
+{
+        const uint16_t h[] = { service.handles[0]->attr_h, service.handles[1]->attr_h };
+        mcs_long_write_stats_t before, after;
+
+        /* Complete any long write in progress */
+        advance(100000);
+        mcs_long_write_get_stats(&before);
+
+        if ((prepare_write_req(0, h[0]) != ATT_ERROR_OK) ||
+                                        (prepare_write_req(0, h[1]) != ATT_ERROR_PREPARE_QUEUE_FULL)) {
+                violation("more than one long write buffer held by a peer device", h[1]);
+        }
+        if (prepare_write_req(1, h[1]) != ATT_ERROR_OK) {
+                violation("long write buffer not available to another peer device", h[1]);
+        }
+
+        /* The prepared writes are never executed */
+        advance(100000);
+        if (prepare_write_req(2, h[0]) != ATT_ERROR_OK) {
+                violation("long write buffer not freed on timeout", h[0]);
+        }
+        disconnect(2);
+        disconnect(2);
+
+        mcs_long_write_get_stats(&after);
+        if ((after.cancelled - before.cancelled != 3) || (after.exhausted - before.exhausted != 1)) {
+                violation("long write buffers miscounted", h[0]);
+        }
+}
+
+/*
+ * Check that an indication rejected by the BLE stack is kept queued and sent again on the timer
+ * expiration, without being counted as dropped, and that only the indications of a characteristic
+ * no longer indicated are skipped
+ */
+static void bench_indic_retry(void)
+{
+        const mcs_char_handle_t chr = service.handles[1];
+        const uint8_t indicated[] = { 0x11, 0x22 };
+        mcs_notif_stats_t notif_before, notif_after;
+        mcs_indic_stats_t indic_before, indic_after;
+        uint32_t num_of_events;
+
+        connect(3);
+        ccc_write_req(3, chr->attr_ccc_h, GATT_CCC_INDICATIONS, 2);
+        mcs_notif_get_stats(&notif_before);
+        mcs_indic_get_stats(&indic_before);
+        num_of_events = host_gatts_log.num_of_events;
+
+        /* Rejected twice, then sent on the next retry */
+        host_gatts_log.events_rejected = true;
+        mcs_char_send_notifications(chr, &indicated[0], 1);
+        advance(20);
+        host_gatts_log.events_rejected = false;
+        if (host_gatts_log.num_of_events != num_of_events) {
+                violation("rejected indication sent", chr->attr_h);
+        }
+        advance(20);
+        if ((host_gatts_log.num_of_events != num_of_events + 1) || (host_gatts_log.event_value[0] != 0x11)) {
+                violation("rejected indication not sent again", chr->attr_h);
+        }
+
+        /* Queued behind the indication in flight, then skipped as the peer device unsubscribes */
+        mcs_char_send_notifications(chr, &indicated[1], 1);
+        ccc_write_req(3, chr->attr_ccc_h, GATT_CCC_NONE, 2);
+        event_sent(3, chr->attr_h, GATT_EVENT_INDICATION, true);
+        if (host_gatts_log.num_of_events != num_of_events + 1) {
+                violation("indication sent to a peer device no longer subscribed", chr->attr_h);
+        }
+
+        mcs_notif_get_stats(&notif_after);
+        mcs_indic_get_stats(&indic_after);
+        if ((notif_after.dropped != notif_before.dropped) || (indic_after.retries - indic_before.retries != 2) ||
+                                        (indic_after.confirmed - indic_before.confirmed != 1)) {
+                violation("indication retries miscounted", chr->attr_h);
+        }
+
+        disconnect(3);
+}
+
+static void bench_service(uint8_t num)
+{
+        static const uint16_t sizes[] = { 20, 100, HOST_MAX_VALUE_SIZE };
+        size_t heap_start = host_heap_in_use(), heap_registered;
+        uint64_t cycles = host_cycles();
+        uint32_t list_cycles, table_cycles;
+
+        service_create(num, sizes, ARRAY_LENGTH(sizes));
+        cycles = host_cycles() - cycles;
+        heap_registered = host_heap_in_use();
+
+        printf("\nCharacteristics: %d, Registration: %" PRIu64 " cycles, Heap: %zu bytes\n", num,
+                                                                cycles, heap_registered - heap_start);
+
+        connect(0);
+
+        for (int type = 0; type < BENCH_NUM_OF_EVENTS; type++) {
+                uint64_t total = 0;
+                uint32_t count = 0;
+                size_t heap_before = host_heap_in_use();
+
+                for (int round = 0; round < HOST_BENCH_ROUNDS; round++) {
+                        uint64_t c = bench_event((bench_event_t)type, round % num);
+
+                        if (c) {
+                                total += c;
+                                count++;
+                        }
+                }
+
+                printf("  %-12s %8" PRIu64 " cycles/request, heap: %+ld bytes\n", bench_event_names[type],
+                                count ? total / count : 0, (long)(host_heap_in_use() - heap_before));
+        }
+
+        bench_txn();
+        bench_long_write_pool();
+
+        disconnect(0);
+        bench_indic_retry();
+        service_destroy();
+
+        if (host_heap_in_use() != heap_start) {
+                violation("heap not released on cleanup", 0);
+        }
+
+        mcs_dispatch_benchmark(num, &list_cycles, &table_cycles);
+        printf("  Dispatch     list: %lu cycles, table: %lu cycles (mcs_dispatch_benchmark)\n",
+                                        (unsigned long)list_cycles, (unsigned long)table_cycles);
+}
+
+static void bench(void)
+{
+        static const uint8_t sizes[] = { 5, 50, HOST_MAX_CHARACTERISTICS };
+
+        for (int i = 0; i < ARRAY_LENGTH(sizes); i++) {
+                bench_service(sizes[i]);
+        }
+
+        printf("\nHeap peak: %zu bytes\n", host_heap_peak());
+}
+
+/**************************************** Fuzzing ********************************************/
+
+/* Source of the fuzz input; a PRNG (xorshift32) or the libFuzzer input */
+static uint32_t fuzz_state;
+static const uint8_t *fuzz_data;
+static size_t fuzz_size;
+
+static uint32_t fuzz_next(uint32_t range)
+{
+        uint32_t r;
+
+        if (fuzz_data) {
+                r = 0;
+                for (int i = 0; (i < 2) && fuzz_size; i++, fuzz_size--) {
+                        r = (r << 8) | *fuzz_data++;
+                }
+        } else {
+                fuzz_state ^= fuzz_state << 13;
+                fuzz_state ^= fuzz_state >> 17;
+                fuzz_state ^= fuzz_state << 5;
+                r = fuzz_state;
+        }
+        return range ? (r % range) : 0;
+}
+
+/* A handle of the service, or just outside its range */
+static uint16_t fuzz_handle(void)
+{
+        return (uint16_t)(service.svc->start_h - 1 + fuzz_next(service.svc->end_h - service.svc->start_h + 3));
+}
+
+/* An offset or length, biased towards the boundaries */
+static uint16_t fuzz_length(void)
+{
+        switch (fuzz_next(4)) {
+        case 0:
+                return 0;
+        case 1:
+                return (uint16_t)fuzz_next(24);
+        default:
+                return (uint16_t)fuzz_next(HOST_MAX_VALUE_SIZE + 64);
+        }
+}
+
+/* Synthesize one request, or another event, decoded from the fuzz input */
+static void fuzz_step(void)
+{
+        uint16_t conn_idx = (uint16_t)fuzz_next(3);
+
+        switch (fuzz_next(10)) {
+        case 0:
+                read_req(conn_idx, fuzz_handle(), fuzz_length());
+                break;
+        case 1:
+                write_req_send(conn_idx, fuzz_handle(), fuzz_next(2) ? 0 : fuzz_length(), fuzz_length());
+                break;
+        case 2: {
+                /* Prepare write followed by the fragments delivered on execution (malformed at times) */
+                uint16_t handle = fuzz_handle();
+                uint16_t offset = 0;
+                int num_of_fragments = (int)fuzz_next(8);
+
+                prepare_write_req(conn_idx, handle);
+                for (int i = 0; i < num_of_fragments; i++) {
+                        uint16_t length = fuzz_length();
+
+                        write_req_send(conn_idx, handle, fuzz_next(4) ? offset : fuzz_length(), length);
+                        offset += length;
+                }
+                break;
+        }
+        case 3:
+                ccc_write_req(conn_idx, fuzz_handle(), (uint16_t)fuzz_next(4), (uint16_t)fuzz_next(4));
+                break;
+        case 4:
+                event_sent(conn_idx, fuzz_handle(), fuzz_next(2) ? GATT_EVENT_NOTIFICATION : GATT_EVENT_INDICATION,
+                                                                                        fuzz_next(2));
+                break;
+        case 5:
+                if (fuzz_next(2)) {
+                        connect(conn_idx);
+                } else {
+                        disconnect(conn_idx);
+                }
+                break;
+        case 6:
+                advance(fuzz_next(200));
+                break;
+        case 7: {
+                int i = (int)fuzz_next(service.num_of_characteristics);
+
+                mcs_char_send_notifications(service.handles[i], value,
+                                        (uint16_t)fuzz_next(service.cfg[i].max_size + 1));
+                break;
+        }
+        case 8:
+                host_gatts_log.events_rejected = fuzz_next(2);
+                break;
+        case 9:
+                value_version++;
+                value_length = (uint16_t)fuzz_next(HOST_MAX_VALUE_SIZE + 1);
+                break;
+        }
+}
+
+static void fuzz_setup(void)
+{
+        static const uint16_t sizes[HOST_MAX_SIZES] = { 1, 2, 20, 23, 100, HOST_MAX_VALUE_SIZE };
+
+        service_create(20, sizes, ARRAY_LENGTH(sizes));
+}
+
+static void fuzz_teardown(void)
+{
+        /* Complete any pending long write and release all the peer devices */
+        advance(100000);
+        for (uint16_t conn_idx = 0; conn_idx < 3; conn_idx++) {
+                disconnect(conn_idx);
+        }
+        service_destroy();
+        host_gatts_log.events_rejected = false;
+}
+
+static void fuzz(uint32_t iterations, uint32_t seed)
+{
+        size_t heap_start = host_heap_in_use();
+
+        fuzz_state = seed ? seed : 1;
+        fuzz_setup();
+
+        for (uint32_t i = 0; i < iterations; i++) {
+                fuzz_step();
+        }
+
+        fuzz_teardown();
+
+        if (host_heap_in_use() != heap_start) {
+                violation("heap not released on cleanup", 0);
+        }
+
+        printf("Fuzz - Iterations: %lu, Seed: %lu, Violations: %lu, Assertions: %lu\n",
+                (unsigned long)iterations, (unsigned long)seed, (unsigned long)num_of_violations,
+                (unsigned long)host_assert_count());
+}
+
+#ifdef HOST_LIBFUZZER
+int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size)
+{
+        fuzz_data = data;
+        fuzz_size = size;
+
+        fuzz_setup();
+        while (fuzz_size) {
+                fuzz_step();
+        }
+        fuzz_teardown();
+
+        if (num_of_violations || host_assert_count()) {
+                abort();
+        }
+        return 0;
+}
+#else
+int main(int argc, char *argv[])
+{
+        mcs_timer_init(OS_GET_CURRENT_TASK(), HOST_MCS_TIMER_NOTIF);
+
+        for (int i = 0; i < HOST_MAX_VALUE_SIZE; i++) {
+                value[i] = (uint8_t)i;
+        }
+
+        if ((argc > 1) && !strcmp(argv[1], "fuzz")) {
+                fuzz((argc > 2) ? strtoul(argv[2], NULL, 0) : HOST_FUZZ_ITERATIONS,
+                                                (argc > 3) ? strtoul(argv[3], NULL, 0) : 1);
+        } else if ((argc > 1) && strcmp(argv[1], "bench")) {
+                fprintf(stderr, "Usage: %s [bench | fuzz [iterations] [seed]]\n", argv[0]);
+                return 2;
+        } else {
+                bench();
+        }
+
+        return (num_of_violations || host_assert_count()) ? 1 : 0;
+}
+#endif
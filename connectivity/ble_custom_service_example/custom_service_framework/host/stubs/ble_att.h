@@ -0,0 +1,65 @@
+/**
+ ****************************************************************************************
+ *
+ * @file ble_att.h
+ *
+ * @brief ATT definitions (host build)
+ *
+ * Copyright (C) 2024 Renesas Electronics Corporation and/or its affiliates.
+ * All rights reserved. Confidential Information.
+ *
+ * This software ("Software") is supplied by Renesas Electronics Corporation and/or its
+ * affiliates ("Renesas"). Renesas grants you a personal, non-exclusive, non-transferable,
+ * revocable, non-sub-licensable right and license to use the Software, solely if used in
+ * or together with Renesas products. You may make copies of this Software, provided this
+ * copyright notice and disclaimer ("Notice") is included in all such copies. Renesas
+ * reserves the right to change or discontinue the Software at any time without notice.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS". RENESAS DISCLAIMS ALL WARRANTIES OF ANY KIND,
+ * WHETHER EXPRESS, IMPLIED, OR STATUTORY, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT. TO THE
+ * MAXIMUM EXTENT PERMITTED UNDER LAW, IN NO EVENT SHALL RENESAS BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, SPECIAL, INCIDENTAL OR CONSEQUENTIAL DAMAGES ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE, EVEN IF RENESAS HAS BEEN ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGES. USE OF THIS SOFTWARE MAY BE SUBJECT TO TERMS AND CONDITIONS CONTAINED IN
+ * AN ADDITIONAL AGREEMENT BETWEEN YOU AND RENESAS. IN CASE OF CONFLICT BETWEEN THE TERMS
+ * OF THIS NOTICE AND ANY SUCH ADDITIONAL LICENSE AGREEMENT, THE TERMS OF THE AGREEMENT
+ * SHALL TAKE PRECEDENCE. BY CONTINUING TO USE THIS SOFTWARE, YOU AGREE TO THE TERMS OF
+ * THIS NOTICE.IF YOU DO NOT AGREE TO THESE TERMS, YOU ARE NOT PERMITTED TO USE THIS
+ * SOFTWARE.
+ *
+ ****************************************************************************************
+ */
+
+#ifndef BLE_ATT_H_
+#define BLE_ATT_H_
+
+#include "sdk_defs.h"
+
+typedef enum {
+        ATT_ERROR_OK                    = 0x00,
+        ATT_ERROR_INVALID_HANDLE        = 0x01,
+        ATT_ERROR_READ_NOT_PERMITTED    = 0x02,
+        ATT_ERROR_WRITE_NOT_PERMITTED   = 0x03,
+        ATT_ERROR_INVALID_OFFSET        = 0x07,
+        ATT_ERROR_PREPARE_QUEUE_FULL    = 0x09,
+        ATT_ERROR_ATTRIBUTE_NOT_LONG    = 0x0B,
+        ATT_ERROR_INVALID_VALUE_LENGTH  = 0x0D,
+} att_error_t;
+
+typedef enum {
+        ATT_PERM_NONE   = 0x00,
+        ATT_PERM_READ   = 0x01,
+        ATT_PERM_WRITE  = 0x02,
+        ATT_PERM_RW     = ATT_PERM_READ | ATT_PERM_WRITE,
+} att_perm_t;
+
+typedef struct {
+        uint8_t type;
+        union {
+                uint16_t uuid16;
+                uint8_t  uuid128[16];
+        };
+} att_uuid_t;
+
+#endif /* BLE_ATT_H_ */
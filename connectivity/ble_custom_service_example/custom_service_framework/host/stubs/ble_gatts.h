@@ -0,0 +1,90 @@
+/**
+ ****************************************************************************************
+ *
+ * @file ble_gatts.h
+ *
+ * @brief GATT server API of the host build; requests are synthesized by the harness
+ *
+ * Copyright (C) 2024 Renesas Electronics Corporation and/or its affiliates.
+ * All rights reserved. Confidential Information.
+ *
+ * This software ("Software") is supplied by Renesas Electronics Corporation and/or its
+ * affiliates ("Renesas"). Renesas grants you a personal, non-exclusive, non-transferable,
+ * revocable, non-sub-licensable right and license to use the Software, solely if used in
+ * or together with Renesas products. You may make copies of this Software, provided this
+ * copyright notice and disclaimer ("Notice") is included in all such copies. Renesas
+ * reserves the right to change or discontinue the Software at any time without notice.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS". RENESAS DISCLAIMS ALL WARRANTIES OF ANY KIND,
+ * WHETHER EXPRESS, IMPLIED, OR STATUTORY, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT. TO THE
+ * MAXIMUM EXTENT PERMITTED UNDER LAW, IN NO EVENT SHALL RENESAS BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, SPECIAL, INCIDENTAL OR CONSEQUENTIAL DAMAGES ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE, EVEN IF RENESAS HAS BEEN ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGES. USE OF THIS SOFTWARE MAY BE SUBJECT TO TERMS AND CONDITIONS CONTAINED IN
+ * AN ADDITIONAL AGREEMENT BETWEEN YOU AND RENESAS. IN CASE OF CONFLICT BETWEEN THE TERMS
+ * OF THIS NOTICE AND ANY SUCH ADDITIONAL LICENSE AGREEMENT, THE TERMS OF THE AGREEMENT
+ * SHALL TAKE PRECEDENCE. BY CONTINUING TO USE THIS SOFTWARE, YOU AGREE TO THE TERMS OF
+ * THIS NOTICE.IF YOU DO NOT AGREE TO THESE TERMS, YOU ARE NOT PERMITTED TO USE THIS
+ * SOFTWARE.
+ *
+ ****************************************************************************************
+ */
+
+#ifndef BLE_GATTS_H_
+#define BLE_GATTS_H_
+
+#include "ble_att.h"
+#include "ble_common.h"
+#include "ble_gatt.h"
+
+typedef enum {
+        GATTS_FLAG_CHAR_READ_REQ = 0x01,
+} gatts_flag_t;
+
+typedef struct {
+        ble_evt_hdr_t hdr;
+        uint16_t      conn_idx;
+        uint16_t      handle;
+        uint16_t      offset;
+} ble_evt_gatts_read_req_t;
+
+typedef struct {
+        ble_evt_hdr_t hdr;
+        uint16_t      conn_idx;
+        uint16_t      handle;
+        uint16_t      offset;
+        uint16_t      length;
+        uint8_t       value[];
+} ble_evt_gatts_write_req_t;
+
+typedef struct {
+        ble_evt_hdr_t hdr;
+        uint16_t      conn_idx;
+        uint16_t      handle;
+} ble_evt_gatts_prepare_write_req_t;
+
+typedef struct {
+        ble_evt_hdr_t hdr;
+        uint16_t      conn_idx;
+        uint16_t      handle;
+        gatt_event_t  type;
+        bool          status;
+} ble_evt_gatts_event_sent_t;
+
+uint16_t ble_gatts_get_num_attr(uint16_t include, uint16_t characteristics, uint16_t descriptors);
+ble_error_t ble_gatts_add_service(const att_uuid_t *uuid, gatt_service_t type, uint16_t num_attrs);
+ble_error_t ble_gatts_add_characteristic(const att_uuid_t *uuid, gatt_prop_t prop, att_perm_t perm,
+                        uint16_t max_len, gatts_flag_t flags, uint16_t *h_offset, uint16_t *h_val_offset);
+ble_error_t ble_gatts_add_descriptor(const att_uuid_t *uuid, att_perm_t perm, uint16_t max_len,
+                                                        gatts_flag_t flags, uint16_t *h_offset);
+ble_error_t ble_gatts_register_service(uint16_t *handle, ...);
+ble_error_t ble_gatts_set_value(uint16_t handle, uint16_t length, const void *value);
+ble_error_t ble_gatts_read_cfm(uint16_t conn_idx, uint16_t handle, att_error_t status, uint16_t length,
+                                                                                const void *value);
+ble_error_t ble_gatts_write_cfm(uint16_t conn_idx, uint16_t handle, att_error_t status);
+ble_error_t ble_gatts_prepare_write_cfm(uint16_t conn_idx, uint16_t handle, uint16_t length, att_error_t status);
+ble_error_t ble_gatts_send_event(uint16_t conn_idx, uint16_t handle, gatt_event_t type, uint16_t length,
+                                                                                const void *value);
+
+#endif /* BLE_GATTS_H_ */
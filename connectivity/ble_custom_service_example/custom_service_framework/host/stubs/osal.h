@@ -0,0 +1,84 @@
+/**
+ ****************************************************************************************
+ *
+ * @file osal.h
+ *
+ * @brief OS abstraction layer of the host build; virtual time and a single-shot timer model
+ *
+ * Copyright (C) 2024 Renesas Electronics Corporation and/or its affiliates.
+ * All rights reserved. Confidential Information.
+ *
+ * This software ("Software") is supplied by Renesas Electronics Corporation and/or its
+ * affiliates ("Renesas"). Renesas grants you a personal, non-exclusive, non-transferable,
+ * revocable, non-sub-licensable right and license to use the Software, solely if used in
+ * or together with Renesas products. You may make copies of this Software, provided this
+ * copyright notice and disclaimer ("Notice") is included in all such copies. Renesas
+ * reserves the right to change or discontinue the Software at any time without notice.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS". RENESAS DISCLAIMS ALL WARRANTIES OF ANY KIND,
+ * WHETHER EXPRESS, IMPLIED, OR STATUTORY, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT. TO THE
+ * MAXIMUM EXTENT PERMITTED UNDER LAW, IN NO EVENT SHALL RENESAS BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, SPECIAL, INCIDENTAL OR CONSEQUENTIAL DAMAGES ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE, EVEN IF RENESAS HAS BEEN ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGES. USE OF THIS SOFTWARE MAY BE SUBJECT TO TERMS AND CONDITIONS CONTAINED IN
+ * AN ADDITIONAL AGREEMENT BETWEEN YOU AND RENESAS. IN CASE OF CONFLICT BETWEEN THE TERMS
+ * OF THIS NOTICE AND ANY SUCH ADDITIONAL LICENSE AGREEMENT, THE TERMS OF THE AGREEMENT
+ * SHALL TAKE PRECEDENCE. BY CONTINUING TO USE THIS SOFTWARE, YOU AGREE TO THE TERMS OF
+ * THIS NOTICE.IF YOU DO NOT AGREE TO THESE TERMS, YOU ARE NOT PERMITTED TO USE THIS
+ * SOFTWARE.
+ *
+ ****************************************************************************************
+ */
+
+#ifndef OSAL_H_
+#define OSAL_H_
+
+#include "sdk_defs.h"
+
+typedef void *OS_TASK;
+typedef struct host_timer *OS_TIMER;
+typedef uint32_t OS_TICK_TIME;
+typedef long OS_BASE_TYPE;
+
+typedef void (*host_timer_cb_t)(OS_TIMER timer);
+
+/* Heap accounted by the harness */
+void *host_malloc(size_t size);
+void host_free(void *ptr);
+
+#define OS_MALLOC(_size)                host_malloc(_size)
+#define OS_FREE(_ptr)                   host_free(_ptr)
+#define OS_ASSERT(_cond)                ASSERT_WARNING(_cond)
+
+/* Virtual time, advanced by the harness; one tick per millisecond */
+OS_TICK_TIME host_get_tick_count(void);
+
+#define OS_GET_TICK_COUNT()             host_get_tick_count()
+#define OS_MS_2_TICKS(_ms)              ((OS_TICK_TIME)(_ms))
+#define OS_TICKS_2_MS(_ticks)           ((uint32_t)(_ticks))
+
+/* Task notifications are latched by the harness, which then calls the handlers of the task */
+void host_task_notify(OS_TASK task, uint32_t value);
+
+#define OS_GET_CURRENT_TASK()           ((OS_TASK)1)
+#define OS_NOTIFY_SET_BITS              ( 0 )
+#define OS_TASK_NOTIFY(_task, _value, _action)  host_task_notify(_task, _value)
+
+/* Timers expire when the harness advances the virtual time past their deadline */
+OS_TIMER host_timer_create(OS_TICK_TIME period, bool reload, void *id, host_timer_cb_t cb);
+void host_timer_start(OS_TIMER timer, OS_TICK_TIME period);
+void host_timer_stop(OS_TIMER timer);
+bool host_timer_is_active(OS_TIMER timer);
+
+#define OS_TIMER_FOREVER                ( 0 )
+#define OS_TIMER_SUCCESS                ( true )
+#define OS_TIMER_FAIL                   ( false )
+#define OS_TIMER_CREATE(_name, _period, _reload, _id, _cb)      \
+                                        host_timer_create(_period, _reload, _id, _cb)
+#define OS_TIMER_CHANGE_PERIOD(_timer, _period, _timeout)       \
+                                        host_timer_start(_timer, _period)
+#define OS_TIMER_STOP(_timer, _timeout) host_timer_stop(_timer)
+#define OS_TIMER_IS_ACTIVE(_timer)      host_timer_is_active(_timer)
+
+#endif /* OSAL_H_ */
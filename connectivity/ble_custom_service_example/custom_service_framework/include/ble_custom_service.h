@@ -31,6 +31,7 @@
 #define BLE_CUSTOM_SERVICE_H_
 
 #include <stdint.h>
+#include <osal.h>
 #include <ble_service.h>
 #include <string.h>
 
@@ -39,6 +40,68 @@
 /* Macro to convert input to text */
 #define STRINGIFY(_val)             (#_val)
 
+/*
+ * Macro to expose the framework benchmark routines. If set, the application can measure the
+ * CPU cycles (DWT cycle counter) spent by the framework hot paths.
+ */
+#ifndef MCS_BENCHMARK_EN
+#define MCS_BENCHMARK_EN            ( 0 )
+#endif
+
+#if MCS_BENCHMARK_EN
+/*
+ * Cycle counter used by the benchmark routines; the DWT cycle counter by default. Both macros can
+ * be overridden, e.g. to build the framework against stubs of the BLE API on a host machine.
+ */
+#ifndef MCS_BENCHMARK_CYCLES
+#define MCS_BENCHMARK_CYCLES_INIT()                               \
+        do {                                                      \
+                CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;   \
+                DWT->CYCCNT = 0;                                  \
+                DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;              \
+        } while (0)
+
+#define MCS_BENCHMARK_CYCLES()      ( DWT->CYCCNT )
+#endif
+#endif
+
+/*
+ * Macro to select static service tables. If set, the characteristic declarations are constant
+ * tables placed in flash and the service declaration macros reserve the RAM needed by the framework
+ * statically, so that no heap is used when registering services.
+ *
+ * \note Characteristic declarations should then be declared with \p MCS_CHARACTERISTIC_TABLE
+ *       and user descriptors should be string literals.
+ */
+#ifndef MCS_STATIC_SERVICES
+#define MCS_STATIC_SERVICES         ( 0 )
+#endif
+
+#if MCS_STATIC_SERVICES
+/* Storage of the characteristic declarations of a service */
+#define MCS_CHARACTERISTIC_TABLE    static const
+
+/* Length of a characteristic user descriptor, computed at compile time */
+#define MCS_DESCRIPTOR_SIZE(_str)   (sizeof(_str) - 1)
+#else
+#define MCS_CHARACTERISTIC_TABLE    const
+
+#define MCS_DESCRIPTOR_SIZE(_str)   strlen(_str)
+#endif
+
+/* Max. number of characteristic values that can be staged in a transaction */
+#ifndef MCS_TXN_MAX_UPDATES
+#define MCS_TXN_MAX_UPDATES         ( 4 )
+#endif
+
+/* Max. size, expressed in bytes, of a characteristic value staged in a transaction */
+#ifndef MCS_TXN_MAX_SIZE
+#define MCS_TXN_MAX_SIZE            ( 20 )
+#endif
+
+/* Max. number of entries of the handle dispatch table of a service with \p _num characteristics */
+#define MCS_HANDLE_TABLE_SIZE(_num) ( 2 + (4 * (_num)) )
+
 /*
  * @brief: Characteristic Attribute declaration
  *
@@ -113,11 +176,44 @@
                   .gatt_prop            = _properties,                                       \
                   .att_perm             = _permission,                                       \
                   .user_descriptor      = _user_descriptor,                                  \
-                  .user_descriptor_size = strlen(_user_descriptor),                          \
+                  .user_descriptor_size = MCS_DESCRIPTOR_SIZE(_user_descriptor),             \
+                  {                                                                          \
+                          .get_value    = _read_cb,                                          \
+                          .set_value    = _write_cb,                                         \
+                          .event_sent   = _event_cb,                                         \
+                  }                                                                          \
+        }
+
+/*
+ * @brief: Characteristic Attribute declaration with value versioning
+ *
+ * Same as \sa CHARACTERISTIC_DECLARATION() but a version callback is also registered. The read
+ * callback should then return a buffer that remains valid (stable) as long as the version reported
+ * is not changed. Values longer than MTU-1 are read by peer devices in multiple requests (read blob);
+ * the read callback is called once per long read and the rest of the value is served directly from
+ * the buffer returned, as long as the version reported is not changed.
+ *
+ * \param [in] _version_cb: User callback function returning the current version of the value.
+ *                          The application should change the version every time the value is
+ *                          updated or the buffer returned by \p _read_cb is changed.
+ *
+ * \note For the rest of the parameters see \sa CHARACTERISTIC_DECLARATION()
+ */
+#define CHARACTERISTIC_DECLARATION_VERSIONED(_uuid, _max_size, _properties, _permission, _user_descriptor,  \
+                                                              _read_cb, _version_cb, _write_cb, _event_cb)  \
+                                                                                                            \
+        {                                                                                                   \
+                  .uuid                 = _uuid,                                             \
+                  .max_size             = _max_size,                                         \
+                  .gatt_prop            = _properties,                                       \
+                  .att_perm             = _permission,                                       \
+                  .user_descriptor      = _user_descriptor,                                  \
+                  .user_descriptor_size = MCS_DESCRIPTOR_SIZE(_user_descriptor),             \
                   {                                                                          \
                           .get_value    = _read_cb,                                          \
                           .set_value    = _write_cb,                                         \
                           .event_sent   = _event_cb,                                         \
+                          .get_version  = _version_cb,                                       \
                   }                                                                          \
         }
 
@@ -134,8 +230,64 @@
  * \warning: The UUID should comply with the following format: XXXXXXXX-XXXX-XXXX-XXXX-XXXXXXXXXXXX,
  *           otherwise an assertion will hit!!!
  */
+#if MCS_STATIC_SERVICES
+#define SERVICE_DECLARATION(_cfg, _uuid)     \
+                        SERVICE_DECLARATION_STATIC(_cfg, _uuid, NULL)
+#else
 #define SERVICE_DECLARATION(_cfg, _uuid)     \
                         mcs_service_init(_cfg, _uuid, ARRAY_LENGTH(_cfg));
+#endif
+
+/*
+ * @brief: Bluetooth Service declaration exporting characteristic handles
+ *
+ * Same as \sa SERVICE_DECLARATION() but the handles of the characteristic attributes declared are
+ * also returned, to be used with \sa mcs_char_send_notifications().
+ *
+ * \param [in] _cfg:      An array containing the characteristic ATT declarations \p mcs_characteristic_config_t
+ *
+ * \param [in] _uuid:     An 128-bit UUID associated with the target Bluetooth Service.
+ *                        Use NUM_TO_STRING() to stringify the text provided.
+ *
+ * \param [out] _handles: An array of \p mcs_char_handle_t, of the same length as \p _cfg, filled
+ *                        in the declaration order of the characteristic attributes.
+ */
+#if MCS_STATIC_SERVICES
+#define SERVICE_DECLARATION_EX(_cfg, _uuid, _handles)     \
+                        SERVICE_DECLARATION_STATIC(_cfg, _uuid, _handles)
+#else
+#define SERVICE_DECLARATION_EX(_cfg, _uuid, _handles)     \
+                        mcs_service_init_ex(_cfg, _uuid, ARRAY_LENGTH(_cfg), _handles);
+#endif
+
+/*
+ * @brief: Bluetooth Service declaration using static storage
+ *
+ * Same as \sa SERVICE_DECLARATION_EX() but the RAM needed by the framework for the service is
+ * reserved statically; no heap is used. Used by \sa SERVICE_DECLARATION() and
+ * \sa SERVICE_DECLARATION_EX() when \p MCS_STATIC_SERVICES is set.
+ *
+ * \param [in] _cfg:      An array containing the characteristic ATT declarations \p mcs_characteristic_config_t.
+ *                        Should be declared with \p MCS_CHARACTERISTIC_TABLE (static storage).
+ *
+ * \param [in] _uuid:     An 128-bit UUID associated with the target Bluetooth Service.
+ *
+ * \param [out] _handles: An array of \p mcs_char_handle_t, of the same length as \p _cfg, or NULL.
+ */
+#define SERVICE_DECLARATION_STATIC(_cfg, _uuid, _handles)                                                      \
+        {                                                                                                       \
+                __RETAINED static mcs_service_config_t _cfg##_hdr;                                              \
+                __RETAINED static mcs_attributes_config_t _cfg##_attrs[ARRAY_LENGTH(_cfg)];                     \
+                __RETAINED static mcs_attributes_config_t *_cfg##_attr_table[ARRAY_LENGTH(_cfg)];               \
+                __RETAINED static uint8_t _cfg##_handle_table[MCS_HANDLE_TABLE_SIZE(ARRAY_LENGTH(_cfg))];       \
+                const mcs_service_storage_t _cfg##_storage = {                                                  \
+                        .hdr          = &_cfg##_hdr,                                                            \
+                        .attrs        = _cfg##_attrs,                                                           \
+                        .attr_table   = _cfg##_attr_table,                                                      \
+                        .handle_table = _cfg##_handle_table,                                                    \
+                };                                                                                              \
+                mcs_service_init_static(_cfg, _uuid, ARRAY_LENGTH(_cfg), &_cfg##_storage, _handles);            \
+        }
 
 /************************************ Type definitions ***************************************/
 typedef att_perm_t    CHAR_ATT_PERM;
@@ -148,6 +300,8 @@ typedef void (* mcs_set_value_cb_t) (const uint8_t *value, uint16_t length);
 
 typedef void (*mcs_notification_sent_cb_t) (uint16_t conn_idx, bool status, gatt_event_t type);
 
+typedef uint32_t (* mcs_get_version_cb_t) (void);
+
 /**
  *  Callback functions associated with a characteristic attribute
  */
@@ -169,6 +323,13 @@ typedef struct mcs_characteristic_callbacks {
          * when a characteristic attribute value is changed.
          */
         mcs_notification_sent_cb_t event_sent;
+
+        /*
+         * Optional callback function returning the version of the value. If defined, the value
+         * returned by \p get_value is considered stable while the version is not changed, and
+         * the read blob requests of a long read are served without calling \p get_value.
+         */
+        mcs_get_version_cb_t get_version;
 } mcs_characteristic_callbacks_t;
 
 /**
@@ -189,6 +350,9 @@ typedef struct mcs_characteristic_config {
         const mcs_characteristic_callbacks_t cb;
 } mcs_characteristic_config_t;
                                                                                                                                              \
+/* Bitmap with one bit per connected peer device slot */
+typedef uint16_t mcs_conn_mask_t;
+
 /**
  * ATT configuration structure
  */
@@ -205,8 +369,74 @@ typedef struct mcs_attributes_config {
          * Maximum permitted length of Characteristic attribute value.
          */
         uint16_t characteristic_max_size;
+
+        /*
+         * Cached CCC values of the connected peer devices; a bit is set if the peer device in the
+         * corresponding slot has enabled notifications/indications.
+         */
+        mcs_conn_mask_t notif_mask;
+        mcs_conn_mask_t indic_mask;
+
+        /*
+         * Minimum time, expressed in milliseconds, between two events sent to the same peer device.
+         * Zero if not limited.
+         */
+        uint16_t notif_min_interval_ms;
 } mcs_attributes_config_t;
 
+/**
+ * Characteristic attribute handle. Should be treated as opaque by the application.
+ */
+typedef struct mcs_attributes_config *mcs_char_handle_t;
+
+/**
+ * Long (queued) write statistics
+ */
+typedef struct {
+        uint32_t committed;      // Long writes delivered to the application
+        uint32_t bytes;          // Total number of bytes delivered by long writes
+        uint32_t duration_ms;    // Total time elapsed from prepare write requests to value delivery
+        uint32_t exhausted;      // Prepare write requests rejected as no reassembly buffer was available to the peer device
+        uint32_t rejected;       // Write requests rejected due to invalid offset or length
+        uint32_t cancelled;      // Reassembly buffers released without delivering a value
+} mcs_long_write_stats_t;
+
+/**
+ * Notification/indication statistics
+ */
+typedef struct {
+        uint32_t sent;           // Events handed to the BLE stack
+        uint32_t coalesced;      // Pending values replaced by a newer value before being sent
+        uint32_t dropped;        // Events rejected by the BLE stack
+} mcs_notif_stats_t;
+
+/**
+ * Transaction of characteristic value updates, committed in one pass
+ */
+typedef struct {
+        uint8_t num_of_updates;
+
+        struct {
+                mcs_char_handle_t chr;
+                uint16_t size;
+                uint8_t value[MCS_TXN_MAX_SIZE];  // Copy of the value staged
+        } updates[MCS_TXN_MAX_UPDATES];
+} mcs_txn_t;
+
+/**
+ * Indication queue statistics
+ */
+typedef struct {
+        uint32_t queued;         // Indications queued
+        uint32_t confirmed;      // Indications confirmed by the peer devices
+        uint32_t timeouts;       // Indications not confirmed within the ATT transaction timeout
+        uint32_t retries;        // Indications rejected by the BLE stack and kept queued to be sent again
+        uint32_t overflows;      // Indications rejected as the queue of the peer device was full
+        uint32_t oversized;      // Indications rejected as larger than the max. size of a queued value
+        uint32_t discarded;      // Indications discarded on disconnection
+        uint16_t max_depth;      // Max. number of indications queued for a peer device (high-water mark)
+} mcs_indic_stats_t;
+
 /**
  * Characteristic notification configuration structure
  */
@@ -252,8 +482,33 @@ typedef struct mcs_service_config {
 
         /* Total number of characteristic attributes  */
         uint8_t num_of_characteristics;
+
+        /* Characteristic attributes, indexed by their declaration order */
+        mcs_attributes_config_t **attr_table;
+
+        /*
+         * Index (plus one) of the characteristic attribute an ATT handle belongs to, indexed by
+         * the handle offset from the service start handle. Zero for handles that are not serviced.
+         */
+        uint8_t *handle_table;
+
+        /* Characteristic declarations; valid only for services using static storage */
+        const mcs_characteristic_config_t *cfg;
+
+        /* Next service using static storage */
+        struct mcs_service_config *next;
 } mcs_service_config_t;
 
+/**
+ * Static storage of a BLE custom service, as reserved by \sa SERVICE_DECLARATION_STATIC()
+ */
+typedef struct {
+        mcs_service_config_t    *hdr;
+        mcs_attributes_config_t *attrs;          // One entry per characteristic
+        mcs_attributes_config_t **attr_table;    // One entry per characteristic
+        uint8_t                 *handle_table;   // MCS_HANDLE_TABLE_SIZE() entries
+} mcs_service_storage_t;
+
 /************************************ API definitions ***************************************/
 
 /*
@@ -273,6 +528,49 @@ typedef struct mcs_service_config {
  */
 ble_service_t* mcs_service_init(const mcs_characteristic_config_t settings[], const char *service_uuid, uint8_t num_of_characrteristics);
 
+/*
+ * @brief Bluetooth custom service creation exporting characteristic handles.
+ *
+ * Same as \sa mcs_service_init() but the handles of the characteristic attributes are also returned.
+ *
+ * \param[in] settings                     An array with all the Characteristic Attribute declarations.
+ * \param[in] service_uuid                 An 128-bit UUID associated with the Bluetooth Service
+ * \param[in] num_of_characrteristics      The total number of Characteristic Attribute declarations, associated
+ *                                         with the Bluetooth Service
+ * \param[out] handles                     Array of \p num_of_characrteristics entries filled with the handles
+ *                                         of the characteristic attributes. Can be NULL.
+ *
+ * \return service handle
+ *
+ * \note It is recommended that user uses \sa SERVICE_DECLARATION_EX() instead of this API
+ *
+ */
+ble_service_t* mcs_service_init_ex(const mcs_characteristic_config_t settings[], const char *service_uuid,
+                                        uint8_t num_of_characrteristics, mcs_char_handle_t handles[]);
+
+/*
+ * @brief Bluetooth custom service creation using static storage.
+ *
+ * Same as \sa mcs_service_init_ex() but no heap is used; the RAM needed by the framework is
+ * provided by \p storage.
+ *
+ * \param[in] settings                     An array with all the Characteristic Attribute declarations.
+ *                                         Should have static storage duration.
+ * \param[in] service_uuid                 An 128-bit UUID associated with the Bluetooth Service
+ * \param[in] num_of_characrteristics      The total number of Characteristic Attribute declarations
+ * \param[in] storage                      Static storage of the service
+ * \param[out] handles                     Array of \p num_of_characrteristics entries filled with the handles
+ *                                         of the characteristic attributes. Can be NULL.
+ *
+ * \return service handle
+ *
+ * \note It is recommended that user uses \sa SERVICE_DECLARATION_STATIC() instead of this API
+ *
+ */
+ble_service_t* mcs_service_init_static(const mcs_characteristic_config_t settings[], const char *service_uuid,
+                                        uint8_t num_of_characrteristics, const mcs_service_storage_t *storage,
+                                        mcs_char_handle_t handles[]);
+
 /*
  * @brief Send notification/indication to the peer devices.
  *
@@ -288,4 +586,234 @@ ble_service_t* mcs_service_init(const mcs_characteristic_config_t settings[], co
  */
 bool mcs_send_notifications(const char *uuid, const uint8_t *value, uint16_t size);
 
+/*
+ * @brief Send notification/indication to the peer devices.
+ *
+ * Same as \sa mcs_send_notifications() but the target characteristic is referenced by its handle,
+ * so no UUID lookup is involved. The type of event sent to each connected peer device is defined by
+ * the CCC value written by that peer.
+ *
+ * \param[in] chr                           The characteristic handle as returned by \sa mcs_service_init_ex()
+ * \param[in] value                         Pointer to the updated value
+ * \param[in] size                          Number of bytes to be read from \p value
+ *
+ */
+bool mcs_char_send_notifications(mcs_char_handle_t chr, const uint8_t *value, uint16_t size);
+
+/*
+ * @brief Start a transaction of characteristic value updates.
+ *
+ * \param[out] txn                          The transaction
+ *
+ */
+void mcs_txn_begin(mcs_txn_t *txn);
+
+/*
+ * @brief Stage the updated value of a characteristic in a transaction.
+ *
+ * The value is copied into the transaction, so \p value can be released once staged. Staging a
+ * characteristic already staged replaces its value. Nothing is sent to the peer devices until the
+ * transaction is committed.
+ *
+ * \param[in] txn                           The transaction
+ * \param[in] chr                           The characteristic handle
+ * \param[in] value                         Pointer to the updated value
+ * \param[in] size                          Number of bytes to be read from \p value
+ *
+ * \return False if the transaction is full or the value exceeds the max. size of the characteristic
+ *         (or \p MCS_TXN_MAX_SIZE)
+ *
+ */
+bool mcs_txn_stage(mcs_txn_t *txn, mcs_char_handle_t chr, const uint8_t *value, uint16_t size);
+
+/*
+ * @brief Commit a transaction of characteristic value updates.
+ *
+ * The connected peer devices are enumerated once and the events of all the values staged are sent
+ * to each peer device back to back, so that they can be delivered in the same connection event.
+ * Notifications are handed to the BLE stack immediately: they are neither held back by the minimum
+ * interval nor coalesced, and a value still pending for the characteristic is discarded as older.
+ * Indications are queued as by \sa mcs_char_send_notifications().
+ *
+ * A commit is not atomic: events already handed to the BLE stack cannot be withdrawn, so a value
+ * rejected for a peer device (by the BLE stack, a full indication queue or its size) does not
+ * prevent the other values from being sent, and that peer device observes a partial update.
+ * Rejected values are not sent again; the transaction should be staged and committed again.
+ *
+ * \param[in] txn                           The transaction; empty once committed
+ *
+ * \return False if a value of this transaction has been rejected for a peer device (the transaction
+ *         may then have been partially sent), else true
+ *
+ */
+bool mcs_txn_commit(mcs_txn_t *txn);
+
+/*
+ * @brief Set the minimum interval between two events sent to the same peer device.
+ *
+ * Values sent sooner are held back, replacing any value already held back for the same peer
+ * device (latest value wins). Held back values are sent once the interval has elapsed via the
+ * framework timer (see \sa mcs_timer_init()), on the next event sent completion, on the next call of
+ * \sa mcs_char_send_notifications() or via \sa mcs_notif_flush().
+ *
+ * \param[in] chr                           The characteristic handle
+ * \param[in] interval_ms                   The minimum interval in milliseconds; zero if not limited
+ *
+ */
+void mcs_char_set_min_interval(mcs_char_handle_t chr, uint16_t interval_ms);
+
+/*
+ * @brief Send the notification/indication values held back whose minimum interval has elapsed.
+ *
+ * Indications not confirmed within the ATT transaction timeout are also given up, so that the
+ * next indications queued are sent.
+ *
+ * \note Called on the expiration of the framework timer; should be called periodically only if
+ *       the timer has not been started via \sa mcs_timer_init().
+ *
+ */
+void mcs_notif_flush(void);
+
+/*
+ * @brief Start the timer servicing the deadlines of the framework.
+ *
+ * Values of long (queued) writes are delivered to the application once the peer device has
+ * executed the prepared writes; the timer detects the end of the fragments delivered. Values held
+ * back by the minimum interval of a characteristic are sent once the interval has elapsed and
+ * indications not confirmed within the ATT transaction timeout are given up. \p notif
+ * is set to the notification value of \p task whenever the timer expires; the task should then call
+ * \sa mcs_timer_expired(). If the timer is not started, values of long writes are delivered on the
+ * next request of the same peer device and held back values have to be sent via
+ * \sa mcs_notif_flush().
+ *
+ * \param[in] task                          The task that registers the custom services
+ * \param[in] notif                         The notification bit of \p task reserved for the timer
+ *
+ */
+void mcs_timer_init(OS_TASK task, uint32_t notif);
+
+/*
+ * @brief Service the deadlines of the framework that have expired.
+ *
+ * \note Should be called by the task passed to \sa mcs_timer_init() once notified.
+ *
+ */
+void mcs_timer_expired(void);
+
+/*
+ * @brief Get the notification/indication statistics.
+ *
+ * \param[out] stats                        The statistics collected since start up
+ *
+ */
+void mcs_notif_get_stats(mcs_notif_stats_t *stats);
+
+/*
+ * @brief Get the indication queue statistics.
+ *
+ * \param[out] stats                        The statistics collected since start up
+ *
+ */
+void mcs_indic_get_stats(mcs_indic_stats_t *stats);
+
+/*
+ * @brief Get the long (queued) write statistics.
+ *
+ * \param[out] stats                        The statistics collected since start up
+ *
+ */
+void mcs_long_write_get_stats(mcs_long_write_stats_t *stats);
+
+#if MCS_BENCHMARK_EN
+/*
+ * @brief Benchmark the ATT handle dispatching of the framework.
+ *
+ * A service of \p num_of_characteristics characteristics (value, CCC and user descriptor
+ * attributes each) is synthesized and all its handles are resolved, once by walking the
+ * characteristic list (legacy dispatching) and once via the handle dispatch table. The service
+ * is not registered to the BLE database.
+ *
+ * \param[in]  num_of_characteristics       Number of characteristics of the synthesized service
+ * \param[out] list_cycles                  Average CPU cycles per request when walking the list
+ * \param[out] table_cycles                 Average CPU cycles per request when using the table
+ *
+ */
+void mcs_dispatch_benchmark(uint8_t num_of_characteristics, uint32_t *list_cycles, uint32_t *table_cycles);
+
+/*
+ * @brief Benchmark the long read handling of the framework.
+ *
+ * A long read of the whole value of the characteristic is emulated (one read request followed by
+ * read blob requests of \p mtu - 1 bytes) \p MCS_BENCHMARK_ROUNDS times, once calling the read
+ * callback per request and once using the version callback of the characteristic (if defined).
+ * No responses are sent to the peer devices.
+ *
+ * \param[in]  chr                          The characteristic handle
+ * \param[in]  mtu                          The ATT MTU assumed
+ * \param[out] uncached_cycles              Average CPU cycles per long read, calling the read callback per request
+ * \param[out] cached_cycles                Average CPU cycles per long read, using the version callback
+ *
+ */
+void mcs_read_benchmark(mcs_char_handle_t chr, uint16_t mtu, uint32_t *uncached_cycles, uint32_t *cached_cycles);
+
+/*
+ * @brief Benchmark the notification sending of the framework.
+ *
+ * The value is sent \p MCS_BENCHMARK_ROUNDS times, once via the legacy path (UUID lookup and
+ * enumeration of the connected devices per call), once via \sa mcs_send_notifications() and once via
+ * \sa mcs_char_send_notifications(). Connected peers that have enabled notifications/indications
+ * for the characteristic will receive all the events sent.
+ *
+ * \param[in]  chr                          The characteristic handle
+ * \param[in]  uuid                         The 128-bit UUID of the same characteristic
+ * \param[in]  value                        Pointer to the value sent
+ * \param[in]  size                         Number of bytes to be read from \p value
+ * \param[out] legacy_cycles                Average CPU cycles per call of the legacy path
+ * \param[out] uuid_cycles                  Average CPU cycles per call of \sa mcs_send_notifications()
+ * \param[out] handle_cycles                Average CPU cycles per call of \sa mcs_char_send_notifications()
+ *
+ */
+void mcs_notify_benchmark(mcs_char_handle_t chr, const char *uuid, const uint8_t *value, uint16_t size,
+                        uint32_t *legacy_cycles, uint32_t *uuid_cycles, uint32_t *handle_cycles);
+
+/*
+ * @brief Benchmark the notification fanout to the connected peer devices.
+ *
+ * The value is sent to all the peer devices currently connected \p MCS_BENCHMARK_ROUNDS times,
+ * once reading the CCC value of each peer device from the BLE storage and once using the cached
+ * CCC values. Connected peers that have enabled notifications/indications for the characteristic
+ * will receive all the events sent; events are sent directly, bypassing the notification slots and
+ * the indication queues.
+ *
+ * \param[in]  chr                          The characteristic handle
+ * \param[in]  value                        Pointer to the value sent
+ * \param[in]  size                         Number of bytes to be read from \p value
+ * \param[out] num_of_peers                 Number of peer devices connected during the benchmark
+ * \param[out] storage_cycles               Average CPU cycles per fanout, reading the BLE storage
+ * \param[out] cache_cycles                 Average CPU cycles per fanout, using the cached CCC values
+ *
+ */
+void mcs_fanout_benchmark(mcs_char_handle_t chr, const uint8_t *value, uint16_t size, uint8_t *num_of_peers,
+                                                        uint32_t *storage_cycles, uint32_t *cache_cycles);
+
+/*
+ * @brief Benchmark the transaction of characteristic value updates.
+ *
+ * The same value is sent for \p num_of_characteristics characteristics \p MCS_BENCHMARK_ROUNDS times,
+ * once calling \sa mcs_char_send_notifications() per characteristic and once via a transaction.
+ * Events are handed to a null sender instead of the BLE stack, so nothing is sent to the peer
+ * devices, and the notification/indication state and statistics are restored once done.
+ *
+ * \param[in]  chr                          The characteristic handles
+ * \param[in]  num_of_characteristics       Number of entries of \p chr (up to \p MCS_TXN_MAX_UPDATES)
+ * \param[in]  value                        Pointer to the value sent
+ * \param[in]  size                         Number of bytes to be read from \p value
+ * \param[out] single_cycles                Average CPU cycles per update of all the characteristics, one by one
+ * \param[out] txn_cycles                   Average CPU cycles per update of all the characteristics, via a transaction
+ *
+ */
+void mcs_txn_benchmark(const mcs_char_handle_t chr[], uint8_t num_of_characteristics, const uint8_t *value,
+                                        uint16_t size, uint32_t *single_cycles, uint32_t *txn_cycles);
+#endif
+
 #endif /* BLE_CUSTOM_SERVICE_H_ */
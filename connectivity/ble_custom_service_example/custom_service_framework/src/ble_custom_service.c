@@ -40,6 +40,9 @@
 #include "ble_storage.h"
 #include "ble_uuid.h"
 #include "ble_custom_service.h"
+#if MCS_BENCHMARK_EN
+#include "sdk_defs.h"
+#endif
 
 /********************************* Macro definitions ****************************************/
 #define UUID_CUSTOM_DEFINITION_MAX_LENGTH       128
@@ -63,34 +66,460 @@
 #define MCS_DBG_SERVICES_EN                    ( 0 )
 #endif
 
+/**
+ * Number of long (queued) write reassembly buffers, shared among all connections. A peer device
+ * holds at most one buffer, for the characteristic attribute of its pending prepare write sequence.
+ */
+#ifndef MCS_LONG_WRITE_POOL_SIZE
+#define MCS_LONG_WRITE_POOL_SIZE               ( 2 )
+#endif
+
+/**
+ * Max. size, expressed in bytes, of a value written via long (queued) writes. Values of
+ * characteristic attributes with a greater max. size are capped to this size.
+ */
+#ifndef MCS_LONG_WRITE_MAX_SIZE
+#define MCS_LONG_WRITE_MAX_SIZE                ( 512 )
+#endif
+
+/**
+ * Time, expressed in milliseconds, without a new fragment after which a long (queued) write is
+ * considered executed. The fragments are delivered by the BLE stack back to back once the peer
+ * device executes the prepared writes; there is no separate event for the execute write request.
+ */
+#ifndef MCS_LONG_WRITE_EXEC_IDLE_MS
+#define MCS_LONG_WRITE_EXEC_IDLE_MS            ( 50 )
+#endif
+
+/**
+ * Time, expressed in milliseconds, after which a reassembly buffer that has received no fragment
+ * is released. The prepared writes of the peer device have then been canceled or are never
+ * executed, e.g. the peer device stopped responding, as the ATT transaction timeout has elapsed.
+ */
+#ifndef MCS_LONG_WRITE_PREPARE_TIMEOUT_MS
+#define MCS_LONG_WRITE_PREPARE_TIMEOUT_MS      ( 30000 )
+#endif
+
+/**
+ * Number of notification/indication slots, shared among all connections. A slot keeps the state of
+ * a characteristic attribute and peer device pair, so that only one event is in flight and only
+ * the latest value is pending per pair. Zero to send every value immediately.
+ */
+#ifndef MCS_NOTIF_POOL_SIZE
+#define MCS_NOTIF_POOL_SIZE                    ( 4 )
+#endif
+
+/**
+ * Max. size, expressed in bytes, of a value that can be held pending. Greater values are sent
+ * immediately.
+ */
+#ifndef MCS_NOTIF_MAX_SIZE
+#define MCS_NOTIF_MAX_SIZE                     ( 20 )
+#endif
+
+/**
+ * Time, expressed in milliseconds, after which a pending value rejected by the BLE stack is sent
+ * again (if greater than the minimum interval of the characteristic attribute). Queued indications
+ * rejected by the BLE stack are sent again after the same time.
+ */
+#ifndef MCS_NOTIF_RETRY_MS
+#define MCS_NOTIF_RETRY_MS                     ( 20 )
+#endif
+
+/**
+ * Number of indications that can be queued per peer device. Indications are sent one at a time,
+ * each one once the previous has been confirmed. Zero to handle indications as notifications
+ * (latest value wins).
+ */
+#ifndef MCS_INDIC_QUEUE_SIZE
+#define MCS_INDIC_QUEUE_SIZE                   ( 4 )
+#endif
+
+/**
+ * Max. size, expressed in bytes, of a value that can be queued for indication. Greater values are
+ * not indicated, as only the queue ensures a single indication in flight per peer device.
+ */
+#ifndef MCS_INDIC_MAX_SIZE
+#define MCS_INDIC_MAX_SIZE                     ( 20 )
+#endif
+
+/**
+ * Time, expressed in milliseconds, an indication is waiting for its confirmation before it is
+ * given up (ATT transaction timeout).
+ */
+#ifndef MCS_INDIC_TIMEOUT_MS
+#define MCS_INDIC_TIMEOUT_MS                   ( 30000 )
+#endif
+
+/* Status returned by a write handler that has already responded to the request */
+#define MCS_ATT_CFM_SENT                       ((att_error_t) - 1)
+
+/**
+ * Number of times each ATT handle is resolved by \sa mcs_dispatch_benchmark().
+ *
+ * \note This macro has a meaning only if \p MCS_BENCHMARK_EN is set.
+ */
+#ifndef MCS_BENCHMARK_ROUNDS
+#define MCS_BENCHMARK_ROUNDS                   ( 100 )
+#endif
+
+/********************************* Type definitions *****************************************/
+
+/* Long (queued) write reassembly buffer */
+typedef struct {
+        /* Service the attribute written belongs to. NULL if the buffer is free. */
+        ble_service_t *svc;
+        mcs_attributes_config_t *attr;
+
+        uint16_t conn_idx;
+        uint16_t max_size;           // Max. number of bytes that can be reassembled
+        uint16_t length;             // Number of bytes reassembled so far
+        OS_TICK_TIME start;          // Time the prepare write request was received
+        OS_TICK_TIME last_fragment;  // Time the last fragment was received
+
+        uint8_t value[MCS_LONG_WRITE_MAX_SIZE];
+} mcs_long_write_t;
+
+/* Long read state of a connection */
+typedef struct {
+        /* Characteristic attribute being read. NULL if the entry is free. */
+        mcs_attributes_config_t *attr;
+
+        uint16_t conn_idx;
+        uint16_t length;             // Length of the value returned at the start of the long read
+        uint8_t  *value;             // Buffer returned at the start of the long read
+        uint32_t version;            // Version of the value at the start of the long read
+} mcs_long_read_t;
+
+#if MCS_NOTIF_POOL_SIZE > 0
+/* Notification/indication state of a characteristic attribute and peer device pair */
+typedef struct {
+        /* Characteristic attribute notified. NULL if the slot is free. */
+        mcs_attributes_config_t *attr;
+
+        uint16_t conn_idx;
+        bool in_flight;              // An event has been sent and not completed yet
+        bool pending;                // A value is waiting to be sent
+        bool retry;                  // The pending value has been rejected by the BLE stack
+        uint16_t length;             // Length of the pending value
+        OS_TICK_TIME last_sent;      // Time the last event was sent (or rejected)
+
+        uint8_t value[MCS_NOTIF_MAX_SIZE];
+} mcs_notif_slot_t;
+#endif
+
+#if MCS_INDIC_QUEUE_SIZE > 0
+/* Indication queued */
+typedef struct {
+        /* Characteristic attribute indicated. NULL if the service has been removed. */
+        mcs_attributes_config_t *attr;
+
+        uint16_t length;
+        uint8_t value[MCS_INDIC_MAX_SIZE];
+} mcs_indic_entry_t;
+
+/* Indication queue of a peer device (FIFO) */
+typedef struct {
+        mcs_indic_entry_t entries[MCS_INDIC_QUEUE_SIZE];
+
+        uint8_t head;                // Index of the oldest indication
+        uint8_t count;               // Number of indications queued (including the one in flight)
+        bool in_flight;              // The oldest indication has been sent and not confirmed yet
+        bool retry;                  // The oldest indication has been rejected by the BLE stack
+        OS_TICK_TIME sent_time;      // Time the oldest indication was sent (or rejected)
+} mcs_indic_queue_t;
+#endif
+
 /********************************* Retained symbols *****************************************/
 
 /* Notifications head linked list */
 __RETAINED_RW static mcs_notif_list_element_t *notif_list_head = NULL;
 
+/* Services using static storage (linked via their headers) */
+__RETAINED static mcs_service_config_t *static_services_head;
+
+/*
+ * Connection indexes of the connected peer devices (maintained on connection events). A peer device
+ * keeps its slot for the whole connection; the slot indexes the subscription bitmaps of the
+ * characteristic attributes.
+ */
+__RETAINED static uint16_t connected_peers[BLE_GAP_MAX_CONNECTED];
+__RETAINED static mcs_conn_mask_t connected_peers_mask;
+
+/* Long (queued) write reassembly buffers and statistics */
+__RETAINED static mcs_long_write_t long_write_pool[MCS_LONG_WRITE_POOL_SIZE];
+__RETAINED static mcs_long_write_stats_t long_write_stats;
+
+/* Timer servicing the deadlines of the framework, and the task (and notification bit) it notifies */
+__RETAINED static OS_TIMER mcs_timer_h;
+__RETAINED static OS_TASK mcs_timer_task;
+__RETAINED static uint32_t mcs_timer_notif;
+
+/* Long read state of the connected peer devices */
+__RETAINED static mcs_long_read_t long_read_cache[BLE_GAP_MAX_CONNECTED];
+
+/* Notification/indication slots and statistics */
+#if MCS_NOTIF_POOL_SIZE > 0
+__RETAINED static mcs_notif_slot_t notif_pool[MCS_NOTIF_POOL_SIZE];
+#endif
+__RETAINED static mcs_notif_stats_t notif_stats;
+
+/* Indication queues of the connected peer devices (indexed by connected peer slot) and statistics */
+#if MCS_INDIC_QUEUE_SIZE > 0
+__RETAINED static mcs_indic_queue_t indic_queues[BLE_GAP_MAX_CONNECTED];
+#endif
+__RETAINED static mcs_indic_stats_t indic_stats;
+
+#if MCS_BENCHMARK_EN
+/* Sender of the notification/indication events; a null sender while benchmarking */
+typedef ble_error_t (*mcs_send_event_t)(uint16_t conn_idx, uint16_t handle, gatt_event_t type,
+                                                                uint16_t length, const void *value);
+
+__RETAINED_RW static mcs_send_event_t send_event = ble_gatts_send_event;
+#else
+#define send_event ble_gatts_send_event
+#endif
+
 #if MCS_DBG_SERVICES_EN
 __RETAINED mcs_characteristic_list_element_t *database_list_head[MCS_DBG_SERVICES_MAX_NUM];
 __RETAINED_RW int cnt_list = 0;
 #endif
 
 /********************************* Function prototypes **************************************/
+#if MCS_BENCHMARK_EN
 static mcs_attributes_config_t* mcs_select_list_item_by_index(mcs_characteristic_list_element_t *head,
                                                                                           uint8_t item_idx);
+#endif
 
 static void mcs_free_list(mcs_characteristic_list_element_t *head);
 
 static void notify_peer_devices(ble_service_t *svc, uint16_t size, const uint8_t *value,
                                                                       mcs_attributes_config_t *attr);
 
-static void helper_notify_peer_devices(ble_service_t *svc, uint16_t conn_idx, uint16_t size,
-                                                const uint8_t *value, mcs_attributes_config_t *attr);
+static void helper_notify_peer_devices(int slot, uint16_t size, const uint8_t *value,
+                                                                      mcs_attributes_config_t *attr);
 
 static mcs_attributes_config_t* mcs_notif_select_list_item_by_uuid(const char *uuid);
 
 static void mcs_notif_remove_list_item_by_addr(uint32_t addr);
 
+static void helper_set_service_callbacks(mcs_service_config_t *hdr);
+
+static ble_service_t* helper_service_register(mcs_service_config_t *service_handle, const mcs_characteristic_config_t cfg[],
+                                                        const char *service_uuid, mcs_char_handle_t handles[]);
+
+static void mcs_timer_arm(void);
+
 /********************************* Static routines *****************************************/
 
+/*
+ * Get the characteristic attribute an ATT handle belongs to. Only the value and CCC handles of a
+ * characteristic are mapped, so NULL is returned for any other handle of the service.
+ */
+static mcs_attributes_config_t* mcs_select_attr_by_handle(mcs_service_config_t *hdr, uint16_t handle)
+{
+        uint8_t entry;
+
+        if ((handle < hdr->svc.start_h) || (handle > hdr->svc.end_h)) {
+                return NULL;
+        }
+
+        entry = hdr->handle_table[handle - hdr->svc.start_h];
+
+        return (entry ? hdr->attr_table[entry - 1] : NULL);
+}
+
+/* Get the slot of a connected peer device. -1 is returned if the peer device is not connected. */
+static int connected_peer_slot(uint16_t conn_idx)
+{
+        for (int i = 0; i < BLE_GAP_MAX_CONNECTED; i++) {
+                if ((connected_peers_mask & (1 << i)) && (connected_peers[i] == conn_idx)) {
+                        return i;
+                }
+        }
+        return -1;
+}
+
+/* Check whether a characteristic attribute exposes a CCC descriptor */
+static bool helper_has_ccc(mcs_service_config_t *hdr, mcs_attributes_config_t *attr)
+{
+        return (attr->attr_ccc_h != attr->attr_h) && (mcs_select_attr_by_handle(hdr, attr->attr_ccc_h) == attr);
+}
+
+/* Update the cached CCC value of a connected peer device */
+static void helper_set_subscription(mcs_attributes_config_t *attr, int slot, uint16_t ccc)
+{
+        mcs_conn_mask_t bit = (mcs_conn_mask_t)(1 << slot);
+
+        if (ccc & GATT_CCC_NOTIFICATIONS) {
+                attr->notif_mask |= bit;
+        } else {
+                attr->notif_mask &= ~bit;
+        }
+
+        if (ccc & GATT_CCC_INDICATIONS) {
+                attr->indic_mask |= bit;
+        } else {
+                attr->indic_mask &= ~bit;
+        }
+}
+
+/* Get the cached CCC value of a connected peer device */
+static uint16_t helper_get_subscription(const mcs_attributes_config_t *attr, int slot)
+{
+        uint16_t ccc = GATT_CCC_NONE;
+
+        if (attr->notif_mask & (1 << slot)) {
+                ccc |= GATT_CCC_NOTIFICATIONS;
+        }
+        if (attr->indic_mask & (1 << slot)) {
+                ccc |= GATT_CCC_INDICATIONS;
+        }
+        return ccc;
+}
+
+/* Get the reassembly buffer of a long write in progress. */
+static mcs_long_write_t* long_write_find(uint16_t conn_idx, uint16_t attr_h)
+{
+        for (int i = 0; i < MCS_LONG_WRITE_POOL_SIZE; i++) {
+                mcs_long_write_t *lw = &long_write_pool[i];
+
+                if (lw->svc && (lw->conn_idx == conn_idx) && (lw->attr->attr_h == attr_h)) {
+                        return lw;
+                }
+        }
+        return NULL;
+}
+
+/* Get the reassembly buffer held by a peer device (if any). */
+static mcs_long_write_t* long_write_find_conn(uint16_t conn_idx)
+{
+        for (int i = 0; i < MCS_LONG_WRITE_POOL_SIZE; i++) {
+                mcs_long_write_t *lw = &long_write_pool[i];
+
+                if (lw->svc && (lw->conn_idx == conn_idx)) {
+                        return lw;
+                }
+        }
+        return NULL;
+}
+
+/* Get a free reassembly buffer. NULL is returned if the pool is exhausted. */
+static mcs_long_write_t* long_write_alloc(ble_service_t *svc, mcs_attributes_config_t *attr, uint16_t conn_idx)
+{
+        for (int i = 0; i < MCS_LONG_WRITE_POOL_SIZE; i++) {
+                mcs_long_write_t *lw = &long_write_pool[i];
+
+                if (lw->svc == NULL) {
+                        lw->svc           = svc;
+                        lw->attr          = attr;
+                        lw->conn_idx      = conn_idx;
+                        lw->max_size      = MIN(attr->characteristic_max_size, MCS_LONG_WRITE_MAX_SIZE);
+                        lw->length        = 0;
+                        lw->start         = OS_GET_TICK_COUNT();
+                        lw->last_fragment = lw->start;
+                        return lw;
+                }
+        }
+        return NULL;
+}
+
+/*
+ * Release a reassembly buffer. If \p deliver is set, the value reassembled (if any) is delivered
+ * to the application and the connected peers are notified, as for a regular write request.
+ */
+static void long_write_release(mcs_long_write_t *lw, bool deliver)
+{
+        ASSERT_WARNING(lw != NULL);
+
+        /* Already released */
+        if (lw->svc == NULL) {
+                return;
+        }
+
+        if (deliver && lw->length) {
+                lw->attr->cb->set_value(lw->value, lw->length);
+                notify_peer_devices(lw->svc, lw->length, lw->value, lw->attr);
+
+                long_write_stats.committed++;
+                long_write_stats.bytes += lw->length;
+                long_write_stats.duration_ms += OS_TICKS_2_MS(OS_GET_TICK_COUNT() - lw->start);
+        } else {
+                long_write_stats.cancelled++;
+        }
+
+        lw->svc = NULL;
+}
+
+/*
+ * Deliver the values reassembled for a connection, except for the attribute \p attr_h. Fragments are
+ * only delivered once the peer device has executed the prepared writes and the execute write
+ * response is only sent once all of them have been serviced, so any other request of the same peer
+ * completes the values. Buffers of prepare write sequences with no data received yet are kept.
+ */
+static void long_write_flush(uint16_t conn_idx, uint16_t attr_h)
+{
+        for (int i = 0; i < MCS_LONG_WRITE_POOL_SIZE; i++) {
+                mcs_long_write_t *lw = &long_write_pool[i];
+
+                if (lw->svc && (lw->conn_idx == conn_idx) && lw->length && (lw->attr->attr_h != attr_h)) {
+                        long_write_release(lw, true);
+                }
+        }
+}
+
+/* Number of ticks until \p deadline; zero or negative once the deadline has passed */
+static int32_t ticks_until(OS_TICK_TIME deadline)
+{
+        return (int32_t)(deadline - OS_GET_TICK_COUNT());
+}
+
+/*
+ * Time a reassembly buffer is released: the value is delivered once the fragments stop and a buffer
+ * without fragments is freed once the prepare write sequence has timed out.
+ */
+static OS_TICK_TIME long_write_deadline(const mcs_long_write_t *lw)
+{
+        if (lw->length) {
+                return lw->last_fragment + OS_MS_2_TICKS(MCS_LONG_WRITE_EXEC_IDLE_MS);
+        }
+        return lw->start + OS_MS_2_TICKS(MCS_LONG_WRITE_PREPARE_TIMEOUT_MS);
+}
+
+static void mcs_timer_cb(OS_TIMER timer)
+{
+        OS_TASK_NOTIFY(mcs_timer_task, mcs_timer_notif, OS_NOTIFY_SET_BITS);
+}
+
+/* Helper function to service the fragments of a long (queued) write. */
+static att_error_t helper_long_write_handler(mcs_long_write_t *lw, const ble_evt_gatts_write_req_t *evt)
+{
+        ASSERT_WARNING(lw != NULL);
+        ASSERT_WARNING(evt != NULL);
+
+        /* Fragments are expected in order and without gaps */
+        if (evt->offset != lw->length) {
+                long_write_stats.rejected++;
+                long_write_release(lw, false);
+                return ATT_ERROR_INVALID_OFFSET;
+        }
+
+        if ((evt->offset + evt->length) > lw->max_size) {
+                long_write_stats.rejected++;
+                long_write_release(lw, false);
+                return ATT_ERROR_INVALID_VALUE_LENGTH;
+        }
+
+        memcpy(&lw->value[lw->length], evt->value, evt->length);
+        lw->length += evt->length;
+        lw->last_fragment = OS_GET_TICK_COUNT();
+
+        /* The value is delivered once the fragments stop (or another request is received) */
+        mcs_timer_arm();
+
+        return ATT_ERROR_OK;
+}
+
 /* Helper function to service ATT write requests. */
 static att_error_t helper_att_write_handler(ble_service_t *svc, mcs_attributes_config_t *attr,
                                                                 const ble_evt_gatts_write_req_t *evt)
@@ -130,7 +559,8 @@ static att_error_t helper_att_write_handler(ble_service_t *svc, mcs_attributes_c
          */
         notify_peer_devices(svc, evt->length, evt->value, attr);
 
-        return ATT_ERROR_OK;
+        /* The request has been responded already */
+        return MCS_ATT_CFM_SENT;
 }
 
 /* Helper function to service write "Client Characteristic Configuration" (CC requests. */
@@ -154,6 +584,78 @@ static att_error_t helper_ccc_write_handler(mcs_attributes_config_t *attr, const
         /* Store the envoy CCC value in Flash memory. */
         ble_storage_put_u32(evt->conn_idx, attr->attr_ccc_h, (uint32_t)ccc, true);
 
+        int slot = connected_peer_slot(evt->conn_idx);
+        if (slot >= 0) {
+                helper_set_subscription(attr, slot, ccc);
+        }
+
+        return ATT_ERROR_OK;
+}
+
+/* Get the long read entry of a connection or a free one. NULL is returned if none is available. */
+static mcs_long_read_t* long_read_find(uint16_t conn_idx)
+{
+        mcs_long_read_t *free_entry = NULL;
+
+        for (int i = 0; i < BLE_GAP_MAX_CONNECTED; i++) {
+                mcs_long_read_t *lr = &long_read_cache[i];
+
+                if (lr->attr == NULL) {
+                        if (free_entry == NULL) {
+                                free_entry = lr;
+                        }
+                } else if (lr->conn_idx == conn_idx) {
+                        return lr;
+                }
+        }
+        return free_entry;
+}
+
+/*
+ * Helper function to get the part of a characteristic value starting at \p offset. Read blob
+ * requests are served from the buffer returned at the start of the long read, as long as the
+ * characteristic declares a version callback and the version has not changed. Otherwise, the read
+ * callback is called. \p lr can be NULL, if no long read state should be used.
+ */
+static att_error_t helper_read_value(mcs_attributes_config_t *attr, mcs_long_read_t *lr, uint16_t conn_idx,
+                                        uint16_t offset, const uint8_t **value, uint16_t *length)
+{
+        ASSERT_WARNING(attr != NULL);
+        ASSERT_WARNING(value != NULL);
+        ASSERT_WARNING(length != NULL);
+
+        uint8_t *buffer = NULL;
+        uint16_t buffer_length = 0;
+
+        if (offset && lr && (lr->attr == attr) && (lr->conn_idx == conn_idx) &&
+                                                (attr->cb->get_version() == lr->version)) {
+                buffer = lr->value;
+                buffer_length = lr->length;
+        } else {
+                uint32_t version = attr->cb->get_version ? attr->cb->get_version() : 0;
+
+                /* Switch to application context to get the characteristic value (as requested by the peer device). */
+                attr->cb->get_value(&buffer, &buffer_length);
+
+                /* Make sure the user has defined a valid value */
+                ASSERT_WARNING(buffer != NULL);
+
+                if (lr && attr->cb->get_version) {
+                        lr->attr     = attr;
+                        lr->conn_idx = conn_idx;
+                        lr->value    = buffer;
+                        lr->length   = buffer_length;
+                        lr->version  = version;
+                }
+        }
+
+        if (offset > buffer_length) {
+                return ATT_ERROR_INVALID_OFFSET;
+        }
+
+        *value = buffer + offset;
+        *length = buffer_length - offset;
+
         return ATT_ERROR_OK;
 }
 
@@ -164,8 +666,9 @@ static void helper_att_read_handler(ble_service_t *svc, mcs_attributes_config_t
         ASSERT_WARNING(attr != NULL);
         ASSERT_WARNING(evt != NULL);
 
+        att_error_t status;
         uint16_t length = 0;
-        uint8_t  *value;
+        const uint8_t *value = NULL;
 
         /*
          * Check whether developer has defined a function for handling
@@ -176,17 +679,17 @@ static void helper_att_read_handler(ble_service_t *svc, mcs_attributes_config_t
                 return;
         }
 
-        /* Switch to application context to get the characteristic value (as requested by the peer device). */
-        attr->cb->get_value(&value, &length);
-
-        /* Make sure the user has defined a valid value */
-        ASSERT_WARNING(value != NULL);
-
-        /* Respond to the BLE_EVT_GATTS_READ_REQ BLE event. */
-        ble_gatts_read_cfm(evt->conn_idx, attr->attr_h, ATT_ERROR_OK, length, (const void *)value);
+        status = helper_read_value(attr, long_read_find(evt->conn_idx), evt->conn_idx, evt->offset, &value, &length);
 
+        /* Respond to the BLE_EVT_GATTS_READ_REQ BLE event; the stack sends as many bytes as fit in the MTU. */
+        if (status == ATT_ERROR_OK) {
+                ble_gatts_read_cfm(evt->conn_idx, attr->attr_h, ATT_ERROR_OK, length, (const void *)value);
+        } else {
+                ble_gatts_read_cfm(evt->conn_idx, attr->attr_h, status, 0, NULL);
+        }
 }
 
+#if MCS_BENCHMARK_EN
 /*
  * Helper function to send notifications to the peer devices.
  *
@@ -213,110 +716,547 @@ static void helper_send_notif(uint16_t conn_idx, uint16_t size, const uint8_t *v
                  ble_gatts_send_event(conn_idx, attr_h, GATT_EVENT_INDICATION, size, (const void *)value);
          }
 }
+#endif
 
-/*
- * Notify peer devices that an ATT value has been changed.
- *
- * \note This routine has the same functionality as \sa mcs_send_notifications() but requires
- *       different input parameters.
- */
-static void notify_peer_devices(ble_service_t *svc, uint16_t size, const uint8_t *value, mcs_attributes_config_t *attr)
+/* Send a notification or indication, as selected by the cached CCC value of the peer device */
+static bool helper_send_event(int slot, uint16_t size, const uint8_t *value, mcs_attributes_config_t *attr)
 {
-        ASSERT_WARNING(svc != NULL);
-        ASSERT_WARNING(attr != NULL);
-        ASSERT_WARNING(value != NULL);
+        gatt_event_t type = (attr->notif_mask & (1 << slot)) ? GATT_EVENT_NOTIFICATION : GATT_EVENT_INDICATION;
 
-        uint8_t num_conn;
-        uint16_t *conn_idx;
+        if (send_event(connected_peers[slot], attr->attr_h, type, size, (const void *)value) != BLE_STATUS_OK) {
+                notif_stats.dropped++;
+                return false;
+        }
 
-        ble_gap_get_connected(&num_conn, &conn_idx);
+        notif_stats.sent++;
+        return true;
+}
 
-        /* For all the connected peer devices. s*/
-        while (num_conn--) {
-                helper_notify_peer_devices(svc, conn_idx[num_conn], size, value, attr);
-        }
+#if MCS_NOTIF_POOL_SIZE > 0
+/* Time the next event can be sent for a slot, as limited by the minimum interval (or the retry time) */
+static OS_TICK_TIME notif_slot_deadline(const mcs_notif_slot_t *ns)
+{
+        uint16_t interval_ms = ns->attr->notif_min_interval_ms;
 
-        if (conn_idx) {
-                OS_FREE(conn_idx);
+        if (ns->retry) {
+                interval_ms = MAX(interval_ms, MCS_NOTIF_RETRY_MS);
         }
+        return ns->last_sent + OS_MS_2_TICKS(interval_ms);
 }
 
-/* Helper function to notify peer devices. */
-static void helper_notify_peer_devices(ble_service_t *svc, uint16_t conn_idx, uint16_t size,
-                                                const uint8_t *value, mcs_attributes_config_t *attr)
+/* Check whether the minimum interval of the characteristic attribute has elapsed for a slot */
+static bool notif_slot_interval_elapsed(const mcs_notif_slot_t *ns)
 {
-        ASSERT_WARNING(svc != NULL);
-        ASSERT_WARNING(attr != NULL);
-        ASSERT_WARNING(value != NULL);
+        return (ticks_until(notif_slot_deadline(ns)) <= 0);
+}
 
-        uint16_t ccc = GATT_CCC_NONE;
+/*
+ * Get the notification slot of a characteristic attribute and peer device pair. A free slot, or
+ * else an idle one, is assigned if none is found. NULL is returned if all slots are busy.
+ */
+static mcs_notif_slot_t* notif_slot_find(mcs_attributes_config_t *attr, uint16_t conn_idx)
+{
+        mcs_notif_slot_t *candidate = NULL;
 
-       /* Get the Client Configuration Characteristic (CCC) value stored in flash memory. */
-        ble_storage_get_u16(conn_idx, attr->attr_ccc_h, &ccc);
+        for (int i = 0; i < MCS_NOTIF_POOL_SIZE; i++) {
+                mcs_notif_slot_t *ns = &notif_pool[i];
 
-        /* Check whether notifications are explicitly enabled by the peer device. */
-        if ( ((!(ccc & GATT_CCC_NOTIFICATIONS)) && (!(ccc & GATT_CCC_INDICATIONS))) ) {
-                return;
+                if (ns->attr == NULL) {
+                        if (candidate == NULL || candidate->attr) {
+                                candidate = ns;
+                        }
+                } else if ((ns->attr == attr) && (ns->conn_idx == conn_idx)) {
+                        return ns;
+                } else if ((candidate == NULL) && !ns->in_flight && !ns->pending &&
+                                                                notif_slot_interval_elapsed(ns)) {
+                        candidate = ns;
+                }
         }
 
-        if (ccc & GATT_CCC_NOTIFICATIONS) {
-                ble_gatts_send_event(conn_idx, attr->attr_h, GATT_EVENT_NOTIFICATION,
-                                                                           size, (const void *)value);
-        } else if (ccc & GATT_CCC_INDICATIONS) {
-                ble_gatts_send_event(conn_idx, attr->attr_h, GATT_EVENT_INDICATION,
-                                                                            size, (const void *)value);
+        if (candidate) {
+                candidate->attr      = attr;
+                candidate->conn_idx  = conn_idx;
+                candidate->in_flight = false;
+                candidate->pending   = false;
+                candidate->retry     = false;
+                candidate->last_sent = OS_GET_TICK_COUNT() - OS_MS_2_TICKS(attr->notif_min_interval_ms);
         }
+        return candidate;
 }
 
-/* Handler to service \sa BLE_EVT_GATTS_EVENT_SENT BLE events */
-static void handle_event_sent(ble_service_t *svc, const ble_evt_gatts_event_sent_t *evt)
+/*
+ * Send the pending value of a slot, if no event is in flight and the minimum interval has elapsed.
+ * A value rejected by the BLE stack is kept pending and sent again once the retry time has elapsed.
+ */
+static void notif_slot_flush(mcs_notif_slot_t *ns)
 {
-        ASSERT_WARNING(svc != NULL);
-        ASSERT_WARNING(evt != NULL);
-
-        mcs_service_config_t *hdr = (mcs_service_config_t *) svc;
+        if (!ns->pending || ns->in_flight || !notif_slot_interval_elapsed(ns)) {
+                return;
+        }
 
-        for (int idx = 0; (idx < hdr->num_of_characteristics); idx++) {
+        int slot = connected_peer_slot(ns->conn_idx);
+        if ((slot < 0) || !((ns->attr->notif_mask | ns->attr->indic_mask) & (1 << slot))) {
+                /* The peer device has unsubscribed in the meantime */
+                ns->pending = false;
+                return;
+        }
 
-                mcs_attributes_config_t *attr = mcs_select_list_item_by_index(hdr->head, idx);
+        ns->retry = !helper_send_event(slot, ns->length, ns->value, ns->attr);
+        ns->last_sent = OS_GET_TICK_COUNT();
 
-                if (evt->handle == attr->attr_h) {
-                        if (attr->cb->event_sent) {
-                                attr->cb->event_sent(evt->conn_idx, evt->status, evt->type);
+        if (!ns->retry) {
+                ns->pending = false;
+                ns->in_flight = true;
+        }
+}
+#endif
+
+#if MCS_INDIC_QUEUE_SIZE > 0
+/* Remove the oldest indication of a queue */
+static void indic_queue_pop(mcs_indic_queue_t *q)
+{
+        q->in_flight = false;
+        q->retry = false;
+        q->head = (q->head + 1) % MCS_INDIC_QUEUE_SIZE;
+        q->count--;
+}
+
+/*
+ * Send the oldest indication of a queue, if none is in flight. Indications whose characteristic
+ * attribute is no longer indicated to the peer device are skipped. An indication rejected by the
+ * BLE stack is kept at the head of the queue and sent again once the retry time has elapsed.
+ */
+static void indic_queue_flush(int slot)
+{
+        mcs_indic_queue_t *q = &indic_queues[slot];
+
+        /* Give up an indication not confirmed in time; the next one is sent */
+        if (q->in_flight && (OS_TICKS_2_MS(OS_GET_TICK_COUNT() - q->sent_time) >= MCS_INDIC_TIMEOUT_MS)) {
+                indic_stats.timeouts++;
+                indic_queue_pop(q);
+        }
+
+        while (q->count && !q->in_flight) {
+                mcs_indic_entry_t *entry = &q->entries[q->head];
+
+                if (!entry->attr || !(helper_get_subscription(entry->attr, slot) & GATT_CCC_INDICATIONS)) {
+                        indic_queue_pop(q);
+                        continue;
+                }
+
+                if (q->retry && (ticks_until(q->sent_time + OS_MS_2_TICKS(MCS_NOTIF_RETRY_MS)) > 0)) {
+                        return;
+                }
+
+                /* Sent as an indication even if notifications have been enabled in the meantime */
+                if (send_event(connected_peers[slot], entry->attr->attr_h, GATT_EVENT_INDICATION,
+                                        entry->length, (const void *)entry->value) == BLE_STATUS_OK) {
+                        notif_stats.sent++;
+                        q->in_flight = true;
+                        q->retry = false;
+                } else {
+                        indic_stats.retries++;
+                        q->retry = true;
+                }
+                q->sent_time = OS_GET_TICK_COUNT();
+
+                /* The confirmation timeout (or the retry time) is serviced by the framework timer */
+                mcs_timer_arm();
+                return;
+        }
+}
+
+/* Queue an indication to the peer device of a connected peer slot. False if the queue is full. */
+static bool indic_queue_push(int slot, uint16_t size, const uint8_t *value, mcs_attributes_config_t *attr)
+{
+        mcs_indic_queue_t *q = &indic_queues[slot];
+
+        if (q->count == MCS_INDIC_QUEUE_SIZE) {
+                /* Make room if the indication in flight has timed out */
+                indic_queue_flush(slot);
+
+                if (q->count == MCS_INDIC_QUEUE_SIZE) {
+                        indic_stats.overflows++;
+                        return false;
+                }
+        }
+
+        mcs_indic_entry_t *entry = &q->entries[(q->head + q->count) % MCS_INDIC_QUEUE_SIZE];
+
+        entry->attr   = attr;
+        entry->length = size;
+        memcpy(entry->value, value, size);
+
+        q->count++;
+        indic_stats.queued++;
+        if (q->count > indic_stats.max_depth) {
+                indic_stats.max_depth = q->count;
+        }
+
+        indic_queue_flush(slot);
+        return true;
+}
+#endif
+
+/* (Re)start the framework timer for the earliest deadline pending, or stop it if none is pending */
+static void mcs_timer_arm(void)
+{
+        int32_t earliest = INT32_MAX;
+
+        if (mcs_timer_h == NULL) {
+                return;
+        }
+
+        for (int i = 0; i < MCS_LONG_WRITE_POOL_SIZE; i++) {
+                mcs_long_write_t *lw = &long_write_pool[i];
+
+                if (lw->svc) {
+                        earliest = MIN(earliest, ticks_until(long_write_deadline(lw)));
+                }
+        }
+
+#if MCS_INDIC_QUEUE_SIZE > 0
+        /* Indications waiting for their confirmation, or to be sent again */
+        for (int i = 0; i < BLE_GAP_MAX_CONNECTED; i++) {
+                mcs_indic_queue_t *q = &indic_queues[i];
+
+                if ((connected_peers_mask & (1 << i)) && q->in_flight) {
+                        earliest = MIN(earliest, ticks_until(q->sent_time + OS_MS_2_TICKS(MCS_INDIC_TIMEOUT_MS)));
+                } else if ((connected_peers_mask & (1 << i)) && q->count && q->retry) {
+                        earliest = MIN(earliest, ticks_until(q->sent_time + OS_MS_2_TICKS(MCS_NOTIF_RETRY_MS)));
+                }
+        }
+#endif
+
+#if MCS_NOTIF_POOL_SIZE > 0
+        /* Values held back by the minimum interval; values waiting for an event in flight are not timed */
+        for (int i = 0; i < MCS_NOTIF_POOL_SIZE; i++) {
+                mcs_notif_slot_t *ns = &notif_pool[i];
+
+                if (ns->attr && ns->pending && !ns->in_flight) {
+                        earliest = MIN(earliest, ticks_until(notif_slot_deadline(ns)));
+                }
+        }
+#endif
+
+        if (earliest == INT32_MAX) {
+                if (OS_TIMER_IS_ACTIVE(mcs_timer_h)) {
+                        OS_TIMER_STOP(mcs_timer_h, OS_TIMER_FOREVER);
+                }
+                return;
+        }
+
+        /* The period is set per deadline; OS_TIMER_CHANGE_PERIOD() also starts the timer */
+        OS_TIMER_CHANGE_PERIOD(mcs_timer_h, MAX(earliest, 1), OS_TIMER_FOREVER);
+}
+
+/*
+ * Notify peer devices that an ATT value has been changed.
+ *
+ * \note This routine has the same functionality as \sa mcs_send_notifications() but requires
+ *       different input parameters.
+ */
+static void notify_peer_devices(ble_service_t *svc, uint16_t size, const uint8_t *value, mcs_attributes_config_t *attr)
+{
+        ASSERT_WARNING(svc != NULL);
+        ASSERT_WARNING(attr != NULL);
+        ASSERT_WARNING(value != NULL);
+
+        /* For all the connected peer devices. */
+        for (int i = 0; i < BLE_GAP_MAX_CONNECTED; i++) {
+                helper_notify_peer_devices(i, size, value, attr);
+        }
+}
+
+/*
+ * Helper function to notify the peer device of a connected peer slot. The cached CCC values are
+ * checked so no BLE storage access takes place.
+ */
+static void helper_notify_peer_devices(int slot, uint16_t size, const uint8_t *value,
+                                                                      mcs_attributes_config_t *attr)
+{
+        ASSERT_WARNING(attr != NULL);
+        ASSERT_WARNING(value != NULL);
+
+        mcs_conn_mask_t bit = (mcs_conn_mask_t)(1 << slot);
+
+        /* Check whether notifications are explicitly enabled by the peer device. */
+        if (!(connected_peers_mask & bit) || !((attr->notif_mask | attr->indic_mask) & bit)) {
+                return;
+        }
+
+#if MCS_INDIC_QUEUE_SIZE > 0
+        /* Indications are queued and sent one at a time; values too large to be queued are rejected */
+        if (!(attr->notif_mask & bit)) {
+                if (size <= MCS_INDIC_MAX_SIZE) {
+                        indic_queue_push(slot, size, value, attr);
+                } else {
+                        indic_stats.oversized++;
+                }
+                return;
+        }
+#endif
+
+#if MCS_NOTIF_POOL_SIZE > 0
+        mcs_notif_slot_t *ns = notif_slot_find(attr, connected_peers[slot]);
+
+        if (ns) {
+                /* Latest value wins; a value still pending is replaced */
+                if (ns->pending) {
+                        ns->pending = false;
+                        notif_stats.coalesced++;
+                }
+
+                if (size <= MCS_NOTIF_MAX_SIZE) {
+                        memcpy(ns->value, value, size);
+                        ns->length  = size;
+                        ns->pending = true;
+                        notif_slot_flush(ns);
+
+                        /* Held back by the minimum interval; sent on the timer expiration */
+                        if (ns->pending && !ns->in_flight) {
+                                mcs_timer_arm();
                         }
                         return;
                 }
+
+                /* Too large to be held pending; sent immediately */
+                if (helper_send_event(slot, size, value, attr)) {
+                        ns->in_flight = true;
+                        ns->last_sent = OS_GET_TICK_COUNT();
+                }
+                return;
         }
+#endif
+
+        /* No slot available; sent immediately */
+        helper_send_event(slot, size, value, attr);
 }
 
-/* Handler to service \sa BLE_EVT_GATTS_READ_REQ BLE events. */
-static void handle_read_req(ble_service_t *svc, const ble_evt_gatts_read_req_t *evt)
+/*
+ * Helper function to send a value of a transaction to the peer device of a connected peer slot.
+ * Notifications are sent immediately, bypassing the minimum interval, and the value held pending
+ * for the characteristic (if any) is discarded as older; indications are queued. False is returned
+ * if the value has been rejected.
+ */
+static bool helper_txn_send(int slot, uint16_t size, const uint8_t *value, mcs_attributes_config_t *attr)
+{
+        mcs_conn_mask_t bit = (mcs_conn_mask_t)(1 << slot);
+
+        if (!((attr->notif_mask | attr->indic_mask) & bit)) {
+                return true;
+        }
+
+#if MCS_INDIC_QUEUE_SIZE > 0
+        if (!(attr->notif_mask & bit)) {
+                if (size > MCS_INDIC_MAX_SIZE) {
+                        indic_stats.oversized++;
+                        return false;
+                }
+                return indic_queue_push(slot, size, value, attr);
+        }
+#endif
+
+#if MCS_NOTIF_POOL_SIZE > 0
+        mcs_notif_slot_t *ns = NULL;
+
+        for (int i = 0; i < MCS_NOTIF_POOL_SIZE; i++) {
+                if ((notif_pool[i].attr == attr) && (notif_pool[i].conn_idx == connected_peers[slot])) {
+                        ns = &notif_pool[i];
+                        break;
+                }
+        }
+
+        if (ns && ns->pending) {
+                ns->pending = false;
+                notif_stats.coalesced++;
+        }
+#endif
+
+        if (!helper_send_event(slot, size, value, attr)) {
+                return false;
+        }
+
+#if MCS_NOTIF_POOL_SIZE > 0
+        /* The minimum interval restarts from the value sent */
+        if (ns) {
+                ns->in_flight = true;
+                ns->last_sent = OS_GET_TICK_COUNT();
+        }
+#endif
+        return true;
+}
+
+/*
+ * Handler to service \sa BLE_EVT_GAP_CONNECTED BLE events. The event is delivered to all the custom
+ * services registered so the peer device should be added only once. Each service restores the
+ * cached CCC values of its own characteristic attributes from the BLE storage (bonded peer devices
+ * keep their CCC values across connections).
+ */
+static void handle_connected_evt(ble_service_t *svc, const ble_evt_gap_connected_t *evt)
 {
         ASSERT_WARNING(svc != NULL);
         ASSERT_WARNING(evt != NULL);
 
         mcs_service_config_t *hdr = (mcs_service_config_t *) svc;
+        int slot = connected_peer_slot(evt->conn_idx);
+
+        if (slot < 0) {
+                for (int i = 0; i < BLE_GAP_MAX_CONNECTED; i++) {
+                        if (!(connected_peers_mask & (1 << i))) {
+                                connected_peers[i] = evt->conn_idx;
+                                connected_peers_mask |= (mcs_conn_mask_t)(1 << i);
+                                slot = i;
+                                break;
+                        }
+                }
+
+                if (slot < 0) {
+                        return;
+                }
+        }
+
+        for (int i = 0; i < hdr->num_of_characteristics; i++) {
+                mcs_attributes_config_t *attr = hdr->attr_table[i];
+                uint16_t ccc = GATT_CCC_NONE;
+
+                if (helper_has_ccc(hdr, attr)) {
+                        ble_storage_get_u16(evt->conn_idx, attr->attr_ccc_h, &ccc);
+                }
+                helper_set_subscription(attr, slot, ccc);
+        }
+}
+
+/* Handler to service \sa BLE_EVT_GAP_DISCONNECTED BLE events. */
+static void handle_disconnected_evt(ble_service_t *svc, const ble_evt_gap_disconnected_t *evt)
+{
+        ASSERT_WARNING(svc != NULL);
+        ASSERT_WARNING(evt != NULL);
+
+        /* Release the long read state of the peer device */
+        for (int i = 0; i < BLE_GAP_MAX_CONNECTED; i++) {
+                if (long_read_cache[i].attr && (long_read_cache[i].conn_idx == evt->conn_idx)) {
+                        long_read_cache[i].attr = NULL;
+                }
+        }
+
+        /* Release the reassembly buffers of the peer device; values not completed are discarded */
+        for (int i = 0; i < MCS_LONG_WRITE_POOL_SIZE; i++) {
+                if (long_write_pool[i].svc && (long_write_pool[i].conn_idx == evt->conn_idx)) {
+                        long_write_release(&long_write_pool[i], false);
+                }
+        }
+
+#if MCS_NOTIF_POOL_SIZE > 0
+        /* Release the notification slots of the peer device; pending values are discarded */
+        for (int i = 0; i < MCS_NOTIF_POOL_SIZE; i++) {
+                if (notif_pool[i].attr && (notif_pool[i].conn_idx == evt->conn_idx)) {
+                        notif_pool[i].attr = NULL;
+                }
+        }
+#endif
 
         /*
-         * Start transacting the characteristic list until the requested attribute is reached.
-         * Then, exit from callback (there is no need to scan the rest items of the list)
+         * Release the slot of the peer device. The cached CCC values of the slot are restored by
+         * each service once the slot is reused.
          */
-        for (int idx = 0; (idx < hdr->num_of_characteristics); idx++) {
+        int slot = connected_peer_slot(evt->conn_idx);
+        if (slot >= 0) {
+#if MCS_INDIC_QUEUE_SIZE > 0
+                /* Discard the indications queued */
+                indic_stats.discarded += indic_queues[slot].count;
+                indic_queues[slot].count = 0;
+                indic_queues[slot].in_flight = false;
+                indic_queues[slot].retry = false;
+#endif
+                connected_peers_mask &= (mcs_conn_mask_t)~(1 << slot);
+        }
+}
 
-                mcs_attributes_config_t *attr = mcs_select_list_item_by_index(hdr->head, idx);
+/* Handler to service \sa BLE_EVT_GATTS_EVENT_SENT BLE events */
+static void handle_event_sent(ble_service_t *svc, const ble_evt_gatts_event_sent_t *evt)
+{
+        ASSERT_WARNING(svc != NULL);
+        ASSERT_WARNING(evt != NULL);
+
+        mcs_service_config_t *hdr = (mcs_service_config_t *) svc;
+        mcs_attributes_config_t *attr = mcs_select_attr_by_handle(hdr, evt->handle);
+
+        if (attr && (evt->handle == attr->attr_h)) {
+#if MCS_INDIC_QUEUE_SIZE > 0
+                /* The indication in flight has been confirmed; send the next one queued (if any) */
+                int slot = connected_peer_slot(evt->conn_idx);
+
+                if ((evt->type == GATT_EVENT_INDICATION) && (slot >= 0)) {
+                        mcs_indic_queue_t *q = &indic_queues[slot];
+
+                        if (q->in_flight && (q->entries[q->head].attr == attr)) {
+                                if (evt->status) {
+                                        indic_stats.confirmed++;
+                                }
+                                indic_queue_pop(q);
+                                indic_queue_flush(slot);
+                        }
+                }
+#endif
+#if MCS_NOTIF_POOL_SIZE > 0
+                /* The event has been completed; send the latest value pending (if any) */
+                for (int i = 0; i < MCS_NOTIF_POOL_SIZE; i++) {
+                        mcs_notif_slot_t *ns = &notif_pool[i];
+
+                        if ((ns->attr == attr) && (ns->conn_idx == evt->conn_idx)) {
+                                ns->in_flight = false;
+                                notif_slot_flush(ns);
+
+                                if (ns->pending) {
+                                        mcs_timer_arm();
+                                }
+                                break;
+                        }
+                }
+#endif
+                if (attr->cb->event_sent) {
+                        attr->cb->event_sent(evt->conn_idx, evt->status, evt->type);
+                }
+        }
+}
 
-                /* Check if the requested attribute is a valid attribute that can be handled. */
+/* Handler to service \sa BLE_EVT_GATTS_READ_REQ BLE events. */
+static void handle_read_req(ble_service_t *svc, const ble_evt_gatts_read_req_t *evt)
+{
+        ASSERT_WARNING(svc != NULL);
+        ASSERT_WARNING(evt != NULL);
+
+        mcs_service_config_t *hdr = (mcs_service_config_t *) svc;
+        mcs_attributes_config_t *attr = mcs_select_attr_by_handle(hdr, evt->handle);
+
+        /* Deliver any value reassembled, so the peer device reads back what has been written */
+        long_write_flush(evt->conn_idx, 0);
+
+        /* Check if the requested attribute is a valid attribute that can be handled. */
+        if (attr) {
                 if (evt->handle == attr->attr_h) {
                         helper_att_read_handler(svc, attr, evt);
                         return;
                 } else if (evt->handle == attr->attr_ccc_h) {  // A request to read the descriptor of the Characteristic
                         uint16_t ccc = 0x0000;
+                        int slot = connected_peer_slot(evt->conn_idx);
 
-                        /* Extract the CCC value from the BLE storage */
-                        ble_storage_get_u16(evt->conn_idx, attr->attr_ccc_h, &ccc);
+                        /* Get the cached CCC value; fall back to the BLE storage for unknown peers */
+                        if (slot >= 0) {
+                                ccc = helper_get_subscription(attr, slot);
+                        } else {
+                                ble_storage_get_u16(evt->conn_idx, attr->attr_ccc_h, &ccc);
+                        }
+
+                        if (evt->offset > sizeof(ccc)) {
+                                ble_gatts_read_cfm(evt->conn_idx, evt->handle, ATT_ERROR_INVALID_OFFSET, 0, NULL);
+                                return;
+                        }
 
                         /* We're little-endian - OK to write directly from uint16_t */
-                        ble_gatts_read_cfm(evt->conn_idx, evt->handle, ATT_ERROR_OK, sizeof(ccc), (const void *)&ccc);
+                        ble_gatts_read_cfm(evt->conn_idx, evt->handle, ATT_ERROR_OK, sizeof(ccc) - evt->offset,
+                                                                (const void *)((uint8_t *)&ccc + evt->offset));
                         return;
                 }
         }
@@ -335,24 +1275,37 @@ static void handle_write_req(ble_service_t *svc, const ble_evt_gatts_write_req_t
         mcs_service_config_t *hdr = (mcs_service_config_t *) svc;
         att_error_t status = ATT_ERROR_WRITE_NOT_PERMITTED;
 
-        /* Start traversing the characteristic list until the requested attribute is reached. */
-        for (int idx = 0; (idx < hdr->num_of_characteristics); idx++) {
+        mcs_attributes_config_t *attr = mcs_select_attr_by_handle(hdr, evt->handle);
+        mcs_long_write_t *lw;
 
-                mcs_attributes_config_t *attr = mcs_select_list_item_by_index(hdr->head, idx);
+        /* Deliver any value reassembled for other attributes of the peer device */
+        long_write_flush(evt->conn_idx, evt->handle);
 
-                /* Check if the requested attribute is a valid attribute that can be handled */
+        /* Check if the requested attribute is a valid attribute that can be handled */
+        if (attr) {
                 if (evt->handle == attr->attr_h) {
-                        status = helper_att_write_handler(svc, attr, evt);
+                        lw = long_write_find(evt->conn_idx, attr->attr_h);
+
+                        /* A write at offset zero following a reassembled value starts a new write */
+                        if (lw && (evt->offset == 0) && lw->length) {
+                                long_write_release(lw, true);
+                                lw = NULL;
+                        }
+
+                        if (lw) {
+                                status = helper_long_write_handler(lw, evt);
+                        } else {
+                                status = helper_att_write_handler(svc, attr, evt);
+                        }
                         goto done;
                 } else if (evt->handle == attr->attr_ccc_h) {
                         status = helper_ccc_write_handler(attr, evt);
                         goto done;
                 }
-
         }
 
 done:
-                if (status == ((att_error_t) - 1)) {
+                if (status == MCS_ATT_CFM_SENT) {
                         return; // Write handler executed properly
                 }
 
@@ -368,15 +1321,43 @@ static void handle_prepare_write_req(ble_service_t *svc, const ble_evt_gatts_pre
 
         mcs_service_config_t *hdr = (mcs_service_config_t *) svc;
 
-        for (int idx = 0; idx < hdr->num_of_characteristics; idx++) {
-                mcs_attributes_config_t *attr = mcs_select_list_item_by_index(hdr->head, idx);
+        mcs_attributes_config_t *attr = mcs_select_attr_by_handle(hdr, evt->handle);
+        mcs_long_write_t *lw;
 
-                if (evt->handle == attr->attr_h) {
-                        /* Response for the prepare write request */
-                        ble_gatts_prepare_write_cfm(evt->conn_idx, evt->handle, attr->characteristic_max_size, ATT_ERROR_OK);
-                        return;
-                }
+        if ((attr == NULL) || (evt->handle != attr->attr_h)) {
+                ble_gatts_prepare_write_cfm(evt->conn_idx, evt->handle, 0, ATT_ERROR_ATTRIBUTE_NOT_LONG);
+                return;
+        }
+
+        if ((attr->cb == NULL) || (attr->cb->set_value == NULL)) {
+                ble_gatts_prepare_write_cfm(evt->conn_idx, evt->handle, 0, ATT_ERROR_WRITE_NOT_PERMITTED);
+                return;
+        }
+
+        /* A previous sequence of the peer device with a value reassembled has been executed */
+        long_write_flush(evt->conn_idx, 0);
+
+        /*
+         * A peer device holds at most one buffer. A previous sequence for the same attribute, with no
+         * fragments received, has been canceled; one for another attribute has not been executed yet.
+         */
+        lw = long_write_find_conn(evt->conn_idx);
+        if (lw && (lw->attr == attr)) {
+                long_write_release(lw, false);
+        }
+
+        lw = long_write_find_conn(evt->conn_idx) ? NULL : long_write_alloc(svc, attr, evt->conn_idx);
+        if (lw == NULL) {
+                long_write_stats.exhausted++;
+                ble_gatts_prepare_write_cfm(evt->conn_idx, evt->handle, 0, ATT_ERROR_PREPARE_QUEUE_FULL);
+                return;
         }
+
+        /* The buffer is freed if the prepared writes are not executed in time */
+        mcs_timer_arm();
+
+        /* Response for the prepare write request; the value is capped to the reassembly buffer size */
+        ble_gatts_prepare_write_cfm(evt->conn_idx, evt->handle, lw->max_size, ATT_ERROR_OK);
 }
 
 
@@ -388,17 +1369,84 @@ static void handle_cleanup_req(ble_service_t *svc)
 
         mcs_service_config_t *hdr = (mcs_service_config_t *) svc;
 
+        /* Release the long read state referring to the service (if any) */
+        for (int i = 0; i < BLE_GAP_MAX_CONNECTED; i++) {
+                mcs_attributes_config_t *attr = long_read_cache[i].attr;
+
+                if (attr && (mcs_select_attr_by_handle(hdr, attr->attr_h) == attr)) {
+                        long_read_cache[i].attr = NULL;
+                }
+        }
+
+        /* Release any reassembly buffers held by the service */
+        for (int i = 0; i < MCS_LONG_WRITE_POOL_SIZE; i++) {
+                if (long_write_pool[i].svc == svc) {
+                        long_write_release(&long_write_pool[i], false);
+                }
+        }
+
+#if MCS_INDIC_QUEUE_SIZE > 0
+        /* Invalidate the indications queued for the service; they are skipped once reached */
+        for (int i = 0; i < BLE_GAP_MAX_CONNECTED; i++) {
+                mcs_indic_queue_t *q = &indic_queues[i];
+
+                for (int j = 0; j < q->count; j++) {
+                        mcs_indic_entry_t *entry = &q->entries[(q->head + j) % MCS_INDIC_QUEUE_SIZE];
+
+                        if (entry->attr && (mcs_select_attr_by_handle(hdr, entry->attr->attr_h) == entry->attr)) {
+                                entry->attr = NULL;
+
+                                /* No confirmation will be delivered for an indication in flight */
+                                if (j == 0) {
+                                        q->in_flight = false;
+                                }
+                        }
+                }
+
+                if (connected_peers_mask & (1 << i)) {
+                        indic_queue_flush(i);
+                }
+        }
+#endif
+
+#if MCS_NOTIF_POOL_SIZE > 0
+        /* Release the notification slots referring to the service */
+        for (int i = 0; i < MCS_NOTIF_POOL_SIZE; i++) {
+                mcs_attributes_config_t *attr = notif_pool[i].attr;
+
+                if (attr && (mcs_select_attr_by_handle(hdr, attr->attr_h) == attr)) {
+                        notif_pool[i].attr = NULL;
+                }
+        }
+#endif
+
         for (int i = 0; i < hdr->num_of_characteristics; i++) {
 
-                mcs_attributes_config_t *list_item = mcs_select_list_item_by_index(hdr->head, i);
+                mcs_attributes_config_t *list_item = hdr->attr_table[i];
 
                 /* Remove all the Characteristic Notification Descriptors stored in flash memory. */
                 ble_storage_remove_all(list_item->attr_ccc_h);
                 mcs_notif_remove_list_item_by_addr((uint32_t)list_item);
         }
 
+        /* Services using static storage are only unlinked */
+        if (hdr->head == NULL) {
+                mcs_service_config_t **node = &static_services_head;
+
+                while (*node != NULL) {
+                        if (*node == hdr) {
+                                *node = hdr->next;
+                                break;
+                        }
+                        node = &(*node)->next;
+                }
+                return;
+        }
+
         /* Remove previously allocated memory spaces. */
         mcs_free_list(hdr->head);
+        OS_FREE(hdr->attr_table);
+        OS_FREE(hdr->handle_table);
         OS_FREE(hdr);
 }
 
@@ -421,14 +1469,24 @@ static mcs_service_config_t* mcs_service_database_init(mcs_characteristic_list_e
         hdr->head = head;
         hdr->num_of_characteristics = num_of_characteristics;
 
+        helper_set_service_callbacks(hdr);
+
+        return hdr;
+}
+
+/* Helper function to declare the callback functions of the Service handle. */
+static void helper_set_service_callbacks(mcs_service_config_t *hdr)
+{
+        ASSERT_WARNING(hdr != NULL);
+
         /* Set callback functions associated with specific BLE events */
         hdr->svc.write_req          = handle_write_req;
         hdr->svc.read_req           = handle_read_req;
         hdr->svc.cleanup            = handle_cleanup_req;
         hdr->svc.event_sent         = handle_event_sent;
         hdr->svc.prepare_write_req  = handle_prepare_write_req;
-
-        return hdr;
+        hdr->svc.connected_evt      = handle_connected_evt;
+        hdr->svc.disconnected_evt   = handle_disconnected_evt;
 }
 
 /*
@@ -544,6 +1602,7 @@ static void mcs_set_list_items(mcs_characteristic_list_element_t *head,
         ASSERT_WARNING(i == num_of_items); // Make sure all requested items are written
 }
 
+#if MCS_BENCHMARK_EN
 /* Function to select an ATT configuration structure (linked list)  */
 static mcs_attributes_config_t* mcs_select_list_item_by_index(mcs_characteristic_list_element_t *head,
                                                                                             uint8_t item_idx)
@@ -566,6 +1625,7 @@ static mcs_attributes_config_t* mcs_select_list_item_by_index(mcs_characteristic
                 return (&current_node->config);
         }
 }
+#endif
 
 /* Function to remove item by address (address of the ATT configuration structures) */
 static void mcs_notif_remove_list_item_by_addr(uint32_t addr)
@@ -638,6 +1698,15 @@ static mcs_attributes_config_t* mcs_notif_select_list_item_by_uuid(const char *u
                 }
                 current_node = current_node->next;
         }
+
+        /* Services using static storage are looked up via their characteristic declarations */
+        for (mcs_service_config_t *hdr = static_services_head; hdr != NULL; hdr = hdr->next) {
+                for (int i = 0; i < hdr->num_of_characteristics; i++) {
+                        if (strncmp(uuid, hdr->cfg[i].uuid, UUID_CUSTOM_DEFINITION_MAX_LENGTH) == 0) {
+                                return hdr->attr_table[i];
+                        }
+                }
+        }
         return NULL;
 }
 
@@ -773,6 +1842,57 @@ static uint16_t helper_compute_total_num_of_descriptors(const mcs_characteristic
         return num_of_descriptors;
 }
 
+/* Helper function to build the table of the characteristic attributes (in declaration order). */
+static void helper_build_attr_table(mcs_service_config_t *hdr)
+{
+        ASSERT_WARNING(hdr != NULL);
+
+        mcs_characteristic_list_element_t *current_node = hdr->head;
+
+        hdr->attr_table = (mcs_attributes_config_t **)
+                        OS_MALLOC(hdr->num_of_characteristics * sizeof(mcs_attributes_config_t *));
+        OS_ASSERT(hdr->attr_table != NULL);
+
+        for (int i = 0; i < hdr->num_of_characteristics; i++) {
+                ASSERT_WARNING(current_node != NULL);
+
+                hdr->attr_table[i] = &current_node->config;
+                current_node = current_node->next;
+        }
+}
+
+/*
+ * Helper function to build the handle dispatch table of the BLE custom service. Only the value
+ * and CCC handles are mapped; any other handle of the service resolves to zero (not serviced).
+ *
+ * \note This routine should be called once all the ATT handle values have been computed and the
+ *       table has been allocated.
+ */
+static void helper_build_handle_table(mcs_service_config_t *hdr, const mcs_characteristic_config_t cfg[])
+{
+        ASSERT_WARNING(hdr != NULL);
+        ASSERT_WARNING(cfg != NULL);
+
+        uint16_t num_of_handles = hdr->svc.end_h - hdr->svc.start_h + 1;
+
+        /* Index zero is reserved to indicate a handle that is not serviced */
+        ASSERT_WARNING(hdr->num_of_characteristics < UINT8_MAX);
+
+        ASSERT_WARNING(hdr->handle_table != NULL);
+
+        memset(hdr->handle_table, 0x00, num_of_handles);
+
+        for (int i = 0; i < hdr->num_of_characteristics; i++) {
+                mcs_attributes_config_t *attr = hdr->attr_table[i];
+
+                hdr->handle_table[attr->attr_h - hdr->svc.start_h] = i + 1;
+
+                if ((cfg[i].gatt_prop & GATT_PROP_NOTIFY) || (cfg[i].gatt_prop & GATT_PROP_INDICATE)) {
+                        hdr->handle_table[attr->attr_ccc_h - hdr->svc.start_h] = i + 1;
+                }
+        }
+}
+
 /********************************* User APIs routines *****************************************/
 
 /*
@@ -786,8 +1906,6 @@ bool mcs_send_notifications(const char *uuid, const uint8_t *value, uint16_t siz
         ASSERT_WARNING(uuid != NULL);
         ASSERT_WARNING(value != NULL);
 
-        uint8_t num_conn;
-        uint16_t *conn_idx;
         mcs_attributes_config_t *cfg;
 
         cfg = mcs_notif_select_list_item_by_uuid(uuid);
@@ -796,30 +1914,209 @@ bool mcs_send_notifications(const char *uuid, const uint8_t *value, uint16_t siz
                 return false;
         }
 
-        ble_gap_get_connected(&num_conn, &conn_idx);
+        return mcs_char_send_notifications(cfg, value, size);
+}
+
+/*
+ * Function used to send notifications to the peer devices for a specific characteristic handle.
+ *
+ * \note A peer device will be notified only if it has enabled notifications explicitly.
+ *
+ */
+bool mcs_char_send_notifications(mcs_char_handle_t chr, const uint8_t *value, uint16_t size)
+{
+        ASSERT_WARNING(value != NULL);
+
+        if (chr == NULL) {
+                ASSERT_WARNING(0);
+                return false;
+        }
+
+        /* The value sent cannot exceed the characteristic attribute value */
+        if (size > chr->characteristic_max_size) {
+                ASSERT_WARNING(0);
+                return false;
+        }
 
         /* For all the connected peer devices. */
-        while (num_conn--) {
-                helper_send_notif(conn_idx[num_conn], size, value, cfg->attr_h, cfg->attr_ccc_h);
+        for (int i = 0; i < BLE_GAP_MAX_CONNECTED; i++) {
+                helper_notify_peer_devices(i, size, value, chr);
         }
+        return true;
+}
 
-        if (conn_idx) {
-                OS_FREE(conn_idx);
+/* Function to start a transaction of characteristic value updates */
+void mcs_txn_begin(mcs_txn_t *txn)
+{
+        ASSERT_WARNING(txn != NULL);
+
+        txn->num_of_updates = 0;
+}
+
+/* Function to stage the updated value of a characteristic in a transaction */
+bool mcs_txn_stage(mcs_txn_t *txn, mcs_char_handle_t chr, const uint8_t *value, uint16_t size)
+{
+        ASSERT_WARNING(txn != NULL);
+        ASSERT_WARNING(chr != NULL);
+        ASSERT_WARNING(value != NULL);
+
+        int i;
+
+        if ((size > chr->characteristic_max_size) || (size > MCS_TXN_MAX_SIZE)) {
+                return false;
+        }
+
+        /* A characteristic staged again is sent once, with its latest value */
+        for (i = 0; i < txn->num_of_updates; i++) {
+                if (txn->updates[i].chr == chr) {
+                        break;
+                }
+        }
+
+        if (i == MCS_TXN_MAX_UPDATES) {
+                return false;
+        }
+
+        txn->updates[i].chr  = chr;
+        txn->updates[i].size = size;
+        memcpy(txn->updates[i].value, value, size);
+
+        if (i == txn->num_of_updates) {
+                txn->num_of_updates++;
         }
         return true;
 }
 
+/* Function to commit a transaction of characteristic value updates */
+bool mcs_txn_commit(mcs_txn_t *txn)
+{
+        ASSERT_WARNING(txn != NULL);
+
+        bool committed = true;
+
+        /* For all the connected peer devices, send all the values staged back to back. */
+        for (int i = 0; i < BLE_GAP_MAX_CONNECTED; i++) {
+                if (!(connected_peers_mask & (1 << i))) {
+                        continue;
+                }
+
+                for (int j = 0; j < txn->num_of_updates; j++) {
+                        if (!helper_txn_send(i, txn->updates[j].size, txn->updates[j].value,
+                                                                        txn->updates[j].chr)) {
+                                committed = false;
+                        }
+                }
+        }
+
+        txn->num_of_updates = 0;
+
+        return committed;
+}
+
+/* Function to set the minimum interval between two events sent to the same peer device */
+void mcs_char_set_min_interval(mcs_char_handle_t chr, uint16_t interval_ms)
+{
+        ASSERT_WARNING(chr != NULL);
+
+        chr->notif_min_interval_ms = interval_ms;
+}
+
+/* Function to send the values held back whose minimum interval has elapsed */
+void mcs_notif_flush(void)
+{
+#if MCS_INDIC_QUEUE_SIZE > 0
+        for (int i = 0; i < BLE_GAP_MAX_CONNECTED; i++) {
+                if (connected_peers_mask & (1 << i)) {
+                        indic_queue_flush(i);
+                }
+        }
+#endif
+#if MCS_NOTIF_POOL_SIZE > 0
+        for (int i = 0; i < MCS_NOTIF_POOL_SIZE; i++) {
+                if (notif_pool[i].attr) {
+                        notif_slot_flush(&notif_pool[i]);
+                }
+        }
+#endif
+
+        mcs_timer_arm();
+}
+
+/* Function to create the framework timer and set the task notified on its expiry */
+void mcs_timer_init(OS_TASK task, uint32_t notif)
+{
+        mcs_timer_task = task;
+        mcs_timer_notif = notif;
+
+        if (!mcs_timer_h) {
+                /* The period is set per deadline */
+                mcs_timer_h = OS_TIMER_CREATE("MCS", OS_MS_2_TICKS(MCS_LONG_WRITE_EXEC_IDLE_MS),
+                                                                OS_TIMER_FAIL, NULL, mcs_timer_cb);
+                ASSERT_WARNING(mcs_timer_h);
+        }
+}
+
+/* Function to service the framework timer expiry, in the context of the task notified */
+void mcs_timer_expired(void)
+{
+        /*
+         * Deliver the long writes executed, as no more fragments have been received, and free the
+         * buffers of the prepare write sequences not executed in time
+         */
+        for (int i = 0; i < MCS_LONG_WRITE_POOL_SIZE; i++) {
+                mcs_long_write_t *lw = &long_write_pool[i];
+
+                if (lw->svc && (ticks_until(long_write_deadline(lw)) <= 0)) {
+                        long_write_release(lw, true);
+                }
+        }
+
+        /*
+         * Send the values held back whose minimum interval has elapsed, send again the indications
+         * rejected by the BLE stack and give up the ones not confirmed in time; the timer is restarted
+         */
+        mcs_notif_flush();
+}
+
+/* Function to get the notification/indication statistics */
+void mcs_notif_get_stats(mcs_notif_stats_t *stats)
+{
+        ASSERT_WARNING(stats != NULL);
+
+        *stats = notif_stats;
+}
+
+/* Function to get the indication queue statistics */
+void mcs_indic_get_stats(mcs_indic_stats_t *stats)
+{
+        ASSERT_WARNING(stats != NULL);
+
+        *stats = indic_stats;
+}
+
+/* Function to get the long (queued) write statistics */
+void mcs_long_write_get_stats(mcs_long_write_stats_t *stats)
+{
+        ASSERT_WARNING(stats != NULL);
+
+        *stats = long_write_stats;
+}
+
 /* Routine to declare a Bluetooth custom service */
 ble_service_t* mcs_service_init(const mcs_characteristic_config_t cfg[], const char *service_uuid, uint8_t num_of_characrteristics)
+{
+        return mcs_service_init_ex(cfg, service_uuid, num_of_characrteristics, NULL);
+}
+
+/* Routine to declare a Bluetooth custom service and export its characteristic handles */
+ble_service_t* mcs_service_init_ex(const mcs_characteristic_config_t cfg[], const char *service_uuid,
+                                        uint8_t num_of_characrteristics, mcs_char_handle_t handles[])
 {
         ASSERT_WARNING(cfg != NULL);
         ASSERT_WARNING(service_uuid != NULL);
 
-        uint16_t num_of_attributes, num_of_descriptors;
         int notif_empty_idx;
-        att_uuid_t uuid;
         mcs_service_config_t *service_handle;
-        mcs_attributes_config_t *current_position;
         mcs_characteristic_list_element_t *head_list;
 
         /*
@@ -839,8 +2136,66 @@ ble_service_t* mcs_service_init(const mcs_characteristic_config_t cfg[], const c
 
         /* Set linked lists items */
         mcs_set_list_items(head_list, cfg, num_of_characrteristics);
+        helper_build_attr_table(service_handle);
         mcs_notif_set_list_items(head_list, cfg, num_of_characrteristics, notif_empty_idx);
 
+        return helper_service_register(service_handle, cfg, service_uuid, handles);
+}
+
+/* Routine to declare a Bluetooth custom service using static storage */
+ble_service_t* mcs_service_init_static(const mcs_characteristic_config_t cfg[], const char *service_uuid,
+                                        uint8_t num_of_characrteristics, const mcs_service_storage_t *storage,
+                                        mcs_char_handle_t handles[])
+{
+        ASSERT_WARNING(cfg != NULL);
+        ASSERT_WARNING(service_uuid != NULL);
+        ASSERT_WARNING(storage != NULL);
+
+        mcs_service_config_t *service_handle = storage->hdr;
+
+        memset((void *)service_handle, 0x00, sizeof(mcs_service_config_t));
+        memset((void *)storage->attrs, 0x00, num_of_characrteristics * sizeof(mcs_attributes_config_t));
+
+        service_handle->num_of_characteristics = num_of_characrteristics;
+        service_handle->attr_table             = storage->attr_table;
+        service_handle->handle_table           = storage->handle_table;
+        service_handle->cfg                    = cfg;
+
+        for (int i = 0; i < num_of_characrteristics; i++) {
+                storage->attrs[i].cb = &cfg[i].cb;
+                storage->attrs[i].characteristic_max_size = cfg[i].max_size;
+
+                service_handle->attr_table[i] = &storage->attrs[i];
+        }
+
+        helper_set_service_callbacks(service_handle);
+
+        /* Make the service reachable by the UUID based APIs */
+        service_handle->next = static_services_head;
+        static_services_head = service_handle;
+
+        return helper_service_register(service_handle, cfg, service_uuid, handles);
+}
+
+/*
+ * Helper function to register a Bluetooth custom service, the characteristic attributes of which
+ * have already been initialized, to the BLE database.
+ */
+static ble_service_t* helper_service_register(mcs_service_config_t *service_handle, const mcs_characteristic_config_t cfg[],
+                                                        const char *service_uuid, mcs_char_handle_t handles[])
+{
+        ASSERT_WARNING(service_handle != NULL);
+        ASSERT_WARNING(cfg != NULL);
+        ASSERT_WARNING(service_uuid != NULL);
+
+        /* One bit per connected peer slot is reserved in the subscription bitmaps */
+        ASSERT_WARNING(BLE_GAP_MAX_CONNECTED <= (8 * sizeof(mcs_conn_mask_t)));
+
+        uint8_t num_of_characrteristics = service_handle->num_of_characteristics;
+        uint16_t num_of_attributes, num_of_descriptors;
+        att_uuid_t uuid;
+        mcs_attributes_config_t *current_position;
+
         num_of_descriptors = helper_compute_total_num_of_descriptors(cfg, num_of_characrteristics);
 
         /**
@@ -855,7 +2210,7 @@ ble_service_t* mcs_service_init(const mcs_characteristic_config_t cfg[], const c
         /* For all the Characteristic Attributes of the Bluetooth Service */
         for (int i = 0; i < num_of_characrteristics; i++) {
 
-                current_position = mcs_select_list_item_by_index(head_list, i);
+                current_position = service_handle->attr_table[i];
 
                 /* ATT Characteristic declarations. */
                 ble_uuid_from_string(cfg[i].uuid, &uuid);
@@ -881,13 +2236,13 @@ ble_service_t* mcs_service_init(const mcs_characteristic_config_t cfg[], const c
         }
 
         /* Compute ATT handle values for the first attribute. */
-        current_position = mcs_select_list_item_by_index(head_list, 0);
+        current_position = service_handle->attr_table[0];
         ble_gatts_register_service(&service_handle->svc.start_h, &current_position->attr_h,
                                         &current_position->attr_ccc_h, &current_position->attr_descriptor_h, 0);
 
         /* Manually, compute ATT handle values for the rest of attributes. */
         for (int i = 1; i < num_of_characrteristics; i++) {
-                current_position = mcs_select_list_item_by_index(head_list, i);
+                current_position = service_handle->attr_table[i];
 
                 current_position->attr_h              = helper_compute_att_handle_offset(&current_position->attr_h, &service_handle->svc.start_h);
                 current_position->attr_ccc_h          = helper_compute_att_handle_offset(&current_position->attr_ccc_h, &service_handle->svc.start_h);
@@ -897,10 +2252,17 @@ ble_service_t* mcs_service_init(const mcs_characteristic_config_t cfg[], const c
         /* Calculate the last attribute handle value for the target BLE custom service database. */
         service_handle->svc.end_h = service_handle->svc.start_h + num_of_attributes;
 
+        /* Map the ATT handles of the service to their characteristic attributes. */
+        if (service_handle->handle_table == NULL) {
+                service_handle->handle_table = (uint8_t *)OS_MALLOC(num_of_attributes + 1);
+                OS_ASSERT(service_handle->handle_table != NULL);
+        }
+        helper_build_handle_table(service_handle, cfg);
+
         /* Declare default values for all the attributes (per needs). */
         for (int i = 0; i < num_of_characrteristics; i++) {
 
-                current_position = mcs_select_list_item_by_index(head_list, i);
+                current_position = service_handle->attr_table[i];
 
                 if (helper_is_user_descriptor_defined(cfg[i].user_descriptor)) {
                         ble_gatts_set_value(current_position->attr_descriptor_h,
@@ -908,9 +2270,331 @@ ble_service_t* mcs_service_init(const mcs_characteristic_config_t cfg[], const c
                 }
         }
 
+        /* Export the characteristic handles (per needs) */
+        if (handles) {
+                for (int i = 0; i < num_of_characrteristics; i++) {
+                        handles[i] = service_handle->attr_table[i];
+                }
+        }
+
         /* Register the BLE custom service database to Dialog BLE database */
         ble_service_add(&service_handle->svc);
 
         /* Return the BLE service handle (used for debugging purposes) */
         return (&service_handle->svc);
 }
+
+#if MCS_BENCHMARK_EN
+/* Legacy ATT handle dispatching, that is, walk the characteristic list from its head per index. */
+static mcs_attributes_config_t* mcs_benchmark_list_dispatch(mcs_service_config_t *hdr, uint16_t handle)
+{
+        for (int idx = 0; idx < hdr->num_of_characteristics; idx++) {
+                mcs_attributes_config_t *attr = mcs_select_list_item_by_index(hdr->head, idx);
+
+                if ((handle == attr->attr_h) || (handle == attr->attr_ccc_h)) {
+                        return attr;
+                }
+        }
+        return NULL;
+}
+
+void mcs_dispatch_benchmark(uint8_t num_of_characteristics, uint32_t *list_cycles, uint32_t *table_cycles)
+{
+        ASSERT_WARNING(num_of_characteristics > 0);
+        ASSERT_WARNING(list_cycles != NULL);
+        ASSERT_WARNING(table_cycles != NULL);
+
+        mcs_service_config_t hdr;
+        mcs_characteristic_config_t *cfg;
+        mcs_attributes_config_t * volatile attr;
+        uint32_t cycles_list = 0, cycles_table = 0;
+        uint32_t num_of_requests;
+        uint16_t handle;
+
+        memset(&hdr, 0x00, sizeof(hdr));
+        hdr.num_of_characteristics = num_of_characteristics;
+
+        /* The head is built explicitly so the notification list is left intact */
+        hdr.head = (mcs_characteristic_list_element_t *)OS_MALLOC(sizeof(mcs_characteristic_list_element_t));
+        OS_ASSERT(hdr.head != NULL);
+        memset(hdr.head, 0x00, sizeof(mcs_characteristic_list_element_t));
+
+        for (int i = 0; i < (num_of_characteristics - 1); i++) {
+                mcs_add_list_item(hdr.head);
+        }
+        helper_build_attr_table(&hdr);
+
+        cfg = (mcs_characteristic_config_t *)OS_MALLOC(num_of_characteristics * sizeof(mcs_characteristic_config_t));
+        OS_ASSERT(cfg != NULL);
+        memset(cfg, 0x00, num_of_characteristics * sizeof(mcs_characteristic_config_t));
+
+        /* Characteristic declaration, value, user descriptor and CCC attributes per characteristic */
+        hdr.svc.start_h = 1;
+        for (int i = 0; i < num_of_characteristics; i++) {
+                cfg[i].gatt_prop = GATT_PROP_NOTIFY;
+
+                hdr.attr_table[i]->attr_h            = hdr.svc.start_h + (4 * i) + 2;
+                hdr.attr_table[i]->attr_descriptor_h = hdr.svc.start_h + (4 * i) + 3;
+                hdr.attr_table[i]->attr_ccc_h        = hdr.svc.start_h + (4 * i) + 4;
+        }
+        hdr.svc.end_h = hdr.svc.start_h + (4 * num_of_characteristics);
+
+        hdr.handle_table = (uint8_t *)OS_MALLOC(hdr.svc.end_h - hdr.svc.start_h + 1);
+        OS_ASSERT(hdr.handle_table != NULL);
+        helper_build_handle_table(&hdr, cfg);
+
+        MCS_BENCHMARK_CYCLES_INIT();
+
+        for (int round = 0; round < MCS_BENCHMARK_ROUNDS; round++) {
+                for (handle = hdr.svc.start_h; handle <= hdr.svc.end_h; handle++) {
+                        uint32_t cycles = MCS_BENCHMARK_CYCLES();
+                        attr = mcs_benchmark_list_dispatch(&hdr, handle);
+                        cycles_list += MCS_BENCHMARK_CYCLES() - cycles;
+
+                        cycles = MCS_BENCHMARK_CYCLES();
+                        attr = mcs_select_attr_by_handle(&hdr, handle);
+                        cycles_table += MCS_BENCHMARK_CYCLES() - cycles;
+                }
+        }
+        (void)attr;
+
+        num_of_requests = MCS_BENCHMARK_ROUNDS * (hdr.svc.end_h - hdr.svc.start_h + 1);
+        *list_cycles  = cycles_list / num_of_requests;
+        *table_cycles = cycles_table / num_of_requests;
+
+        mcs_free_list(hdr.head);
+        OS_FREE(hdr.attr_table);
+        OS_FREE(hdr.handle_table);
+        OS_FREE(cfg);
+}
+
+void mcs_read_benchmark(mcs_char_handle_t chr, uint16_t mtu, uint32_t *uncached_cycles, uint32_t *cached_cycles)
+{
+        ASSERT_WARNING(chr != NULL);
+        ASSERT_WARNING(chr->cb->get_value != NULL);
+        ASSERT_WARNING(mtu > 1);
+        ASSERT_WARNING(uncached_cycles != NULL);
+        ASSERT_WARNING(cached_cycles != NULL);
+
+        mcs_long_read_t lr;
+        const uint8_t *value;
+        uint16_t length, remaining, offset;
+        uint32_t cycles_uncached = 0, cycles_cached = 0;
+        uint8_t *buffer;
+
+        memset(&lr, 0x00, sizeof(lr));
+
+        /* Get the length of the value */
+        chr->cb->get_value(&buffer, &length);
+
+        MCS_BENCHMARK_CYCLES_INIT();
+
+        for (int round = 0; round < MCS_BENCHMARK_ROUNDS; round++) {
+                uint32_t cycles = MCS_BENCHMARK_CYCLES();
+                for (offset = 0; offset < length; offset += (mtu - 1)) {
+                        helper_read_value(chr, NULL, BLE_CONN_IDX_INVALID, offset, &value, &remaining);
+                }
+                cycles_uncached += MCS_BENCHMARK_CYCLES() - cycles;
+
+                cycles = MCS_BENCHMARK_CYCLES();
+                for (offset = 0; offset < length; offset += (mtu - 1)) {
+                        helper_read_value(chr, chr->cb->get_version ? &lr : NULL, BLE_CONN_IDX_INVALID,
+                                                                        offset, &value, &remaining);
+                }
+                cycles_cached += MCS_BENCHMARK_CYCLES() - cycles;
+        }
+
+        *uncached_cycles = cycles_uncached / MCS_BENCHMARK_ROUNDS;
+        *cached_cycles   = cycles_cached / MCS_BENCHMARK_ROUNDS;
+}
+
+/* Legacy notification sending, that is, UUID lookup and enumeration of the connected devices per call. */
+static void mcs_benchmark_legacy_send_notifications(const char *uuid, const uint8_t *value, uint16_t size)
+{
+        uint8_t num_conn;
+        uint16_t *conn_idx;
+        mcs_attributes_config_t *cfg;
+
+        cfg = mcs_notif_select_list_item_by_uuid(uuid);
+        if (cfg == NULL) {
+                return;
+        }
+
+        ble_gap_get_connected(&num_conn, &conn_idx);
+
+        while (num_conn--) {
+                helper_send_notif(conn_idx[num_conn], size, value, cfg->attr_h, cfg->attr_ccc_h);
+        }
+
+        if (conn_idx) {
+                OS_FREE(conn_idx);
+        }
+}
+
+void mcs_notify_benchmark(mcs_char_handle_t chr, const char *uuid, const uint8_t *value, uint16_t size,
+                        uint32_t *legacy_cycles, uint32_t *uuid_cycles, uint32_t *handle_cycles)
+{
+        ASSERT_WARNING(chr != NULL);
+        ASSERT_WARNING(uuid != NULL);
+        ASSERT_WARNING(legacy_cycles != NULL);
+        ASSERT_WARNING(uuid_cycles != NULL);
+        ASSERT_WARNING(handle_cycles != NULL);
+
+        uint32_t cycles_legacy = 0, cycles_uuid = 0, cycles_handle = 0;
+
+        MCS_BENCHMARK_CYCLES_INIT();
+
+        for (int round = 0; round < MCS_BENCHMARK_ROUNDS; round++) {
+                uint32_t cycles = MCS_BENCHMARK_CYCLES();
+                mcs_benchmark_legacy_send_notifications(uuid, value, size);
+                cycles_legacy += MCS_BENCHMARK_CYCLES() - cycles;
+
+                cycles = MCS_BENCHMARK_CYCLES();
+                mcs_send_notifications(uuid, value, size);
+                cycles_uuid += MCS_BENCHMARK_CYCLES() - cycles;
+
+                cycles = MCS_BENCHMARK_CYCLES();
+                mcs_char_send_notifications(chr, value, size);
+                cycles_handle += MCS_BENCHMARK_CYCLES() - cycles;
+        }
+
+        *legacy_cycles = cycles_legacy / MCS_BENCHMARK_ROUNDS;
+        *uuid_cycles   = cycles_uuid / MCS_BENCHMARK_ROUNDS;
+        *handle_cycles = cycles_handle / MCS_BENCHMARK_ROUNDS;
+}
+
+void mcs_fanout_benchmark(mcs_char_handle_t chr, const uint8_t *value, uint16_t size, uint8_t *num_of_peers,
+                                                        uint32_t *storage_cycles, uint32_t *cache_cycles)
+{
+        ASSERT_WARNING(chr != NULL);
+        ASSERT_WARNING(value != NULL);
+        ASSERT_WARNING(num_of_peers != NULL);
+        ASSERT_WARNING(storage_cycles != NULL);
+        ASSERT_WARNING(cache_cycles != NULL);
+
+        uint32_t cycles_storage = 0, cycles_cache = 0;
+
+        *num_of_peers = 0;
+        for (int i = 0; i < BLE_GAP_MAX_CONNECTED; i++) {
+                if (connected_peers_mask & (1 << i)) {
+                        (*num_of_peers)++;
+                }
+        }
+
+        MCS_BENCHMARK_CYCLES_INIT();
+
+        for (int round = 0; round < MCS_BENCHMARK_ROUNDS; round++) {
+                uint32_t cycles = MCS_BENCHMARK_CYCLES();
+                for (int i = 0; i < BLE_GAP_MAX_CONNECTED; i++) {
+                        if (connected_peers_mask & (1 << i)) {
+                                helper_send_notif(connected_peers[i], size, value, chr->attr_h, chr->attr_ccc_h);
+                        }
+                }
+                cycles_storage += MCS_BENCHMARK_CYCLES() - cycles;
+
+                cycles = MCS_BENCHMARK_CYCLES();
+                for (int i = 0; i < BLE_GAP_MAX_CONNECTED; i++) {
+                        mcs_conn_mask_t bit = (mcs_conn_mask_t)(1 << i);
+
+                        if ((connected_peers_mask & bit) && ((chr->notif_mask | chr->indic_mask) & bit)) {
+                                helper_send_event(i, size, value, chr);
+                        }
+                }
+                cycles_cache += MCS_BENCHMARK_CYCLES() - cycles;
+        }
+
+        *storage_cycles = cycles_storage / MCS_BENCHMARK_ROUNDS;
+        *cache_cycles   = cycles_cache / MCS_BENCHMARK_ROUNDS;
+}
+
+/* Sender accepting every event without sending it over the air */
+static ble_error_t null_send_event(uint16_t conn_idx, uint16_t handle, gatt_event_t type, uint16_t length,
+                                                                                        const void *value)
+{
+        return BLE_STATUS_OK;
+}
+
+/* Notification/indication state, saved while benchmarking with the null sender */
+typedef struct {
+#if MCS_NOTIF_POOL_SIZE > 0
+        mcs_notif_slot_t notif_pool[MCS_NOTIF_POOL_SIZE];
+#endif
+#if MCS_INDIC_QUEUE_SIZE > 0
+        mcs_indic_queue_t indic_queues[BLE_GAP_MAX_CONNECTED];
+#endif
+        mcs_notif_stats_t notif_stats;
+        mcs_indic_stats_t indic_stats;
+} mcs_notif_state_t;
+
+static void notif_state_save(mcs_notif_state_t *state)
+{
+#if MCS_NOTIF_POOL_SIZE > 0
+        memcpy(state->notif_pool, notif_pool, sizeof(notif_pool));
+#endif
+#if MCS_INDIC_QUEUE_SIZE > 0
+        memcpy(state->indic_queues, indic_queues, sizeof(indic_queues));
+#endif
+        state->notif_stats = notif_stats;
+        state->indic_stats = indic_stats;
+}
+
+static void notif_state_restore(const mcs_notif_state_t *state)
+{
+#if MCS_NOTIF_POOL_SIZE > 0
+        memcpy(notif_pool, state->notif_pool, sizeof(notif_pool));
+#endif
+#if MCS_INDIC_QUEUE_SIZE > 0
+        memcpy(indic_queues, state->indic_queues, sizeof(indic_queues));
+#endif
+        notif_stats = state->notif_stats;
+        indic_stats = state->indic_stats;
+}
+
+void mcs_txn_benchmark(const mcs_char_handle_t chr[], uint8_t num_of_characteristics, const uint8_t *value,
+                                        uint16_t size, uint32_t *single_cycles, uint32_t *txn_cycles)
+{
+        ASSERT_WARNING(chr != NULL);
+        ASSERT_WARNING(num_of_characteristics <= MCS_TXN_MAX_UPDATES);
+        ASSERT_WARNING(single_cycles != NULL);
+        ASSERT_WARNING(txn_cycles != NULL);
+
+        uint32_t cycles_single = 0, cycles_txn = 0;
+        mcs_notif_state_t *state;
+        mcs_txn_t txn;
+
+        /* Both paths start each round from the live state, which is restored once done */
+        state = OS_MALLOC(sizeof(mcs_notif_state_t));
+        OS_ASSERT(state != NULL);
+        notif_state_save(state);
+        send_event = null_send_event;
+
+        MCS_BENCHMARK_CYCLES_INIT();
+
+        for (int round = 0; round < MCS_BENCHMARK_ROUNDS; round++) {
+                uint32_t cycles = MCS_BENCHMARK_CYCLES();
+                for (int i = 0; i < num_of_characteristics; i++) {
+                        mcs_char_send_notifications(chr[i], value, size);
+                }
+                cycles_single += MCS_BENCHMARK_CYCLES() - cycles;
+                notif_state_restore(state);
+
+                cycles = MCS_BENCHMARK_CYCLES();
+                mcs_txn_begin(&txn);
+                for (int i = 0; i < num_of_characteristics; i++) {
+                        mcs_txn_stage(&txn, chr[i], value, size);
+                }
+                mcs_txn_commit(&txn);
+                cycles_txn += MCS_BENCHMARK_CYCLES() - cycles;
+                notif_state_restore(state);
+        }
+
+        send_event = ble_gatts_send_event;
+        OS_FREE(state);
+
+        /* Deadlines may have been armed for values held back while benchmarking */
+        mcs_timer_arm();
+
+        *single_cycles = cycles_single / MCS_BENCHMARK_ROUNDS;
+        *txn_cycles    = cycles_txn / MCS_BENCHMARK_ROUNDS;
+}
+#endif /* MCS_BENCHMARK_EN */
@@ -40,6 +40,7 @@
  * Tags definition for 'ble_app' area.
  */
 #define TAG_BLE_APP_NAME                        0x01 // up to 29 bytes value
+#define TAG_BLE_APP_GLS_SN_CHECKPOINT           0x02 // 2 bytes value
 
 /**
  * 'ble_app' area definition
@@ -53,6 +54,7 @@
 
 NVPARAM_AREA(ble_app, NVMS_PARAM_PART, 0x0100)
         NVPARAM_VARPARAM(TAG_BLE_APP_NAME,                      0x0000, 33) // uint8[29]
+        NVPARAM_PARAM(TAG_BLE_APP_GLS_SN_CHECKPOINT,            0x0021, 4)  // uint16
 NVPARAM_AREA_END()
 
 #endif /* APP_NVPARAM_H_ */
@@ -45,6 +45,17 @@
 #define GLS_ATT_PROCEDURE_ALREADY_IN_PROGRESS   0x80
 #define GLS_ATT_CCC_IMPROPERLY_CONFIGURED       0x81
 
+/* Subscription state flags cached per connection */
+#define GLS_CONN_GM_NOTIFICATIONS       (1 << 0)
+#define GLS_CONN_GMC_NOTIFICATIONS      (1 << 1)
+#define GLS_CONN_BONDED                 (1 << 2)
+
+#if GLS_FLAGS_CONTEXT_INFORMATION
+#define GLS_CONN_RECORD_NOTIFICATIONS   (GLS_CONN_GM_NOTIFICATIONS | GLS_CONN_GMC_NOTIFICATIONS | GLS_CONN_BONDED)
+#else
+#define GLS_CONN_RECORD_NOTIFICATIONS   (GLS_CONN_GM_NOTIFICATIONS | GLS_CONN_BONDED)
+#endif
+
 typedef struct {
         uint8_t command;       /* Current command being processed */
         bool racp_in_progress; /* Flag to indicate whether or not a record is currently being processed
@@ -55,6 +66,15 @@ typedef struct {
                                   RACP indications as response to the previously received RACP command. */
 } g_service_data_t;
 
+/*
+ * Subscription state of a connected peer device. It mirrors the CCC values kept in BLE storage so that
+ * notifying records does not require storage and GAP lookups for each record.
+ */
+typedef struct {
+        uint16_t conn_idx;      /* BLE_CONN_IDX_INVALID if entry is not in use */
+        uint8_t flags;          /* Bitmask of GLS_CONN_xxx flags */
+} g_service_conn_t;
+
 typedef struct {
         ble_service_t svc;
 
@@ -76,38 +96,77 @@ typedef struct {
 #endif
         uint16_t racp_val_h;    /* Record access control point value handle */
         uint16_t racp_ccc_h;    /* Record access control point CCC descriptor handle */
+
+        g_service_conn_t conn[BLE_GAP_MAX_CONNECTED];
 } g_service_t;
 
+static g_service_conn_t *get_conn(g_service_t *gls, uint16_t conn_idx)
+{
+        for (int i = 0; i < BLE_GAP_MAX_CONNECTED; i++) {
+                if (gls->conn[i].conn_idx == conn_idx) {
+                        return &gls->conn[i];
+                }
+        }
+
+        return NULL;
+}
+
+static void update_conn_bonded(g_service_conn_t *conn)
+{
+        gap_device_t dev;
+
+        if (ble_gap_get_device_by_conn_idx(conn->conn_idx, &dev) == BLE_STATUS_OK && dev.bonded) {
+                conn->flags |= GLS_CONN_BONDED;
+        } else {
+                conn->flags &= ~GLS_CONN_BONDED;
+        }
+}
+
+static void update_conn_ccc(g_service_conn_t *conn, uint8_t flag, uint16_t ccc)
+{
+        if (ccc & GATT_CCC_NOTIFICATIONS) {
+                conn->flags |= flag;
+        } else {
+                conn->flags &= ~flag;
+        }
+}
+
+bool gls_is_record_notification_enabled(ble_service_t *svc, uint16_t conn_idx)
+{
+        ASSERT_WARNING(svc);
+
+        g_service_t *gls = (g_service_t *)svc;
+        g_service_conn_t *conn = get_conn(gls, conn_idx);
+
+        if (!conn) {
+                return false;
+        }
+
+        /* Bonding might have been completed after the last write request of the peer device */
+        if (!(conn->flags & GLS_CONN_BONDED)) {
+                update_conn_bonded(conn);
+        }
+
+        return ((conn->flags & GLS_CONN_RECORD_NOTIFICATIONS) == GLS_CONN_RECORD_NOTIFICATIONS);
+}
+
 bool gls_notify_record(ble_service_t *svc, uint16_t conn_idx, gls_record_t *record)
 {
         ASSERT_WARNING(svc);
 
         g_service_t *gls = (g_service_t *)svc;
-        uint16_t ccc;
-        gap_device_t dev;
         ble_error_t status;
 
         /*
          * Since this API can also be called to send notifications when new records are
          * available since the last connection with a bonded device, we should first
-         * check if notifications are enabled for the specified peer device.
-         * Note that if this API is called as response to RACP requests, CCC and bond status
-         * checks should have already been done.
+         * check if notifications are enabled for the specified peer device. The check
+         * is performed against the subscription state cached per connection so it is
+         * cheap enough to be repeated for each record of a bulk report.
          */
-        ble_storage_get_u16(conn_idx, gls->gm_ccc_h, &ccc);
-        ble_gap_get_device_by_conn_idx(conn_idx, &dev);
-
-        if (!(ccc & GATT_CCC_NOTIFICATIONS) || !dev.bonded) {
-                return false;
-        }
-
-#if GLS_FLAGS_CONTEXT_INFORMATION
-        ble_storage_get_u16(conn_idx, gls->gmc_ccc_h, &ccc);
-
-        if (!(ccc & GATT_CCC_NOTIFICATIONS)) {
+        if (!gls_is_record_notification_enabled(svc, conn_idx)) {
                 return false;
         }
-#endif
 
         /* Record data should already be packed! */
         status = ble_gatts_send_event(conn_idx, gls->gm_val_h, GATT_EVENT_NOTIFICATION,
@@ -121,9 +180,38 @@ bool gls_notify_record(ble_service_t *svc, uint16_t conn_idx, gls_record_t *reco
                                                 sizeof(record->context), &record->context);
 #endif
 
+        /* Disconnection event might not have been processed yet; stop reporting to that peer */
+        if (status == BLE_ERROR_NOT_CONNECTED) {
+                g_service_conn_t *conn = get_conn(gls, conn_idx);
+
+                if (conn) {
+                        conn->conn_idx = BLE_CONN_IDX_INVALID;
+                }
+        }
+
         return (status == BLE_STATUS_OK);
 }
 
+bool gls_get_record_sync_cursor(ble_service_t *svc, uint16_t conn_idx, uint16_t *seq_number)
+{
+        ASSERT_WARNING(svc && seq_number);
+
+        g_service_t *gls = (g_service_t *)svc;
+
+        /* The measurement value handle is not used as storage key otherwise */
+        return (ble_storage_get_u16(conn_idx, gls->gm_val_h, seq_number) == BLE_STATUS_OK);
+}
+
+void gls_set_record_sync_cursor(ble_service_t *svc, uint16_t conn_idx, uint16_t seq_number)
+{
+        ASSERT_WARNING(svc);
+
+        g_service_t *gls = (g_service_t *)svc;
+
+        /* Value should be persistent for bonded devices */
+        ble_storage_put_u32(conn_idx, gls->gm_val_h, seq_number, true);
+}
+
 void gls_notify_record_all(ble_service_t *svc, gls_record_t *record)
 {
         uint8_t num_conn;
@@ -307,82 +395,16 @@ static void handle_read_req(ble_service_t *svc, const ble_evt_gatts_read_req_t *
         }
 }
 
-static att_error_t racp_parse_command(g_service_t *gls, const ble_evt_gatts_write_req_t *evt, uint8_t command, const uint8_t *ptr)
+static void racp_dispatch_command(g_service_t *gls, uint16_t conn_idx, gls_racp_request_t *request)
 {
-        gls_racp_t record;
-
-        if (evt->length < 2) {
-                return ATT_ERROR_INVALID_VALUE_LENGTH;
-        }
-
-        /* Next byte should reflect the operator */
-        record.operator = get_u8_inc(&ptr);
-
-        if (command == GLS_RACP_COMMAND_ABORT_OPERATION) {
-                /* Operator should be NULL */
-                if (record.operator != GLS_RACP_OPERATOR_NULL) {
-                        gls_indicate_status(&gls->svc, evt->conn_idx, command, GLS_RACP_RESPONSE_INVALID_OPERATOR);
-                } else {
-                        gls->cb->racp_callbacks.abort_operation(&gls->svc, evt->conn_idx);
-                }
-                return ATT_ERROR_OK;
+        if (request->response != GLS_RACP_RESPONSE_RFU) {
+                gls_indicate_status(&gls->svc, conn_idx, request->command, request->response);
+                return;
         }
 
-        switch (record.operator) {
-        case GLS_RACP_OPERATOR_ALL_RECORDS:
-#if GLS_RACP_OPERATOR_FIRST_RECORD_SUPPORT
-        case GLS_RACP_OPERATOR_FIRST_RECORD:
-#endif
-#if GLS_RACP_OPERATOR_LAST_RECORD_SUPPORT
-        case GLS_RACP_OPERATOR_LAST_RECORD:
-#endif
-                /* Registered callback can be invoked immediately as no operand is expected next */
-                record.filter_type = GLS_RACP_FILTER_TYPE_RFU;
-                record.filter_param = NULL;
-                record.filter_param_len = 0;
-                break;
-#if GLS_RACP_OPERATOR_LESS_EQUAL_SUPPORT
-        case GLS_RACP_OPERATOR_LESS_EQUAL:
-#endif
-        case GLS_RACP_OPERATOR_GREATER_EQUAL:
-#if GLS_RACP_OPERATOR_WITHIN_RANGE_SUPPORT
-        case GLS_RACP_OPERATOR_WITHIN_RANGE:
-#endif
-                /* At least one more byte is expected and that should reflect the filter type
-                 * upon which records will be filtered. */
-                if (evt->length < 3) {
-                        return ATT_ERROR_INVALID_VALUE_LENGTH;
-                }
-
-                record.filter_type = get_u8_inc(&ptr);
-
-                switch (record.filter_type) {
-                case GLS_RACP_FILTER_TYPE_SN:
-#if GLS_RACP_FILTER_USER_FACING_TIME_SUPPORT
-                case GLS_RACP_FILTER_TYPE_UFT:
-#endif
-                        /* Based on the filter type and operator compute the number of the next expected
-                         * bytes that should reflect the actual operand value */
-                        record.filter_param_len = (record.filter_type == GLS_RACP_FILTER_TYPE_SN) ?
-                                                                        2 : sizeof(gls_base_user_facing_time_t);
-                        record.filter_param_len *= (record.operator == GLS_RACP_OPERATOR_WITHIN_RANGE) ? 2 : 1;
-
-                        /* Make sure operand has the expected size */
-                        if (evt->length < (3 + record.filter_param_len) ||
-                                evt->length > (3 + record.filter_param_len)) {
-                                return ATT_ERROR_INVALID_VALUE_LENGTH;
-                        }
-
-                        record.filter_param = ptr;
-                        break;
-                default:
-                        gls_indicate_status(&gls->svc, evt->conn_idx, command, GLS_RACP_RESPONSE_UNSUPPORTED_OPERAND);
-                        return ATT_ERROR_OK;
-                }
-                break;
-        default:
-                gls_indicate_status(&gls->svc, evt->conn_idx, command, GLS_RACP_RESPONSE_UNSUPPORTED_OPERATOR);
-                return ATT_ERROR_OK;
+        if (request->command == GLS_RACP_COMMAND_ABORT_OPERATION) {
+                gls->cb->racp_callbacks.abort_operation(&gls->svc, conn_idx);
+                return;
         }
 
         /*
@@ -393,16 +415,16 @@ static att_error_t racp_parse_command(g_service_t *gls, const ble_evt_gatts_writ
          */
         gls->data.racp_in_progress = true;
 
-        switch (command) {
+        switch (request->command) {
         case GLS_RACP_COMMAND_NUMBER_OF_RECORDS:
-                gls->cb->racp_callbacks.report_num_of_records(&gls->svc, evt->conn_idx, &record);
+                gls->cb->racp_callbacks.report_num_of_records(&gls->svc, conn_idx, &request->record);
                 break;
         case GLS_RACP_COMMAND_REPORT_RECORDS:
-                gls->cb->racp_callbacks.report_records(&gls->svc, evt->conn_idx, &record);
+                gls->cb->racp_callbacks.report_records(&gls->svc, conn_idx, &request->record);
                 break;
 #if GLS_RACP_COMMAND_DELETE_STORED_RECORDS_SUPPORT
         case GLS_RACP_COMMAND_DELETE_RECORDS:
-                gls->cb->racp_callbacks.delete_records(&gls->svc, evt->conn_idx, &record);
+                gls->cb->racp_callbacks.delete_records(&gls->svc, conn_idx, &request->record);
                 break;
 #endif
         default:
@@ -410,33 +432,27 @@ static att_error_t racp_parse_command(g_service_t *gls, const ble_evt_gatts_writ
                 ASSERT_WARNING(0);
                 break;
         }
-
-        return ATT_ERROR_OK;
 }
 
 static att_error_t do_racp_write(g_service_t *gls, const ble_evt_gatts_write_req_t *evt)
 {
+        g_service_conn_t *conn;
+        gls_racp_request_t request;
+        att_error_t status;
         uint16_t ccc;
-        const uint8_t *ptr = (uint8_t *)evt->value;
-        uint8_t command;
 
-        /*
-         * The data received should be of variable size and so parsing should become gradually.
-         * The first byte should represent the requested command.
-         */
+        /* Format checks are performed by the parser; those related to the service state follow */
+        status = gls_racp_parse(evt->value, evt->length, &request);
+        gls->data.command = request.command;
+
         if (evt->length < 1) {
                 /* As per GLS specifications, if requested command cannot be serviced
                  * RACP should be indicated sending response. However, the command
                  * here cannot be parsed and so a zero value is sent part of the requested
                  * opcode. */
-                gls->data.command = GLS_RACP_COMMAND_RFU;
-                return ATT_ERROR_INVALID_VALUE_LENGTH;
+                return status;
         }
 
-        /* The first byte should reflect the requested command (opcode) */
-        command = get_u8_inc(&ptr);
-        gls->data.command = command;
-
         if (evt->offset) {
                 return ATT_ERROR_ATTRIBUTE_NOT_LONG;
         }
@@ -448,12 +464,12 @@ static att_error_t do_racp_write(g_service_t *gls, const ble_evt_gatts_write_req
                 return GLS_ATT_CCC_IMPROPERLY_CONFIGURED;
         }
 
-        switch (command) {
+        switch (request.command) {
         case GLS_RACP_COMMAND_ABORT_OPERATION:
                 /* Though not clearly stated in GLS specifications there is no
                  * reason to continue processing if no RACP procedure is in progress. */
                 if (!gls->data.racp_in_progress) {
-                        gls_indicate_status(&gls->svc, evt->conn_idx, command, GLS_RACP_RESPONSE_SUCCESS);
+                        gls_indicate_status(&gls->svc, evt->conn_idx, request.command, GLS_RACP_RESPONSE_SUCCESS);
                         return ATT_ERROR_OK;
                 }
                 break;
@@ -464,19 +480,15 @@ static att_error_t do_racp_write(g_service_t *gls, const ble_evt_gatts_write_req
 #endif
                 /* Notifications for glucose measurements and glucose measurements contexts optionally
                  * should be enabled. */
-                ble_storage_get_u16(evt->conn_idx, gls->gm_ccc_h, &ccc);
+                conn = get_conn(gls, evt->conn_idx);
 
-                if (!(ccc & GATT_CCC_NOTIFICATIONS)) {
+                if (!conn || (conn->flags & (GLS_CONN_RECORD_NOTIFICATIONS & ~GLS_CONN_BONDED)) !=
+                                                (GLS_CONN_RECORD_NOTIFICATIONS & ~GLS_CONN_BONDED)) {
                         return GLS_ATT_CCC_IMPROPERLY_CONFIGURED;
                 }
 
-#if GLS_FLAGS_CONTEXT_INFORMATION
-                ble_storage_get_u16(evt->conn_idx, gls->gmc_ccc_h, &ccc);
-
-                if (!(ccc & GATT_CCC_NOTIFICATIONS)) {
-                        return GLS_ATT_CCC_IMPROPERLY_CONFIGURED;
-                }
-#endif
+                /* RACP requires authentication so bonding status might have changed since connection */
+                update_conn_bonded(conn);
 
                 /* Mandated by GLS specifications */
                 if (gls->data.racp_in_progress) {
@@ -488,11 +500,18 @@ static att_error_t do_racp_write(g_service_t *gls, const ble_evt_gatts_write_req
                 return ATT_ERROR_OK;
         }
 
-        return racp_parse_command(gls, evt, command, ptr);
+        if (status != ATT_ERROR_OK) {
+                return status;
+        }
+
+        racp_dispatch_command(gls, evt->conn_idx, &request);
+
+        return ATT_ERROR_OK;
 }
 
 static att_error_t do_generic_ccc_write(g_service_t *gls, const ble_evt_gatts_write_req_t *evt)
 {
+        g_service_conn_t *conn;
         uint16_t ccc;
 
         if (evt->offset) {
@@ -508,6 +527,19 @@ static att_error_t do_generic_ccc_write(g_service_t *gls, const ble_evt_gatts_wr
         /* Value should be persistent for bonded devices */
         ble_storage_put_u32(evt->conn_idx, evt->handle, ccc, true);
 
+        conn = get_conn(gls, evt->conn_idx);
+        if (conn) {
+                if (evt->handle == gls->gm_ccc_h) {
+                        update_conn_ccc(conn, GLS_CONN_GM_NOTIFICATIONS, ccc);
+                }
+#if GLS_FLAGS_CONTEXT_INFORMATION
+                else if (evt->handle == gls->gmc_ccc_h) {
+                        update_conn_ccc(conn, GLS_CONN_GMC_NOTIFICATIONS, ccc);
+                }
+#endif
+                update_conn_bonded(conn);
+        }
+
         if (ccc == GATT_CCC_NOTIFICATIONS &&
                         gls->cb->ccc_enabled) {
                 gls->cb->ccc_enabled(&gls->svc, evt);
@@ -567,11 +599,47 @@ static void handle_event_sent(ble_service_t *svc, const ble_evt_gatts_event_sent
         }
 }
 
+static void handle_connected_evt(ble_service_t *svc, const ble_evt_gap_connected_t *evt)
+{
+        g_service_t *gls = (g_service_t *)svc;
+        g_service_conn_t *conn = get_conn(gls, BLE_CONN_IDX_INVALID);
+        uint16_t ccc;
+
+        if (!conn) {
+                return;
+        }
+
+        conn->conn_idx = evt->conn_idx;
+        conn->flags = 0;
+
+        /* CCC values of bonded peer devices are restored from BLE storage */
+        ccc = 0;
+        ble_storage_get_u16(evt->conn_idx, gls->gm_ccc_h, &ccc);
+        update_conn_ccc(conn, GLS_CONN_GM_NOTIFICATIONS, ccc);
+#if GLS_FLAGS_CONTEXT_INFORMATION
+        ccc = 0;
+        ble_storage_get_u16(evt->conn_idx, gls->gmc_ccc_h, &ccc);
+        update_conn_ccc(conn, GLS_CONN_GMC_NOTIFICATIONS, ccc);
+#endif
+        update_conn_bonded(conn);
+}
+
+static void handle_disconnected_evt(ble_service_t *svc, const ble_evt_gap_disconnected_t *evt)
+{
+        g_service_t *gls = (g_service_t *)svc;
+        g_service_conn_t *conn = get_conn(gls, evt->conn_idx);
+
+        if (conn) {
+                conn->conn_idx = BLE_CONN_IDX_INVALID;
+        }
+}
+
 static void handle_cleanup(ble_service_t *svc)
 {
         g_service_t *gls = (g_service_t *)svc;
 
         ble_storage_remove_all(gls->gm_ccc_h);
+        ble_storage_remove_all(gls->gm_val_h);
 #if GLS_FLAGS_CONTEXT_INFORMATION
         ble_storage_remove_all(gls->gmc_ccc_h);
 #endif
@@ -620,6 +688,12 @@ ble_service_t *gls_init(const gls_callbacks_t *cb)
         OS_ASSERT(gls);
         memset(gls, 0, sizeof(*gls));
 
+        for (int i = 0; i < BLE_GAP_MAX_CONNECTED; i++) {
+                gls->conn[i].conn_idx = BLE_CONN_IDX_INVALID;
+        }
+
+        gls->svc.connected_evt = handle_connected_evt;
+        gls->svc.disconnected_evt = handle_disconnected_evt;
         gls->svc.read_req = handle_read_req;
         gls->svc.write_req = handle_write_req;
         gls->svc.cleanup = handle_cleanup;
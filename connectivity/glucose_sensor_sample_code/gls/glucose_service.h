@@ -54,6 +54,15 @@ typedef struct __packed {
         size_t filter_param_len;
 } gls_racp_t;
 
+/* Outcome of parsing a RACP write request, see \sa gls_racp_parse */
+typedef struct {
+        uint8_t command;        /* Requested command (op code) */
+        uint8_t response;       /* GLS_RACP_RESPONSE_RFU if the request is valid, otherwise the response that
+                                   should be indicated to the collector */
+        gls_racp_t record;      /* Operator and operand of the request; valid only if response is
+                                   GLS_RACP_RESPONSE_RFU */
+} gls_racp_request_t;
+
 typedef uint16_t sfloat;
 
 /*
@@ -603,4 +612,55 @@ bool gls_notify_record(ble_service_t *svc, uint16_t conn_idx, gls_record_t *reco
  */
 void gls_notify_record_all(ble_service_t *svc, gls_record_t *record);
 
+/*
+ * Function to check whether records can be notified to the selected peer device. Records can be
+ * notified only if the peer device is bonded and notifications have been enabled via the CCC
+ * descriptors of the Glucose Measurement and, if supported, Glucose Measurement Context characteristics.
+ *
+ * \param [in] svc          pointer to the instantiated Glucose server
+ * \param [in] conn_idx     connection index that reflects the peer device
+ *
+ * \return True if records can be notified to the peer device, false otherwise.
+ */
+bool gls_is_record_notification_enabled(ble_service_t *svc, uint16_t conn_idx);
+
+/*
+ * Function to get the sync cursor of a peer device, that is the SN of the most recent record
+ * that has been reported to that peer device. The value is stored along with the rest of the bonding
+ * data and so it survives disconnections (and device reboots if bonding data are stored persistently).
+ *
+ * \param [in]  svc          pointer to the instantiated Glucose server
+ * \param [in]  conn_idx     connection index that reflects the peer device
+ * \param [out] seq_number   SN of the most recent record reported to the peer device
+ *
+ * \return True if a cursor has been stored for the peer device, false otherwise.
+ */
+bool gls_get_record_sync_cursor(ble_service_t *svc, uint16_t conn_idx, uint16_t *seq_number);
+
+/*
+ * Function to update the sync cursor of a peer device. See description of \sa gls_get_record_sync_cursor.
+ *
+ * \param [in] svc          pointer to the instantiated Glucose server
+ * \param [in] conn_idx     connection index that reflects the peer device
+ * \param [in] seq_number   SN of the most recent record reported to the peer device
+ */
+void gls_set_record_sync_cursor(ble_service_t *svc, uint16_t conn_idx, uint16_t seq_number);
+
+/*
+ * Function to parse the value written to the RACP characteristic. Only the format of the value and
+ * the supported commands, operators and filter types are checked; the state of the service and of the
+ * peer device (CCC descriptors, RACP procedure in progress) is not taken into account. The function
+ * does not depend on any service instance or BLE stack resources and so it can also be used to feed
+ * the database framework with RACP requests outside of a BLE connection.
+ *
+ * \param [in]  value        value written to the RACP characteristic
+ * \param [in]  length       length of the value
+ * \param [out] request      parsed request; the operand of the request points in \p value
+ *
+ * \return ATT_ERROR_OK if the value could be parsed, in which case request->response should be checked
+ *         for the validity of the request, or the ATT error that should be returned to the collector
+ *         otherwise.
+ */
+att_error_t gls_racp_parse(const uint8_t *value, uint16_t length, gls_racp_request_t *request);
+
 #endif /* GLUCOSE_SERVICE_H_ */
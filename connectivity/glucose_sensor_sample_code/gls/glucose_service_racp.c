@@ -0,0 +1,145 @@
+/**
+ ****************************************************************************************
+ *
+ * @file glucose_service_racp.c
+ *
+ * @brief Glucose Service Record Access Control Point (RACP) parser
+ *
+ * Copyright (C) 2015-2023 Renesas Electronics Corporation and/or its affiliates.
+ * All rights reserved. Confidential Information.
+ *
+ * This software ("Software") is supplied by Renesas Electronics Corporation and/or its
+ * affiliates ("Renesas"). Renesas grants you a personal, non-exclusive, non-transferable,
+ * revocable, non-sub-licensable right and license to use the Software, solely if used in
+ * or together with Renesas products. You may make copies of this Software, provided this
+ * copyright notice and disclaimer ("Notice") is included in all such copies. Renesas
+ * reserves the right to change or discontinue the Software at any time without notice.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS". RENESAS DISCLAIMS ALL WARRANTIES OF ANY KIND,
+ * WHETHER EXPRESS, IMPLIED, OR STATUTORY, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT. TO THE
+ * MAXIMUM EXTENT PERMITTED UNDER LAW, IN NO EVENT SHALL RENESAS BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, SPECIAL, INCIDENTAL OR CONSEQUENTIAL DAMAGES ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE, EVEN IF RENESAS HAS BEEN ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGES. USE OF THIS SOFTWARE MAY BE SUBJECT TO TERMS AND CONDITIONS CONTAINED IN
+ * AN ADDITIONAL AGREEMENT BETWEEN YOU AND RENESAS. IN CASE OF CONFLICT BETWEEN THE TERMS
+ * OF THIS NOTICE AND ANY SUCH ADDITIONAL LICENSE AGREEMENT, THE TERMS OF THE AGREEMENT
+ * SHALL TAKE PRECEDENCE. BY CONTINUING TO USE THIS SOFTWARE, YOU AGREE TO THE TERMS OF
+ * THIS NOTICE.IF YOU DO NOT AGREE TO THESE TERMS, YOU ARE NOT PERMITTED TO USE THIS
+ * SOFTWARE.
+ *
+ ****************************************************************************************
+ */
+
+#include <stdbool.h>
+#include "ble_att.h"
+#include "ble_bufops.h"
+#include "glucose_service.h"
+
+att_error_t gls_racp_parse(const uint8_t *value, uint16_t length, gls_racp_request_t *request)
+{
+        const uint8_t *ptr = value;
+        gls_racp_t *record = &request->record;
+
+        request->response = GLS_RACP_RESPONSE_RFU;
+
+        /*
+         * The data received should be of variable size and so parsing should become gradually.
+         * The first byte should represent the requested command.
+         */
+        if (length < 1) {
+                /* The command cannot be parsed and so a zero value should be sent part of
+                 * the requested opcode. */
+                request->command = GLS_RACP_COMMAND_RFU;
+                return ATT_ERROR_INVALID_VALUE_LENGTH;
+        }
+
+        /* The first byte should reflect the requested command (opcode) */
+        request->command = get_u8_inc(&ptr);
+
+        switch (request->command) {
+        case GLS_RACP_COMMAND_ABORT_OPERATION:
+        case GLS_RACP_COMMAND_NUMBER_OF_RECORDS:
+        case GLS_RACP_COMMAND_REPORT_RECORDS:
+#if GLS_RACP_COMMAND_DELETE_STORED_RECORDS_SUPPORT
+        case GLS_RACP_COMMAND_DELETE_RECORDS:
+#endif
+                break;
+        default:
+                request->response = GLS_RACP_RESPONSE_UNSUPPORTED_COMMAND;
+                return ATT_ERROR_OK;
+        }
+
+        if (length < 2) {
+                return ATT_ERROR_INVALID_VALUE_LENGTH;
+        }
+
+        /* Next byte should reflect the operator */
+        record->operator = get_u8_inc(&ptr);
+        record->filter_type = GLS_RACP_FILTER_TYPE_RFU;
+        record->filter_param = NULL;
+        record->filter_param_len = 0;
+
+        if (request->command == GLS_RACP_COMMAND_ABORT_OPERATION) {
+                /* Operator should be NULL */
+                if (record->operator != GLS_RACP_OPERATOR_NULL) {
+                        request->response = GLS_RACP_RESPONSE_INVALID_OPERATOR;
+                }
+                return ATT_ERROR_OK;
+        }
+
+        switch (record->operator) {
+        case GLS_RACP_OPERATOR_ALL_RECORDS:
+#if GLS_RACP_OPERATOR_FIRST_RECORD_SUPPORT
+        case GLS_RACP_OPERATOR_FIRST_RECORD:
+#endif
+#if GLS_RACP_OPERATOR_LAST_RECORD_SUPPORT
+        case GLS_RACP_OPERATOR_LAST_RECORD:
+#endif
+                /* No operand is expected next */
+                break;
+#if GLS_RACP_OPERATOR_LESS_EQUAL_SUPPORT
+        case GLS_RACP_OPERATOR_LESS_EQUAL:
+#endif
+        case GLS_RACP_OPERATOR_GREATER_EQUAL:
+#if GLS_RACP_OPERATOR_WITHIN_RANGE_SUPPORT
+        case GLS_RACP_OPERATOR_WITHIN_RANGE:
+#endif
+                /* At least one more byte is expected and that should reflect the filter type
+                 * upon which records will be filtered. */
+                if (length < 3) {
+                        return ATT_ERROR_INVALID_VALUE_LENGTH;
+                }
+
+                record->filter_type = get_u8_inc(&ptr);
+
+                switch (record->filter_type) {
+                case GLS_RACP_FILTER_TYPE_SN:
+#if GLS_RACP_FILTER_USER_FACING_TIME_SUPPORT
+                case GLS_RACP_FILTER_TYPE_UFT:
+#endif
+                        /* Based on the filter type and operator compute the number of the next expected
+                         * bytes that should reflect the actual operand value */
+                        record->filter_param_len = (record->filter_type == GLS_RACP_FILTER_TYPE_SN) ?
+                                                                        2 : sizeof(gls_base_user_facing_time_t);
+                        record->filter_param_len *= (record->operator == GLS_RACP_OPERATOR_WITHIN_RANGE) ? 2 : 1;
+
+                        /* Make sure operand has the expected size */
+                        if (length != (3 + record->filter_param_len)) {
+                                return ATT_ERROR_INVALID_VALUE_LENGTH;
+                        }
+
+                        record->filter_param = ptr;
+                        break;
+                default:
+                        request->response = GLS_RACP_RESPONSE_UNSUPPORTED_OPERAND;
+                        break;
+                }
+                break;
+        default:
+                request->response = GLS_RACP_RESPONSE_UNSUPPORTED_OPERATOR;
+                break;
+        }
+
+        return ATT_ERROR_OK;
+}
@@ -0,0 +1,295 @@
+/**
+ ****************************************************************************************
+ *
+ * @file gls_host.c
+ *
+ * @brief Host harness of the glucose database and RACP parser
+ *
+ * Copyright (C) 2024 Renesas Electronics Corporation and/or its affiliates.
+ * All rights reserved. Confidential Information.
+ *
+ * This software ("Software") is supplied by Renesas Electronics Corporation and/or its
+ * affiliates ("Renesas"). Renesas grants you a personal, non-exclusive, non-transferable,
+ * revocable, non-sub-licensable right and license to use the Software, solely if used in
+ * or together with Renesas products. You may make copies of this Software, provided this
+ * copyright notice and disclaimer ("Notice") is included in all such copies. Renesas
+ * reserves the right to change or discontinue the Software at any time without notice.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS". RENESAS DISCLAIMS ALL WARRANTIES OF ANY KIND,
+ * WHETHER EXPRESS, IMPLIED, OR STATUTORY, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT. TO THE
+ * MAXIMUM EXTENT PERMITTED UNDER LAW, IN NO EVENT SHALL RENESAS BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, SPECIAL, INCIDENTAL OR CONSEQUENTIAL DAMAGES ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE, EVEN IF RENESAS HAS BEEN ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGES. USE OF THIS SOFTWARE MAY BE SUBJECT TO TERMS AND CONDITIONS CONTAINED IN
+ * AN ADDITIONAL AGREEMENT BETWEEN YOU AND RENESAS. IN CASE OF CONFLICT BETWEEN THE TERMS
+ * OF THIS NOTICE AND ANY SUCH ADDITIONAL LICENSE AGREEMENT, THE TERMS OF THE AGREEMENT
+ * SHALL TAKE PRECEDENCE. BY CONTINUING TO USE THIS SOFTWARE, YOU AGREE TO THE TERMS OF
+ * THIS NOTICE.IF YOU DO NOT AGREE TO THESE TERMS, YOU ARE NOT PERMITTED TO USE THIS
+ * SOFTWARE.
+ *
+ ****************************************************************************************
+ */
+
+/*
+ * The database, the RACP parser and the load generator are built against the stub OS, list,
+ * NVPARAM and GATT server layers of this directory.
+ *
+ * check: runs of the load generator, starting from an optional SN checkpoint, so that the SNs of
+ *        the inserted records and the number of records matched by each RACP request are checked
+ *        against the reference model of the load generator, up to and past the max. SN value.
+ *        The exit status is non-zero on any mismatch or failed assertion.
+ * bench: CPU cycles (host cycle counter) per gls_notify_record call for a bonded, subscribed
+ *        collector, against a replica of the subscription check performed before the state was
+ *        cached per connection (BLE storage and GAP lookups per record), followed by RACP report
+ *        requests of all the stored records with and without a full TX queue, as profiled by the
+ *        database.
+ */
+
+#include "osal.h"
+#include "ble_gap.h"
+#include "ble_gatts.h"
+#include "ble_storage.h"
+#include "glucose_service.h"
+#include "glucose_sensor_database.h"
+#include "glucose_sensor_load_generator.h"
+#include "host_stubs.h"
+
+/* Default number of load generator runs in the check mode */
+#define HOST_CHECK_RUNS                 ( 200 )
+
+/* Number of gls_notify_record calls timed per variant in the bench mode */
+#define HOST_BENCH_ROUNDS               ( 10000 )
+
+/* Connection index of the collector of the bench mode */
+#define HOST_CONN_IDX                   ( 0 )
+
+/* Max. number of CCC descriptors of the service */
+#define HOST_MAX_CCC                    ( 4 )
+
+static uint16_t last_sn;
+static uint32_t num_of_violations;
+
+static ble_service_t *gls;
+
+/* CCC descriptor handles in declaration order: measurement, measurement context, feature, RACP */
+static uint16_t ccc_h[HOST_MAX_CCC];
+static uint8_t num_of_ccc;
+
+/* Record initialization as done by the application task, with fixed measurement values */
+static void init_record_entry_cb(gls_record_t * const record)
+{
+        record->measurement.flags = GLS_FLAGS_FIELD_VALUE;
+        record->measurement.seq_number = app_db_get_sequence_number();
+
+        record->measurement.base_time.year = APP_DB_BASE_TIME_YEAR;
+        record->measurement.base_time.month = APP_DB_BASE_TIME_MONTH;
+        record->measurement.base_time.day = APP_DB_BASE_TIME_DAY;
+        record->measurement.base_time.hours = APP_DB_BASE_TIME_HOURS;
+        record->measurement.base_time.minutes = APP_DB_BASE_TIME_MINUTES;
+        record->measurement.base_time.seconds = APP_DB_BASE_TIME_SECONDS;
+        record->measurement.time_offset = record->measurement.seq_number;
+
+#if GLS_FLAGS_CONTEXT_INFORMATION
+        record->context.flags = GLS_CONTEXT_FLAGS_FIELD_VALUE;
+        record->context.seq_number = record->measurement.seq_number;
+#endif
+
+        last_sn = record->measurement.seq_number;
+}
+
+/* RACP requests are serviced by the bench itself */
+static void racp_request_cb(ble_service_t *svc, uint16_t conn_idx, gls_racp_t *record)
+{
+}
+
+static void abort_operation_cb(ble_service_t *svc, uint16_t conn_idx)
+{
+}
+
+static void get_features_cb(ble_service_t *svc, uint16_t conn_idx)
+{
+}
+
+static const gls_callbacks_t gls_callbacks = {
+#if GLS_FEATURE_INDICATION_PROPERTY
+        .get_features = get_features_cb,
+#endif
+        .racp_callbacks = {
+                .report_num_of_records = racp_request_cb,
+                .report_records = racp_request_cb,
+                .abort_operation = abort_operation_cb,
+#if GLS_RACP_COMMAND_DELETE_STORED_RECORDS_SUPPORT
+                .delete_records = racp_request_cb,
+#endif
+        },
+};
+
+/* Connect a bonded collector that enables all the CCC descriptors of the service */
+static void connect_collector(void)
+{
+        ble_evt_gap_connected_t evt = {
+                .conn_idx = HOST_CONN_IDX,
+        };
+        uint8_t buf[sizeof(ble_evt_gatts_write_req_t) + sizeof(uint16_t)];
+        ble_evt_gatts_write_req_t *req = (ble_evt_gatts_write_req_t *)buf;
+
+        host_gap_connect(HOST_CONN_IDX, true);
+        gls->connected_evt(gls, &evt);
+
+        num_of_ccc = host_gatts_get_ccc_handles(ccc_h, HOST_MAX_CCC);
+
+        for (uint8_t i = 0; i < num_of_ccc; i++) {
+                memset(buf, 0, sizeof(buf));
+                req->conn_idx = HOST_CONN_IDX;
+                req->handle = ccc_h[i];
+                req->length = sizeof(uint16_t);
+                req->value[0] = (i == num_of_ccc - 1) ? GATT_CCC_INDICATIONS : GATT_CCC_NOTIFICATIONS;
+                gls->write_req(gls, req);
+        }
+}
+
+/*
+ * Replica of gls_notify_record as it was before the subscription state was cached per connection:
+ * the CCC values are read from BLE storage and the bond status from GAP for each record. Value
+ * handles precede the CCC descriptors.
+ */
+static bool notify_record_uncached(uint16_t conn_idx, gls_record_t *record)
+{
+        uint16_t ccc = 0;
+        gap_device_t dev;
+        ble_error_t status;
+
+        ble_storage_get_u16(conn_idx, ccc_h[0], &ccc);
+
+        if (!(ccc & GATT_CCC_NOTIFICATIONS)) {
+                return false;
+        }
+
+        if (ble_gap_get_device_by_conn_idx(conn_idx, &dev) != BLE_STATUS_OK || !dev.bonded) {
+                return false;
+        }
+
+#if GLS_FLAGS_CONTEXT_INFORMATION
+        ccc = 0;
+        ble_storage_get_u16(conn_idx, ccc_h[1], &ccc);
+
+        if (!(ccc & GATT_CCC_NOTIFICATIONS)) {
+                return false;
+        }
+#endif
+
+        status = ble_gatts_send_event(conn_idx, ccc_h[0] - 1, GATT_EVENT_NOTIFICATION,
+                                                sizeof(record->measurement), &record->measurement);
+#if GLS_FLAGS_CONTEXT_INFORMATION
+        status |= ble_gatts_send_event(conn_idx, ccc_h[1] - 1, GATT_EVENT_NOTIFICATION,
+                                                sizeof(record->context), &record->context);
+#endif
+
+        return (status == BLE_STATUS_OK);
+}
+
+static void report_all_records(void)
+{
+        static const uint8_t value[] = { GLS_RACP_COMMAND_REPORT_RECORDS, GLS_RACP_OPERATOR_ALL_RECORDS };
+        gls_racp_request_t request;
+
+        if (gls_racp_parse(value, sizeof(value), &request) != ATT_ERROR_OK) {
+                num_of_violations++;
+                return;
+        }
+
+        app_db_update_racp_request(gls, HOST_CONN_IDX, request.command, &request.record);
+
+        /* The database prints the profiling results */
+        host_set_verbose(true);
+        app_db_report_records_handle();
+        host_set_verbose(false);
+}
+
+static void bench(void)
+{
+        gls_record_t record;
+        uint64_t cached = 0, uncached = 0;
+        uint32_t events;
+
+        gls = gls_init(&gls_callbacks);
+        connect_collector();
+
+        memset(&record, 0, sizeof(record));
+        init_record_entry_cb(&record);
+
+        for (uint32_t i = 0; i < HOST_BENCH_ROUNDS; i++) {
+                uint64_t start = host_cycles();
+
+                num_of_violations += !gls_notify_record(gls, HOST_CONN_IDX, &record);
+                cached += host_cycles() - start;
+
+                start = host_cycles();
+                num_of_violations += !notify_record_uncached(HOST_CONN_IDX, &record);
+                uncached += host_cycles() - start;
+        }
+
+        printf("gls_notify_record, cached subscription state: %lu cycles/call\n",
+                                                (unsigned long)(cached / HOST_BENCH_ROUNDS));
+        printf("gls_notify_record, storage and GAP lookups:   %lu cycles/call\n",
+                                                (unsigned long)(uncached / HOST_BENCH_ROUNDS));
+
+        for (uint32_t i = 0; i < APP_DB_MAX_LIST_LEN; i++) {
+                app_db_add_record_entry(init_record_entry_cb);
+        }
+
+        events = host_gatts_num_of_events();
+        printf("RACP report of all records:\n");
+        report_all_records();
+        if (host_gatts_num_of_events() - events < APP_DB_MAX_LIST_LEN) {
+                num_of_violations++;
+        }
+
+        /* Both events of a record are rejected, so half of the records are queued on a retry */
+        host_gatts_reject_events(APP_DB_MAX_LIST_LEN);
+        printf("RACP report of all records, TX queue full for the first %u events:\n", APP_DB_MAX_LIST_LEN);
+        report_all_records();
+
+        printf("%lu violations, %lu assertions failed\n", (unsigned long)num_of_violations,
+                                                        (unsigned long)host_assert_count());
+}
+
+static void check(uint32_t runs)
+{
+        for (uint32_t i = 0; i < runs; i++) {
+                app_db_load_generator_run(init_record_entry_cb);
+        }
+
+        printf("%lu runs, last SN %u, %lu mismatches, %lu assertions failed, peak heap %zu bytes\n",
+                        (unsigned long)runs, last_sn, (unsigned long)app_db_load_generator_get_mismatches(),
+                        (unsigned long)host_assert_count(), host_heap_peak());
+}
+
+int main(int argc, char *argv[])
+{
+        if ((argc > 1) && !strcmp(argv[1], "bench")) {
+                app_db_init();
+                bench();
+
+                return (num_of_violations || host_assert_count()) ? 1 : 0;
+        }
+
+        if ((argc < 2) || strcmp(argv[1], "check")) {
+                fprintf(stderr, "Usage: %s bench | check [runs] [first SN] [-v]\n", argv[0]);
+                return 2;
+        }
+
+        host_set_verbose((argc > 4) && !strcmp(argv[4], "-v"));
+
+        if (argc > 3) {
+                host_nvparam_set_sn_checkpoint((uint16_t)strtoul(argv[3], NULL, 0));
+        }
+
+        app_db_init();
+        app_db_load_generator_init();
+
+        check((argc > 2) ? strtoul(argv[2], NULL, 0) : HOST_CHECK_RUNS);
+
+        return (app_db_load_generator_get_mismatches() || host_assert_count()) ? 1 : 0;
+}
@@ -0,0 +1,564 @@
+/**
+ ****************************************************************************************
+ *
+ * @file host_stubs.c
+ *
+ * @brief Stub OS, list, NVPARAM, GAP and GATT server layers of the glucose database host build
+ *
+ * Copyright (C) 2024 Renesas Electronics Corporation and/or its affiliates.
+ * All rights reserved. Confidential Information.
+ *
+ * This software ("Software") is supplied by Renesas Electronics Corporation and/or its
+ * affiliates ("Renesas"). Renesas grants you a personal, non-exclusive, non-transferable,
+ * revocable, non-sub-licensable right and license to use the Software, solely if used in
+ * or together with Renesas products. You may make copies of this Software, provided this
+ * copyright notice and disclaimer ("Notice") is included in all such copies. Renesas
+ * reserves the right to change or discontinue the Software at any time without notice.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS". RENESAS DISCLAIMS ALL WARRANTIES OF ANY KIND,
+ * WHETHER EXPRESS, IMPLIED, OR STATUTORY, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT. TO THE
+ * MAXIMUM EXTENT PERMITTED UNDER LAW, IN NO EVENT SHALL RENESAS BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, SPECIAL, INCIDENTAL OR CONSEQUENTIAL DAMAGES ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE, EVEN IF RENESAS HAS BEEN ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGES. USE OF THIS SOFTWARE MAY BE SUBJECT TO TERMS AND CONDITIONS CONTAINED IN
+ * AN ADDITIONAL AGREEMENT BETWEEN YOU AND RENESAS. IN CASE OF CONFLICT BETWEEN THE TERMS
+ * OF THIS NOTICE AND ANY SUCH ADDITIONAL LICENSE AGREEMENT, THE TERMS OF THE AGREEMENT
+ * SHALL TAKE PRECEDENCE. BY CONTINUING TO USE THIS SOFTWARE, YOU AGREE TO THE TERMS OF
+ * THIS NOTICE.IF YOU DO NOT AGREE TO THESE TERMS, YOU ARE NOT PERMITTED TO USE THIS
+ * SOFTWARE.
+ *
+ ****************************************************************************************
+ */
+
+#include <stdarg.h>
+#include <time.h>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+#include "osal.h"
+#include "misc.h"
+#include "sdk_list.h"
+#include "ad_nvparam.h"
+#include "ble_gap.h"
+#include "ble_gatts.h"
+#include "ble_service.h"
+#include "ble_storage.h"
+#include "ble_uuid.h"
+#include "app_nvparam.h"
+#include "host_config.h"
+#include "host_stubs.h"
+
+/* Max. number of CCC values kept by the stub BLE storage */
+#define HOST_STORAGE_SIZE               ( 1024 )
+
+/* Heap available to the sample code, as configured for the target (configTOTAL_HEAP_SIZE) */
+#define HOST_HEAP_SIZE                  ( 37372 )
+
+/* Max. number of descriptors tracked per service */
+#define HOST_MAX_DESCRIPTORS            ( 8 )
+
+/* UUID of the Client Characteristic Configuration descriptor */
+#define HOST_UUID_CCC                   ( 0x2902 )
+
+typedef struct {
+        bool used;
+        uint16_t conn_idx;
+        ble_storage_key_t key;
+        uint32_t value;
+} host_storage_entry_t;
+
+/* Elements of the stub list start with the pointer to the next element, as in the SDK */
+typedef struct host_list_elem {
+        struct host_list_elem *next;
+} host_list_elem_t;
+
+static uint32_t now_ms;
+static size_t heap_in_use, heap_peak;
+static uint32_t asserts;
+static bool verbose;
+static int mutex_depth;
+
+static DWT_Type dwt;
+CoreDebug_Type host_core_debug;
+
+static uint16_t sn_checkpoint;
+static bool sn_checkpoint_valid;
+
+static gap_device_t devices[BLE_GAP_MAX_CONNECTED];
+
+static host_storage_entry_t storage[HOST_STORAGE_SIZE];
+
+/* Attribute handle offsets allocated while a service is declared; services start at handle 1 */
+static uint16_t handle_offset;
+static uint16_t next_start_h = 1;
+
+/* CCC descriptors of the service being declared; offsets are turned into handles on registration */
+static uint16_t *ccc_h[HOST_MAX_DESCRIPTORS];
+static uint8_t num_of_ccc;
+
+static uint32_t num_of_events;
+static uint32_t events_to_reject;
+
+/*********************************** Harness services ***************************************/
+
+uint64_t host_cycles(void)
+{
+#if defined(__x86_64__) || defined(__i386__)
+        return __rdtsc();
+#else
+        struct timespec ts;
+
+        clock_gettime(CLOCK_MONOTONIC, &ts);
+        return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+#endif
+}
+
+void host_assert_failed(const char *file, int line)
+{
+        asserts++;
+        fprintf(stderr, "Assertion failed: %s:%d\n", file, line);
+}
+
+uint32_t host_assert_count(void)
+{
+        return asserts;
+}
+
+void host_set_verbose(bool enable)
+{
+        verbose = enable;
+}
+
+void host_printf(const char *format, ...)
+{
+        va_list ap;
+
+        if (!verbose) {
+                return;
+        }
+
+        va_start(ap, format);
+        vprintf(format, ap);
+        va_end(ap);
+}
+
+size_t host_heap_in_use(void)
+{
+        return heap_in_use;
+}
+
+size_t host_heap_peak(void)
+{
+        return heap_peak;
+}
+
+uint32_t host_time_ms(void)
+{
+        return now_ms;
+}
+
+void host_nvparam_set_sn_checkpoint(uint16_t seq_number)
+{
+        sn_checkpoint = seq_number;
+        sn_checkpoint_valid = true;
+}
+
+void host_gap_connect(uint16_t conn_idx, bool bonded)
+{
+        ASSERT_WARNING(conn_idx < BLE_GAP_MAX_CONNECTED);
+
+        devices[conn_idx].conn_idx = conn_idx;
+        devices[conn_idx].connected = true;
+        devices[conn_idx].bonded = bonded;
+}
+
+void host_gap_disconnect(uint16_t conn_idx)
+{
+        ASSERT_WARNING(conn_idx < BLE_GAP_MAX_CONNECTED);
+
+        devices[conn_idx].connected = false;
+}
+
+uint8_t host_gatts_get_ccc_handles(uint16_t *handles, uint8_t max_handles)
+{
+        uint8_t i;
+
+        for (i = 0; i < num_of_ccc && i < max_handles; i++) {
+                handles[i] = *ccc_h[i];
+        }
+
+        return i;
+}
+
+uint32_t host_gatts_num_of_events(void)
+{
+        return num_of_events;
+}
+
+void host_gatts_reject_events(uint32_t num)
+{
+        events_to_reject = num;
+}
+
+/************************************* OS layer *********************************************/
+
+void *host_malloc(size_t size)
+{
+        size_t *block;
+
+        /* Heap block headers are not accounted for */
+        if (heap_in_use + size > HOST_HEAP_SIZE) {
+                return NULL;
+        }
+
+        block = malloc(sizeof(size_t) + size);
+        if (block == NULL) {
+                return NULL;
+        }
+
+        *block = size;
+        heap_in_use += size;
+        heap_peak = MAX(heap_peak, heap_in_use);
+        return block + 1;
+}
+
+void host_free(void *ptr)
+{
+        if (ptr) {
+                size_t *block = (size_t *)ptr - 1;
+
+                heap_in_use -= *block;
+                free(block);
+        }
+}
+
+size_t host_free_heap(void)
+{
+        return HOST_HEAP_SIZE - heap_in_use;
+}
+
+void host_mutex_get(OS_MUTEX *mutex)
+{
+        (*mutex)++;
+        mutex_depth++;
+}
+
+void host_mutex_put(OS_MUTEX *mutex)
+{
+        ASSERT_WARNING(*mutex > 0);
+
+        (*mutex)--;
+        mutex_depth--;
+}
+
+void host_delay_ms(uint32_t ms)
+{
+        /* Delays while holding the database mutex would block the BLE manager on the target */
+        ASSERT_WARNING(mutex_depth == 0);
+
+        now_ms += ms;
+}
+
+DWT_Type *host_dwt(void)
+{
+        dwt.CYCCNT = (uint32_t)host_cycles();
+        return &dwt;
+}
+
+/************************************* List *************************************************/
+
+void list_append(void **head, void *elem)
+{
+        host_list_elem_t **tail = (host_list_elem_t **)head;
+
+        while (*tail) {
+                tail = &(*tail)->next;
+        }
+
+        ((host_list_elem_t *)elem)->next = NULL;
+        *tail = elem;
+}
+
+void *list_peek_back(void **head)
+{
+        host_list_elem_t *elem = *head;
+
+        while (elem && elem->next) {
+                elem = elem->next;
+        }
+
+        return elem;
+}
+
+static void list_unlink(void **head, list_elem_match_t match, const void *ud, bool all)
+{
+        host_list_elem_t **link = (host_list_elem_t **)head;
+
+        while (*link) {
+                host_list_elem_t *elem = *link;
+
+                if (match(elem, ud)) {
+                        *link = elem->next;
+                        OS_FREE(elem);
+                        if (!all) {
+                                return;
+                        }
+                } else {
+                        link = &elem->next;
+                }
+        }
+}
+
+void list_remove(void **head, list_elem_match_t match, const void *ud)
+{
+        list_unlink(head, match, ud, false);
+}
+
+void list_filter(void **head, list_elem_match_t match, const void *ud)
+{
+        list_unlink(head, match, ud, true);
+}
+
+void list_foreach(void *head, list_elem_cb_t cb, const void *ud)
+{
+        host_list_elem_t *elem = head;
+
+        while (elem) {
+                host_list_elem_t *next = elem->next;
+
+                cb(elem, ud);
+                elem = next;
+        }
+}
+
+int list_size(void *head)
+{
+        host_list_elem_t *elem = head;
+        int size = 0;
+
+        while (elem) {
+                size++;
+                elem = elem->next;
+        }
+
+        return size;
+}
+
+/************************************ NVPARAM ***********************************************/
+
+nvparam_t ad_nvparam_open(const char *area_name)
+{
+        return &sn_checkpoint;
+}
+
+void ad_nvparam_close(nvparam_t param)
+{
+}
+
+uint16_t ad_nvparam_read(nvparam_t param, uint8_t tag, uint16_t length, void *data)
+{
+        if (tag != TAG_BLE_APP_GLS_SN_CHECKPOINT || !sn_checkpoint_valid) {
+                return 0;
+        }
+
+        length = MIN(length, sizeof(sn_checkpoint));
+        memcpy(data, &sn_checkpoint, length);
+        return length;
+}
+
+uint16_t ad_nvparam_write(nvparam_t param, uint8_t tag, uint16_t length, const void *data)
+{
+        if (tag != TAG_BLE_APP_GLS_SN_CHECKPOINT) {
+                return 0;
+        }
+
+        length = MIN(length, sizeof(sn_checkpoint));
+        memcpy(&sn_checkpoint, data, length);
+        sn_checkpoint_valid = true;
+        return length;
+}
+
+/*********************************** GATT server ********************************************/
+
+uint16_t ble_gatts_get_num_attr(uint16_t include, uint16_t characteristics, uint16_t descriptors)
+{
+        return 1 + include + (2 * characteristics) + descriptors;
+}
+
+ble_error_t ble_gatts_add_service(const att_uuid_t *uuid, gatt_service_t type, uint16_t num_attrs)
+{
+        handle_offset = 0;
+        num_of_ccc = 0;
+        return BLE_STATUS_OK;
+}
+
+ble_error_t ble_gatts_add_characteristic(const att_uuid_t *uuid, gatt_prop_t prop, att_perm_t perm,
+                        uint16_t max_len, gatts_flag_t flags, uint16_t *h_offset, uint16_t *h_val_offset)
+{
+        /* Characteristic declaration followed by the value */
+        if (h_offset) {
+                *h_offset = handle_offset + 1;
+        }
+        handle_offset += 2;
+        *h_val_offset = handle_offset;
+        return BLE_STATUS_OK;
+}
+
+ble_error_t ble_gatts_add_descriptor(const att_uuid_t *uuid, att_perm_t perm, uint16_t max_len,
+                                                        gatts_flag_t flags, uint16_t *h_offset)
+{
+        *h_offset = ++handle_offset;
+
+        if (uuid->uuid16 == HOST_UUID_CCC && num_of_ccc < HOST_MAX_DESCRIPTORS) {
+                ccc_h[num_of_ccc++] = h_offset;
+        }
+        return BLE_STATUS_OK;
+}
+
+ble_error_t ble_gatts_register_service(uint16_t *handle, ...)
+{
+        va_list ap;
+        uint16_t *h;
+
+        /* The offsets passed are turned into handles, as done by the BLE stack */
+        *handle = next_start_h;
+        next_start_h += handle_offset + 1;
+
+        va_start(ap, handle);
+        while ((h = va_arg(ap, uint16_t *)) != NULL) {
+                *h += *handle;
+        }
+        va_end(ap);
+
+        return BLE_STATUS_OK;
+}
+
+ble_error_t ble_gatts_read_cfm(uint16_t conn_idx, uint16_t handle, att_error_t status, uint16_t length,
+                                                                                const void *value)
+{
+        return BLE_STATUS_OK;
+}
+
+ble_error_t ble_gatts_write_cfm(uint16_t conn_idx, uint16_t handle, att_error_t status)
+{
+        return BLE_STATUS_OK;
+}
+
+ble_error_t ble_gatts_send_event(uint16_t conn_idx, uint16_t handle, gatt_event_t type, uint16_t length,
+                                                                                const void *value)
+{
+        if (conn_idx >= BLE_GAP_MAX_CONNECTED || !devices[conn_idx].connected) {
+                return BLE_ERROR_NOT_CONNECTED;
+        }
+
+        if (events_to_reject) {
+                events_to_reject--;
+                return BLE_ERROR_FAILED;
+        }
+
+        num_of_events++;
+        return BLE_STATUS_OK;
+}
+
+void ble_service_add(ble_service_t *svc)
+{
+}
+
+/*************************************** GAP ************************************************/
+
+ble_error_t ble_gap_get_connected(uint8_t *length, uint16_t **conn_idx)
+{
+        uint8_t num = 0;
+
+        *conn_idx = OS_MALLOC(sizeof(**conn_idx) * BLE_GAP_MAX_CONNECTED);
+        if (*conn_idx == NULL) {
+                *length = 0;
+                return BLE_ERROR_FAILED;
+        }
+
+        for (uint16_t i = 0; i < BLE_GAP_MAX_CONNECTED; i++) {
+                if (devices[i].connected) {
+                        (*conn_idx)[num++] = i;
+                }
+        }
+
+        *length = num;
+        return BLE_STATUS_OK;
+}
+
+ble_error_t ble_gap_get_device_by_conn_idx(uint16_t conn_idx, gap_device_t *gap_device)
+{
+        if (conn_idx >= BLE_GAP_MAX_CONNECTED || !devices[conn_idx].connected) {
+                return BLE_ERROR_NOT_CONNECTED;
+        }
+
+        *gap_device = devices[conn_idx];
+        return BLE_STATUS_OK;
+}
+
+/************************************** Storage *********************************************/
+
+static host_storage_entry_t *storage_find(uint16_t conn_idx, ble_storage_key_t key, bool create)
+{
+        host_storage_entry_t *free_entry = NULL;
+
+        for (int i = 0; i < HOST_STORAGE_SIZE; i++) {
+                if (storage[i].used && (storage[i].conn_idx == conn_idx) && (storage[i].key == key)) {
+                        return &storage[i];
+                }
+                if (!storage[i].used && (free_entry == NULL)) {
+                        free_entry = &storage[i];
+                }
+        }
+
+        if (create && free_entry) {
+                free_entry->used = true;
+                free_entry->conn_idx = conn_idx;
+                free_entry->key = key;
+                return free_entry;
+        }
+        return NULL;
+}
+
+ble_error_t ble_storage_get_u16(uint16_t conn_idx, ble_storage_key_t key, uint16_t *value)
+{
+        host_storage_entry_t *entry = storage_find(conn_idx, key, false);
+
+        if (entry == NULL) {
+                return BLE_ERROR_FAILED;
+        }
+
+        *value = (uint16_t)entry->value;
+        return BLE_STATUS_OK;
+}
+
+ble_error_t ble_storage_put_u32(uint16_t conn_idx, ble_storage_key_t key, uint32_t value, bool persistent)
+{
+        host_storage_entry_t *entry = storage_find(conn_idx, key, true);
+
+        if (entry == NULL) {
+                return BLE_ERROR_FAILED;
+        }
+
+        entry->value = value;
+        return BLE_STATUS_OK;
+}
+
+ble_error_t ble_storage_remove_all(ble_storage_key_t key)
+{
+        for (int i = 0; i < HOST_STORAGE_SIZE; i++) {
+                if (storage[i].key == key) {
+                        storage[i].used = false;
+                }
+        }
+        return BLE_STATUS_OK;
+}
+
+/*************************************** UUID ***********************************************/
+
+void ble_uuid_create16(uint16_t uuid16, att_uuid_t *uuid)
+{
+        memset(uuid, 0, sizeof(*uuid));
+        uuid->uuid16 = uuid16;
+}
@@ -0,0 +1,68 @@
+/**
+ ****************************************************************************************
+ *
+ * @file host_stubs.h
+ *
+ * @brief Services of the stub layers of the glucose database host build
+ *
+ * Copyright (C) 2024 Renesas Electronics Corporation and/or its affiliates.
+ * All rights reserved. Confidential Information.
+ *
+ * This software ("Software") is supplied by Renesas Electronics Corporation and/or its
+ * affiliates ("Renesas"). Renesas grants you a personal, non-exclusive, non-transferable,
+ * revocable, non-sub-licensable right and license to use the Software, solely if used in
+ * or together with Renesas products. You may make copies of this Software, provided this
+ * copyright notice and disclaimer ("Notice") is included in all such copies. Renesas
+ * reserves the right to change or discontinue the Software at any time without notice.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS". RENESAS DISCLAIMS ALL WARRANTIES OF ANY KIND,
+ * WHETHER EXPRESS, IMPLIED, OR STATUTORY, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT. TO THE
+ * MAXIMUM EXTENT PERMITTED UNDER LAW, IN NO EVENT SHALL RENESAS BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, SPECIAL, INCIDENTAL OR CONSEQUENTIAL DAMAGES ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE, EVEN IF RENESAS HAS BEEN ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGES. USE OF THIS SOFTWARE MAY BE SUBJECT TO TERMS AND CONDITIONS CONTAINED IN
+ * AN ADDITIONAL AGREEMENT BETWEEN YOU AND RENESAS. IN CASE OF CONFLICT BETWEEN THE TERMS
+ * OF THIS NOTICE AND ANY SUCH ADDITIONAL LICENSE AGREEMENT, THE TERMS OF THE AGREEMENT
+ * SHALL TAKE PRECEDENCE. BY CONTINUING TO USE THIS SOFTWARE, YOU AGREE TO THE TERMS OF
+ * THIS NOTICE.IF YOU DO NOT AGREE TO THESE TERMS, YOU ARE NOT PERMITTED TO USE THIS
+ * SOFTWARE.
+ *
+ ****************************************************************************************
+ */
+
+#ifndef HOST_STUBS_H_
+#define HOST_STUBS_H_
+
+#include "sdk_defs.h"
+
+/* Number of failed assertions so far */
+uint32_t host_assert_count(void);
+
+/* Print the output of the sample code (DBG_PRINTF) */
+void host_set_verbose(bool verbose);
+
+/* Heap in use and peak heap use, in bytes */
+size_t host_heap_in_use(void);
+size_t host_heap_peak(void);
+
+/* Virtual time advanced by OS_DELAY_MS, in ms */
+uint32_t host_time_ms(void);
+
+/* Preset the SN checkpoint read by the database at initialization */
+void host_nvparam_set_sn_checkpoint(uint16_t seq_number);
+
+/* Report a peer device as connected (and bonded) to the service */
+void host_gap_connect(uint16_t conn_idx, bool bonded);
+void host_gap_disconnect(uint16_t conn_idx);
+
+/* Handles of the CCC descriptors of the last registered service */
+uint8_t host_gatts_get_ccc_handles(uint16_t *handles, uint8_t max_handles);
+
+/* Events sent via ble_gatts_send_event */
+uint32_t host_gatts_num_of_events(void);
+
+/* Reject the next events sent, as done by the BLE stack when its TX queue is full */
+void host_gatts_reject_events(uint32_t num_of_events);
+
+#endif /* HOST_STUBS_H_ */
@@ -0,0 +1,68 @@
+/**
+ ****************************************************************************************
+ *
+ * @file ble_bufops.h
+ *
+ * @brief Buffer helpers used by the glucose service (host build)
+ *
+ * Copyright (C) 2024 Renesas Electronics Corporation and/or its affiliates.
+ * All rights reserved. Confidential Information.
+ *
+ * This software ("Software") is supplied by Renesas Electronics Corporation and/or its
+ * affiliates ("Renesas"). Renesas grants you a personal, non-exclusive, non-transferable,
+ * revocable, non-sub-licensable right and license to use the Software, solely if used in
+ * or together with Renesas products. You may make copies of this Software, provided this
+ * copyright notice and disclaimer ("Notice") is included in all such copies. Renesas
+ * reserves the right to change or discontinue the Software at any time without notice.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS". RENESAS DISCLAIMS ALL WARRANTIES OF ANY KIND,
+ * WHETHER EXPRESS, IMPLIED, OR STATUTORY, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT. TO THE
+ * MAXIMUM EXTENT PERMITTED UNDER LAW, IN NO EVENT SHALL RENESAS BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, SPECIAL, INCIDENTAL OR CONSEQUENTIAL DAMAGES ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE, EVEN IF RENESAS HAS BEEN ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGES. USE OF THIS SOFTWARE MAY BE SUBJECT TO TERMS AND CONDITIONS CONTAINED IN
+ * AN ADDITIONAL AGREEMENT BETWEEN YOU AND RENESAS. IN CASE OF CONFLICT BETWEEN THE TERMS
+ * OF THIS NOTICE AND ANY SUCH ADDITIONAL LICENSE AGREEMENT, THE TERMS OF THE AGREEMENT
+ * SHALL TAKE PRECEDENCE. BY CONTINUING TO USE THIS SOFTWARE, YOU AGREE TO THE TERMS OF
+ * THIS NOTICE.IF YOU DO NOT AGREE TO THESE TERMS, YOU ARE NOT PERMITTED TO USE THIS
+ * SOFTWARE.
+ *
+ ****************************************************************************************
+ */
+
+#ifndef BLE_BUFOPS_H_
+#define BLE_BUFOPS_H_
+
+#include "sdk_defs.h"
+
+static inline uint16_t get_u16(const uint8_t *buffer)
+{
+        return (uint16_t)(buffer[0] | (buffer[1] << 8));
+}
+
+static inline uint8_t get_u8_inc(const uint8_t **buffer)
+{
+        return *(*buffer)++;
+}
+
+static inline uint16_t get_u16_inc(const uint8_t **buffer)
+{
+        uint16_t value = get_u16(*buffer);
+
+        *buffer += 2;
+        return value;
+}
+
+static inline void put_u8_inc(uint8_t **buffer, uint8_t value)
+{
+        *(*buffer)++ = value;
+}
+
+static inline void put_u16_inc(uint8_t **buffer, uint16_t value)
+{
+        put_u8_inc(buffer, (uint8_t)value);
+        put_u8_inc(buffer, (uint8_t)(value >> 8));
+}
+
+#endif /* BLE_BUFOPS_H_ */
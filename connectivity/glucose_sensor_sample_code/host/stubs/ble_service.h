@@ -0,0 +1,63 @@
+/**
+ ****************************************************************************************
+ *
+ * @file ble_service.h
+ *
+ * @brief BLE service framework definitions used by the glucose service (host build)
+ *
+ * Copyright (C) 2024 Renesas Electronics Corporation and/or its affiliates.
+ * All rights reserved. Confidential Information.
+ *
+ * This software ("Software") is supplied by Renesas Electronics Corporation and/or its
+ * affiliates ("Renesas"). Renesas grants you a personal, non-exclusive, non-transferable,
+ * revocable, non-sub-licensable right and license to use the Software, solely if used in
+ * or together with Renesas products. You may make copies of this Software, provided this
+ * copyright notice and disclaimer ("Notice") is included in all such copies. Renesas
+ * reserves the right to change or discontinue the Software at any time without notice.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS". RENESAS DISCLAIMS ALL WARRANTIES OF ANY KIND,
+ * WHETHER EXPRESS, IMPLIED, OR STATUTORY, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT. TO THE
+ * MAXIMUM EXTENT PERMITTED UNDER LAW, IN NO EVENT SHALL RENESAS BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, SPECIAL, INCIDENTAL OR CONSEQUENTIAL DAMAGES ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE, EVEN IF RENESAS HAS BEEN ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGES. USE OF THIS SOFTWARE MAY BE SUBJECT TO TERMS AND CONDITIONS CONTAINED IN
+ * AN ADDITIONAL AGREEMENT BETWEEN YOU AND RENESAS. IN CASE OF CONFLICT BETWEEN THE TERMS
+ * OF THIS NOTICE AND ANY SUCH ADDITIONAL LICENSE AGREEMENT, THE TERMS OF THE AGREEMENT
+ * SHALL TAKE PRECEDENCE. BY CONTINUING TO USE THIS SOFTWARE, YOU AGREE TO THE TERMS OF
+ * THIS NOTICE.IF YOU DO NOT AGREE TO THESE TERMS, YOU ARE NOT PERMITTED TO USE THIS
+ * SOFTWARE.
+ *
+ ****************************************************************************************
+ */
+
+#ifndef BLE_SERVICE_H_
+#define BLE_SERVICE_H_
+
+#include "ble_gap.h"
+#include "ble_gatts.h"
+
+typedef struct ble_service ble_service_t;
+
+typedef void (* ble_service_connected_evt_t) (ble_service_t *svc, const ble_evt_gap_connected_t *evt);
+typedef void (* ble_service_disconnected_evt_t) (ble_service_t *svc, const ble_evt_gap_disconnected_t *evt);
+typedef void (* ble_service_read_req_t) (ble_service_t *svc, const ble_evt_gatts_read_req_t *evt);
+typedef void (* ble_service_write_req_t) (ble_service_t *svc, const ble_evt_gatts_write_req_t *evt);
+typedef void (* ble_service_event_sent_t) (ble_service_t *svc, const ble_evt_gatts_event_sent_t *evt);
+typedef void (* ble_service_cleanup_t) (ble_service_t *svc);
+
+struct ble_service {
+        uint16_t start_h;
+        uint16_t end_h;
+
+        ble_service_connected_evt_t connected_evt;
+        ble_service_disconnected_evt_t disconnected_evt;
+        ble_service_read_req_t read_req;
+        ble_service_write_req_t write_req;
+        ble_service_event_sent_t event_sent;
+        ble_service_cleanup_t cleanup;
+};
+
+void ble_service_add(ble_service_t *svc);
+
+#endif /* BLE_SERVICE_H_ */
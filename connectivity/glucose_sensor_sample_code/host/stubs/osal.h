@@ -0,0 +1,65 @@
+/**
+ ****************************************************************************************
+ *
+ * @file osal.h
+ *
+ * @brief OS abstraction layer of the glucose database host build
+ *
+ * Copyright (C) 2024 Renesas Electronics Corporation and/or its affiliates.
+ * All rights reserved. Confidential Information.
+ *
+ * This software ("Software") is supplied by Renesas Electronics Corporation and/or its
+ * affiliates ("Renesas"). Renesas grants you a personal, non-exclusive, non-transferable,
+ * revocable, non-sub-licensable right and license to use the Software, solely if used in
+ * or together with Renesas products. You may make copies of this Software, provided this
+ * copyright notice and disclaimer ("Notice") is included in all such copies. Renesas
+ * reserves the right to change or discontinue the Software at any time without notice.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS". RENESAS DISCLAIMS ALL WARRANTIES OF ANY KIND,
+ * WHETHER EXPRESS, IMPLIED, OR STATUTORY, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT. TO THE
+ * MAXIMUM EXTENT PERMITTED UNDER LAW, IN NO EVENT SHALL RENESAS BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, SPECIAL, INCIDENTAL OR CONSEQUENTIAL DAMAGES ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE, EVEN IF RENESAS HAS BEEN ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGES. USE OF THIS SOFTWARE MAY BE SUBJECT TO TERMS AND CONDITIONS CONTAINED IN
+ * AN ADDITIONAL AGREEMENT BETWEEN YOU AND RENESAS. IN CASE OF CONFLICT BETWEEN THE TERMS
+ * OF THIS NOTICE AND ANY SUCH ADDITIONAL LICENSE AGREEMENT, THE TERMS OF THE AGREEMENT
+ * SHALL TAKE PRECEDENCE. BY CONTINUING TO USE THIS SOFTWARE, YOU AGREE TO THE TERMS OF
+ * THIS NOTICE.IF YOU DO NOT AGREE TO THESE TERMS, YOU ARE NOT PERMITTED TO USE THIS
+ * SOFTWARE.
+ *
+ ****************************************************************************************
+ */
+
+#ifndef OSAL_H_
+#define OSAL_H_
+
+#include "sdk_defs.h"
+
+typedef int OS_MUTEX;
+
+/* Heap accounted by the harness */
+void *host_malloc(size_t size);
+void host_free(void *ptr);
+size_t host_free_heap(void);
+
+#define OS_MALLOC(_size)                host_malloc(_size)
+#define OS_FREE(_ptr)                   host_free(_ptr)
+#define OS_ASSERT(_cond)                ASSERT_WARNING(_cond)
+#define OS_GET_FREE_HEAP_SIZE()         host_free_heap()
+
+/* The harness is single threaded; mutexes only check that they are taken and released in pairs */
+void host_mutex_get(OS_MUTEX *mutex);
+void host_mutex_put(OS_MUTEX *mutex);
+
+#define OS_MUTEX_FOREVER                ( 0 )
+#define OS_MUTEX_CREATE(_mutex)         ((_mutex) = 0)
+#define OS_MUTEX_GET(_mutex, _timeout)  host_mutex_get(&(_mutex))
+#define OS_MUTEX_PUT(_mutex)            host_mutex_put(&(_mutex))
+
+/* Delays advance the virtual time of the harness */
+void host_delay_ms(uint32_t ms);
+
+#define OS_DELAY_MS(_ms)                host_delay_ms(_ms)
+
+#endif /* OSAL_H_ */
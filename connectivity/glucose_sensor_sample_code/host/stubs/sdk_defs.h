@@ -0,0 +1,93 @@
+/**
+ ****************************************************************************************
+ *
+ * @file sdk_defs.h
+ *
+ * @brief SDK definitions used by the glucose database and service (host build)
+ *
+ * Copyright (C) 2024 Renesas Electronics Corporation and/or its affiliates.
+ * All rights reserved. Confidential Information.
+ *
+ * This software ("Software") is supplied by Renesas Electronics Corporation and/or its
+ * affiliates ("Renesas"). Renesas grants you a personal, non-exclusive, non-transferable,
+ * revocable, non-sub-licensable right and license to use the Software, solely if used in
+ * or together with Renesas products. You may make copies of this Software, provided this
+ * copyright notice and disclaimer ("Notice") is included in all such copies. Renesas
+ * reserves the right to change or discontinue the Software at any time without notice.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS". RENESAS DISCLAIMS ALL WARRANTIES OF ANY KIND,
+ * WHETHER EXPRESS, IMPLIED, OR STATUTORY, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT. TO THE
+ * MAXIMUM EXTENT PERMITTED UNDER LAW, IN NO EVENT SHALL RENESAS BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, SPECIAL, INCIDENTAL OR CONSEQUENTIAL DAMAGES ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE, EVEN IF RENESAS HAS BEEN ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGES. USE OF THIS SOFTWARE MAY BE SUBJECT TO TERMS AND CONDITIONS CONTAINED IN
+ * AN ADDITIONAL AGREEMENT BETWEEN YOU AND RENESAS. IN CASE OF CONFLICT BETWEEN THE TERMS
+ * OF THIS NOTICE AND ANY SUCH ADDITIONAL LICENSE AGREEMENT, THE TERMS OF THE AGREEMENT
+ * SHALL TAKE PRECEDENCE. BY CONTINUING TO USE THIS SOFTWARE, YOU AGREE TO THE TERMS OF
+ * THIS NOTICE.IF YOU DO NOT AGREE TO THESE TERMS, YOU ARE NOT PERMITTED TO USE THIS
+ * SOFTWARE.
+ *
+ ****************************************************************************************
+ */
+
+#ifndef SDK_DEFS_H_
+#define SDK_DEFS_H_
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define __RETAINED
+#define __RETAINED_RW
+#define __RETAINED_UNINIT
+#define __packed                __attribute__((packed))
+#define __unused                __attribute__((unused))
+#define __UNUSED                __attribute__((unused))
+
+#define OPT_MEMCPY              memcpy
+
+/* Assertions are reported by the harness (file and line) instead of halting the CPU */
+void host_assert_failed(const char *file, int line);
+
+#define ASSERT_WARNING(_cond)                                           \
+        do {                                                            \
+                if (!(_cond)) {                                         \
+                        host_assert_failed(__FILE__, __LINE__);         \
+                }                                                       \
+        } while (0)
+
+#define ASSERT_ERROR(_cond)     ASSERT_WARNING(_cond)
+
+#define ARRAY_LENGTH(_a)        (sizeof(_a) / sizeof((_a)[0]))
+
+#ifndef MIN
+#define MIN(_a, _b)             (((_a) < (_b)) ? (_a) : (_b))
+#endif
+
+#ifndef MAX
+#define MAX(_a, _b)             (((_a) > (_b)) ? (_a) : (_b))
+#endif
+
+/* The DWT cycle counter reads the host cycle counter each time it is accessed */
+typedef struct {
+        uint32_t CTRL;
+        uint32_t CYCCNT;
+} DWT_Type;
+
+typedef struct {
+        uint32_t DEMCR;
+} CoreDebug_Type;
+
+DWT_Type *host_dwt(void);
+extern CoreDebug_Type host_core_debug;
+
+#define DWT                             host_dwt()
+#define CoreDebug                       (&host_core_debug)
+#define DWT_CTRL_CYCCNTENA_Msk          ( 1UL )
+#define CoreDebug_DEMCR_TRCENA_Msk      ( 1UL << 24 )
+
+#endif /* SDK_DEFS_H_ */
@@ -37,33 +37,40 @@
 #include "ble_gap.h"
 #include "ble_gatts.h"
 #include "glucose_sensor_database.h"
+#include "glucose_sensor_database_compact.h"
 #include "glucose_service.h"
 #include "svc_types.h"
 #include "sdk_list.h"
 #include "ad_nvms.h"
 
+#if APP_DB_PROFILING_ENABLE
+#include "sdk_defs.h"
+#include "misc.h"
+#endif
+
+#if APP_DB_SN_PERSISTENCE
+#include "ad_nvparam.h"
+#include "app_nvparam.h"
+#endif
+
+#if APP_DB_RTC_BASE_TIME
+# if !dg_configUSE_HW_RTC
+#  error "APP_DB_RTC_BASE_TIME requires dg_configUSE_HW_RTC"
+# endif
+#include "hw_rtc.h"
+#endif
+
 __RETAINED static app_db_data_t db_data;
 
+#if !APP_DB_COMPACT_STORAGE
 /* List used to maintain records for the GLS ATT database */
 __RETAINED static void *gls_database_records;
+#endif
 
 /* Synchronization semaphore required as database can be updated at any time when
  * a RACP parsing request is in progress. */
 __RETAINED static OS_MUTEX app_db_sync;
 
-/*
- * Helper macro to call a function until success is returned
- *
- * \param [in] _f     function to be called
- * \param [in] _s     value that should indicate success
- * \param [in] args   function arguments
- */
-#define APP_CALL_FUNCTION_UNTILL_SUCCESS(_f, _s, args...) \
-        typeof(_s) status;                                \
-        do {                                              \
-                status = _f(args);                        \
-        } while (status != _s);                           \
-
 
 /* Header structure appended at the start of the flash storage. */
 typedef struct __packed {
@@ -71,16 +78,230 @@ typedef struct __packed {
         size_t num_of_records;
 } storage_header_t;
 
-__RETAINED static uint8_t current_sn;
+__RETAINED static uint16_t current_sn;
+
+#if APP_DB_SN_PERSISTENCE
+/* SN following the last one reserved by the current lease */
+__RETAINED static uint16_t sn_lease_end;
+#endif
+
+#if APP_DB_RTC_BASE_TIME
+/* Magic value indicating the RTC has been initialized; valid as long as the device is powered */
+#define APP_DB_RTC_MAGIC_VALUE  0x474C5354
+
+__RETAINED_UNINIT static uint32_t rtc_magic_value;
+#endif
+
+#if APP_DB_SYNC_CURSOR_SUPPORT
+__RETAINED static app_db_sync_stats_t sync_stats;
+#endif
+
+#if APP_DB_PROFILING_ENABLE
+/*
+ * CPU cycles spent per attempt to notify the records of the current RACP request. Attempts that
+ * fail because the TX queue is full are retried and each one is accounted separately.
+ */
+__RETAINED static uint32_t profiling_cycles;
+__RETAINED static uint32_t profiling_attempts;
+__RETAINED static uint32_t profiling_records;
+
+# define APP_DB_PROFILING_START() \
+        uint32_t _cycles = DWT->CYCCNT
+
+# define APP_DB_PROFILING_STOP() \
+        profiling_cycles += DWT->CYCCNT - _cycles; \
+        profiling_attempts++
+
+# define APP_DB_PROFILING_RECORD() \
+        profiling_records++
+
+static void app_db_profiling_reset(void)
+{
+        profiling_cycles = 0;
+        profiling_attempts = 0;
+        profiling_records = 0;
+}
+
+static void app_db_profiling_report(void)
+{
+        if (profiling_attempts) {
+                DBG_PRINTF("Reported records: %lu, notification attempts: %lu, cycles/attempt: %lu\n\r",
+                        (unsigned long)profiling_records, (unsigned long)profiling_attempts,
+                        (unsigned long)(profiling_cycles / profiling_attempts));
+        }
+}
+#else
+# define APP_DB_PROFILING_START()
+# define APP_DB_PROFILING_STOP()
+# define APP_DB_PROFILING_RECORD()
+#endif /* APP_DB_PROFILING_ENABLE */
 
 // compile-time assertion
 #define C_ASSERT(cond) typedef char __c_assert[(cond) ? 1 : -1] __attribute__((unused))
 
+#if APP_DB_SN_PERSISTENCE
+static bool sn_checkpoint_read(uint16_t *seq_number)
+{
+        nvparam_t param;
+        uint16_t read_len;
+
+        param = ad_nvparam_open("ble_app");
+        read_len = ad_nvparam_read(param, TAG_BLE_APP_GLS_SN_CHECKPOINT, sizeof(*seq_number), seq_number);
+        ad_nvparam_close(param);
+
+        return read_len == sizeof(*seq_number);
+}
+
+/* Reserve the next APP_DB_SN_LEASE_SIZE SNs */
+static void sn_lease_renew(void)
+{
+        nvparam_t param;
+        /* The last lease ends at the max. SN value, which is not rolled over */
+        uint16_t lease_end = MIN((uint32_t)current_sn + APP_DB_SN_LEASE_SIZE, 0xFFFF);
+
+        param = ad_nvparam_open("ble_app");
+        if (ad_nvparam_write(param, TAG_BLE_APP_GLS_SN_CHECKPOINT, sizeof(lease_end),
+                                                                &lease_end) != sizeof(lease_end)) {
+                /* Numbering will continue but SNs might be reused following a reset */
+                ASSERT_WARNING(0);
+        }
+        ad_nvparam_close(param);
+
+        sn_lease_end = lease_end;
+}
+#endif /* APP_DB_SN_PERSISTENCE */
+
+#if APP_DB_RTC_BASE_TIME
+/* Number of days since 1970-01-01 of a date of the proleptic Gregorian calendar */
+static int32_t days_from_civil(int32_t year, uint32_t month, uint32_t day)
+{
+        int32_t era;
+        uint32_t yoe, doy, doe;
+
+        year -= month <= 2;
+        era = (year >= 0 ? year : year - 399) / 400;
+        yoe = (uint32_t)(year - era * 400);
+        doy = (153 * (month + (month > 2 ? -3 : 9)) + 2) / 5 + day - 1;
+        doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+
+        return era * 146097 + (int32_t)doe - 719468;
+}
+
+/* Date of the proleptic Gregorian calendar from the number of days since 1970-01-01 */
+static void civil_from_days(int32_t days, gls_base_user_facing_time_t *date)
+{
+        int32_t era;
+        uint32_t doe, yoe, doy, mp;
+
+        days += 719468;
+        era = (days >= 0 ? days : days - 146096) / 146097;
+        doe = (uint32_t)(days - era * 146097);
+        yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+        doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+        mp = (5 * doy + 2) / 153;
+
+        date->day = doy - (153 * mp + 2) / 5 + 1;
+        date->month = mp < 10 ? mp + 3 : mp - 9;
+        date->year = (int32_t)yoe + era * 400 + (date->month <= 2);
+}
+
+static void rtc_init(void)
+{
+        hw_rtc_time_t time = {
+                .hour = APP_DB_BASE_TIME_HOURS,
+                .minute = APP_DB_BASE_TIME_MINUTES,
+                .sec = APP_DB_BASE_TIME_SECONDS,
+        };
+        hw_rtc_calendar_t calendar = {
+                .year = APP_DB_BASE_TIME_YEAR,
+                .month = APP_DB_BASE_TIME_MONTH,
+                .mday = APP_DB_BASE_TIME_DAY,
+                .wday = 1,
+        };
+
+        hw_rtc_set_hour_clk_mode(RTC_24H_CLK);
+
+        /* RTC contents are retained following a reset; time keeps counting from where it was */
+        if (rtc_magic_value != APP_DB_RTC_MAGIC_VALUE) {
+                if (hw_rtc_set_time_clndr(&time, &calendar) != HW_RTC_VALID_ENTRY) {
+                        ASSERT_WARNING(0);
+                }
+                rtc_magic_value = APP_DB_RTC_MAGIC_VALUE;
+        }
+
+        hw_rtc_clock_enable();
+        hw_rtc_start();
+}
+
+void app_db_get_record_time(gls_base_user_facing_time_t *base_time, int16_t *time_offset)
+{
+        hw_rtc_time_t time;
+        hw_rtc_calendar_t calendar;
+        int32_t base_min, elapsed_min, steps, days;
+
+        ASSERT_WARNING(base_time && time_offset);
+
+        hw_rtc_get_time_clndr(&time, &calendar);
+
+        base_min = days_from_civil(APP_DB_BASE_TIME_YEAR, APP_DB_BASE_TIME_MONTH, APP_DB_BASE_TIME_DAY) * 1440 +
+                                        APP_DB_BASE_TIME_HOURS * 60 + APP_DB_BASE_TIME_MINUTES;
+        elapsed_min = days_from_civil(calendar.year, calendar.month, calendar.mday) * 1440 +
+                                        time.hour * 60 + time.minute - base_min;
+
+        if (elapsed_min < 0) {
+                elapsed_min = 0;
+        }
+
+        /* The base time is fully determined by the RTC value and so it is recovered following a reset */
+        steps = elapsed_min / APP_DB_BASE_TIME_STEP_MIN;
+        base_min += steps * APP_DB_BASE_TIME_STEP_MIN;
+        *time_offset = elapsed_min - steps * APP_DB_BASE_TIME_STEP_MIN;
+
+        days = base_min / 1440;
+        civil_from_days(days, base_time);
+        base_time->hours = (base_min - days * 1440) / 60;
+        base_time->minutes = base_min % 60;
+        base_time->seconds = APP_DB_BASE_TIME_SECONDS;
+}
+#endif /* APP_DB_RTC_BASE_TIME */
+
 void app_db_init(void)
 {
         C_ASSERT(APP_DB_MAX_LIST_LEN);
 
         OS_MUTEX_CREATE(app_db_sync);
+
+#if APP_DB_SN_PERSISTENCE
+        /* Resume from the end of the last lease as any SN up to that point might have been used */
+        if (!sn_checkpoint_read(&current_sn)) {
+                current_sn = 0;
+        }
+        sn_lease_renew();
+#endif
+
+#if APP_DB_RTC_BASE_TIME
+        rtc_init();
+#endif
+
+#if APP_DB_COMPACT_STORAGE
+        app_db_compact_init();
+#endif
+
+#if APP_DB_PROFILING_ENABLE
+        /* Enable the DWT cycle counter */
+        CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+        DWT->CYCCNT = 0;
+        DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
+# if APP_DB_COMPACT_STORAGE
+        DBG_PRINTF("Record storage: %u records, %u bytes\n\r", APP_DB_MAX_LIST_LEN,
+                                                        (unsigned)app_db_compact_footprint());
+# else
+        /* Heap block headers are not accounted for */
+        DBG_PRINTF("Record storage: %u records, %u bytes\n\r", APP_DB_MAX_LIST_LEN,
+                                        (unsigned)(APP_DB_MAX_LIST_LEN * sizeof(app_db_record_entry_t)));
+# endif
+#endif
 }
 
 uint16_t app_db_get_sequence_number(void)
@@ -89,11 +310,18 @@ uint16_t app_db_get_sequence_number(void)
          * failure. It is also recommended that SN be stored in non-volatile memory to ensure consistency.  */
         if (current_sn == 0xFFFF) {
                 return current_sn;
-        } else {
-                return current_sn++;
         }
+
+#if APP_DB_SN_PERSISTENCE
+        if (current_sn == sn_lease_end) {
+                sn_lease_renew();
+        }
+#endif
+
+        return current_sn++;
 }
 
+#if !APP_DB_COMPACT_STORAGE
 static bool racp_records_compare(const void *elem, const void *ud)
 {
         app_db_record_entry_t *record = (app_db_record_entry_t *)elem;
@@ -101,11 +329,204 @@ static bool racp_records_compare(const void *elem, const void *ud)
 
         return (record->record.measurement.seq_number == data->record.measurement.seq_number);
 }
+#endif
+
+/*
+ * Storage helpers. Records are either linked in a list of full record entries or, if
+ * APP_DB_COMPACT_STORAGE is set, encoded in the compact storage and decoded on demand.
+ */
+#if APP_DB_COMPACT_STORAGE
+/* Entry the oldest or most recent record is decoded into */
+__RETAINED static app_db_record_entry_t db_entry;
+#endif
+
+static app_db_record_entry_t *db_first(void)
+{
+#if APP_DB_COMPACT_STORAGE
+        return app_db_compact_get_first(&db_entry) ? &db_entry : NULL;
+#else
+        return gls_database_records;
+#endif
+}
+
+static app_db_record_entry_t *db_last(void)
+{
+#if APP_DB_COMPACT_STORAGE
+        return app_db_compact_get_last(&db_entry) ? &db_entry : NULL;
+#else
+        return list_peek_back(&gls_database_records);
+#endif
+}
+
+static __unused void db_remove_first(void)
+{
+#if APP_DB_COMPACT_STORAGE
+        app_db_compact_remove_first();
+#else
+        app_db_record_entry_t *first_entry = gls_database_records;
+
+        if (first_entry) {
+                list_remove(&gls_database_records, racp_records_compare, (const void *)first_entry);
+        }
+#endif
+}
+
+static __unused void db_remove_last(void)
+{
+#if APP_DB_COMPACT_STORAGE
+        app_db_compact_remove_last();
+#else
+        app_db_record_entry_t *last_entry = list_peek_back(&gls_database_records);
+
+        if (last_entry) {
+                list_remove(&gls_database_records, racp_records_compare, (const void *)last_entry);
+        }
+#endif
+}
+
+static void db_foreach(void (*cb)(const void *elem, const void *ud), const void *ud)
+{
+#if APP_DB_COMPACT_STORAGE
+        app_db_compact_foreach(cb, ud);
+#else
+        list_foreach(gls_database_records, cb, ud);
+#endif
+}
+
+static void db_filter(bool (*match)(const void *elem, const void *ud), const void *ud)
+{
+#if APP_DB_COMPACT_STORAGE
+        app_db_compact_filter(match, ud);
+#else
+        list_filter(&gls_database_records, match, ud);
+#endif
+}
+
+#if APP_DB_SYNC_CURSOR_SUPPORT
+/* Structure holding the state of a record sync procedure */
+typedef struct {
+        ble_service_t *svc;
+        uint16_t conn_idx;
+        uint16_t cursor;
+        bool has_cursor;
+        bool updated;
+        bool aborted;
+} app_db_sync_data_t;
+
+/* Move the sync cursor of a collector forward; records reported out of order should not rewind it */
+static void app_db_update_sync_cursor(ble_service_t *svc, uint16_t conn_idx, uint16_t seq_number)
+{
+        uint16_t cursor;
+
+        if (!gls_get_record_sync_cursor(svc, conn_idx, &cursor) || seq_number > cursor) {
+                gls_set_record_sync_cursor(svc, conn_idx, seq_number);
+        }
+}
+
+/*
+ * Notify a record, giving up if the collector disconnects or disables notifications meanwhile.
+ * If the TX queue is full, retry after a delay so that lower priority tasks can run meanwhile;
+ * a disconnection is detected by gls_notify_record() and reported as notifications disabled.
+ */
+static bool app_db_sync_notify_record(ble_service_t *svc, uint16_t conn_idx, gls_record_t *record)
+{
+        while (!gls_notify_record(svc, conn_idx, record)) {
+                if (!gls_is_record_notification_enabled(svc, conn_idx)) {
+                        return false;
+                }
+
+                OS_DELAY_MS(APP_DB_NOTIFY_RETRY_MS);
+        }
+
+        return true;
+}
+
+static void sync_records_foreach_cb(const void *elem, const void *ud)
+{
+        app_db_record_entry_t *entry = (app_db_record_entry_t *)elem;
+        app_db_sync_data_t *sync = (app_db_sync_data_t *)ud;
+        uint16_t seq_number = entry->record.measurement.seq_number;
+
+        if (sync->aborted) {
+                return;
+        }
+
+        if (sync->has_cursor && seq_number <= sync->cursor) {
+                sync_stats.skipped++;
+                return;
+        }
+
+        if (!app_db_sync_notify_record(sync->svc, sync->conn_idx, &entry->record)) {
+                sync->aborted = true;
+                return;
+        }
+
+        sync_stats.served++;
+        sync->cursor = seq_number;
+        sync->has_cursor = true;
+        sync->updated = true;
+}
+
+void app_db_sync_records_handle(ble_service_t *svc, uint16_t conn_idx)
+{
+        app_db_sync_data_t sync;
+
+        ASSERT_WARNING(svc);
+
+        /* Wait until all the required CCC descriptors are enabled by the collector */
+        if (!gls_is_record_notification_enabled(svc, conn_idx)) {
+                return;
+        }
+
+        sync.svc = svc;
+        sync.conn_idx = conn_idx;
+        sync.has_cursor = gls_get_record_sync_cursor(svc, conn_idx, &sync.cursor);
+        sync.updated = false;
+        sync.aborted = false;
+
+        OS_MUTEX_GET(app_db_sync, OS_MUTEX_FOREVER);
+
+        /* Elements are stored in chronological order */
+        db_foreach(sync_records_foreach_cb, (const void *)&sync);
+
+        OS_MUTEX_PUT(app_db_sync);
+
+        if (sync.updated) {
+                gls_set_record_sync_cursor(svc, conn_idx, sync.cursor);
+        }
+}
 
-void app_db_add_record_entry(app_db_add_record_entry_cb_t cb)
+void app_db_get_sync_stats(app_db_sync_stats_t *stats)
 {
+        ASSERT_WARNING(stats);
+
+        OS_MUTEX_GET(app_db_sync, OS_MUTEX_FOREVER);
+        *stats = sync_stats;
+        OS_MUTEX_PUT(app_db_sync);
+}
+#endif /* APP_DB_SYNC_CURSOR_SUPPORT */
+
+bool app_db_add_record_entry(app_db_add_record_entry_cb_t cb)
+{
+        bool stored;
+
         ASSERT_WARNING(cb);
 
+#if APP_DB_COMPACT_STORAGE
+        gls_record_t record;
+
+        memset(&record, 0, sizeof(record));
+
+        /* Call user's callback to initialize the record */
+        cb(&record);
+
+        OS_MUTEX_GET(app_db_sync, OS_MUTEX_FOREVER);
+
+        /* The oldest record is overwritten if the max. storage capacity has been reached */
+        stored = app_db_compact_append(&record);
+
+        OS_MUTEX_PUT(app_db_sync);
+#else
         app_db_record_entry_t *record;
         uint8_t size;
 
@@ -120,6 +541,7 @@ void app_db_add_record_entry(app_db_add_record_entry_cb_t cb)
         }
 
         record = OS_MALLOC(sizeof(*record));
+        stored = (record != NULL);
         if (record) {
                 memset(record, 0, sizeof(*record));
 
@@ -131,23 +553,57 @@ void app_db_add_record_entry(app_db_add_record_entry_cb_t cb)
         }
 
         OS_MUTEX_PUT(app_db_sync);
+#endif /* APP_DB_COMPACT_STORAGE */
+
+        return stored;
 }
 
-void app_db_update_racp_request(ble_service_t *svc, uint16_t conn_idx, uint8_t command, gls_racp_t *record)
+static void racp_request_init(app_db_data_t *racp, uint8_t command, const gls_racp_t *record)
 {
         if (record->filter_type == GLS_RACP_FILTER_TYPE_SN) {
-                OPT_MEMCPY(&db_data.filter_param.seq_number,
+                OPT_MEMCPY(&racp->filter_param.seq_number,
                                         record->filter_param, record->filter_param_len);
         } else if (record->filter_type == GLS_RACP_FILTER_TYPE_UFT) {
-                OPT_MEMCPY(&db_data.filter_param.data_time,
+                OPT_MEMCPY(&racp->filter_param.data_time,
                                         record->filter_param, record->filter_param_len);
         }
 
-        db_data.operator = record->operator;
-        db_data.filter_type = record->filter_type;
+        racp->operator = record->operator;
+        racp->filter_type = record->filter_type;
+        racp->command = command;
+}
+
+void app_db_update_racp_request(ble_service_t *svc, uint16_t conn_idx, uint8_t command, gls_racp_t *record)
+{
+        racp_request_init(&db_data, command, record);
+
         db_data.conn_idx = conn_idx;
         db_data.svc = svc;
-        db_data.command = command;
+}
+
+/* Notify a record that matches the RACP report criteria */
+static void racp_notify_record(app_db_data_t *racp, gls_record_t *record)
+{
+        bool sent;
+
+        /* Notification is retried until the record is queued; each attempt is profiled on its own */
+        do {
+                APP_DB_PROFILING_START();
+
+                sent = gls_notify_record(racp->svc, racp->conn_idx, record);
+
+                APP_DB_PROFILING_STOP();
+        } while (!sent);
+
+        APP_DB_PROFILING_RECORD();
+
+        /* Success if at least one record matches criteria */
+        racp->status = GLS_RACP_RESPONSE_SUCCESS;
+
+#if APP_DB_SYNC_CURSOR_SUPPORT
+        /* Records are reported in chronological order */
+        racp->last_reported_sn = record->measurement.seq_number;
+#endif
 }
 
 static void racp_report_record_foreach_cb(const void *elem, const void *ud)
@@ -159,12 +615,7 @@ static void racp_report_record_foreach_cb(const void *elem, const void *ud)
         case GLS_RACP_OPERATOR_ALL_RECORDS:
                 if (racp->command == GLS_RACP_COMMAND_REPORT_RECORDS) {
                         /* No operands are used; just notify collector */
-
-                        APP_CALL_FUNCTION_UNTILL_SUCCESS(gls_notify_record, (bool)true,
-                                                        racp->svc, racp->conn_idx, &record->record);
-
-                        /* Success if at least one record matches criteria */
-                        racp->status = GLS_RACP_RESPONSE_SUCCESS;
+                        racp_notify_record(racp, &record->record);
                 } else {
                         racp->num_of_records++;
                 }
@@ -173,12 +624,7 @@ static void racp_report_record_foreach_cb(const void *elem, const void *ud)
                 if (racp->filter_type == GLS_RACP_FILTER_TYPE_SN) {
                         if (record->record.measurement.seq_number >= racp->filter_param.seq_number[0]) {
                                 if (racp->command == GLS_RACP_COMMAND_REPORT_RECORDS) {
-
-                                        APP_CALL_FUNCTION_UNTILL_SUCCESS(gls_notify_record, (bool)true,
-                                                                        racp->svc, racp->conn_idx, &record->record);
-
-                                        /* Success if at least one record matches criteria */
-                                        racp->status = GLS_RACP_RESPONSE_SUCCESS;
+                                        racp_notify_record(racp, &record->record);
                                 } else {
                                         racp->num_of_records++;
                                 }
@@ -196,12 +642,7 @@ static void racp_report_record_foreach_cb(const void *elem, const void *ud)
                 if (racp->filter_type == GLS_RACP_FILTER_TYPE_SN) {
                         if (record->record.measurement.seq_number <= racp->filter_param.seq_number[0]) {
                                 if (racp->command == GLS_RACP_COMMAND_REPORT_RECORDS) {
-
-                                        APP_CALL_FUNCTION_UNTILL_SUCCESS(gls_notify_record, (bool)true,
-                                                                        racp->svc, racp->conn_idx, &record->record);
-
-                                        /* Success if at least one record matches criteria */
-                                        racp->status = GLS_RACP_RESPONSE_SUCCESS;
+                                        racp_notify_record(racp, &record->record);
                                 } else {
                                         racp->num_of_records++;
                                 }
@@ -221,12 +662,7 @@ static void racp_report_record_foreach_cb(const void *elem, const void *ud)
                         if (record->record.measurement.seq_number >= racp->filter_param.seq_number[0] &&
                                 record->record.measurement.seq_number <= racp->filter_param.seq_number[1]) {
                                 if (racp->command == GLS_RACP_COMMAND_REPORT_RECORDS) {
-
-                                        APP_CALL_FUNCTION_UNTILL_SUCCESS(gls_notify_record, (bool)true,
-                                                                        racp->svc, racp->conn_idx, &record->record);
-
-                                        /* Success if at least one record matches criteria */
-                                        racp->status = GLS_RACP_RESPONSE_SUCCESS;
+                                        racp_notify_record(racp, &record->record);
                                 } else {
                                         racp->num_of_records++;
                                 }
@@ -324,41 +760,37 @@ static bool racp_delete_records_foreach_cb(const void *elem, const void *ud)
         return ret;
 }
 
-void app_db_report_num_of_records_handle(void)
+/* Count the records that match the criteria of a RACP request; should be called with the database locked */
+static void racp_count_records(app_db_data_t *racp)
 {
-        OS_MUTEX_GET(app_db_sync, OS_MUTEX_FOREVER);
-
-        db_data.num_of_records = 0;
+        racp->num_of_records = 0;
 
         /* It is assumed that RACP requests sanity checks are performed by the service */
-        switch (db_data.operator) {
+        switch (racp->operator) {
 #if GLS_RACP_OPERATOR_FIRST_RECORD_SUPPORT
         case GLS_RACP_OPERATOR_FIRST_RECORD:
-        {
-                app_db_record_entry_t *record = gls_database_records;
-
-                if (record) {
-                        db_data.num_of_records = 1;
-                }
-        }
-                break;
-#endif /* GLS_RACP_OPERATOR_FIRST_RECORD_SUPPORT */
+#endif
 #if GLS_RACP_OPERATOR_LAST_RECORD_SUPPORT
         case GLS_RACP_OPERATOR_LAST_RECORD:
-        {
-                app_db_record_entry_t *record = list_peek_back(&gls_database_records);
-                if (record) {
-                        db_data.num_of_records = 1;
+#endif
+#if GLS_RACP_OPERATOR_FIRST_RECORD_SUPPORT || GLS_RACP_OPERATOR_LAST_RECORD_SUPPORT
+                if (db_first()) {
+                        racp->num_of_records = 1;
                 }
-        }
                 break;
-#endif /* GLS_RACP_OPERATOR_LAST_RECORD_SUPPORT */
+#endif
         default:
                 /* The rest operators require parsing the database records */
-                list_foreach(gls_database_records, racp_report_record_foreach_cb,
-                                                                (const void *)&db_data);
+                db_foreach(racp_report_record_foreach_cb, (const void *)racp);
                 break;
         }
+}
+
+void app_db_report_num_of_records_handle(void)
+{
+        OS_MUTEX_GET(app_db_sync, OS_MUTEX_FOREVER);
+
+        racp_count_records(&db_data);
 
         OS_MUTEX_PUT(app_db_sync);
 
@@ -367,23 +799,42 @@ void app_db_report_num_of_records_handle(void)
                                                         db_data.num_of_records);
 }
 
+uint16_t app_db_query_num_of_records(const gls_racp_t *record)
+{
+        app_db_data_t racp = { 0 };
+
+        ASSERT_WARNING(record);
+
+        racp_request_init(&racp, GLS_RACP_COMMAND_NUMBER_OF_RECORDS, record);
+
+        OS_MUTEX_GET(app_db_sync, OS_MUTEX_FOREVER);
+
+        racp_count_records(&racp);
+
+        OS_MUTEX_PUT(app_db_sync);
+
+        return racp.num_of_records;
+}
+
 void app_db_report_records_handle(void)
 {
         OS_MUTEX_GET(app_db_sync, OS_MUTEX_FOREVER);
 
         db_data.status = GLS_RACP_RESPONSE_NO_RECORDS;
 
+#if APP_DB_PROFILING_ENABLE
+        app_db_profiling_reset();
+#endif
+
         /* It is assumed that RACP requests sanity checks are performed by the service */
         switch (db_data.operator) {
 #if GLS_RACP_OPERATOR_FIRST_RECORD_SUPPORT
         case GLS_RACP_OPERATOR_FIRST_RECORD:
         {
-                app_db_record_entry_t *record = gls_database_records;
+                app_db_record_entry_t *record = db_first();
 
                 if (record) {
-                        APP_CALL_FUNCTION_UNTILL_SUCCESS(gls_notify_record, (bool)true,
-                                                db_data.svc, db_data.conn_idx, &record->record);
-                        db_data.status = GLS_RACP_RESPONSE_SUCCESS;
+                        racp_notify_record(&db_data, &record->record);
                 }
         }
                 break;
@@ -391,23 +842,30 @@ void app_db_report_records_handle(void)
 #if GLS_RACP_OPERATOR_LAST_RECORD_SUPPORT
         case GLS_RACP_OPERATOR_LAST_RECORD:
         {
-                app_db_record_entry_t *record = list_peek_back(&gls_database_records);
+                app_db_record_entry_t *record = db_last();
                 if (record) {
-                        APP_CALL_FUNCTION_UNTILL_SUCCESS(gls_notify_record, (bool)true,
-                                                db_data.svc, db_data.conn_idx, &record->record);
-                        db_data.status = GLS_RACP_RESPONSE_SUCCESS;
+                        racp_notify_record(&db_data, &record->record);
                 }
         }
                 break;
 #endif /* GLS_RACP_OPERATOR_LAST_RECORD_SUPPORT */
         default:
                 /* The rest operators require parsing the database records */
-                list_foreach(gls_database_records, racp_report_record_foreach_cb,
-                                                                (const void *)&db_data);
+                db_foreach(racp_report_record_foreach_cb, (const void *)&db_data);
                 break;
         }
         OS_MUTEX_PUT(app_db_sync);
 
+#if APP_DB_PROFILING_ENABLE
+        app_db_profiling_report();
+#endif
+
+#if APP_DB_SYNC_CURSOR_SUPPORT
+        if (db_data.status == GLS_RACP_RESPONSE_SUCCESS) {
+                app_db_update_sync_cursor(db_data.svc, db_data.conn_idx, db_data.last_reported_sn);
+        }
+#endif
+
         /* Last step is to indicate collector */
         gls_indicate_report_records_status(db_data.svc, db_data.conn_idx, db_data.status);
 }
@@ -422,34 +880,23 @@ void app_db_delete_records_handle(void)
         switch (db_data.operator) {
 #if GLS_RACP_OPERATOR_FIRST_RECORD_SUPPORT
         case GLS_RACP_OPERATOR_FIRST_RECORD:
-        {
-                app_db_record_entry_t *first_entry;
-
-                first_entry = gls_database_records;
-                if (first_entry) {
-                        list_remove(&gls_database_records, racp_records_compare, (const void *)first_entry);
+                if (db_first()) {
+                        db_remove_first();
                         db_data.status = GLS_RACP_RESPONSE_SUCCESS;
                 }
-        }
                 break;
 #endif
 #if GLS_RACP_OPERATOR_LAST_RECORD_SUPPORT
         case GLS_RACP_OPERATOR_LAST_RECORD:
-        {
-                app_db_record_entry_t *last_entry;
-
-                last_entry = list_peek_back(&gls_database_records);
-                if (last_entry) {
-                        list_remove(&gls_database_records, racp_records_compare, (const void *)last_entry);
+                if (db_last()) {
+                        db_remove_last();
                         db_data.status = GLS_RACP_RESPONSE_SUCCESS;
                 }
-        }
                 break;
 #endif
         default:
                 /* The rest operators require parsing the database records */
-                list_filter(&gls_database_records, racp_delete_records_foreach_cb,
-                                                        (const void *)&db_data);
+                db_filter(racp_delete_records_foreach_cb, (const void *)&db_data);
                 break;
         }
 
@@ -37,6 +37,86 @@
 
 #include "glucose_service.h"
 
+/*
+ * Max number of records supported by database. As per GLS specifications,
+ * if the max. storage capacity is reached, the oldest record should
+ * be overwritten.
+ */
+#ifndef APP_DB_MAX_LIST_LEN
+#define APP_DB_MAX_LIST_LEN      10
+#endif
+
+/*
+ * If set, the database keeps track of the most recent record reported to each bonded collector
+ * (sync cursor). Once a bonded collector re-enables notifications upon reconnection, only records
+ * newer than its sync cursor are notified instead of the whole database.
+ */
+#ifndef APP_DB_SYNC_CURSOR_SUPPORT
+#define APP_DB_SYNC_CURSOR_SUPPORT      ( 0 )
+#endif
+
+/* Delay before retrying to notify a record to a collector whose TX queue is full, in ms */
+#ifndef APP_DB_NOTIFY_RETRY_MS
+#define APP_DB_NOTIFY_RETRY_MS          ( 10 )
+#endif
+
+/*
+ * If set, the CPU cycles spent per attempt to notify the records reported as response to RACP
+ * requests are measured (using the DWT cycle counter) and printed once the request has been
+ * serviced. Attempts that fail because the TX queue is full are counted separately.
+ */
+#ifndef APP_DB_PROFILING_ENABLE
+#define APP_DB_PROFILING_ENABLE         ( 0 )
+#endif
+
+/*
+ * If set, records are stored in a statically allocated ring using a compact delta encoding
+ * (sequence number, time offset and concentration are stored relative to the previous record)
+ * instead of a heap-allocated list. Fields that rarely change (flags, type, location, context info)
+ * are kept once in a shared annex. Storage capacity per byte of RAM is increased significantly
+ * while the records reported to collectors remain identical.
+ */
+#ifndef APP_DB_COMPACT_STORAGE
+#define APP_DB_COMPACT_STORAGE          ( 0 )
+#endif
+
+/*
+ * If set, the SN counter is checkpointed in the 'ble_app' NVPARAM area so that SNs keep increasing
+ * across device resets. Instead of storing the counter for each record, a lease of
+ * APP_DB_SN_LEASE_SIZE SNs is reserved in advance and the checkpoint is only updated once the lease
+ * has been consumed. Following a reset, numbering resumes from the end of the last lease and so up to
+ * APP_DB_SN_LEASE_SIZE SNs might be skipped but never reused.
+ */
+#ifndef APP_DB_SN_PERSISTENCE
+#define APP_DB_SN_PERSISTENCE           ( 0 )
+#endif
+
+/*
+ * Sync cursors are kept in bond storage and so they survive a reset; SNs should never be reused
+ * after a reset, otherwise new records would compare as already reported to bonded collectors.
+ */
+#if APP_DB_SYNC_CURSOR_SUPPORT && !APP_DB_SN_PERSISTENCE
+#error "APP_DB_SYNC_CURSOR_SUPPORT requires APP_DB_SN_PERSISTENCE"
+#endif
+
+#ifndef APP_DB_SN_LEASE_SIZE
+#define APP_DB_SN_LEASE_SIZE            ( 64 )
+#endif
+
+/*
+ * If set, the base time and time offset of records are derived from the RTC, which keeps running
+ * across device resets. The RTC is initialized to the APP_DB_BASE_TIME_xxx values on power-up. The
+ * base time is moved forward in steps of APP_DB_BASE_TIME_STEP_MIN minutes so that time offsets always
+ * fit in their 16-bit field. Requires dg_configUSE_HW_RTC.
+ */
+#ifndef APP_DB_RTC_BASE_TIME
+#define APP_DB_RTC_BASE_TIME            ( 0 )
+#endif
+
+#ifndef APP_DB_BASE_TIME_STEP_MIN
+#define APP_DB_BASE_TIME_STEP_MIN       ( 16384 )
+#endif
+
 /* Structure holding the record element in the list database. */
 typedef struct {
         /* Should always be the first element; will be used by the list framework internally. */
@@ -60,16 +140,16 @@ typedef struct {
         uint8_t status;
         uint8_t command;
         uint16_t num_of_records;
+#if APP_DB_SYNC_CURSOR_SUPPORT
+        uint16_t last_reported_sn;
+#endif
 } app_db_data_t;
 
-/*
- * Max number of records supported by database. As per GLS specifications,
- * if the max. storage capacity is reached, the oldest record should
- * be overwritten.
- */
-#ifndef APP_DB_MAX_LIST_LEN
-#define APP_DB_MAX_LIST_LEN      10
-#endif
+/* Counters reflecting the records handled by the per-bond record sync procedure. */
+typedef struct {
+        uint32_t served;        /* Records notified because they were newer than the peer's sync cursor */
+        uint32_t skipped;       /* Records not notified because they had already been reported to the peer */
+} app_db_sync_stats_t;
 
 /*
  * Base time is typically set at the time of manufacturing or upon first use
@@ -123,8 +203,10 @@ void app_db_init(void);
  *
  * \param [in] cb  callback function so application can initialize the reserved record memory area.
  *
+ * \return True if the record has been stored, false if it has been rejected; either no memory could
+ *         be allocated or, with APP_DB_COMPACT_STORAGE, the annex table is full.
  */
-void app_db_add_record_entry(app_db_add_record_entry_cb_t cb);
+bool app_db_add_record_entry(app_db_add_record_entry_cb_t cb);
 
 /*
  * Function to be called by application when a RACP user callback function is called. This
@@ -163,6 +245,18 @@ void app_db_update_racp_request(ble_service_t *svc, uint16_t conn_idx, uint8_t c
  */
 void app_db_report_num_of_records_handle(void);
 
+/*
+ * Function to get the number of stored records that match the criteria of a RACP request, as parsed
+ * by \sa gls_racp_parse. Unlike \sa app_db_report_num_of_records_handle, the request is not bound to
+ * any collector and the result is returned to the caller instead of being indicated. It can be used
+ * to query the database locally, e.g. to validate or benchmark the database.
+ *
+ * \param [in] record      pointer to the operator and operand of the request
+ *
+ * \return The number of matching records.
+ */
+uint16_t app_db_query_num_of_records(const gls_racp_t *record);
+
 /*
  * Function to be called by application when a report RACP request has been received
  * through the \sa report_records registered callback function.
@@ -198,10 +292,44 @@ void app_db_delete_records_handle(void);
 
 /*
  * Function to get a unique sequence number. This function should be called by application to initialize
- * the SN entry of a newly reserved record via \sa app_db_add_record_entry. If NVMS support is in place,
- * the SN value is stored so continuum is preserved across device reboots as suggested by GLS
- * specifications.
+ * the SN entry of a newly reserved record via \sa app_db_add_record_entry. If APP_DB_SN_PERSISTENCE is set,
+ * the SN value is checkpointed so continuum is preserved across device reboots as suggested by GLS
+ * specifications. As mandated by GLS specifications SNs do not roll over; once the max. value (0xFFFF) is
+ * reached, it is assigned to all subsequent records.
  */
 uint16_t app_db_get_sequence_number(void);
 
+#if APP_DB_RTC_BASE_TIME
+/*
+ * Function to get the base time and time offset, in minutes, that should be assigned to a newly
+ * reserved record via \sa app_db_add_record_entry, as derived from the current RTC value.
+ *
+ * \param [out] base_time     base time of the record
+ * \param [out] time_offset   time offset of the record
+ */
+void app_db_get_record_time(gls_base_user_facing_time_t *base_time, int16_t *time_offset);
+#endif /* APP_DB_RTC_BASE_TIME */
+
+#if APP_DB_SYNC_CURSOR_SUPPORT
+/*
+ * Function to be called by application when a bonded collector is ready to receive records, typically
+ * after notifications have been enabled upon reconnection (\sa ccc_enabled callback). Only the records
+ * that are newer than the sync cursor of the collector are notified and the cursor is updated accordingly.
+ * The cursor is also updated each time records are reported as response to RACP requests. If notifications
+ * are not enabled for all the required characteristics or the collector is not bonded, the function
+ * returns immediately.
+ *
+ * \param [in] svc         glucose database instance
+ * \param [in] conn_idx    connection index indicating the collector
+ */
+void app_db_sync_records_handle(ble_service_t *svc, uint16_t conn_idx);
+
+/*
+ * Get the number of records served and skipped by the record sync procedure since boot.
+ *
+ * \param [out] stats      pointer to the structure the counters should be copied to
+ */
+void app_db_get_sync_stats(app_db_sync_stats_t *stats);
+#endif /* APP_DB_SYNC_CURSOR_SUPPORT */
+
 #endif /* SRC_GLUCOSE_SENSOR_DATABASE_H_ */
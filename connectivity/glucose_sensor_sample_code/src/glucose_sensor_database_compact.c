@@ -0,0 +1,395 @@
+/**
+ ****************************************************************************************
+ *
+ * @file glucose_sensor_database_compact.c
+ *
+ * @brief Compact storage backend of the glucose sensor database
+ *
+ * Copyright (C) 2015-2023 Renesas Electronics Corporation and/or its affiliates.
+ * All rights reserved. Confidential Information.
+ *
+ * This software ("Software") is supplied by Renesas Electronics Corporation and/or its
+ * affiliates ("Renesas"). Renesas grants you a personal, non-exclusive, non-transferable,
+ * revocable, non-sub-licensable right and license to use the Software, solely if used in
+ * or together with Renesas products. You may make copies of this Software, provided this
+ * copyright notice and disclaimer ("Notice") is included in all such copies. Renesas
+ * reserves the right to change or discontinue the Software at any time without notice.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS". RENESAS DISCLAIMS ALL WARRANTIES OF ANY KIND,
+ * WHETHER EXPRESS, IMPLIED, OR STATUTORY, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT. TO THE
+ * MAXIMUM EXTENT PERMITTED UNDER LAW, IN NO EVENT SHALL RENESAS BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, SPECIAL, INCIDENTAL OR CONSEQUENTIAL DAMAGES ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE, EVEN IF RENESAS HAS BEEN ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGES. USE OF THIS SOFTWARE MAY BE SUBJECT TO TERMS AND CONDITIONS CONTAINED IN
+ * AN ADDITIONAL AGREEMENT BETWEEN YOU AND RENESAS. IN CASE OF CONFLICT BETWEEN THE TERMS
+ * OF THIS NOTICE AND ANY SUCH ADDITIONAL LICENSE AGREEMENT, THE TERMS OF THE AGREEMENT
+ * SHALL TAKE PRECEDENCE. BY CONTINUING TO USE THIS SOFTWARE, YOU AGREE TO THE TERMS OF
+ * THIS NOTICE.IF YOU DO NOT AGREE TO THESE TERMS, YOU ARE NOT PERMITTED TO USE THIS
+ * SOFTWARE.
+ *
+ ****************************************************************************************
+ */
+#include <stdbool.h>
+#include <string.h>
+#include "osal.h"
+#include "glucose_sensor_database.h"
+#include "glucose_sensor_database_compact.h"
+
+#if APP_DB_COMPACT_STORAGE
+
+#if APP_DB_PROFILING_ENABLE
+#include "sdk_defs.h"
+#include "misc.h"
+#endif
+
+/* The annex of the entry differs from that of the previous entry */
+#define COMPACT_FLAG_ANNEX              (1 << 0)
+
+#if GLS_FLAGS_CONCENTRATION_TYPE_SAMPLE_LOCATION
+#define COMPACT_MANTISSA_MASK           ( 0x0FFF )
+#define COMPACT_FLAGS_POS               ( 12 )
+#else
+#define COMPACT_FLAGS_POS               ( 0 )
+#endif
+
+/* Compact record entry */
+typedef struct __packed {
+        uint16_t sn_delta;      /* SN delta from the previous record */
+        uint16_t time_delta;    /* Time offset delta from the previous record */
+#if GLS_FLAGS_CONCENTRATION_TYPE_SAMPLE_LOCATION
+        uint16_t value;         /* Concentration mantissa (bits 0-11) and COMPACT_FLAG_xxx flags (bits 12-15) */
+#else
+        uint8_t value;          /* COMPACT_FLAG_xxx flags */
+#endif
+} compact_entry_t;
+
+typedef struct {
+        uint16_t head;          /* Index of the oldest entry */
+        uint16_t count;         /* Number of stored entries */
+        uint16_t annex_head;    /* Index of the annex of the oldest entry */
+        uint16_t annex_count;   /* Number of annexes referenced by the stored entries */
+        uint16_t first_sn;      /* SN of the oldest record */
+        int16_t first_time;     /* Time offset of the oldest record */
+        uint16_t last_sn;       /* SN of the most recent record */
+        int16_t last_time;      /* Time offset of the most recent record */
+} compact_state_t;
+
+/* Structure used to traverse the stored records */
+typedef struct {
+        uint16_t pos;
+        uint16_t count;
+        int annex_pos;
+        uint16_t sn;
+        int16_t time;
+        const gls_record_t *annex;
+} compact_cursor_t;
+
+__RETAINED static compact_entry_t entries[APP_DB_MAX_LIST_LEN];
+__RETAINED static gls_record_t annexes[APP_DB_COMPACT_ANNEX_MAX];
+__RETAINED static compact_state_t state;
+
+/* Scratch entry records are decoded into */
+__RETAINED static app_db_record_entry_t scratch;
+
+static inline uint8_t entry_flags(const compact_entry_t *entry)
+{
+        return entry->value >> COMPACT_FLAGS_POS;
+}
+
+static inline void entry_set_flags(compact_entry_t *entry, uint8_t flags)
+{
+        entry->value |= flags << COMPACT_FLAGS_POS;
+}
+
+static inline compact_entry_t *entry_at(uint16_t pos)
+{
+        return &entries[(state.head + pos) % APP_DB_MAX_LIST_LEN];
+}
+
+static inline gls_record_t *annex_at(uint16_t pos)
+{
+        return &annexes[(state.annex_head + pos) % APP_DB_COMPACT_ANNEX_MAX];
+}
+
+/* Strip the fields that are stored per record so that only the annex remains */
+static void record_to_annex(const gls_record_t *record, gls_record_t *annex)
+{
+        *annex = *record;
+
+        annex->measurement.seq_number = 0;
+        annex->measurement.time_offset = 0;
+#if GLS_FLAGS_CONCENTRATION_TYPE_SAMPLE_LOCATION
+        annex->measurement.concentration &= ~COMPACT_MANTISSA_MASK;
+#endif
+#if GLS_FLAGS_CONTEXT_INFORMATION
+        annex->context.seq_number = 0;
+#endif
+}
+
+static void drop_first(void)
+{
+        compact_entry_t *next;
+
+        if (state.count <= 1) {
+                state.count = 0;
+                state.annex_count = 0;
+                return;
+        }
+
+        next = entry_at(1);
+
+        state.first_sn += next->sn_delta;
+        state.first_time += next->time_delta;
+
+        /* The oldest entry should always point to its annex */
+        if (entry_flags(next) & COMPACT_FLAG_ANNEX) {
+                state.annex_head = (state.annex_head + 1) % APP_DB_COMPACT_ANNEX_MAX;
+                state.annex_count--;
+        } else {
+                entry_set_flags(next, COMPACT_FLAG_ANNEX);
+        }
+
+        next->sn_delta = 0;
+        next->time_delta = 0;
+
+        state.head = (state.head + 1) % APP_DB_MAX_LIST_LEN;
+        state.count--;
+}
+
+/* Dropping the oldest record also releases its annex, i.e. no other record refers to it */
+static bool first_annex_exclusive(void)
+{
+        return state.count == 1 || (entry_flags(entry_at(1)) & COMPACT_FLAG_ANNEX);
+}
+
+static bool encode(const gls_record_t *record)
+{
+        gls_record_t annex;
+        compact_entry_t *entry;
+        bool new_annex;
+        bool full = (state.count == APP_DB_MAX_LIST_LEN);
+
+        record_to_annex(record, &annex);
+
+        new_annex = !state.count || memcmp(&annex, annex_at(state.annex_count - 1), sizeof(annex));
+
+        /*
+         * Only the oldest record is overwritten once the storage capacity is reached, as per GLS
+         * specifications; records are never dropped to make room in the annex table.
+         */
+        if (new_annex && state.annex_count == APP_DB_COMPACT_ANNEX_MAX && !(full && first_annex_exclusive())) {
+                return false;
+        }
+
+        if (full) {
+                drop_first();
+        }
+
+        entry = entry_at(state.count);
+        memset(entry, 0, sizeof(*entry));
+
+        if (state.count) {
+                entry->sn_delta = record->measurement.seq_number - state.last_sn;
+                entry->time_delta = record->measurement.time_offset - state.last_time;
+        } else {
+                state.first_sn = record->measurement.seq_number;
+                state.first_time = record->measurement.time_offset;
+                new_annex = true;
+        }
+
+#if GLS_FLAGS_CONCENTRATION_TYPE_SAMPLE_LOCATION
+        entry->value = record->measurement.concentration & COMPACT_MANTISSA_MASK;
+#endif
+
+        if (new_annex) {
+                *annex_at(state.annex_count) = annex;
+                state.annex_count++;
+                entry_set_flags(entry, COMPACT_FLAG_ANNEX);
+        }
+
+        state.last_sn = record->measurement.seq_number;
+        state.last_time = record->measurement.time_offset;
+        state.count++;
+
+        return true;
+}
+
+static void cursor_init(compact_cursor_t *cursor)
+{
+        cursor->pos = 0;
+        cursor->count = state.count;
+        cursor->annex_pos = -1;
+        cursor->sn = state.first_sn;
+        cursor->time = state.first_time;
+        cursor->annex = NULL;
+}
+
+static bool cursor_next(compact_cursor_t *cursor, app_db_record_entry_t *out)
+{
+        const compact_entry_t *entry;
+
+        if (cursor->pos >= cursor->count) {
+                return false;
+        }
+
+        entry = entry_at(cursor->pos);
+
+        if (cursor->pos) {
+                cursor->sn += entry->sn_delta;
+                cursor->time += entry->time_delta;
+        }
+
+        if (entry_flags(entry) & COMPACT_FLAG_ANNEX) {
+                cursor->annex = annex_at(++cursor->annex_pos);
+        }
+
+        out->next = NULL;
+        out->record = *cursor->annex;
+        out->record.measurement.seq_number = cursor->sn;
+        out->record.measurement.time_offset = cursor->time;
+#if GLS_FLAGS_CONCENTRATION_TYPE_SAMPLE_LOCATION
+        out->record.measurement.concentration |= entry->value & COMPACT_MANTISSA_MASK;
+#endif
+#if GLS_FLAGS_CONTEXT_INFORMATION
+        out->record.context.seq_number = cursor->sn;
+#endif
+
+        cursor->pos++;
+
+        return true;
+}
+
+void app_db_compact_init(void)
+{
+        memset(&state, 0, sizeof(state));
+}
+
+uint16_t app_db_compact_size(void)
+{
+        return state.count;
+}
+
+bool app_db_compact_append(const gls_record_t *record)
+{
+        ASSERT_WARNING(record);
+
+        return encode(record);
+}
+
+bool app_db_compact_get_first(app_db_record_entry_t *entry)
+{
+        compact_cursor_t cursor;
+
+        cursor_init(&cursor);
+
+        return cursor_next(&cursor, entry);
+}
+
+bool app_db_compact_get_last(app_db_record_entry_t *entry)
+{
+        const compact_entry_t *last;
+
+        if (!state.count) {
+                return false;
+        }
+
+        last = entry_at(state.count - 1);
+
+        entry->next = NULL;
+        entry->record = *annex_at(state.annex_count - 1);
+        entry->record.measurement.seq_number = state.last_sn;
+        entry->record.measurement.time_offset = state.last_time;
+#if GLS_FLAGS_CONCENTRATION_TYPE_SAMPLE_LOCATION
+        entry->record.measurement.concentration |= last->value & COMPACT_MANTISSA_MASK;
+#endif
+#if GLS_FLAGS_CONTEXT_INFORMATION
+        entry->record.context.seq_number = state.last_sn;
+#endif
+
+        return true;
+}
+
+void app_db_compact_remove_first(void)
+{
+        drop_first();
+}
+
+void app_db_compact_remove_last(void)
+{
+        const compact_entry_t *last;
+
+        if (!state.count) {
+                return;
+        }
+
+        last = entry_at(state.count - 1);
+
+        if (entry_flags(last) & COMPACT_FLAG_ANNEX) {
+                state.annex_count--;
+        }
+
+        /* Deltas allow the previous record to be restored without traversing the storage */
+        state.last_sn -= last->sn_delta;
+        state.last_time -= last->time_delta;
+        state.count--;
+}
+
+void app_db_compact_foreach(void (*cb)(const void *elem, const void *ud), const void *ud)
+{
+        compact_cursor_t cursor;
+#if APP_DB_PROFILING_ENABLE
+        uint32_t cycles = 0;
+        uint32_t start = DWT->CYCCNT;
+#endif
+
+        cursor_init(&cursor);
+
+        while (cursor_next(&cursor, &scratch)) {
+#if APP_DB_PROFILING_ENABLE
+                cycles += DWT->CYCCNT - start;
+#endif
+                cb(&scratch, ud);
+#if APP_DB_PROFILING_ENABLE
+                start = DWT->CYCCNT;
+#endif
+        }
+
+#if APP_DB_PROFILING_ENABLE
+        if (cursor.count) {
+                DBG_PRINTF("Decoded records: %u, cycles/record: %lu\n\r", cursor.count,
+                                                        (unsigned long)(cycles / cursor.count));
+        }
+#endif
+}
+
+void app_db_compact_filter(bool (*match)(const void *elem, const void *ud), const void *ud)
+{
+        compact_cursor_t cursor;
+
+        cursor_init(&cursor);
+
+        /*
+         * Re-encode the remaining records in place. Entries and annexes are never written
+         * ahead of the position they are decoded from.
+         */
+        state.count = 0;
+        state.annex_count = 0;
+
+        while (cursor_next(&cursor, &scratch)) {
+                if (!match(&scratch, ud)) {
+                        bool stored __UNUSED;
+
+                        /* A subset of the records never requires more annexes than the whole */
+                        stored = encode(&scratch.record);
+                        ASSERT_WARNING(stored);
+                }
+        }
+}
+
+size_t app_db_compact_footprint(void)
+{
+        return sizeof(entries) + sizeof(annexes) + sizeof(state) + sizeof(scratch);
+}
+
+#endif /* APP_DB_COMPACT_STORAGE */
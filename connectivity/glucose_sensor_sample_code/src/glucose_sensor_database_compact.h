@@ -0,0 +1,114 @@
+/**
+ ****************************************************************************************
+ *
+ * @file glucose_sensor_database_compact.h
+ *
+ * @brief Compact storage backend of the glucose sensor database
+ *
+ * Copyright (C) 2015-2023 Renesas Electronics Corporation and/or its affiliates.
+ * All rights reserved. Confidential Information.
+ *
+ * This software ("Software") is supplied by Renesas Electronics Corporation and/or its
+ * affiliates ("Renesas"). Renesas grants you a personal, non-exclusive, non-transferable,
+ * revocable, non-sub-licensable right and license to use the Software, solely if used in
+ * or together with Renesas products. You may make copies of this Software, provided this
+ * copyright notice and disclaimer ("Notice") is included in all such copies. Renesas
+ * reserves the right to change or discontinue the Software at any time without notice.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS". RENESAS DISCLAIMS ALL WARRANTIES OF ANY KIND,
+ * WHETHER EXPRESS, IMPLIED, OR STATUTORY, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT. TO THE
+ * MAXIMUM EXTENT PERMITTED UNDER LAW, IN NO EVENT SHALL RENESAS BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, SPECIAL, INCIDENTAL OR CONSEQUENTIAL DAMAGES ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE, EVEN IF RENESAS HAS BEEN ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGES. USE OF THIS SOFTWARE MAY BE SUBJECT TO TERMS AND CONDITIONS CONTAINED IN
+ * AN ADDITIONAL AGREEMENT BETWEEN YOU AND RENESAS. IN CASE OF CONFLICT BETWEEN THE TERMS
+ * OF THIS NOTICE AND ANY SUCH ADDITIONAL LICENSE AGREEMENT, THE TERMS OF THE AGREEMENT
+ * SHALL TAKE PRECEDENCE. BY CONTINUING TO USE THIS SOFTWARE, YOU AGREE TO THE TERMS OF
+ * THIS NOTICE.IF YOU DO NOT AGREE TO THESE TERMS, YOU ARE NOT PERMITTED TO USE THIS
+ * SOFTWARE.
+ *
+ ****************************************************************************************
+ */
+
+#ifndef SRC_GLUCOSE_SENSOR_DATABASE_COMPACT_H_
+
+#define SRC_GLUCOSE_SENSOR_DATABASE_COMPACT_H_
+
+#include "glucose_sensor_database.h"
+
+#if APP_DB_COMPACT_STORAGE
+
+/*
+ * Compact storage of the glucose sensor database.
+ *
+ * Instead of allocating a full record entry per record, each record is stored as a fixed size
+ * entry that holds the SN and time offset deltas from the previous record and the mantissa of
+ * the glucose concentration. All the remaining record fields (flags, base time, type and sample
+ * location, status and context information), referred to as annex, typically change rarely and so
+ * they are stored in a separate, small, table only when they differ from those of the previous
+ * record. Records are decoded on demand while being traversed.
+ *
+ * Records are decoded exactly as stored. The concentration is stored as the 12-bit mantissa of its
+ * SFLOAT value, whereas the exponent is part of the annex, so a record with a different exponent
+ * requires a new annex. An entry takes 6 bytes against about 40 bytes for a list entry (27 bytes of
+ * record data, the list pointer and the heap block header), i.e. about 6 times as many records fit
+ * in the same RAM, as long as annex changes are rare.
+ */
+
+/*
+ * Max number of distinct annexes that can be referenced by the stored records. If a new annex
+ * is required and the table is full, the record is rejected (see app_db_compact_append()); only
+ * the oldest record, when the storage is full, is dropped to make room.
+ */
+#ifndef APP_DB_COMPACT_ANNEX_MAX
+#define APP_DB_COMPACT_ANNEX_MAX        ( 4 )
+#endif
+
+/* Initialize the compact storage. */
+void app_db_compact_init(void);
+
+/* Get the number of stored records. */
+uint16_t app_db_compact_size(void);
+
+/*
+ * Store a record. Records should be stored in chronological order. If the storage is full
+ * the oldest record is dropped.
+ *
+ * \param [in] record   record to be encoded and stored
+ *
+ * \return True if stored, false if the record requires a new annex and the annex table is full.
+ */
+bool app_db_compact_append(const gls_record_t *record);
+
+/*
+ * Decode the oldest (first) or the most recent (last) record.
+ *
+ * \param [out] entry   entry the decoded record should be copied to
+ *
+ * \return True if a record is stored, false otherwise.
+ */
+bool app_db_compact_get_first(app_db_record_entry_t *entry);
+bool app_db_compact_get_last(app_db_record_entry_t *entry);
+
+/* Remove the oldest (first) or the most recent (last) record. */
+void app_db_compact_remove_first(void);
+void app_db_compact_remove_last(void);
+
+/*
+ * Decode all stored records, in chronological order, and invoke the callback for each
+ * of them. The entry passed to the callback is valid only within the callback's context.
+ */
+void app_db_compact_foreach(void (*cb)(const void *elem, const void *ud), const void *ud);
+
+/*
+ * Decode all stored records and remove the ones for which the callback returns true.
+ */
+void app_db_compact_filter(bool (*match)(const void *elem, const void *ud), const void *ud);
+
+/* Get the RAM required to store the max. number of records (APP_DB_MAX_LIST_LEN). */
+size_t app_db_compact_footprint(void);
+
+#endif /* APP_DB_COMPACT_STORAGE */
+
+#endif /* SRC_GLUCOSE_SENSOR_DATABASE_COMPACT_H_ */
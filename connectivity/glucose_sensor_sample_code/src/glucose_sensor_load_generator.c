@@ -0,0 +1,382 @@
+/**
+ ****************************************************************************************
+ *
+ * @file glucose_sensor_load_generator.c
+ *
+ * @brief Glucose sensor database synthetic load generator
+ *
+ * Copyright (C) 2015-2023 Renesas Electronics Corporation and/or its affiliates.
+ * All rights reserved. Confidential Information.
+ *
+ * This software ("Software") is supplied by Renesas Electronics Corporation and/or its
+ * affiliates ("Renesas"). Renesas grants you a personal, non-exclusive, non-transferable,
+ * revocable, non-sub-licensable right and license to use the Software, solely if used in
+ * or together with Renesas products. You may make copies of this Software, provided this
+ * copyright notice and disclaimer ("Notice") is included in all such copies. Renesas
+ * reserves the right to change or discontinue the Software at any time without notice.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS". RENESAS DISCLAIMS ALL WARRANTIES OF ANY KIND,
+ * WHETHER EXPRESS, IMPLIED, OR STATUTORY, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT. TO THE
+ * MAXIMUM EXTENT PERMITTED UNDER LAW, IN NO EVENT SHALL RENESAS BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, SPECIAL, INCIDENTAL OR CONSEQUENTIAL DAMAGES ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE, EVEN IF RENESAS HAS BEEN ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGES. USE OF THIS SOFTWARE MAY BE SUBJECT TO TERMS AND CONDITIONS CONTAINED IN
+ * AN ADDITIONAL AGREEMENT BETWEEN YOU AND RENESAS. IN CASE OF CONFLICT BETWEEN THE TERMS
+ * OF THIS NOTICE AND ANY SUCH ADDITIONAL LICENSE AGREEMENT, THE TERMS OF THE AGREEMENT
+ * SHALL TAKE PRECEDENCE. BY CONTINUING TO USE THIS SOFTWARE, YOU AGREE TO THE TERMS OF
+ * THIS NOTICE.IF YOU DO NOT AGREE TO THESE TERMS, YOU ARE NOT PERMITTED TO USE THIS
+ * SOFTWARE.
+ *
+ ****************************************************************************************
+ */
+
+#include <stdbool.h>
+#include "osal.h"
+#include "ble_att.h"
+#include "ble_bufops.h"
+#include "sdk_defs.h"
+#include "misc.h"
+#include "glucose_service.h"
+#include "glucose_sensor_database.h"
+#include "glucose_sensor_load_generator.h"
+
+#if APP_DB_LOAD_GENERATOR_ENABLE
+
+/* Operand of the requests part of the RACP request mix */
+typedef enum {
+        LOAD_GEN_OPERAND_NONE,
+        LOAD_GEN_OPERAND_SN,
+        LOAD_GEN_OPERAND_SN_RANGE,
+} LOAD_GEN_OPERAND;
+
+typedef struct {
+        const char *name;
+        uint8_t operator;
+        uint8_t operand;
+} load_gen_request_t;
+
+/* Requests replayed against the database; operand values are selected at run time */
+static const load_gen_request_t request_mix[] = {
+        { "all",   GLS_RACP_OPERATOR_ALL_RECORDS,   LOAD_GEN_OPERAND_NONE     },
+        { ">=",    GLS_RACP_OPERATOR_GREATER_EQUAL, LOAD_GEN_OPERAND_SN       },
+#if GLS_RACP_OPERATOR_LESS_EQUAL_SUPPORT
+        { "<=",    GLS_RACP_OPERATOR_LESS_EQUAL,    LOAD_GEN_OPERAND_SN       },
+#endif
+#if GLS_RACP_OPERATOR_WITHIN_RANGE_SUPPORT
+        { "range", GLS_RACP_OPERATOR_WITHIN_RANGE,  LOAD_GEN_OPERAND_SN_RANGE },
+#endif
+#if GLS_RACP_OPERATOR_FIRST_RECORD_SUPPORT
+        { "first", GLS_RACP_OPERATOR_FIRST_RECORD,  LOAD_GEN_OPERAND_NONE     },
+#endif
+#if GLS_RACP_OPERATOR_LAST_RECORD_SUPPORT
+        { "last",  GLS_RACP_OPERATOR_LAST_RECORD,   LOAD_GEN_OPERAND_NONE     },
+#endif
+};
+
+/* Malformed requests along with the outcome expected by the RACP parser */
+static const struct {
+        uint8_t value[4];
+        uint8_t length;
+        att_error_t status;
+        uint8_t response;
+} malformed_requests[] = {
+        { { GLS_RACP_COMMAND_NUMBER_OF_RECORDS }, 1,
+                                ATT_ERROR_INVALID_VALUE_LENGTH, GLS_RACP_RESPONSE_RFU },
+        { { GLS_RACP_COMMAND_NUMBER_OF_RECORDS, GLS_RACP_OPERATOR_GREATER_EQUAL }, 2,
+                                ATT_ERROR_INVALID_VALUE_LENGTH, GLS_RACP_RESPONSE_RFU },
+        { { GLS_RACP_COMMAND_NUMBER_OF_RECORDS, GLS_RACP_OPERATOR_GREATER_EQUAL, GLS_RACP_FILTER_TYPE_SN, 0x00 }, 4,
+                                ATT_ERROR_INVALID_VALUE_LENGTH, GLS_RACP_RESPONSE_RFU },
+        { { GLS_RACP_COMMAND_NUMBER_OF_RECORDS, 0x7F }, 2,
+                                ATT_ERROR_OK, GLS_RACP_RESPONSE_UNSUPPORTED_OPERATOR },
+        { { GLS_RACP_COMMAND_NUMBER_OF_RECORDS, GLS_RACP_OPERATOR_GREATER_EQUAL, 0x7F }, 3,
+                                ATT_ERROR_OK, GLS_RACP_RESPONSE_UNSUPPORTED_OPERAND },
+        { { 0x7F, GLS_RACP_OPERATOR_ALL_RECORDS }, 2,
+                                ATT_ERROR_OK, GLS_RACP_RESPONSE_UNSUPPORTED_COMMAND },
+        { { GLS_RACP_COMMAND_ABORT_OPERATION, GLS_RACP_OPERATOR_ALL_RECORDS }, 2,
+                                ATT_ERROR_OK, GLS_RACP_RESPONSE_INVALID_OPERATOR },
+};
+
+/* Latency statistics per request type of the mix */
+typedef struct {
+        uint32_t requests;
+        uint32_t cycles;
+        uint32_t max_cycles;
+} load_gen_stats_t;
+
+__RETAINED static load_gen_stats_t stats[ARRAY_LENGTH(request_mix)];
+__RETAINED static uint32_t total_records;
+__RETAINED static uint32_t total_requests;
+__RETAINED static uint32_t mismatches;
+
+/* Max. SN value; SNs do not roll over */
+#define LOAD_GEN_SN_MAX         ( 0xFFFF )
+
+/*
+ * Reference model of the database; SNs of the records inserted by the load generator. As with
+ * the database, the oldest record is overwritten once the storage capacity is reached. SNs are
+ * derived by the model itself and kept as absolute 32-bit values, so that neither the database
+ * SN arithmetic nor 16-bit wrap-around is involved in the expected results.
+ */
+__RETAINED static uint32_t model_sn[APP_DB_MAX_LIST_LEN];
+__RETAINED static uint16_t model_head;
+__RETAINED static uint16_t model_count;
+/* SN expected for the next inserted record; set by the first record inserted */
+__RETAINED static uint32_t model_next_sn;
+__RETAINED static bool model_next_sn_valid;
+
+__RETAINED static uint32_t seed;
+__RETAINED static app_db_add_record_entry_cb_t record_cb;
+__RETAINED static uint16_t record_sn;
+
+static uint32_t load_gen_random(void)
+{
+        seed = seed * 1103515245 + 12345;
+
+        return seed >> 16;
+}
+
+static void model_insert(uint16_t seq_number)
+{
+        if (!model_next_sn_valid) {
+                model_next_sn = seq_number;
+                model_next_sn_valid = true;
+        } else if (seq_number != model_next_sn) {
+                DBG_PRINTF("Record SN %u, expected %lu\n\r", seq_number, (unsigned long)model_next_sn);
+                mismatches++;
+        }
+
+        if (model_count == APP_DB_MAX_LIST_LEN) {
+                model_head = (model_head + 1) % APP_DB_MAX_LIST_LEN;
+                model_count--;
+        }
+
+        model_sn[(model_head + model_count) % APP_DB_MAX_LIST_LEN] = model_next_sn;
+        model_count++;
+
+        /* Once the max. value is reached, it is assigned to all subsequent records */
+        if (model_next_sn < LOAD_GEN_SN_MAX) {
+                model_next_sn++;
+        }
+}
+
+static uint16_t model_query(uint8_t operator, uint32_t sn_min, uint32_t sn_max)
+{
+        uint16_t num = 0;
+        uint16_t i;
+
+        switch (operator) {
+        case GLS_RACP_OPERATOR_FIRST_RECORD:
+        case GLS_RACP_OPERATOR_LAST_RECORD:
+                return model_count ? 1 : 0;
+        default:
+                break;
+        }
+
+        for (i = 0; i < model_count; i++) {
+                uint32_t sn = model_sn[(model_head + i) % APP_DB_MAX_LIST_LEN];
+
+                switch (operator) {
+                case GLS_RACP_OPERATOR_ALL_RECORDS:
+                        num++;
+                        break;
+                case GLS_RACP_OPERATOR_GREATER_EQUAL:
+                        num += (sn >= sn_min);
+                        break;
+                case GLS_RACP_OPERATOR_LESS_EQUAL:
+                        num += (sn <= sn_max);
+                        break;
+                case GLS_RACP_OPERATOR_WITHIN_RANGE:
+                        num += (sn >= sn_min && sn <= sn_max);
+                        break;
+                default:
+                        break;
+                }
+        }
+
+        return num;
+}
+
+/*
+ * Select an SN operand. Mostly around the stored SNs so that boundaries and empty results are
+ * exercised, but also the extreme values and any value of the 16-bit range.
+ */
+static uint32_t select_sn(void)
+{
+        uint32_t sn;
+
+        switch (load_gen_random() % 8) {
+        case 0:
+                return 0;
+        case 1:
+                return LOAD_GEN_SN_MAX;
+        case 2:
+        case 3:
+                return load_gen_random() & LOAD_GEN_SN_MAX;
+        default:
+                break;
+        }
+
+        if (!model_count) {
+                return load_gen_random() & LOAD_GEN_SN_MAX;
+        }
+
+        sn = model_sn[(model_head + load_gen_random() % model_count) % APP_DB_MAX_LIST_LEN];
+        sn += load_gen_random() % 5;
+
+        /* Operands are limited to the SN range */
+        if (sn < 2) {
+                return 0;
+        }
+
+        return MIN(sn - 2, LOAD_GEN_SN_MAX);
+}
+
+static void load_gen_record_cb(gls_record_t * const record)
+{
+        record_cb(record);
+
+        record_sn = record->measurement.seq_number;
+}
+
+static void replay_request(uint8_t idx)
+{
+        const load_gen_request_t *req = &request_mix[idx];
+        gls_racp_request_t request;
+        uint8_t value[7];
+        uint8_t *ptr = value;
+        uint32_t sn_min = 0;
+        uint32_t sn_max = 0;
+        uint16_t expected;
+        uint16_t num;
+        uint32_t cycles;
+
+        put_u8_inc(&ptr, GLS_RACP_COMMAND_NUMBER_OF_RECORDS);
+        put_u8_inc(&ptr, req->operator);
+
+        switch (req->operand) {
+        case LOAD_GEN_OPERAND_SN:
+                sn_min = sn_max = select_sn();
+                put_u8_inc(&ptr, GLS_RACP_FILTER_TYPE_SN);
+                put_u16_inc(&ptr, (uint16_t)sn_min);
+                break;
+        case LOAD_GEN_OPERAND_SN_RANGE:
+                sn_min = select_sn();
+                sn_max = select_sn();
+                if (sn_min > sn_max) {
+                        uint32_t tmp = sn_min;
+
+                        sn_min = sn_max;
+                        sn_max = tmp;
+                }
+                put_u8_inc(&ptr, GLS_RACP_FILTER_TYPE_SN);
+                put_u16_inc(&ptr, (uint16_t)sn_min);
+                put_u16_inc(&ptr, (uint16_t)sn_max);
+                break;
+        default:
+                break;
+        }
+
+        expected = model_query(req->operator, sn_min, sn_max);
+
+        cycles = DWT->CYCCNT;
+
+        if (gls_racp_parse(value, ptr - value, &request) != ATT_ERROR_OK ||
+                                                request.response != GLS_RACP_RESPONSE_RFU) {
+                DBG_PRINTF("RACP %s: request rejected\n\r", req->name);
+                mismatches++;
+                return;
+        }
+
+        num = app_db_query_num_of_records(&request.record);
+
+        cycles = DWT->CYCCNT - cycles;
+
+        if (num != expected) {
+                DBG_PRINTF("RACP %s [%lu, %lu]: %u records, expected %u\n\r", req->name,
+                                (unsigned long)sn_min, (unsigned long)sn_max, num, expected);
+                mismatches++;
+        }
+
+        stats[idx].requests++;
+        stats[idx].cycles += cycles;
+        if (cycles > stats[idx].max_cycles) {
+                stats[idx].max_cycles = cycles;
+        }
+        total_requests++;
+}
+
+static void check_malformed_requests(void)
+{
+        gls_racp_request_t request;
+        att_error_t status;
+        uint8_t i;
+
+        for (i = 0; i < ARRAY_LENGTH(malformed_requests); i++) {
+                status = gls_racp_parse(malformed_requests[i].value, malformed_requests[i].length, &request);
+
+                if (status != malformed_requests[i].status ||
+                        (status == ATT_ERROR_OK && request.response != malformed_requests[i].response)) {
+                        DBG_PRINTF("RACP malformed request #%u: unexpected outcome\n\r", i);
+                        mismatches++;
+                }
+        }
+}
+
+void app_db_load_generator_init(void)
+{
+        /* Enable the DWT cycle counter */
+        CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+        DWT->CYCCNT = 0;
+        DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
+        seed = 1;
+
+        /* Records stored beforehand are not part of the reference model */
+        ASSERT_WARNING(model_count == 0);
+
+        check_malformed_requests();
+}
+
+uint32_t app_db_load_generator_get_mismatches(void)
+{
+        return mismatches;
+}
+
+void app_db_load_generator_run(app_db_add_record_entry_cb_t cb)
+{
+        uint8_t i, j;
+
+        ASSERT_WARNING(cb);
+
+        record_cb = cb;
+
+        for (i = 0; i < APP_DB_LOAD_GEN_RECORDS_PER_RUN; i++) {
+                /* Rejected records are not part of the reference model */
+                if (app_db_add_record_entry(load_gen_record_cb)) {
+                        model_insert(record_sn);
+                }
+        }
+        total_records += APP_DB_LOAD_GEN_RECORDS_PER_RUN;
+
+        for (j = 0; j < APP_DB_LOAD_GEN_MIX_REPEAT; j++) {
+                for (i = 0; i < ARRAY_LENGTH(request_mix); i++) {
+                        replay_request(i);
+                }
+        }
+
+        DBG_PRINTF("Load generator: %lu records inserted, %u stored, %lu requests, %lu mismatches, "
+                        "free heap: %u bytes\n\r", (unsigned long)total_records, model_count,
+                        (unsigned long)total_requests, (unsigned long)mismatches,
+                        (unsigned)OS_GET_FREE_HEAP_SIZE());
+
+        for (i = 0; i < ARRAY_LENGTH(request_mix); i++) {
+                if (stats[i].requests) {
+                        DBG_PRINTF("RACP %-5s: avg %lu, max %lu cycles\n\r", request_mix[i].name,
+                                (unsigned long)(stats[i].cycles / stats[i].requests),
+                                (unsigned long)stats[i].max_cycles);
+                }
+        }
+}
+
+#endif /* APP_DB_LOAD_GENERATOR_ENABLE */
@@ -0,0 +1,90 @@
+/**
+ ****************************************************************************************
+ *
+ * @file glucose_sensor_load_generator.h
+ *
+ * @brief Glucose sensor database synthetic load generator
+ *
+ * Copyright (C) 2015-2023 Renesas Electronics Corporation and/or its affiliates.
+ * All rights reserved. Confidential Information.
+ *
+ * This software ("Software") is supplied by Renesas Electronics Corporation and/or its
+ * affiliates ("Renesas"). Renesas grants you a personal, non-exclusive, non-transferable,
+ * revocable, non-sub-licensable right and license to use the Software, solely if used in
+ * or together with Renesas products. You may make copies of this Software, provided this
+ * copyright notice and disclaimer ("Notice") is included in all such copies. Renesas
+ * reserves the right to change or discontinue the Software at any time without notice.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS". RENESAS DISCLAIMS ALL WARRANTIES OF ANY KIND,
+ * WHETHER EXPRESS, IMPLIED, OR STATUTORY, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT. TO THE
+ * MAXIMUM EXTENT PERMITTED UNDER LAW, IN NO EVENT SHALL RENESAS BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, SPECIAL, INCIDENTAL OR CONSEQUENTIAL DAMAGES ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE, EVEN IF RENESAS HAS BEEN ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGES. USE OF THIS SOFTWARE MAY BE SUBJECT TO TERMS AND CONDITIONS CONTAINED IN
+ * AN ADDITIONAL AGREEMENT BETWEEN YOU AND RENESAS. IN CASE OF CONFLICT BETWEEN THE TERMS
+ * OF THIS NOTICE AND ANY SUCH ADDITIONAL LICENSE AGREEMENT, THE TERMS OF THE AGREEMENT
+ * SHALL TAKE PRECEDENCE. BY CONTINUING TO USE THIS SOFTWARE, YOU AGREE TO THE TERMS OF
+ * THIS NOTICE.IF YOU DO NOT AGREE TO THESE TERMS, YOU ARE NOT PERMITTED TO USE THIS
+ * SOFTWARE.
+ *
+ ****************************************************************************************
+ */
+
+#ifndef SRC_GLUCOSE_SENSOR_LOAD_GENERATOR_H_
+
+#define SRC_GLUCOSE_SENSOR_LOAD_GENERATOR_H_
+
+#include "glucose_sensor_database.h"
+
+/*
+ * If set, a synthetic load is applied to the database each time the application requests a new
+ * record: a burst of records is inserted and a mix of RACP requests is replayed against the database
+ * locally, that is without a collector being involved. The SNs of the inserted records and the number
+ * of matching records returned by the database are checked against a reference model and the latency
+ * of each request type and the memory occupied are printed. This allows database changes to be
+ * benchmarked and checked for regressions on the target or, via the build in the host folder, on a
+ * PC. Collector initiated record deletions are not reflected in the reference model and should be
+ * avoided while the load generator is enabled.
+ */
+#ifndef APP_DB_LOAD_GENERATOR_ENABLE
+#define APP_DB_LOAD_GENERATOR_ENABLE    ( 0 )
+#endif
+
+#if APP_DB_LOAD_GENERATOR_ENABLE
+
+/* Number of records inserted per run */
+#ifndef APP_DB_LOAD_GEN_RECORDS_PER_RUN
+#define APP_DB_LOAD_GEN_RECORDS_PER_RUN         ( 5 )
+#endif
+
+/* Number of times the RACP request mix is replayed per run */
+#ifndef APP_DB_LOAD_GEN_MIX_REPEAT
+#define APP_DB_LOAD_GEN_MIX_REPEAT              ( 4 )
+#endif
+
+/*
+ * Initialize the load generator. Should be called once, after the database has been initialized
+ * via \sa app_db_init.
+ */
+void app_db_load_generator_init(void);
+
+/*
+ * Apply one run of the synthetic load to the database and print the results.
+ *
+ * \param [in] cb  callback function used to initialize the inserted records; the SN of the records
+ *                 should be assigned via \sa app_db_get_sequence_number.
+ */
+void app_db_load_generator_run(app_db_add_record_entry_cb_t cb);
+
+/*
+ * Get the number of mismatches against the reference model found so far, including the
+ * malformed requests with an unexpected outcome.
+ *
+ * \return number of mismatches
+ */
+uint32_t app_db_load_generator_get_mismatches(void);
+
+#endif /* APP_DB_LOAD_GENERATOR_ENABLE */
+
+#endif /* SRC_GLUCOSE_SENSOR_LOAD_GENERATOR_H_ */
@@ -55,8 +55,10 @@
 #include "glucose_service.h"
 #include "svc_types.h"
 #include "misc.h"
+#include "ble_evt_pump.h"
 #include "gap.h"
 #include "glucose_sensor_database.h"
+#include "glucose_sensor_load_generator.h"
 
 /*
  * Notification bits reservation
@@ -70,6 +72,7 @@
 #define RACP_DELETE_RECORDS_NOTIF       (1 << 5)
 #define RACP_REPORT_RECORDS_NOTIF       (1 << 6)
 #define RACP_REPORT_NUM_NOTIF           (1 << 7)
+#define RECORD_SYNC_NOTIF               (1 << 8)
 
 /*
  * The maximum length of name in scan response
@@ -152,6 +155,9 @@ static const gap_adv_ad_struct_t adv_data[] = {
  * Store information about ongoing SUOTA.
  */
 __RETAINED_RW static bool suota_ongoing = false;
+
+/* SUOTA service, which handles the L2CAP events */
+__RETAINED static ble_service_t *suota;
 #endif
 
 __RETAINED static OS_TASK gls_task_h;
@@ -617,6 +623,15 @@ static void event_sent_cb(ble_service_t *svc, const ble_evt_gatts_event_sent_t *
 {
 }
 
+#if APP_DB_SYNC_CURSOR_SUPPORT
+static void ccc_enabled_cb(ble_service_t *svc, const ble_evt_gatts_write_req_t *evt)
+{
+        /* Records not yet reported to a bonded collector will be notified once all the required
+         * CCC descriptors are enabled. Defer the handling to the application's task context. */
+        OS_TASK_NOTIFY(gls_task_h, RECORD_SYNC_NOTIF, OS_NOTIFY_SET_BITS);
+}
+#endif
+
 #if GLS_FEATURE_INDICATION_PROPERTY
 static void get_features_cb(ble_service_t *svc, uint16_t conn_idx)
 {
@@ -626,6 +641,9 @@ static void get_features_cb(ble_service_t *svc, uint16_t conn_idx)
 
 __RETAINED_RW static gls_callbacks_t gls_callbacks = {
         .event_sent = event_sent_cb,
+#if APP_DB_SYNC_CURSOR_SUPPORT
+        .ccc_enabled = ccc_enabled_cb,
+#endif
 #if GLS_FEATURE_INDICATION_PROPERTY
         .get_features = get_features_cb,
 #endif
@@ -652,6 +670,13 @@ static void init_record_entry_cb(gls_record_t *record)
 
         record->measurement.seq_number = app_db_get_sequence_number();
 
+#if APP_DB_RTC_BASE_TIME
+        int16_t time_offset;
+
+        /* Base time and time offset reflect the current time as kept by the RTC */
+        app_db_get_record_time(&record->measurement.base_time, &time_offset);
+        record->measurement.time_offset = time_offset;
+#else
         /* Typically this value is fixed and does not change over the lifetime of the device unless a serious
          * malfunctions occurs. */
         record->measurement.base_time.year = APP_DB_BASE_TIME_YEAR;
@@ -665,6 +690,7 @@ static void init_record_entry_cb(gls_record_t *record)
          * translated in minutes. For demonstrated purposes this value matches
          * SN. */
         record->measurement.time_offset = record->measurement.seq_number;
+#endif
 
 #if GLS_FLAGS_CONCENTRATION_TYPE_SAMPLE_LOCATION
         /* Add arbitrary values */
@@ -746,12 +772,62 @@ static void init_record_entry_cb(gls_record_t *record)
 #endif /* GLS_FLAGS_CONTEXT_INFORMATION */
 }
 
+static void handle_ble_evt(ble_evt_hdr_t *hdr, void *user_data)
+{
+        /*
+         * First, the application needs to check if the event is handled by the
+         * ble_service framework. If it is not handled, the application may handle
+         * it by defining a case for it in the `switch ()` statement below. If the
+         * event is not handled by the application either, it is handled by the
+         * default event handler.
+         */
+        if (!ble_service_handle_event(hdr)) {
+                switch (hdr->evt_code) {
+                case BLE_EVT_GAP_CONNECTED:
+                        handle_evt_gap_connected((ble_evt_gap_connected_t *) hdr);
+                        break;
+                case BLE_EVT_GAP_DISCONNECTED:
+                        handle_evt_gap_disconnected((ble_evt_gap_disconnected_t *) hdr);
+                        break;
+                case BLE_EVT_GAP_ADV_COMPLETED:
+                        handle_evt_gap_adv_completed((ble_evt_gap_adv_completed_t *) hdr);
+                        break;
+                case BLE_EVT_GAP_PAIR_REQ:
+                        handle_evt_gap_pair_req((ble_evt_gap_pair_req_t *) hdr);
+                        break;
+                case BLE_EVT_GAP_PASSKEY_NOTIFY:
+                        handle_evt_gap_passkey_notify((ble_evt_gap_passkey_notify_t *) hdr);
+                        break;
+                case BLE_EVT_GAP_PAIR_COMPLETED:
+                        handle_evt_gap_pair_completed((ble_evt_gap_pair_completed_t *) hdr);
+                        break;
+#if (dg_configSUOTA_SUPPORT == 1)
+#if (dg_configBLE_2MBIT_PHY == 1)
+                case BLE_EVT_GAP_PHY_SET_COMPLETED:
+                        handle_ble_evt_gap_phy_set_completed((ble_evt_gap_phy_set_completed_t *) hdr);
+                        break;
+                case BLE_EVT_GAP_PHY_CHANGED:
+                        handle_ble_evt_gap_phy_changed((ble_evt_gap_phy_changed_t *) hdr);
+                        break;
+#endif /* (dg_configBLE_2MBIT_PHY == 1) */
+#endif /* (dg_configSUOTA_SUPPORT == 1) */
+#if dg_configSUOTA_SUPPORT && defined(SUOTA_PSM)
+                case BLE_EVT_L2CAP_CONNECTED:
+                case BLE_EVT_L2CAP_DISCONNECTED:
+                case BLE_EVT_L2CAP_DATA_IND:
+                        suota_l2cap_event(suota, hdr);
+                        break;
+#endif
+                default:
+                        ble_handle_event_default(hdr);
+                        break;
+                }
+        }
+}
+
 OS_TASK_FUNCTION(glucose_sensor_task, params)
 {
         int8_t wdog_id;
-#if dg_configSUOTA_SUPPORT
-        ble_service_t *suota;
-#endif
         ble_service_t *gls;
 
         uint16_t name_len;
@@ -830,6 +906,10 @@ OS_TASK_FUNCTION(glucose_sensor_task, params)
 
         app_db_init();
 
+#if APP_DB_LOAD_GENERATOR_ENABLE
+        app_db_load_generator_init();
+#endif
+
         OS_TIMER record_tim = OS_TIMER_CREATE("record", OS_MS_2_TICKS(GLS_DATABASE_UPDATE_MS),
                                                 OS_TIMER_SUCCESS, (void *) OS_GET_CURRENT_TASK(),
                                                 record_tim_cb);
@@ -873,75 +953,7 @@ OS_TASK_FUNCTION(glucose_sensor_task, params)
 
                 /* Notified from BLE manager? */
                 if (notif & BLE_APP_NOTIFY_MASK) {
-                        ble_evt_hdr_t *hdr;
-
-                        hdr = ble_get_event(false);
-                        if (!hdr) {
-                                goto no_event;
-                        }
-
-                        /*
-                         * First, the application needs to check if the event is handled by the
-                         * ble_service framework. If it is not handled, the application may handle
-                         * it by defining a case for it in the `switch ()` statement below. If the
-                         * event is not handled by the application either, it is handled by the
-                         * default event handler.
-                         */
-                        if (!ble_service_handle_event(hdr)) {
-                                switch (hdr->evt_code) {
-                                case BLE_EVT_GAP_CONNECTED:
-                                        handle_evt_gap_connected((ble_evt_gap_connected_t *) hdr);
-                                        break;
-                                case BLE_EVT_GAP_DISCONNECTED:
-                                        handle_evt_gap_disconnected((ble_evt_gap_disconnected_t *) hdr);
-                                        break;
-                                case BLE_EVT_GAP_ADV_COMPLETED:
-                                        handle_evt_gap_adv_completed((ble_evt_gap_adv_completed_t *) hdr);
-                                        break;
-                                case BLE_EVT_GAP_PAIR_REQ:
-                                        handle_evt_gap_pair_req((ble_evt_gap_pair_req_t *) hdr);
-                                        break;
-                                case BLE_EVT_GAP_PASSKEY_NOTIFY:
-                                        handle_evt_gap_passkey_notify((ble_evt_gap_passkey_notify_t *) hdr);
-                                        break;
-                                case BLE_EVT_GAP_PAIR_COMPLETED:
-                                        handle_evt_gap_pair_completed((ble_evt_gap_pair_completed_t *) hdr);
-                                        break;
-#if (dg_configSUOTA_SUPPORT == 1)
-#if (dg_configBLE_2MBIT_PHY == 1)
-                                case BLE_EVT_GAP_PHY_SET_COMPLETED:
-                                        handle_ble_evt_gap_phy_set_completed((ble_evt_gap_phy_set_completed_t *) hdr);
-                                        break;
-                                case BLE_EVT_GAP_PHY_CHANGED:
-                                        handle_ble_evt_gap_phy_changed((ble_evt_gap_phy_changed_t *) hdr);
-                                        break;
-#endif /* (dg_configBLE_2MBIT_PHY == 1) */
-#endif /* (dg_configSUOTA_SUPPORT == 1) */
-#if dg_configSUOTA_SUPPORT && defined(SUOTA_PSM)
-                                case BLE_EVT_L2CAP_CONNECTED:
-                                case BLE_EVT_L2CAP_DISCONNECTED:
-                                case BLE_EVT_L2CAP_DATA_IND:
-                                        suota_l2cap_event(suota, hdr);
-                                        break;
-#endif
-                                default:
-                                        ble_handle_event_default(hdr);
-                                        break;
-                                }
-                        }
-
-                        /* Free event buffer (it's not needed anymore) */
-                        OS_FREE(hdr);
-
-no_event:
-                        /*
-                         * If there are more events waiting in queue, application should process
-                         * them now.
-                         */
-                        if (ble_has_event()) {
-                                OS_TASK_NOTIFY(OS_GET_CURRENT_TASK(), BLE_APP_NOTIFY_MASK,
-                                                                                OS_NOTIFY_SET_BITS);
-                        }
+                        ble_evt_pump(OS_GET_CURRENT_TASK(), handle_ble_evt, NULL);
                 }
 
 #if GLS_FEATURE_INDICATION_PROPERTY
@@ -954,11 +966,17 @@ no_event:
 #endif
 
                 if (notif & RECORD_UPDATE_TMO_NOTIF) {
+#if APP_DB_LOAD_GENERATOR_ENABLE
+                        app_db_load_generator_run(init_record_entry_cb);
+#else
                         /*
                          * No callback is used here; record entries will be initialized
                          * internally using arbitrary values.
                          */
-                        app_db_add_record_entry(init_record_entry_cb);
+                        if (!app_db_add_record_entry(init_record_entry_cb)) {
+                                DBG_PRINTF("Record rejected\r\n");
+                        }
+#endif
                 }
 
                 /* The number of records might be long enough to timeout WDOG. */
@@ -972,6 +990,29 @@ no_event:
                         app_db_delete_records_handle();
                 }
 
+#if APP_DB_SYNC_CURSOR_SUPPORT
+                if (notif & RECORD_SYNC_NOTIF) {
+                        uint8_t num_conn;
+                        uint16_t *conn_idx;
+                        app_db_sync_stats_t stats;
+
+                        ble_gap_get_connected(&num_conn, &conn_idx);
+
+                        /* Collectors that have already been synced will be skipped */
+                        while (num_conn--) {
+                                app_db_sync_records_handle(gls, conn_idx[num_conn]);
+                        }
+
+                        if (conn_idx) {
+                                OS_FREE(conn_idx);
+                        }
+
+                        app_db_get_sync_stats(&stats);
+                        DBG_PRINTF("Record sync, served: %" PRIu32 ", skipped: %" PRIu32 "\n\r",
+                                                                        stats.served, stats.skipped);
+                }
+#endif
+
                 sys_watchdog_notify_and_resume(wdog_id);
 
                 if (notif & RACP_REPORT_NUM_NOTIF) {
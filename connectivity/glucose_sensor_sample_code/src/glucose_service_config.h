@@ -54,4 +54,7 @@
 
 #define APP_DB_MAX_LIST_LEN                              50
 
+#define APP_DB_SYNC_CURSOR_SUPPORT                       ( 1 )
+#define APP_DB_SN_PERSISTENCE                            ( 1 )
+
 #endif /* GLUCOSE_SERVICE_CONFIG_H_ */
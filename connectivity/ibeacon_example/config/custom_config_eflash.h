@@ -61,6 +61,17 @@
 #define dg_configNVMS_VES                       ( 0 )
 #define dg_configNVPARAM_ADAPTER                ( 1 )
 
+/*
+ * Fill the Eddystone-TLM frame with the battery voltage and the die temperature (GPADC), the time
+ * since power-up and the advertising count. If 0 the frame is static, which gives the baseline
+ * when measuring the current.
+ */
+#define BEACON_TELEMETRY_EN                     ( 1 )
+#if BEACON_TELEMETRY_EN
+#define dg_configGPADC_ADAPTER                  ( 1 )
+#define dg_configGPADC_DMA_SUPPORT              ( 0 )
+#endif
+
 
 /*************************************************************************************************\
  * BLE configuration
@@ -72,6 +83,15 @@
 #define dg_configBLE_BROADCASTER                ( 0 )
 #define dg_configBLE_L2CAP_COC                  ( 0 )
 
+/*
+ * Measure the CPU cycles spent switching advertising frames and print them, over the UART, after
+ * each rotation (see adv_rotation.h). It should be disabled when measuring the current.
+ */
+#define ADV_ROTATION_STATS_EN                   ( 0 )
+#if ADV_ROTATION_STATS_EN
+#define CONFIG_RETARGET
+#endif
+
 /* Include bsp default values */
 #include "bsp_defaults.h"
 /* Include middleware default values */
@@ -0,0 +1,253 @@
+/**
+ ****************************************************************************************
+ *
+ * @file host_stubs.c
+ *
+ * @brief OS and BLE stubs of the iBeacon host build
+ *
+ * Copyright (C) 2024 Renesas Electronics Corporation and/or its affiliates.
+ * All rights reserved. Confidential Information.
+ *
+ * This software ("Software") is supplied by Renesas Electronics Corporation and/or its
+ * affiliates ("Renesas"). Renesas grants you a personal, non-exclusive, non-transferable,
+ * revocable, non-sub-licensable right and license to use the Software, solely if used in
+ * or together with Renesas products. You may make copies of this Software, provided this
+ * copyright notice and disclaimer ("Notice") is included in all such copies. Renesas
+ * reserves the right to change or discontinue the Software at any time without notice.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS". RENESAS DISCLAIMS ALL WARRANTIES OF ANY KIND,
+ * WHETHER EXPRESS, IMPLIED, OR STATUTORY, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT. TO THE
+ * MAXIMUM EXTENT PERMITTED UNDER LAW, IN NO EVENT SHALL RENESAS BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, SPECIAL, INCIDENTAL OR CONSEQUENTIAL DAMAGES ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE, EVEN IF RENESAS HAS BEEN ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGES. USE OF THIS SOFTWARE MAY BE SUBJECT TO TERMS AND CONDITIONS CONTAINED IN
+ * AN ADDITIONAL AGREEMENT BETWEEN YOU AND RENESAS. IN CASE OF CONFLICT BETWEEN THE TERMS
+ * OF THIS NOTICE AND ANY SUCH ADDITIONAL LICENSE AGREEMENT, THE TERMS OF THE AGREEMENT
+ * SHALL TAKE PRECEDENCE. BY CONTINUING TO USE THIS SOFTWARE, YOU AGREE TO THE TERMS OF
+ * THIS NOTICE.IF YOU DO NOT AGREE TO THESE TERMS, YOU ARE NOT PERMITTED TO USE THIS
+ * SOFTWARE.
+ *
+ ****************************************************************************************
+ */
+
+#include <time.h>
+#include "osal.h"
+#include "ble_gap.h"
+#include "ad_gpadc.h"
+#include "host_stubs.h"
+
+/* Cycles are nanoseconds of the host monotonic clock */
+uint32_t SystemCoreClock = 1000000000;
+
+static uint32_t now_ms;
+static uint32_t asserts;
+
+static DWT_Type dwt;
+CoreDebug_Type host_core_debug;
+
+static uint32_t task_notif;
+
+static host_timer_cb_t timer_cb;
+static OS_TICK_TIME timer_period;
+static bool timer_created;
+
+static host_adv_t adv;
+
+static host_gpadc_t gpadc;
+static const ad_gpadc_controller_conf_t *gpadc_conf;
+
+/*********************************** Harness services ***************************************/
+
+void host_assert_failed(const char *file, int line)
+{
+        asserts++;
+        fprintf(stderr, "Assertion failed: %s:%d\n", file, line);
+}
+
+uint32_t host_assert_count(void)
+{
+        return asserts;
+}
+
+void host_advance_ms(uint32_t ms)
+{
+        now_ms += ms;
+}
+
+const host_adv_t *host_adv(void)
+{
+        return &adv;
+}
+
+void host_adv_reset(void)
+{
+        memset(&adv, 0, sizeof(adv));
+        timer_period = 0;
+}
+
+const host_gpadc_t *host_gpadc(void)
+{
+        return &gpadc;
+}
+
+bool host_adv_take_completed(void)
+{
+        bool completed = adv.stop_pending;
+
+        adv.stop_pending = false;
+        return completed;
+}
+
+OS_TICK_TIME host_timer_period(void)
+{
+        return timer_period;
+}
+
+void host_timer_expire(void)
+{
+        OS_TICK_TIME period = timer_period;
+
+        ASSERT_WARNING(period);
+
+        /* One-shot timer */
+        timer_period = 0;
+        now_ms += period;
+        timer_cb(&timer_created);
+}
+
+uint32_t host_task_take_notif(void)
+{
+        uint32_t notif = task_notif;
+
+        task_notif = 0;
+        return notif;
+}
+
+/************************************* OS layer *********************************************/
+
+OS_TICK_TIME host_get_tick_count(void)
+{
+        return now_ms;
+}
+
+void host_task_notify(OS_TASK task, uint32_t value)
+{
+        task_notif |= value;
+}
+
+OS_TIMER host_timer_create(OS_TICK_TIME period, host_timer_cb_t cb)
+{
+        /* A single timer; created stopped */
+        ASSERT_WARNING(!timer_created);
+
+        timer_created = true;
+        timer_cb = cb;
+        return &timer_created;
+}
+
+void host_timer_change_period(OS_TIMER timer, OS_TICK_TIME period)
+{
+        timer_period = period;
+}
+
+DWT_Type *host_dwt(void)
+{
+        struct timespec ts;
+
+        clock_gettime(CLOCK_MONOTONIC, &ts);
+        dwt.CYCCNT = (uint32_t)((uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec);
+        return &dwt;
+}
+
+/*************************************** BLE ************************************************/
+
+ble_error_t ble_gap_adv_intv_set(uint16_t adv_intv_min, uint16_t adv_intv_max)
+{
+        ASSERT_WARNING(adv_intv_min == adv_intv_max);
+
+        adv.interval_set = adv_intv_min;
+        return BLE_STATUS_OK;
+}
+
+ble_error_t ble_gap_adv_data_set(uint8_t adv_data_len, const uint8_t *adv_data,
+                                 uint8_t scan_rsp_data_len, const uint8_t *scan_rsp_data)
+{
+        adv.data = adv_data;
+        adv.num_of_data_sets++;
+        return BLE_STATUS_OK;
+}
+
+ble_error_t ble_gap_adv_start(gap_conn_mode_t adv_type)
+{
+        if (adv.active || adv.stop_pending) {
+                return BLE_ERROR_IN_PROGRESS;
+        }
+
+        adv.active = true;
+        adv.interval = adv.interval_set;
+        adv.num_of_starts++;
+        return BLE_STATUS_OK;
+}
+
+ble_error_t ble_gap_adv_stop(void)
+{
+        if (!adv.active) {
+                return BLE_ERROR_FAILED;
+        }
+
+        /* The completion event is delivered by the harness */
+        adv.active = false;
+        adv.stop_pending = true;
+        adv.num_of_stops++;
+        return BLE_STATUS_OK;
+}
+
+/************************************** GPADC ***********************************************/
+
+ad_gpadc_handle_t ad_gpadc_open(const ad_gpadc_controller_conf_t *conf)
+{
+        if (gpadc.open) {
+                return NULL;
+        }
+
+        gpadc.open = true;
+        gpadc.num_of_opens++;
+        gpadc_conf = conf;
+        return &gpadc;
+}
+
+int ad_gpadc_read_nof_conv(ad_gpadc_handle_t handle, int nof_conv, uint16_t *outbuf)
+{
+        if (!gpadc.open || (handle != &gpadc)) {
+                return AD_GPADC_ERROR_OTHER;
+        }
+
+        for (int i = 0; i < nof_conv; i++) {
+                outbuf[i] = (gpadc_conf->drv->positive == HW_GPADC_INP_VBAT) ? 3000 : 2500;
+        }
+
+        gpadc.num_of_conversions += nof_conv;
+        gpadc.num_of_samples += nof_conv << gpadc_conf->drv->oversampling;
+        return AD_GPADC_ERROR_NONE;
+}
+
+int ad_gpadc_close(ad_gpadc_handle_t handle, bool force)
+{
+        if (!gpadc.open || (handle != &gpadc)) {
+                return AD_GPADC_ERROR_OTHER;
+        }
+
+        gpadc.open = false;
+        return AD_GPADC_ERROR_NONE;
+}
+
+uint16_t ad_gpadc_conv_to_batt_mvolt(const ad_gpadc_driver_conf_t *drv, uint32_t value)
+{
+        return (uint16_t)value;
+}
+
+int32_t ad_gpadc_conv_to_temp_x100(const ad_gpadc_driver_conf_t *drv, uint16_t value)
+{
+        return value;
+}
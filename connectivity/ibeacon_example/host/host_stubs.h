@@ -0,0 +1,84 @@
+/**
+ ****************************************************************************************
+ *
+ * @file host_stubs.h
+ *
+ * @brief Services of the iBeacon host build stubs
+ *
+ * Copyright (C) 2024 Renesas Electronics Corporation and/or its affiliates.
+ * All rights reserved. Confidential Information.
+ *
+ * This software ("Software") is supplied by Renesas Electronics Corporation and/or its
+ * affiliates ("Renesas"). Renesas grants you a personal, non-exclusive, non-transferable,
+ * revocable, non-sub-licensable right and license to use the Software, solely if used in
+ * or together with Renesas products. You may make copies of this Software, provided this
+ * copyright notice and disclaimer ("Notice") is included in all such copies. Renesas
+ * reserves the right to change or discontinue the Software at any time without notice.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS". RENESAS DISCLAIMS ALL WARRANTIES OF ANY KIND,
+ * WHETHER EXPRESS, IMPLIED, OR STATUTORY, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT. TO THE
+ * MAXIMUM EXTENT PERMITTED UNDER LAW, IN NO EVENT SHALL RENESAS BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, SPECIAL, INCIDENTAL OR CONSEQUENTIAL DAMAGES ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE, EVEN IF RENESAS HAS BEEN ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGES. USE OF THIS SOFTWARE MAY BE SUBJECT TO TERMS AND CONDITIONS CONTAINED IN
+ * AN ADDITIONAL AGREEMENT BETWEEN YOU AND RENESAS. IN CASE OF CONFLICT BETWEEN THE TERMS
+ * OF THIS NOTICE AND ANY SUCH ADDITIONAL LICENSE AGREEMENT, THE TERMS OF THE AGREEMENT
+ * SHALL TAKE PRECEDENCE. BY CONTINUING TO USE THIS SOFTWARE, YOU AGREE TO THE TERMS OF
+ * THIS NOTICE.IF YOU DO NOT AGREE TO THESE TERMS, YOU ARE NOT PERMITTED TO USE THIS
+ * SOFTWARE.
+ *
+ ****************************************************************************************
+ */
+
+#ifndef HOST_STUBS_H_
+#define HOST_STUBS_H_
+
+#include "osal.h"
+
+/* Advertising as seen by the stack stubs */
+typedef struct {
+        bool active;                    /* Advertising started and not stopped */
+        bool stop_pending;              /* Stopped; BLE_EVT_GAP_ADV_COMPLETED not delivered yet */
+        uint16_t interval;              /* Interval advertising was started with */
+        uint16_t interval_set;          /* Interval set for the next start */
+        const uint8_t *data;            /* Advertising data in use */
+        uint32_t num_of_data_sets;
+        uint32_t num_of_starts;
+        uint32_t num_of_stops;
+} host_adv_t;
+
+/* GPADC use, as seen by the adapter stub */
+typedef struct {
+        bool open;                      /* Adapter open; the device cannot enter extended sleep */
+        uint32_t num_of_opens;
+        uint32_t num_of_conversions;
+        uint32_t num_of_samples;        /* Samples taken, including oversampling */
+} host_gpadc_t;
+
+/* Number of failed assertions so far */
+uint32_t host_assert_count(void);
+
+/* Advance the virtual time */
+void host_advance_ms(uint32_t ms);
+
+/* Advertising state of the stubs; reset by host_adv_reset() */
+const host_adv_t *host_adv(void);
+void host_adv_reset(void);
+
+/* GPADC use since start-up */
+const host_gpadc_t *host_gpadc(void);
+
+/* Deliver BLE_EVT_GAP_ADV_COMPLETED if advertising has been stopped; true if delivered */
+bool host_adv_take_completed(void);
+
+/* Period of the frame timer, or 0 if it is not running */
+OS_TICK_TIME host_timer_period(void);
+
+/* Expire the frame timer: advance the virtual time by its period and call its callback */
+void host_timer_expire(void);
+
+/* Notification bits set since the previous call */
+uint32_t host_task_take_notif(void);
+
+#endif /* HOST_STUBS_H_ */
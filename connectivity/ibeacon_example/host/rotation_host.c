@@ -0,0 +1,353 @@
+/**
+ ****************************************************************************************
+ *
+ * @file rotation_host.c
+ *
+ * @brief Host test and benchmark harness of the iBeacon frame rotation
+ *
+ * Copyright (C) 2024 Renesas Electronics Corporation and/or its affiliates.
+ * All rights reserved. Confidential Information.
+ *
+ * This software ("Software") is supplied by Renesas Electronics Corporation and/or its
+ * affiliates ("Renesas"). Renesas grants you a personal, non-exclusive, non-transferable,
+ * revocable, non-sub-licensable right and license to use the Software, solely if used in
+ * or together with Renesas products. You may make copies of this Software, provided this
+ * copyright notice and disclaimer ("Notice") is included in all such copies. Renesas
+ * reserves the right to change or discontinue the Software at any time without notice.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS". RENESAS DISCLAIMS ALL WARRANTIES OF ANY KIND,
+ * WHETHER EXPRESS, IMPLIED, OR STATUTORY, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT. TO THE
+ * MAXIMUM EXTENT PERMITTED UNDER LAW, IN NO EVENT SHALL RENESAS BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, SPECIAL, INCIDENTAL OR CONSEQUENTIAL DAMAGES ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE, EVEN IF RENESAS HAS BEEN ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGES. USE OF THIS SOFTWARE MAY BE SUBJECT TO TERMS AND CONDITIONS CONTAINED IN
+ * AN ADDITIONAL AGREEMENT BETWEEN YOU AND RENESAS. IN CASE OF CONFLICT BETWEEN THE TERMS
+ * OF THIS NOTICE AND ANY SUCH ADDITIONAL LICENSE AGREEMENT, THE TERMS OF THE AGREEMENT
+ * SHALL TAKE PRECEDENCE. BY CONTINUING TO USE THIS SOFTWARE, YOU AGREE TO THE TERMS OF
+ * THIS NOTICE.IF YOU DO NOT AGREE TO THESE TERMS, YOU ARE NOT PERMITTED TO USE THIS
+ * SOFTWARE.
+ *
+ ****************************************************************************************
+ */
+
+/*
+ * The frame rotation and the telemetry are built against the stub OS, GAP and GPADC layers of
+ * this directory. The harness plays the beacon task: it expires the frame timer, which advances
+ * the virtual time by the period of the frame, switches to the next frame when notified and
+ * delivers the completion of advertising when it has been stopped. The Eddystone-TLM frame
+ * samples the telemetry when switched in, as in the example. The DWT cycle counter reads the host
+ * monotonic clock, so the cycle figures are nanoseconds of host time, with the GAP calls and the
+ * GPADC conversions stubbed; all the other figures only depend on the frames and are the same on
+ * the target.
+ *
+ * bench: rotations of the frames of the example, and of frames with different intervals, with
+ *        the rotation statistics and the telemetry printed as the example does with
+ *        ADV_ROTATION_STATS_EN.
+ * check: the period of a rotation, the frame advertised after each switch, the switches that
+ *        only update the advertising data and those that restart advertising; the GPADC sampling
+ *        schedule and conversions.
+ */
+
+#include <inttypes.h>
+#include "osal.h"
+#include "adv_rotation.h"
+#include "telemetry.h"
+#include "host_stubs.h"
+
+/* Notification of the frame switch */
+#define HOST_ROTATION_NOTIF             ( 1 << 2 )
+
+/* Advertising intervals, in steps of 0.625 ms */
+#define HOST_INTERVAL_100_MS            ( 160 )
+#define HOST_INTERVAL_1000_MS           ( 1600 )
+
+/* Rotations of the benchmark and of the checks */
+#define HOST_BENCH_ROTATIONS            ( 10000 )
+#define HOST_CHECK_ROTATIONS            ( 16 )
+
+/* Rotations of the telemetry check: 15 rotations of 4.2 s per sampling period of 60 s */
+#define HOST_TELEMETRY_ROTATIONS        ( 150 )
+
+/* Advertising data of the frames; the content is not used by the rotation */
+static const uint8_t ibeacon_data[27];
+static const uint8_t eddystone_uid_data[27];
+static const uint8_t eddystone_url_data[19];
+static const uint8_t eddystone_tlm_data[21];
+
+/* Sampling of the Eddystone-TLM update of the example (eddystone_tlm_update() in main.c) */
+static uint32_t num_of_tlm_updates;
+static OS_TICK_TIME last_sampling_time;
+static bool sampling_late;
+
+static void tlm_update(void)
+{
+        OS_TICK_TIME now = OS_GET_TICK_COUNT();
+        uint32_t elapsed = now - last_sampling_time;
+
+        num_of_tlm_updates++;
+
+        if (telemetry_sample()) {
+                last_sampling_time = now;
+        } else if (elapsed >= TELEMETRY_SAMPLE_PERIOD_MS) {
+                sampling_late = true;
+        }
+}
+
+/* Frames of the example (adv_frames[] in main.c): 4 frames of 10 events every 100 ms */
+static const adv_frame_t example_frames[] = {
+        { ibeacon_data,       sizeof(ibeacon_data),       HOST_INTERVAL_100_MS, 10, NULL },
+        { eddystone_uid_data, sizeof(eddystone_uid_data), HOST_INTERVAL_100_MS, 10, NULL },
+        { eddystone_url_data, sizeof(eddystone_url_data), HOST_INTERVAL_100_MS, 10, NULL },
+        { eddystone_tlm_data, sizeof(eddystone_tlm_data), HOST_INTERVAL_100_MS, 10, tlm_update },
+};
+
+/* Frames with different intervals: advertising is restarted twice per rotation */
+static const adv_frame_t mixed_frames[] = {
+        { ibeacon_data,       sizeof(ibeacon_data),       HOST_INTERVAL_100_MS,  10, NULL },
+        { eddystone_uid_data, sizeof(eddystone_uid_data), HOST_INTERVAL_100_MS,  10, NULL },
+        { eddystone_tlm_data, sizeof(eddystone_tlm_data), HOST_INTERVAL_1000_MS, 2,  NULL },
+};
+
+/* Expected per rotation */
+typedef struct {
+        const char *name;
+        const adv_frame_t *frames;
+        uint8_t num_of_frames;
+        uint32_t period_ms;             /* Sum of the events times (interval + advDelay) */
+        uint32_t num_of_switches;
+        uint32_t num_of_restarts;
+        uint32_t num_of_adv_events;
+} rotation_expected_t;
+
+static const rotation_expected_t rotation_expected[] = {
+        { "Example", example_frames, ARRAY_LENGTH(example_frames), 4 * 10 * (100 + 5), 4, 0, 40 },
+        { "Mixed",   mixed_frames,   ARRAY_LENGTH(mixed_frames),
+                                        2 * 10 * (100 + 5) + 2 * (1000 + 5),       1, 2, 22 },
+};
+
+static uint32_t num_of_violations;
+static int task;
+
+static void violation(const char *what)
+{
+        num_of_violations++;
+        printf("Violation: %s\n", what);
+}
+
+/*
+ * Run the task until the next frame switch: expire the frame timer, switch frames and, if
+ * advertising has been stopped, deliver its completion
+ */
+static bool frame_switch(void)
+{
+        bool rotation_completed = false;
+
+        host_timer_expire();
+
+        if (host_task_take_notif() & HOST_ROTATION_NOTIF) {
+                rotation_completed = adv_rotation_next();
+        }
+
+        if (host_adv_take_completed()) {
+                adv_rotation_adv_completed();
+        }
+
+        return rotation_completed;
+}
+
+static void rotation_start(const rotation_expected_t *e)
+{
+        host_adv_reset();
+        adv_rotation_start(e->frames, e->num_of_frames, &task, HOST_ROTATION_NOTIF);
+}
+
+/************************************** Benchmark *******************************************/
+
+static void bench(void)
+{
+        telemetry_t telemetry;
+
+        printf("Cycles are nanoseconds of host time, with the GAP calls and the GPADC conversions "
+               "stubbed\n\n");
+
+        for (int i = 0; i < ARRAY_LENGTH(rotation_expected); i++) {
+                const rotation_expected_t *e = &rotation_expected[i];
+                adv_rotation_stats_t stats;
+                uint64_t cycles = 0;
+
+                /* Warm-up, so that the max. value is not that of the first rotation after start-up */
+                rotation_start(e);
+                while (!frame_switch()) {
+                }
+
+                rotation_start(e);
+                for (uint32_t n = 0; n < HOST_BENCH_ROTATIONS; ) {
+                        if (frame_switch()) {
+                                adv_rotation_get_stats(&stats);
+                                cycles += stats.cycles_last;
+                                n++;
+                        }
+                }
+
+                printf("%s frames (%d, rotation of %" PRIu32 " ms), %d rotations\n", e->name,
+                                        e->num_of_frames, e->period_ms, HOST_BENCH_ROTATIONS);
+                printf("  Rotation %" PRIu32 ": CPU cycles = %" PRIu32 " (%" PRIu32 " us), max = %" PRIu32
+                       ", switches = %" PRIu32 ", restarts = %" PRIu32 "\n", stats.num_of_rotations,
+                       stats.cycles_last, stats.cycles_last / (SystemCoreClock / 1000000),
+                       stats.cycles_max, stats.num_of_switches, stats.num_of_restarts);
+                printf("  Average CPU cycles per rotation: %" PRIu64 "\n", cycles / HOST_BENCH_ROTATIONS);
+        }
+
+        telemetry_get(&telemetry);
+        printf("\nTelemetry: battery = %u mV, temperature = %d oC, samples = %" PRIu32
+               ", last sampling = %" PRIu32 " cycles\n", telemetry.battery_mv,
+               telemetry.temperature_x100 / 100, telemetry.num_of_samples, telemetry.sample_cycles);
+}
+
+/**************************************** Checks ********************************************/
+
+static void check_rotation(const rotation_expected_t *e)
+{
+        const host_adv_t *adv = host_adv();
+        adv_rotation_stats_t stats;
+        uint8_t current = 0;
+        OS_TICK_TIME start;
+
+        rotation_start(e);
+
+        if (!adv->active || (adv->data != e->frames[0].data) || (adv->interval != e->frames[0].interval)) {
+                violation("first frame not advertised");
+        }
+
+        for (uint32_t n = 1; n <= HOST_CHECK_ROTATIONS; n++) {
+                uint32_t data_sets = adv->num_of_data_sets;
+                uint32_t stops = adv->num_of_stops;
+                bool rotation_completed;
+
+                start = OS_GET_TICK_COUNT();
+                do {
+                        rotation_completed = frame_switch();
+                        current = (current + 1) % e->num_of_frames;
+
+                        if (!adv->active || (adv->data != e->frames[current].data) ||
+                                        (adv->interval != e->frames[current].interval)) {
+                                violation("frame advertised after a switch");
+                        }
+                } while (!rotation_completed);
+
+                if (OS_GET_TICK_COUNT() - start != e->period_ms) {
+                        printf("%s frames: rotation of %" PRIu32 " ms\n", e->name, OS_GET_TICK_COUNT() - start);
+                        violation("rotation period");
+                }
+
+                if ((adv->num_of_data_sets - data_sets != e->num_of_frames) ||
+                                (adv->num_of_stops - stops != e->num_of_restarts)) {
+                        violation("advertising data updates and restarts per rotation");
+                }
+        }
+
+        adv_rotation_get_stats(&stats);
+        if ((stats.num_of_rotations != HOST_CHECK_ROTATIONS) ||
+                        (stats.num_of_switches != HOST_CHECK_ROTATIONS * e->num_of_switches) ||
+                        (stats.num_of_restarts != HOST_CHECK_ROTATIONS * e->num_of_restarts) ||
+                        (stats.num_of_adv_events != HOST_CHECK_ROTATIONS * e->num_of_adv_events)) {
+                violation("rotation statistics");
+        }
+
+        printf("%s frames: rotation of %" PRIu32 " ms, %" PRIu32 " switches and %" PRIu32
+               " restarts per rotation\n", e->name, e->period_ms, e->num_of_switches, e->num_of_restarts);
+}
+
+/* A single frame is advertised continuously */
+static void check_single_frame(void)
+{
+        const host_adv_t *adv = host_adv();
+
+        host_adv_reset();
+        adv_rotation_start(example_frames, 1, &task, HOST_ROTATION_NOTIF);
+
+        if (!adv->active || (adv->num_of_data_sets != 1) || host_timer_period()) {
+                violation("single frame");
+        }
+}
+
+/*
+ * The GPADC is sampled on the first Eddystone-TLM update after TELEMETRY_SAMPLE_PERIOD_MS, with a
+ * conversion of the battery voltage (4 samples) and one of the die temperature (16 samples), and
+ * the adapter is closed once done
+ */
+static void check_telemetry(void)
+{
+        const host_gpadc_t *gpadc = host_gpadc();
+        host_gpadc_t before = *gpadc;
+        uint32_t updates = num_of_tlm_updates;
+        uint32_t samplings, n = 0;
+        telemetry_t telemetry;
+
+        telemetry_get(&telemetry);
+        samplings = telemetry.num_of_samples;
+
+        rotation_start(&rotation_expected[0]);
+        while (n < HOST_TELEMETRY_ROTATIONS) {
+                if (frame_switch()) {
+                        n++;
+                }
+
+                if (gpadc->open) {
+                        violation("GPADC left open");
+                }
+        }
+
+        telemetry_get(&telemetry);
+        samplings = telemetry.num_of_samples - samplings;
+        updates = num_of_tlm_updates - updates;
+
+        if (updates != HOST_TELEMETRY_ROTATIONS) {
+                violation("telemetry updates per rotation");
+        }
+
+        /* One sampling per 15 rotations, as a rotation lasts 4.2 s */
+        if (sampling_late || (samplings != HOST_TELEMETRY_ROTATIONS / 15)) {
+                violation("GPADC sampling schedule");
+        }
+
+        if ((gpadc->num_of_opens - before.num_of_opens != 2 * samplings) ||
+                        (gpadc->num_of_conversions - before.num_of_conversions != 2 * samplings) ||
+                        (gpadc->num_of_samples - before.num_of_samples != (4 + 16) * samplings)) {
+                violation("GPADC conversions per sampling");
+        }
+
+        if ((telemetry.battery_mv != 3000) || (telemetry.temperature_x100 != 2500)) {
+                violation("telemetry values");
+        }
+
+        printf("Telemetry: %" PRIu32 " samplings in %d rotations, 2 conversions (%d samples) each\n",
+                                                samplings, HOST_TELEMETRY_ROTATIONS, 4 + 16);
+}
+
+static void check(void)
+{
+        for (int i = 0; i < ARRAY_LENGTH(rotation_expected); i++) {
+                check_rotation(&rotation_expected[i]);
+        }
+
+        check_single_frame();
+        check_telemetry();
+}
+
+int main(int argc, char *argv[])
+{
+        if ((argc == 2) && !strcmp(argv[1], "bench")) {
+                bench();
+        } else if ((argc == 2) && !strcmp(argv[1], "check")) {
+                check();
+                printf("Check - Violations: %" PRIu32 ", Assertions: %" PRIu32 "\n", num_of_violations,
+                                                                                host_assert_count());
+        } else {
+                printf("Usage: %s bench | check\n", argv[0]);
+                return 2;
+        }
+
+        return (num_of_violations || host_assert_count()) ? 1 : 0;
+}
@@ -0,0 +1,105 @@
+/**
+ ****************************************************************************************
+ *
+ * @file ad_gpadc.h
+ *
+ * @brief GPADC adapter of the iBeacon host build
+ *
+ * Copyright (C) 2024 Renesas Electronics Corporation and/or its affiliates.
+ * All rights reserved. Confidential Information.
+ *
+ * This software ("Software") is supplied by Renesas Electronics Corporation and/or its
+ * affiliates ("Renesas"). Renesas grants you a personal, non-exclusive, non-transferable,
+ * revocable, non-sub-licensable right and license to use the Software, solely if used in
+ * or together with Renesas products. You may make copies of this Software, provided this
+ * copyright notice and disclaimer ("Notice") is included in all such copies. Renesas
+ * reserves the right to change or discontinue the Software at any time without notice.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS". RENESAS DISCLAIMS ALL WARRANTIES OF ANY KIND,
+ * WHETHER EXPRESS, IMPLIED, OR STATUTORY, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT. TO THE
+ * MAXIMUM EXTENT PERMITTED UNDER LAW, IN NO EVENT SHALL RENESAS BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, SPECIAL, INCIDENTAL OR CONSEQUENTIAL DAMAGES ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE, EVEN IF RENESAS HAS BEEN ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGES. USE OF THIS SOFTWARE MAY BE SUBJECT TO TERMS AND CONDITIONS CONTAINED IN
+ * AN ADDITIONAL AGREEMENT BETWEEN YOU AND RENESAS. IN CASE OF CONFLICT BETWEEN THE TERMS
+ * OF THIS NOTICE AND ANY SUCH ADDITIONAL LICENSE AGREEMENT, THE TERMS OF THE AGREEMENT
+ * SHALL TAKE PRECEDENCE. BY CONTINUING TO USE THIS SOFTWARE, YOU AGREE TO THE TERMS OF
+ * THIS NOTICE.IF YOU DO NOT AGREE TO THESE TERMS, YOU ARE NOT PERMITTED TO USE THIS
+ * SOFTWARE.
+ *
+ ****************************************************************************************
+ */
+
+#ifndef AD_GPADC_H_
+#define AD_GPADC_H_
+
+#include "sdk_defs.h"
+
+typedef enum {
+        HW_GPADC_1,
+} HW_GPADC_ID;
+
+typedef enum {
+        HW_GPADC_INPUT_MODE_SINGLE_ENDED,
+        HW_GPADC_INPUT_MODE_DIFFERENTIAL,
+} HW_GPADC_INPUT_MODE;
+
+typedef enum {
+        HW_GPADC_INP_VBAT,
+        HW_GPADC_INP_DIE_TEMP,
+} HW_GPADC_INPUT;
+
+typedef enum {
+        HW_GPADC_INPUT_VOLTAGE_UP_TO_0V9,
+        HW_GPADC_INPUT_VOLTAGE_UP_TO_3V6,
+} HW_GPADC_MAX_INPUT_VOLTAGE;
+
+/* 2^n samples per conversion */
+typedef enum {
+        HW_GPADC_OVERSAMPLING_1_SAMPLE,
+        HW_GPADC_OVERSAMPLING_2_SAMPLES,
+        HW_GPADC_OVERSAMPLING_4_SAMPLES,
+        HW_GPADC_OVERSAMPLING_8_SAMPLES,
+        HW_GPADC_OVERSAMPLING_16_SAMPLES,
+} HW_GPADC_OVERSAMPLING;
+
+#define HW_GPADC_DIE_TEMP_SMPL_TIME     ( 0x0F )
+
+typedef struct {
+        uint8_t unused;
+} ad_gpadc_io_conf_t;
+
+typedef struct {
+        HW_GPADC_INPUT_MODE input_mode;
+        HW_GPADC_INPUT positive;
+        uint8_t sample_time;
+        bool continuous;
+        uint8_t interval;
+        HW_GPADC_MAX_INPUT_VOLTAGE input_attenuator;
+        bool chopping;
+        HW_GPADC_OVERSAMPLING oversampling;
+} ad_gpadc_driver_conf_t;
+
+typedef struct {
+        HW_GPADC_ID id;
+        const ad_gpadc_io_conf_t *io;
+        const ad_gpadc_driver_conf_t *drv;
+} ad_gpadc_controller_conf_t;
+
+typedef void *ad_gpadc_handle_t;
+
+#define AD_GPADC_ERROR_NONE             ( 0 )
+#define AD_GPADC_ERROR_OTHER            ( -1 )
+
+/*
+ * Conversions complete immediately; they are recorded by the harness (see host_stubs.h). A
+ * conversion of the battery voltage reads 3000 mV, one of the die temperature 25 degrees Celsius.
+ */
+ad_gpadc_handle_t ad_gpadc_open(const ad_gpadc_controller_conf_t *conf);
+int ad_gpadc_read_nof_conv(ad_gpadc_handle_t handle, int nof_conv, uint16_t *outbuf);
+int ad_gpadc_close(ad_gpadc_handle_t handle, bool force);
+uint16_t ad_gpadc_conv_to_batt_mvolt(const ad_gpadc_driver_conf_t *drv, uint32_t value);
+int32_t ad_gpadc_conv_to_temp_x100(const ad_gpadc_driver_conf_t *drv, uint16_t value);
+
+#endif /* AD_GPADC_H_ */
@@ -0,0 +1,67 @@
+/**
+ ****************************************************************************************
+ *
+ * @file osal.h
+ *
+ * @brief OS abstraction layer of the iBeacon host build
+ *
+ * Copyright (C) 2024 Renesas Electronics Corporation and/or its affiliates.
+ * All rights reserved. Confidential Information.
+ *
+ * This software ("Software") is supplied by Renesas Electronics Corporation and/or its
+ * affiliates ("Renesas"). Renesas grants you a personal, non-exclusive, non-transferable,
+ * revocable, non-sub-licensable right and license to use the Software, solely if used in
+ * or together with Renesas products. You may make copies of this Software, provided this
+ * copyright notice and disclaimer ("Notice") is included in all such copies. Renesas
+ * reserves the right to change or discontinue the Software at any time without notice.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS". RENESAS DISCLAIMS ALL WARRANTIES OF ANY KIND,
+ * WHETHER EXPRESS, IMPLIED, OR STATUTORY, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT. TO THE
+ * MAXIMUM EXTENT PERMITTED UNDER LAW, IN NO EVENT SHALL RENESAS BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, SPECIAL, INCIDENTAL OR CONSEQUENTIAL DAMAGES ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE, EVEN IF RENESAS HAS BEEN ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGES. USE OF THIS SOFTWARE MAY BE SUBJECT TO TERMS AND CONDITIONS CONTAINED IN
+ * AN ADDITIONAL AGREEMENT BETWEEN YOU AND RENESAS. IN CASE OF CONFLICT BETWEEN THE TERMS
+ * OF THIS NOTICE AND ANY SUCH ADDITIONAL LICENSE AGREEMENT, THE TERMS OF THE AGREEMENT
+ * SHALL TAKE PRECEDENCE. BY CONTINUING TO USE THIS SOFTWARE, YOU AGREE TO THE TERMS OF
+ * THIS NOTICE.IF YOU DO NOT AGREE TO THESE TERMS, YOU ARE NOT PERMITTED TO USE THIS
+ * SOFTWARE.
+ *
+ ****************************************************************************************
+ */
+
+#ifndef OSAL_H_
+#define OSAL_H_
+
+#include "sdk_defs.h"
+
+typedef void *OS_TASK;
+typedef void *OS_TIMER;
+typedef uint32_t OS_TICK_TIME;
+
+/* Virtual time, advanced by the harness; one tick per millisecond */
+OS_TICK_TIME host_get_tick_count(void);
+
+#define OS_GET_TICK_COUNT()             host_get_tick_count()
+#define OS_MS_2_TICKS(_ms)              ((OS_TICK_TIME)(_ms))
+#define OS_TICKS_2_MS(_ticks)           ((uint32_t)(_ticks))
+
+/* Notification bits are collected by the harness, which plays the task */
+void host_task_notify(OS_TASK task, uint32_t value);
+
+#define OS_NOTIFY_SET_BITS              ( 0 )
+#define OS_TASK_NOTIFY(_task, _value, _action) host_task_notify(_task, _value)
+
+/* A single one-shot timer, fired by the harness once its period has elapsed */
+typedef void (*host_timer_cb_t)(OS_TIMER timer);
+
+OS_TIMER host_timer_create(OS_TICK_TIME period, host_timer_cb_t cb);
+void host_timer_change_period(OS_TIMER timer, OS_TICK_TIME period);
+
+#define OS_TIMER_FAIL                   ( 0 )
+#define OS_TIMER_FOREVER                ( 0 )
+#define OS_TIMER_CREATE(_name, _period, _reload, _id, _cb) host_timer_create(_period, _cb)
+#define OS_TIMER_CHANGE_PERIOD(_timer, _period, _timeout) host_timer_change_period(_timer, _period)
+
+#endif /* OSAL_H_ */
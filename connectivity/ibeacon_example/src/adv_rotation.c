@@ -0,0 +1,182 @@
+/**
+ ****************************************************************************************
+ *
+ * @file adv_rotation.c
+ *
+ * @brief Rotation of advertising frames
+ *
+ * Copyright (c) 2024 Renesas Electronics Corporation and/or its affiliates
+ * The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ * OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE
+ * OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ ****************************************************************************************
+ */
+
+#include <string.h>
+#include "sdk_defs.h"
+#include "osal.h"
+#include "ble_common.h"
+#include "ble_gap.h"
+#include "adv_rotation.h"
+
+__RETAINED static const adv_frame_t *rotation_frames;
+__RETAINED static uint8_t rotation_num_of_frames;
+__RETAINED static uint8_t current;
+__RETAINED static bool restart_pending;
+__RETAINED static OS_TASK rotation_task;
+__RETAINED static uint32_t rotation_notif;
+__RETAINED static OS_TIMER frame_timer_h;
+
+__RETAINED static adv_rotation_stats_t stats;
+#if ADV_ROTATION_STATS_EN
+__RETAINED static uint32_t rotation_cycles;
+#endif
+
+static void frame_timer_cb(OS_TIMER timer)
+{
+        OS_TASK_NOTIFY(rotation_task, rotation_notif, OS_NOTIFY_SET_BITS);
+}
+
+/* Time, expressed in ms, a frame is advertised for */
+static uint32_t frame_duration_ms(const adv_frame_t *frame)
+{
+        return frame->num_of_events * ((frame->interval * 5) / 8 + ADV_ROTATION_ADV_DELAY_MS);
+}
+
+static void frame_timer_start(const adv_frame_t *frame)
+{
+        /* A single frame is advertised continuously */
+        if (rotation_num_of_frames < 2) {
+                return;
+        }
+
+        OS_TIMER_CHANGE_PERIOD(frame_timer_h, OS_MS_2_TICKS(frame_duration_ms(frame)), OS_TIMER_FOREVER);
+}
+
+static void frame_data_set(const adv_frame_t *frame)
+{
+        if (frame->update) {
+                frame->update();
+        }
+
+        ble_gap_adv_data_set(frame->length, frame->data, 0, NULL);
+}
+
+static void frame_adv_start(const adv_frame_t *frame)
+{
+        ble_error_t status __UNUSED;
+
+        ble_gap_adv_intv_set(frame->interval, frame->interval);
+        frame_data_set(frame);
+
+        status = ble_gap_adv_start(GAP_CONN_MODE_NON_CONN);
+        ASSERT_WARNING(status == BLE_STATUS_OK);
+
+        frame_timer_start(frame);
+}
+
+void adv_rotation_start(const adv_frame_t *frames, uint8_t num_of_frames, OS_TASK task, uint32_t notif)
+{
+        rotation_frames = frames;
+        rotation_num_of_frames = num_of_frames;
+        current = 0;
+        restart_pending = false;
+        rotation_task = task;
+        rotation_notif = notif;
+        memset(&stats, 0, sizeof(stats));
+
+        if (!frame_timer_h) {
+                /* The period is set per frame; OS_TIMER_CHANGE_PERIOD() also starts the timer */
+                frame_timer_h = OS_TIMER_CREATE("ADV_FRAME", OS_MS_2_TICKS(frame_duration_ms(&frames[0])),
+                                                                        OS_TIMER_FAIL, NULL, frame_timer_cb);
+                ASSERT_WARNING(frame_timer_h);
+        }
+
+#if ADV_ROTATION_STATS_EN
+        CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+        DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+        rotation_cycles = 0;
+#endif
+
+        frame_adv_start(&rotation_frames[current]);
+}
+
+bool adv_rotation_next(void)
+{
+        const adv_frame_t *frame = &rotation_frames[current];
+        bool rotation_completed;
+#if ADV_ROTATION_STATS_EN
+        uint32_t start = DWT->CYCCNT;
+#endif
+
+        current = (current + 1) % rotation_num_of_frames;
+        rotation_completed = (current == 0);
+        stats.num_of_adv_events += frame->num_of_events;
+
+        if (rotation_frames[current].interval == frame->interval) {
+                /* Same interval; the controller uses the new data from the next advertising event on */
+                frame_data_set(&rotation_frames[current]);
+                frame_timer_start(&rotation_frames[current]);
+                stats.num_of_switches++;
+        } else {
+                /* The interval cannot be changed while advertising; restarted once completed */
+                restart_pending = true;
+                ble_gap_adv_stop();
+                stats.num_of_restarts++;
+        }
+
+#if ADV_ROTATION_STATS_EN
+        rotation_cycles += DWT->CYCCNT - start;
+#endif
+
+        if (rotation_completed) {
+                stats.num_of_rotations++;
+#if ADV_ROTATION_STATS_EN
+                stats.cycles_last = rotation_cycles;
+                stats.cycles_max = MAX(stats.cycles_max, rotation_cycles);
+                rotation_cycles = 0;
+#endif
+        }
+
+        return rotation_completed;
+}
+
+void adv_rotation_adv_completed(void)
+{
+#if ADV_ROTATION_STATS_EN
+        uint32_t start = DWT->CYCCNT;
+#endif
+
+        if (!restart_pending) {
+                return;
+        }
+
+        restart_pending = false;
+        frame_adv_start(&rotation_frames[current]);
+
+#if ADV_ROTATION_STATS_EN
+        rotation_cycles += DWT->CYCCNT - start;
+#endif
+}
+
+void adv_rotation_get_stats(adv_rotation_stats_t *rotation_stats)
+{
+        *rotation_stats = stats;
+}
@@ -0,0 +1,102 @@
+/**
+ ****************************************************************************************
+ *
+ * @file adv_rotation.h
+ *
+ * @brief Rotation of advertising frames
+ *
+ * Copyright (c) 2024 Renesas Electronics Corporation and/or its affiliates
+ * The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ * OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE
+ * OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ ****************************************************************************************
+ */
+
+#ifndef ADV_ROTATION_H_
+#define ADV_ROTATION_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "osal.h"
+
+/*
+ * If set, the CPU cycles spent switching frames are measured (DWT cycle counter), see
+ * adv_rotation_get_stats()
+ */
+#ifndef ADV_ROTATION_STATS_EN
+#define ADV_ROTATION_STATS_EN           ( 0 )
+#endif
+
+/* Mean advDelay, expressed in ms, the controller adds to each advertising interval */
+#define ADV_ROTATION_ADV_DELAY_MS       ( 5 )
+
+/*
+ * Advertising frame. The advertising data are prebuilt, so that switching frames only passes
+ * another buffer to the stack. Frames carrying live data (e.g. telemetry) can update their buffer
+ * in place from the update callback, which is called, from the task, each time the frame is
+ * switched in; no extra wakeup is needed.
+ */
+typedef struct {
+        const uint8_t *data;            /* Advertising data, excluding the flags */
+        uint8_t length;
+        uint16_t interval;              /* Advertising interval, in steps of 0.625 ms */
+        uint16_t num_of_events;         /* Advertising events before switching to the next frame */
+        void (*update)(void);           /* Called before the frame is switched in; can be NULL */
+} adv_frame_t;
+
+/* Rotation statistics */
+typedef struct {
+        uint32_t num_of_rotations;      /* Rotations over all the frames completed */
+        uint32_t num_of_switches;       /* Frame switches (advertising data update only) */
+        uint32_t num_of_restarts;       /* Frame switches that restarted advertising (interval change) */
+        uint32_t num_of_adv_events;     /* Advertising events of the frames switched out (estimated) */
+        uint32_t cycles_last;           /* CPU cycles spent switching frames in the last rotation */
+        uint32_t cycles_max;            /* Max. CPU cycles spent switching frames in a rotation */
+} adv_rotation_stats_t;
+
+/*
+ * Start advertising the frames in turn. Each frame is advertised for its number of advertising
+ * events; consecutive frames with the same interval are switched by updating the advertising
+ * data, otherwise advertising is stopped and restarted with the interval of the next frame.
+ *
+ * \param [in] frames        The frames; the array should remain valid while advertising
+ * \param [in] num_of_frames Number of frames
+ * \param [in] task          Task notified when a frame should be switched
+ * \param [in] notif         Notification bit
+ */
+void adv_rotation_start(const adv_frame_t *frames, uint8_t num_of_frames, OS_TASK task, uint32_t notif);
+
+/*
+ * Switch to the next frame. It should be called by the task when notified.
+ *
+ * \return True if a rotation over all the frames has been completed
+ */
+bool adv_rotation_next(void);
+
+/*
+ * Handle the completion of advertising (BLE_EVT_GAP_ADV_COMPLETED); advertising is restarted
+ * with the pending frame.
+ */
+void adv_rotation_adv_completed(void);
+
+/* Get the rotation statistics */
+void adv_rotation_get_stats(adv_rotation_stats_t *stats);
+
+#endif /* ADV_ROTATION_H_ */
@@ -28,6 +28,7 @@
  *
  ****************************************************************************************
  */
+#include <stdio.h>
 #include "osal.h"
 #include "ble_common.h"
 #include "ble_gap.h"
@@ -35,6 +36,10 @@
 #include "sys_clock_mgr.h"
 #include "sys_power_mgr.h"
 #include "sys_watchdog.h"
+#include "adv_rotation.h"
+#if BEACON_TELEMETRY_EN
+#include "telemetry.h"
+#endif
 
 /* iBeacon advertising data */
 #define IBEACON_LENGTH              0x1a
@@ -47,8 +52,38 @@
 #define IBEACON_MINOR_NUM           0x00, 0x01
 #define IBEACON_TX_POWER            0x3c
 
+/* Eddystone advertising data: complete list of 16-bit service UUIDs and service data */
+#define EDDYSTONE_UUID_LIST         0x03, 0x03, 0xaa, 0xfe
+#define EDDYSTONE_SVC_DATA_TYPE     0x16
+#define EDDYSTONE_UUID              0xaa, 0xfe
+#define EDDYSTONE_FRAME_UID         0x00
+#define EDDYSTONE_FRAME_URL         0x10
+#define EDDYSTONE_FRAME_TLM         0x20
+#define EDDYSTONE_TX_POWER          0xee /* Calibrated TX power at 0 m: -18 dBm */
+#define EDDYSTONE_NAMESPACE         0xf0, 0x23, 0x1f, 0x82, 0x2d, 0x3b, 0xfd, 0x12, 0x85, 0x02
+#define EDDYSTONE_INSTANCE          0x00, 0x00, 0x00, 0x00, 0x00, 0x01
+#define EDDYSTONE_URL_SCHEME        0x01 /* https://www. */
+#define EDDYSTONE_URL               'r', 'e', 'n', 'e', 's', 'a', 's', 0x07 /* .com */
+#define EDDYSTONE_TLM_VERSION       0x00
+#define EDDYSTONE_TLM_VBATT         0x00, 0x00 /* Not supported */
+#define EDDYSTONE_TLM_TEMP          0x80, 0x00 /* Not supported */
+#define EDDYSTONE_TLM_ADV_CNT       0x00, 0x00, 0x00, 0x00
+#define EDDYSTONE_TLM_SEC_CNT       0x00, 0x00, 0x00, 0x00
+
+/* Offsets of the Eddystone-TLM fields (big-endian) in the advertising data */
+#define EDDYSTONE_TLM_VBATT_OFFSET      10
+#define EDDYSTONE_TLM_TEMP_OFFSET       12
+#define EDDYSTONE_TLM_ADV_CNT_OFFSET    14
+#define EDDYSTONE_TLM_SEC_CNT_OFFSET    18
+
+/* Advertising intervals, in steps of 0.625 ms */
+#define ADV_INTERVAL_100_MS         0xA0
+
+/* Task notification, sent when the advertised frame should be switched */
+#define ADV_FRAME_NOTIF             (1 << 1)
+
 /* iBeacon advertising data */
-static const uint8_t adv_data[] = {
+static const uint8_t ibeacon_adv_data[] = {
 /* Standard flags must not be included in the advertising data. These will be included automatically by stack.*/
 IBEACON_LENGTH,
 IBEACON_TYPE,
@@ -60,6 +95,101 @@ IBEACON_MAJOR_NUM,
 IBEACON_MINOR_NUM,
 IBEACON_TX_POWER };
 
+/* Eddystone-UID advertising data */
+static const uint8_t eddystone_uid_adv_data[] = {
+EDDYSTONE_UUID_LIST,
+0x17,
+EDDYSTONE_SVC_DATA_TYPE,
+EDDYSTONE_UUID,
+EDDYSTONE_FRAME_UID,
+EDDYSTONE_TX_POWER,
+EDDYSTONE_NAMESPACE,
+EDDYSTONE_INSTANCE,
+0x00, 0x00 /* Reserved */ };
+
+/* Eddystone-URL advertising data */
+static const uint8_t eddystone_url_adv_data[] = {
+EDDYSTONE_UUID_LIST,
+0x0e,
+EDDYSTONE_SVC_DATA_TYPE,
+EDDYSTONE_UUID,
+EDDYSTONE_FRAME_URL,
+EDDYSTONE_TX_POWER,
+EDDYSTONE_URL_SCHEME,
+EDDYSTONE_URL };
+
+/*
+ * Eddystone-TLM (unencrypted) advertising data. With BEACON_TELEMETRY_EN the fields are updated
+ * in place each time the frame is switched in, see eddystone_tlm_update().
+ */
+#if BEACON_TELEMETRY_EN
+__RETAINED_RW static uint8_t eddystone_tlm_adv_data[] = {
+#else
+static const uint8_t eddystone_tlm_adv_data[] = {
+#endif
+EDDYSTONE_UUID_LIST,
+0x11,
+EDDYSTONE_SVC_DATA_TYPE,
+EDDYSTONE_UUID,
+EDDYSTONE_FRAME_TLM,
+EDDYSTONE_TLM_VERSION,
+EDDYSTONE_TLM_VBATT,
+EDDYSTONE_TLM_TEMP,
+EDDYSTONE_TLM_ADV_CNT,
+EDDYSTONE_TLM_SEC_CNT };
+
+#if BEACON_TELEMETRY_EN
+static void put_be16(uint8_t *p, uint16_t value)
+{
+        p[0] = value >> 8;
+        p[1] = value;
+}
+
+static void put_be32(uint8_t *p, uint32_t value)
+{
+        put_be16(p, value >> 16);
+        put_be16(p + 2, value);
+}
+
+/*
+ * Update the Eddystone-TLM fields. It is called by the frame rotation right before the frame is
+ * passed to the stack, so it runs on a wakeup that takes place anyway. The GPADC is sampled only
+ * every TELEMETRY_SAMPLE_PERIOD_MS; the counters are updated each time.
+ */
+static void eddystone_tlm_update(void)
+{
+        adv_rotation_stats_t stats;
+        telemetry_t telemetry;
+        uint8_t *tlm = eddystone_tlm_adv_data;
+
+        telemetry_sample();
+        telemetry_get(&telemetry);
+        adv_rotation_get_stats(&stats);
+
+        /* Battery voltage in mV, temperature in signed 8.8 fixed point, time since power-up in 0.1 s */
+        put_be16(&tlm[EDDYSTONE_TLM_VBATT_OFFSET], telemetry.battery_mv);
+        put_be16(&tlm[EDDYSTONE_TLM_TEMP_OFFSET], (int16_t) ((telemetry.temperature_x100 * 256) / 100));
+        put_be32(&tlm[EDDYSTONE_TLM_ADV_CNT_OFFSET], stats.num_of_adv_events);
+        put_be32(&tlm[EDDYSTONE_TLM_SEC_CNT_OFFSET],
+                (uint32_t) (((uint64_t) OS_GET_TICK_COUNT() * 10) / configTICK_RATE_HZ));
+}
+#define EDDYSTONE_TLM_UPDATE        eddystone_tlm_update
+#else
+#define EDDYSTONE_TLM_UPDATE        NULL
+#endif /* BEACON_TELEMETRY_EN */
+
+/*
+ * Frames advertised in turn: each frame is advertised for a number of advertising events at its
+ * own interval. The DA1459x supports a single advertising set, so the frames share it. All frames
+ * use the same interval, so the telemetry is updated without stopping advertising.
+ */
+static const adv_frame_t adv_frames[] = {
+        { ibeacon_adv_data,       sizeof(ibeacon_adv_data),       ADV_INTERVAL_100_MS, 10, NULL },
+        { eddystone_uid_adv_data, sizeof(eddystone_uid_adv_data), ADV_INTERVAL_100_MS, 10, NULL },
+        { eddystone_url_adv_data, sizeof(eddystone_url_adv_data), ADV_INTERVAL_100_MS, 10, NULL },
+        { eddystone_tlm_adv_data, sizeof(eddystone_tlm_adv_data), ADV_INTERVAL_100_MS, 10, EDDYSTONE_TLM_UPDATE },
+};
+
 /* Task priorities */
 #define mainIBEACON_DEMO_TASK_PRIORITY              ( OS_TASK_PRIORITY_NORMAL )
 
@@ -188,6 +318,39 @@ static void handle_evt_gap_disconnected(ble_evt_gap_disconnected_t *evt) {
 	ble_gap_adv_start(GAP_CONN_MODE_UNDIRECTED);
 }
 
+static void handle_evt_gap_adv_completed(ble_evt_gap_adv_completed_t *evt) {
+	/* Advertising is stopped to switch to a frame with a different interval */
+	adv_rotation_adv_completed();
+}
+
+static void adv_frame_switch(void) {
+	bool rotation_completed = adv_rotation_next();
+
+#if ADV_ROTATION_STATS_EN
+	if (rotation_completed) {
+		adv_rotation_stats_t stats;
+
+		adv_rotation_get_stats(&stats);
+		printf("Rotation %lu: CPU cycles = %lu (%lu us), max = %lu, switches = %lu, restarts = %lu\r\n",
+			stats.num_of_rotations, stats.cycles_last,
+			stats.cycles_last / (SystemCoreClock / 1000000), stats.cycles_max,
+			stats.num_of_switches, stats.num_of_restarts);
+
+#if BEACON_TELEMETRY_EN
+		telemetry_t telemetry;
+
+		telemetry_get(&telemetry);
+		printf("Telemetry: battery = %u mV, temperature = %d oC, samples = %lu, "
+			"last sampling = %lu cycles\r\n",
+			telemetry.battery_mv, telemetry.temperature_x100 / 100,
+			telemetry.num_of_samples, telemetry.sample_cycles);
+#endif
+	}
+#else
+	(void) rotation_completed;
+#endif
+}
+
 static void handle_evt_gap_pair_req(ble_evt_gap_pair_req_t *evt) {
 	ble_gap_pair_reply(evt->conn_idx, true, evt->bond);
 }
@@ -204,56 +367,74 @@ static OS_TASK_FUNCTION(ibeacon_demo_task, pvParameters) {
 	/* Start BLE device as a peripheral */
 	ble_peripheral_start();
 
-	/* Set advertising data */
-	ble_gap_adv_data_set(sizeof(adv_data), adv_data, 0, NULL);
-
-	/* Set Advertising interval to 100ms */
-	ble_gap_adv_intv_set(0xA0, 0xA0);
+	/* Register task to BLE manager to be notified of BLE events */
+	ble_register_app();
 
-	/* Start advertising */
-	ble_gap_adv_start(GAP_CONN_MODE_NON_CONN);
+	/*
+	 * Start advertising the frames in turn (non-connectable). Each frame is
+	 * advertised for its number of advertising events at its own interval.
+	 */
+	adv_rotation_start(adv_frames, ARRAY_LENGTH(adv_frames), OS_GET_CURRENT_TASK(), ADV_FRAME_NOTIF);
 
 	for (;;) {
-		ble_evt_hdr_t *hdr;
+		OS_BASE_TYPE ret __UNUSED;
+		uint32_t notif;
 
 		/* Notify watchdog on each loop */
 		sys_watchdog_notify(wdog_id);
 
-		/* Suspend watchdog while blocking on ble_get_event() */
+		/* Suspend watchdog while blocking on OS_TASK_NOTIFY_WAIT() */
 		sys_watchdog_suspend(wdog_id);
 
 		/*
-		 * Wait for a BLE event - this task will block
-		 * indefinitely since nothing will be received,
-		 * because it is not possible to connect to the
-		 * iBeacon (GAP_CONN_MODE_NON_CONN).
+		 * Wait on any of the notification bits, then clear them all. Nothing
+		 * is received from the BLE manager except the completion of advertising,
+		 * because it is not possible to connect to the beacon (GAP_CONN_MODE_NON_CONN).
 		 */
-		hdr = ble_get_event(true);
+		ret = OS_TASK_NOTIFY_WAIT(0, OS_TASK_NOTIFY_ALL_BITS, &notif, OS_TASK_NOTIFY_FOREVER);
+		/* Blocks forever waiting for task notification. The return value must be OS_OK */
+		OS_ASSERT(ret == OS_OK);
 
 		/* Resume watchdog */
 		sys_watchdog_notify_and_resume(wdog_id);
 
-		if (!hdr) {
-			continue;
+		/* Notified from BLE manager, can get event */
+		if (notif & BLE_APP_NOTIFY_MASK) {
+			ble_evt_hdr_t *hdr;
+
+			hdr = ble_get_event(false);
+			if (hdr) {
+				switch (hdr->evt_code) {
+				case BLE_EVT_GAP_CONNECTED:
+					handle_evt_gap_connected((ble_evt_gap_connected_t*) hdr);
+					break;
+				case BLE_EVT_GAP_DISCONNECTED:
+					handle_evt_gap_disconnected((ble_evt_gap_disconnected_t*) hdr);
+					break;
+				case BLE_EVT_GAP_ADV_COMPLETED:
+					handle_evt_gap_adv_completed((ble_evt_gap_adv_completed_t*) hdr);
+					break;
+				case BLE_EVT_GAP_PAIR_REQ:
+					handle_evt_gap_pair_req((ble_evt_gap_pair_req_t*) hdr);
+					break;
+				default:
+					ble_handle_event_default(hdr);
+					break;
+				}
+
+				/* Free event buffer (it's not needed anymore) */
+				OS_FREE(hdr);
+			}
+
+			/* Notify again if there are more events to process in queue */
+			if (ble_has_event()) {
+				OS_TASK_NOTIFY(OS_GET_CURRENT_TASK(), BLE_APP_NOTIFY_MASK, OS_NOTIFY_SET_BITS);
+			}
 		}
 
-		switch (hdr->evt_code) {
-		case BLE_EVT_GAP_CONNECTED:
-			handle_evt_gap_connected((ble_evt_gap_connected_t*) hdr);
-			break;
-		case BLE_EVT_GAP_DISCONNECTED:
-			handle_evt_gap_disconnected((ble_evt_gap_disconnected_t*) hdr);
-			break;
-		case BLE_EVT_GAP_PAIR_REQ:
-			handle_evt_gap_pair_req((ble_evt_gap_pair_req_t*) hdr);
-			break;
-		default:
-			ble_handle_event_default(hdr);
-			break;
+		if (notif & ADV_FRAME_NOTIF) {
+			adv_frame_switch();
 		}
-
-		/* Free event buffer (it's not needed anymore) */
-		OS_FREE(hdr);
 	}
 }
 
@@ -0,0 +1,47 @@
+/**
+ ****************************************************************************************
+ *
+ * @file platform_devices.h
+ *
+ * @brief Configuration of devices connected to board.
+ *
+ * Copyright (c) 2024 Renesas Electronics Corporation and/or its affiliates
+ * The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ * OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE
+ * OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ ****************************************************************************************
+ */
+
+#ifndef PLATFORM_DEVICES_H_
+#define PLATFORM_DEVICES_H_
+
+#include "ad_gpadc.h"
+
+#if (dg_configGPADC_ADAPTER == 1)
+
+extern const ad_gpadc_controller_conf_t battery_level_ctrl;
+#define BATTERY_LEVEL battery_level_ctrl
+
+extern const ad_gpadc_controller_conf_t die_temp_ctrl;
+#define DIE_TEMPERATURE die_temp_ctrl
+
+#endif
+
+#endif /* PLATFORM_DEVICES_H_ */
@@ -0,0 +1,92 @@
+/**
+ ****************************************************************************************
+ *
+ * @file telemetry.c
+ *
+ * @brief Beacon telemetry: battery voltage and die temperature
+ *
+ * Copyright (c) 2024 Renesas Electronics Corporation and/or its affiliates
+ * The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ * OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE
+ * OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ ****************************************************************************************
+ */
+
+#include "sdk_defs.h"
+#include "osal.h"
+#include "ad_gpadc.h"
+#include "platform_devices.h"
+#include "adv_rotation.h"
+#include "telemetry.h"
+
+__RETAINED static telemetry_t latest;
+__RETAINED static OS_TICK_TIME last_sample_time;
+
+/* Perform a single blocking conversion; the adapter is open only for its duration */
+static uint16_t gpadc_read(const ad_gpadc_controller_conf_t *conf)
+{
+        ad_gpadc_handle_t handle;
+        uint16_t value = 0;
+        int ret __UNUSED;
+
+        handle = ad_gpadc_open(conf);
+        ASSERT_WARNING(handle != NULL);
+
+        ret = ad_gpadc_read_nof_conv(handle, 1, &value);
+        ASSERT_WARNING(ret == AD_GPADC_ERROR_NONE);
+
+        ret = ad_gpadc_close(handle, false);
+        ASSERT_WARNING(ret == AD_GPADC_ERROR_NONE);
+
+        return value;
+}
+
+bool telemetry_sample(void)
+{
+        OS_TICK_TIME now = OS_GET_TICK_COUNT();
+#if ADV_ROTATION_STATS_EN
+        uint32_t start;
+#endif
+
+        if (latest.num_of_samples &&
+                        (now - last_sample_time) < OS_MS_2_TICKS(TELEMETRY_SAMPLE_PERIOD_MS)) {
+                return false;
+        }
+
+        last_sample_time = now;
+#if ADV_ROTATION_STATS_EN
+        /* The cycle counter is enabled by the frame rotation */
+        start = DWT->CYCCNT;
+#endif
+
+        latest.battery_mv = ad_gpadc_conv_to_batt_mvolt(BATTERY_LEVEL.drv, gpadc_read(&BATTERY_LEVEL));
+        latest.temperature_x100 = ad_gpadc_conv_to_temp_x100(DIE_TEMPERATURE.drv, gpadc_read(&DIE_TEMPERATURE));
+        latest.num_of_samples++;
+#if ADV_ROTATION_STATS_EN
+        latest.sample_cycles = DWT->CYCCNT - start;
+#endif
+
+        return true;
+}
+
+void telemetry_get(telemetry_t *telemetry)
+{
+        *telemetry = latest;
+}
@@ -0,0 +1,66 @@
+/**
+ ****************************************************************************************
+ *
+ * @file telemetry.h
+ *
+ * @brief Beacon telemetry: battery voltage and die temperature
+ *
+ * Copyright (c) 2024 Renesas Electronics Corporation and/or its affiliates
+ * The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ * OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE
+ * OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ ****************************************************************************************
+ */
+
+#ifndef TELEMETRY_H_
+#define TELEMETRY_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/*
+ * Minimum time, expressed in ms, between two GPADC samplings. Battery voltage and die
+ * temperature change slowly, so sampling them at each telemetry update would only cost current.
+ */
+#ifndef TELEMETRY_SAMPLE_PERIOD_MS
+#define TELEMETRY_SAMPLE_PERIOD_MS      ( 60000 )
+#endif
+
+/* Latest telemetry */
+typedef struct {
+        uint16_t battery_mv;            /* Battery voltage, in mV */
+        int16_t temperature_x100;       /* Die temperature, in 0.01 degrees Celsius */
+        uint32_t num_of_samples;        /* GPADC samplings since power-up */
+        uint32_t sample_cycles;         /* CPU cycles of the last sampling (ADV_ROTATION_STATS_EN) */
+} telemetry_t;
+
+/*
+ * Sample the battery voltage and the die temperature, if TELEMETRY_SAMPLE_PERIOD_MS has elapsed
+ * since the last sampling. It blocks the calling task for the GPADC conversions and keeps the
+ * device out of extended sleep only for their duration.
+ *
+ * \return True if sampled
+ */
+bool telemetry_sample(void);
+
+/* Get the latest telemetry */
+void telemetry_get(telemetry_t *telemetry);
+
+#endif /* TELEMETRY_H_ */
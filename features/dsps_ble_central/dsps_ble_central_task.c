@@ -31,6 +31,7 @@
    #include "dsps_uart.h"
 #endif
 #include "misc.h"
+#include "ble_evt_pump.h"
 #include "dsps_common.h"
 #include "dsps_port.h"
 #include "platform_devices.h"
@@ -784,6 +785,65 @@ static void conn_timeout_cb(OS_TIMER xTimer)
         OS_TASK_NOTIFY(task, BLE_CONN_TIMEOUT_NOTIF, OS_NOTIFY_SET_BITS);
 }
 
+static void handle_ble_evt(ble_evt_hdr_t *hdr, void *user_data)
+{
+        switch (hdr->evt_code) {
+        case BLE_EVT_GAP_CONNECTED:
+                handle_evt_gap_connected((ble_evt_gap_connected_t *) hdr);
+                break;
+        case BLE_EVT_GATTC_MTU_CHANGED:
+                handle_evt_gap_mtu_exchanged((ble_evt_gattc_mtu_changed_t *) hdr);
+                break;
+        case BLE_EVT_GAP_ADV_REPORT:
+                handle_evt_gap_adv_report((ble_evt_gap_adv_report_t *) hdr);
+                break;
+        case BLE_EVT_GAP_SCAN_COMPLETED:
+                handle_evt_gap_scan_completed((ble_evt_gap_scan_completed_t *) hdr);
+                break;
+        case BLE_EVT_GAP_CONNECTION_COMPLETED:
+                handle_evt_gap_connection_completed((ble_evt_gap_connection_completed_t *) hdr);
+                break;
+        case BLE_EVT_GAP_CONN_PARAM_UPDATE_REQ:
+                handle_evt_gap_conn_param_updated_req((ble_evt_gap_conn_param_update_req_t *) hdr);
+                break;
+        case BLE_EVT_GAP_DISCONNECTED:
+                handle_evt_gap_disconnected((ble_evt_gap_disconnected_t *) hdr);
+                break;
+        case BLE_EVT_GAP_SECURITY_REQUEST:
+                handle_evt_gap_security_request((ble_evt_gap_security_request_t *) hdr);
+                break;
+        case BLE_EVT_GAP_PAIR_COMPLETED:
+                handle_evt_gap_pair_completed((ble_evt_gap_pair_completed_t *) hdr);
+                break;
+        case BLE_EVT_GATTC_BROWSE_SVC:
+                handle_evt_gattc_browse_svc((ble_evt_gattc_browse_svc_t *) hdr);
+                break;
+        case BLE_EVT_GATTC_BROWSE_COMPLETED:
+                handle_evt_gattc_browse_completed((ble_evt_gattc_browse_completed_t *) hdr);
+                break;
+        case BLE_EVT_GATTC_READ_COMPLETED:
+                handle_evt_gattc_read_completed((ble_evt_gattc_read_completed_t *) hdr);
+                break;
+        case BLE_EVT_GATTC_WRITE_COMPLETED:
+                handle_evt_gattc_write_completed((ble_evt_gattc_write_completed_t *) hdr);
+                break;
+        case BLE_EVT_GATTC_NOTIFICATION:
+                handle_evt_gattc_notification((ble_evt_gattc_notification_t *) hdr);
+                break;
+#if (dg_configBLE_2MBIT_PHY == 1)
+        case BLE_EVT_GAP_PHY_SET_COMPLETED:
+                handle_ble_evt_gap_phy_set_completed((ble_evt_gap_phy_set_completed_t *) hdr);
+                break;
+        case BLE_EVT_GAP_PHY_CHANGED:
+                handle_ble_evt_gap_phy_changed((ble_evt_gap_phy_changed_t *) hdr);
+                break;
+#endif /* (dg_configBLE_2MBIT_PHY == 1) */
+        default:
+                ble_handle_event_default(hdr);
+                break;
+        }
+}
+
 OS_TASK_FUNCTION(dsps_central_task, pvParameters)
 {
         int8_t wdog_id;
@@ -838,76 +898,7 @@ OS_TASK_FUNCTION(dsps_central_task, pvParameters)
 
                 /* notified from BLE manager, can get event */
                 if (notif & BLE_APP_NOTIFY_MASK) {
-                        ble_evt_hdr_t *hdr;
-
-                        hdr = ble_get_event(false);
-                        if (!hdr) {
-                                goto no_event;
-                        }
-
-                        switch (hdr->evt_code) {
-                        case BLE_EVT_GAP_CONNECTED:
-                                handle_evt_gap_connected((ble_evt_gap_connected_t *) hdr);
-                                break;
-                        case BLE_EVT_GATTC_MTU_CHANGED:
-                                handle_evt_gap_mtu_exchanged((ble_evt_gattc_mtu_changed_t *) hdr);
-                                break;
-                        case BLE_EVT_GAP_ADV_REPORT:
-                                handle_evt_gap_adv_report((ble_evt_gap_adv_report_t *) hdr);
-                                break;
-                        case BLE_EVT_GAP_SCAN_COMPLETED:
-                                handle_evt_gap_scan_completed((ble_evt_gap_scan_completed_t *) hdr);
-                                break;
-                        case BLE_EVT_GAP_CONNECTION_COMPLETED:
-                                handle_evt_gap_connection_completed((ble_evt_gap_connection_completed_t *) hdr);
-                                break;
-                        case BLE_EVT_GAP_CONN_PARAM_UPDATE_REQ:
-                                handle_evt_gap_conn_param_updated_req((ble_evt_gap_conn_param_update_req_t *) hdr);
-                                break;
-                        case BLE_EVT_GAP_DISCONNECTED:
-                                handle_evt_gap_disconnected((ble_evt_gap_disconnected_t *) hdr);
-                                break;
-                        case BLE_EVT_GAP_SECURITY_REQUEST:
-                                handle_evt_gap_security_request((ble_evt_gap_security_request_t *) hdr);
-                                break;
-                        case BLE_EVT_GAP_PAIR_COMPLETED:
-                                handle_evt_gap_pair_completed((ble_evt_gap_pair_completed_t *) hdr);
-                                break;
-                        case BLE_EVT_GATTC_BROWSE_SVC:
-                                handle_evt_gattc_browse_svc((ble_evt_gattc_browse_svc_t *) hdr);
-                                break;
-                        case BLE_EVT_GATTC_BROWSE_COMPLETED:
-                                handle_evt_gattc_browse_completed((ble_evt_gattc_browse_completed_t *) hdr);
-                                break;
-                        case BLE_EVT_GATTC_READ_COMPLETED:
-                                handle_evt_gattc_read_completed((ble_evt_gattc_read_completed_t *) hdr);
-                                break;
-                        case BLE_EVT_GATTC_WRITE_COMPLETED:
-                                handle_evt_gattc_write_completed((ble_evt_gattc_write_completed_t *) hdr);
-                                break;
-                        case BLE_EVT_GATTC_NOTIFICATION:
-                                handle_evt_gattc_notification((ble_evt_gattc_notification_t *) hdr);
-                                break;
-#if (dg_configBLE_2MBIT_PHY == 1)
-                        case BLE_EVT_GAP_PHY_SET_COMPLETED:
-                                handle_ble_evt_gap_phy_set_completed((ble_evt_gap_phy_set_completed_t *) hdr);
-                                break;
-                        case BLE_EVT_GAP_PHY_CHANGED:
-                                handle_ble_evt_gap_phy_changed((ble_evt_gap_phy_changed_t *) hdr);
-                                break;
-#endif /* (dg_configBLE_2MBIT_PHY == 1) */
-                        default:
-                                ble_handle_event_default(hdr);
-                                break;
-                        }
-
-                        OS_FREE(hdr);
-
-no_event:
-                        /* Notify again if there are more events to process in queue */
-                        if (ble_has_event()) {
-                                OS_TASK_NOTIFY(ble_central_task_handle, BLE_APP_NOTIFY_MASK, OS_NOTIFY_SET_BITS);
-                        }
+                        ble_evt_pump(ble_central_task_handle, handle_ble_evt, NULL);
                 }
 
                 if (notif & SPS_BLE_TX_NOTIF) {
@@ -30,6 +30,7 @@
 #endif
 #include "dsps_queue.h"
 #include "misc.h"
+#include "ble_evt_pump.h"
 #include "dsps_common.h"
 #include "dsps_port.h"
 #include "platform_devices.h"
@@ -60,6 +61,9 @@
  * Store information about ongoing SUOTA.
  */
 __RETAINED_RW static bool suota_ongoing = false;
+
+/* SUOTA service, which handles the L2CAP events */
+__RETAINED static ble_service_t *suota;
 #endif /* dg_configSUOTA_SUPPORT */
 
 __RETAINED static sps_queue_t *rx_queue;
@@ -584,15 +588,61 @@ static const dis_device_info_t dis_info = {
 };
 #endif /* dg_configSUOTA_SUPPORT */
 
+static void handle_ble_evt(ble_evt_hdr_t *hdr, void *user_data)
+{
+        if (!ble_service_handle_event(hdr)) {
+                switch (hdr->evt_code) {
+                case BLE_EVT_GAP_CONNECTED:
+                        handle_evt_gap_connected((ble_evt_gap_connected_t *) hdr);
+                        break;
+                case BLE_EVT_GAP_DATA_LENGTH_CHANGED:
+                        handle_evt_gap_datalength_changed((ble_evt_gap_data_length_changed_t *) hdr);
+                        break;
+                case BLE_EVT_GAP_CONN_PARAM_UPDATED:
+                        handle_evt_gap_conn_param_updated((ble_evt_gap_conn_param_updated_t *) hdr);
+                        break;
+                case BLE_EVT_GAP_CONN_PARAM_UPDATE_COMPLETED:
+                        handle_evt_gap_conn_param_update_completed((ble_evt_gap_conn_param_update_completed_t *) hdr);
+                        break;
+                case BLE_EVT_GATTC_MTU_CHANGED:
+                        handle_evt_gap_mtu_exchanged((ble_evt_gattc_mtu_changed_t *) hdr);
+                        break;
+                case BLE_EVT_GAP_DISCONNECTED:
+                        handle_disconnected((ble_evt_gap_disconnected_t *) hdr);
+                        break;
+                case BLE_EVT_GAP_PAIR_REQ:
+                {
+                        ble_evt_gap_pair_req_t *evt = (ble_evt_gap_pair_req_t *) hdr;
+                        ble_gap_pair_reply(evt->conn_idx, true, evt->bond);
+                        break;
+                }
+#if (dg_configBLE_2MBIT_PHY == 1)
+                case BLE_EVT_GAP_PHY_SET_COMPLETED:
+                        handle_ble_evt_gap_phy_set_completed((ble_evt_gap_phy_set_completed_t *) hdr);
+                        break;
+                case BLE_EVT_GAP_PHY_CHANGED:
+                        handle_ble_evt_gap_phy_changed((ble_evt_gap_phy_changed_t *) hdr);
+                        break;
+#endif /* (dg_configBLE_2MBIT_PHY == 1) */
+#if dg_configSUOTA_SUPPORT && defined (SUOTA_PSM)
+                case BLE_EVT_L2CAP_CONNECTED:
+                case BLE_EVT_L2CAP_DISCONNECTED:
+                case BLE_EVT_L2CAP_DATA_IND:
+                        suota_l2cap_event(suota, hdr);
+                        break;
+#endif
+                default:
+                        ble_handle_event_default(hdr);
+                        break;
+                }
+        }
+}
+
 OS_TASK_FUNCTION(dsps_peripheral_task, pvParameters)
 {
         att_uuid_t sps_uuid;
         int8_t wdog_id;
 
-#if dg_configSUOTA_SUPPORT
-        ble_service_t *suota;
-#endif
-
         wdog_id = sys_watchdog_register(false);
 
         ble_periph_task_handle = OS_GET_CURRENT_TASK();
@@ -656,67 +706,7 @@ OS_TASK_FUNCTION(dsps_peripheral_task, pvParameters)
 
                 /* Notified from BLE manager, can get event */
                 if (notif & BLE_APP_NOTIFY_MASK) {
-                        ble_evt_hdr_t *hdr;
-
-                        hdr = ble_get_event(false);
-                        if (!hdr) {
-                                goto no_event;
-                        }
-
-                        if (!ble_service_handle_event(hdr)) {
-                                switch (hdr->evt_code) {
-                                case BLE_EVT_GAP_CONNECTED:
-                                        handle_evt_gap_connected((ble_evt_gap_connected_t *) hdr);
-                                        break;
-                                case BLE_EVT_GAP_DATA_LENGTH_CHANGED:
-                                        handle_evt_gap_datalength_changed((ble_evt_gap_data_length_changed_t *) hdr);
-                                        break;
-                                case BLE_EVT_GAP_CONN_PARAM_UPDATED:
-                                        handle_evt_gap_conn_param_updated((ble_evt_gap_conn_param_updated_t *) hdr);
-                                        break;
-                                case BLE_EVT_GAP_CONN_PARAM_UPDATE_COMPLETED:
-                                        handle_evt_gap_conn_param_update_completed((ble_evt_gap_conn_param_update_completed_t *) hdr);
-                                        break;
-                                case BLE_EVT_GATTC_MTU_CHANGED:
-                                        handle_evt_gap_mtu_exchanged((ble_evt_gattc_mtu_changed_t *) hdr);
-                                        break;
-                                case BLE_EVT_GAP_DISCONNECTED:
-                                        handle_disconnected((ble_evt_gap_disconnected_t *) hdr);
-                                        break;
-                                case BLE_EVT_GAP_PAIR_REQ:
-                                {
-                                        ble_evt_gap_pair_req_t *evt = (ble_evt_gap_pair_req_t *) hdr;
-                                        ble_gap_pair_reply(evt->conn_idx, true, evt->bond);
-                                        break;
-                                }
-#if (dg_configBLE_2MBIT_PHY == 1)
-                                case BLE_EVT_GAP_PHY_SET_COMPLETED:
-                                        handle_ble_evt_gap_phy_set_completed((ble_evt_gap_phy_set_completed_t *) hdr);
-                                        break;
-                                case BLE_EVT_GAP_PHY_CHANGED:
-                                        handle_ble_evt_gap_phy_changed((ble_evt_gap_phy_changed_t *) hdr);
-                                        break;
-#endif /* (dg_configBLE_2MBIT_PHY == 1) */
-#if dg_configSUOTA_SUPPORT && defined (SUOTA_PSM)
-                                case BLE_EVT_L2CAP_CONNECTED:
-                                case BLE_EVT_L2CAP_DISCONNECTED:
-                                case BLE_EVT_L2CAP_DATA_IND:
-                                        suota_l2cap_event(suota, hdr);
-                                        break;
-#endif
-                                default:
-                                        ble_handle_event_default(hdr);
-                                        break;
-                                }
-                        }
-
-                        OS_FREE(hdr);
-
-no_event:
-                        /* Notify again if there are more events to process in queue */
-                        if (ble_has_event()) {
-                                OS_TASK_NOTIFY(ble_periph_task_handle, BLE_APP_NOTIFY_MASK, OS_NOTIFY_SET_BITS);
-                        }
+                        ble_evt_pump(ble_periph_task_handle, handle_ble_evt, NULL);
                 }
 
                 if (notif & SPS_BLE_TX_NOTIF) {